@@ -0,0 +1,29 @@
+struct VSInput
+{
+    float3 position : POSITION; // 単位形状の頂点
+    float4 world0 : WORLD0;     // ワールド行列のアフィン部分の列
+    float4 world1 : WORLD1;
+    float4 world2 : WORLD2;
+    float4 color : COLOR;       // インスタンスの色
+};
+
+struct VSOutput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+cbuffer WVPBuffer : register(b0)
+{
+    matrix viewProjection;
+};
+
+VSOutput main(VSInput input)
+{
+    VSOutput output;
+    float4 local = float4(input.position, 1.0f);
+    float3 world = float3(dot(input.world0, local), dot(input.world1, local), dot(input.world2, local));
+    output.position = mul(float4(world, 1.0f), viewProjection);
+    output.color = input.color;
+    return output;
+}
@@ -9,7 +9,8 @@ struct Material
     float4x4 uvTransform;
     float shininess;
     float reflectivity; // 反射率
-    float2 pad2;
+    uint textureIndex; // gTexturesの添字（SRVヒープでの番号）
+    float pad2;
 };
 
 // ディレクショナルライト
@@ -55,22 +56,53 @@ struct LightCounts
     uint gSpotLightCount;
 };
 
-ConstantBuffer<Material> gMaterial : register(b0);
+// クラスタ（画面のタイルと奥行きのスライス）の求め方
+struct LightClusterParams
+{
+    float4 viewDepthAxis; // ワールド座標との内積+wでビュー空間の奥行き
+    float2 tileScale; // ピクセル座標からタイル番号への倍率
+    float depthScale; // スライス番号 = log(奥行き) * depthScale + depthBias
+    float depthBias;
+    uint3 clusterCount;
+    uint isEnabled; // 0なら全てのライトを計算する
+};
+
+// スポットライトの影（スポットライトと同じ番号で並ぶ）
+struct SpotLightShadow
+{
+    float4x4 viewProjection; // ワールド座標からライトのクリップ座標へ
+    float4 atlasRect; // xy:タイルの左上のUV zw:タイルの大きさのUV
+    float depthBias;
+    float texelSize; // アトラスの1テクセルのUV
+    uint isEnabled; // 0なら影を付けない
+    float padding;
+};
+
+StructuredBuffer<Material> gMaterials : register(t8); // 頂点シェーダーから受け取った番号で引く
 ConstantBuffer<DirectionalLight> gDirectionalLight : register(b1);
 ConstantBuffer<Camera> gCamera : register(b2);
 StructuredBuffer<GPUPointLight> gPointLights : register(t3);
 StructuredBuffer<GPUSpotLight> gSpotLights : register(t4);
 ConstantBuffer<LightCounts> gLightCounts : register(b5);
+ConstantBuffer<LightClusterParams> gLightCluster : register(b6);
+StructuredBuffer<uint2> gClusterRanges : register(t5); // x:ライト番号の開始位置 y:ポイントライトの数(下位16bit)とスポットライトの数(上位16bit)
+StructuredBuffer<uint> gClusterLightIndices : register(t6);
+StructuredBuffer<SpotLightShadow> gSpotLightShadows : register(t7);
 
-Texture2D<float4> gTexture : register(t0);
+Texture2D<float4> gTextures[] : register(t0, space1); // SRVヒープ全体
 TextureCube<float4> gEnvironmentTexture : register(t1);
+Texture2D<float> gShadowAtlas : register(t2);
 SamplerState gSampler : register(s0);
+SamplerComparisonState gShadowSampler : register(s1);
 
 struct PixelShaderOutput
 {
     float4 color : SV_TARGET0;
 };
 
+// このピクセルのマテリアル（mainの最初に引く）
+static Material gMaterial;
+
 // 効率化された照明計算関数
 float3 CalculateHalfLambert(float3 normal, float3 lightDir)
 {
@@ -87,13 +119,94 @@ float3 CalculateSpecular(float3 normal, float3 lightDir, float3 toEye, float3 li
     return lightColor * intensity * specularPow;
 }
 
+// ピクセルの位置と奥行きからクラスタの番号を求める（LightCluster::FindClusterと同じ計算）
+uint ComputeClusterIndex(float2 pixel, float3 worldPos)
+{
+    float viewDepth = dot(float4(worldPos, 1.0f), gLightCluster.viewDepthAxis);
+    uint3 cluster;
+    cluster.xy = min(uint2(pixel * gLightCluster.tileScale), gLightCluster.clusterCount.xy - 1);
+    cluster.z = uint(clamp(floor(log(viewDepth) * gLightCluster.depthScale + gLightCluster.depthBias), 0.0f, float(gLightCluster.clusterCount.z - 1)));
+    return (cluster.z * gLightCluster.clusterCount.y + cluster.y) * gLightCluster.clusterCount.x + cluster.x;
+}
+
+// スポットライトの光が届く割合（影の中なら0）
+float SampleSpotLightShadow(uint lightIndex, float3 worldPos)
+{
+    SpotLightShadow shadow = gSpotLightShadows[lightIndex];
+    if (shadow.isEnabled == 0)
+        return 1.0f;
+
+    float4 clip = mul(float4(worldPos, 1.0f), shadow.viewProjection);
+    if (clip.w <= 0.0f)
+        return 1.0f;
+    float3 ndc = clip.xyz / clip.w;
+    float2 uv = ndc.xy * float2(0.5f, -0.5f) + 0.5f;
+    if (any(uv < 0.0f) || any(uv > 1.0f) || ndc.z > 1.0f)
+        return 1.0f;
+
+    // 隣のタイルを読まないよう、タイルの端から半テクセル内側に収める
+    float2 halfTexel = shadow.texelSize * 0.5f;
+    float2 atlasUV = clamp(shadow.atlasRect.xy + uv * shadow.atlasRect.zw, shadow.atlasRect.xy + halfTexel, shadow.atlasRect.xy + shadow.atlasRect.zw - halfTexel);
+    return gShadowAtlas.SampleCmpLevelZero(gShadowSampler, atlasUV, ndc.z - shadow.depthBias);
+}
+
+void AccumulatePointLight(GPUPointLight light, float3 worldPos, float3 normal, float3 toEye, float3 baseColor, inout float3 totalDiffuse, inout float3 totalSpecular)
+{
+    float3 lightToPixel = worldPos - light.position;
+    float distance = length(lightToPixel);
+    float3 pointLightDir = lightToPixel / distance; // 正規化を効率化
+        
+    // 減衰計算
+    float factor = pow(saturate(1.0f - distance / light.radius), light.decay);
+        
+    // 減衰が十分小さい場合はスキップ
+    if (factor < 0.01f)
+        return;
+        
+    float pointNdotL = CalculateHalfLambert(normal, -pointLightDir);
+    totalDiffuse += baseColor * light.color.rgb * pointNdotL * light.intensity * factor;
+    totalSpecular += CalculateSpecular(normal, -pointLightDir, toEye, light.color.rgb, light.intensity, gMaterial.shininess) * factor;
+}
+
+void AccumulateSpotLight(GPUSpotLight light, uint lightIndex, float3 worldPos, float3 normal, float3 toEye, float3 baseColor, inout float3 totalDiffuse, inout float3 totalSpecular)
+{
+    float3 lightToPixel = worldPos - light.position;
+    float distance = length(lightToPixel);
+    float3 spotLightDir = lightToPixel / distance; // 正規化を効率化
+        
+    // 距離減衰
+    float spotFactor = pow(saturate(1.0f - distance / light.distance), light.decay);
+        
+    // フォールオフ計算
+    float cosAngle = dot(spotLightDir, light.direction);
+    float falloffFactor = saturate((cosAngle - light.cosAngle) / (light.cosFalloffStart - light.cosAngle));
+        
+    float combinedFactor = spotFactor * falloffFactor;
+        
+    // 結合された減衰が十分小さい場合はスキップ
+    if (combinedFactor < 0.01f)
+        return;
+
+    // 影の中なら光が届かない
+    combinedFactor *= SampleSpotLightShadow(lightIndex, worldPos);
+    if (combinedFactor <= 0.0f)
+        return;
+        
+    float spotNdotL = CalculateHalfLambert(normal, -spotLightDir);
+    totalDiffuse += baseColor * light.color.rgb * spotNdotL * light.intensity * combinedFactor;
+    totalSpecular += CalculateSpecular(normal, -spotLightDir, toEye, light.color.rgb, light.intensity, gMaterial.shininess) * combinedFactor;
+}
+
 PixelShaderOutput main(VertexShaderOutput input)
 {
     PixelShaderOutput output;
 
+    // インスタンスごとにマテリアルとテクスチャが違うので、添字が揃っていない前提で引く
+    gMaterial = gMaterials[input.materialIndex];
+
     // テクスチャUVとカラーの取得（early out用に先に計算）
     float4 transformedUV = mul(float4(input.texcoord, 0.0f, 1.0f), gMaterial.uvTransform);
-    float4 textureColor = gTexture.Sample(gSampler, transformedUV.xy);
+    float4 textureColor = gTextures[NonUniformResourceIndex(gMaterial.textureIndex)].Sample(gSampler, transformedUV.xy);
 
     // アルファテスト（early out）
     if (textureColor.a <= 0.5f)
@@ -119,62 +232,38 @@ PixelShaderOutput main(VertexShaderOutput input)
     float3 diffuse = baseColor * gDirectionalLight.color.rgb * NdotL * gDirectionalLight.intensity;
     float3 specular = CalculateSpecular(normal, lightDir, toEye, gDirectionalLight.color.rgb, gDirectionalLight.intensity, gMaterial.shininess);
 
-    /*-----[ ポイントライトの合計（最適化されたループ）]-----*/
+    /*-----[ このピクセルのクラスタに入っているライトだけを計算する ]-----*/
+    uint pointLightCount = gLightCounts.gPointLightCount;
+    uint spotLightCount = gLightCounts.gSpotLightCount;
+    uint indexOffset = 0;
+    if (gLightCluster.isEnabled != 0)
+    {
+        uint2 range = gClusterRanges[ComputeClusterIndex(input.position.xy, input.worldPos)];
+        indexOffset = range.x;
+        pointLightCount = range.y & 0xFFFF;
+        spotLightCount = range.y >> 16;
+    }
+
+    /*-----[ ポイントライトの合計 ]-----*/
     float3 totalPointDiffuse = 0.0f;
     float3 totalPointSpecular = 0.0f;
     
     [loop]
-    for (uint j = 0; j < gLightCounts.gPointLightCount; j++)
+    for (uint i = 0; i < pointLightCount; i++)
     {
-        float3 lightToPixel = input.worldPos - gPointLights[j].position;
-        float distance = length(lightToPixel);
-        float3 pointLightDir = lightToPixel / distance; // 正規化を効率化
-        
-        // 減衰計算
-        float factor = pow(saturate(1.0f - distance / gPointLights[j].radius), gPointLights[j].decay);
-        
-        // 減衰が十分小さい場合はスキップ
-        if (factor < 0.01f)
-            continue;
-        
-        float pointNdotL = CalculateHalfLambert(normal, -pointLightDir);
-        float3 pointDiffuse = baseColor * gPointLights[j].color.rgb * pointNdotL * gPointLights[j].intensity * factor;
-        float3 pointSpecular = CalculateSpecular(normal, -pointLightDir, toEye, gPointLights[j].color.rgb, gPointLights[j].intensity, gMaterial.shininess) * factor;
-        
-        totalPointDiffuse += pointDiffuse;
-        totalPointSpecular += pointSpecular;
+        uint j = gLightCluster.isEnabled != 0 ? gClusterLightIndices[indexOffset + i] : i;
+        AccumulatePointLight(gPointLights[j], input.worldPos, normal, toEye, baseColor, totalPointDiffuse, totalPointSpecular);
     }
 
-    /*-----[ スポットライトの合計（最適化されたループ）]-----*/
+    /*-----[ スポットライトの合計 ]-----*/
     float3 totalSpotDiffuse = 0.0f;
     float3 totalSpotSpecular = 0.0f;
     
     [loop]
-    for (uint k = 0; k < gLightCounts.gSpotLightCount; k++)
+    for (uint n = 0; n < spotLightCount; n++)
     {
-        float3 lightToPixel = input.worldPos - gSpotLights[k].position;
-        float distance = length(lightToPixel);
-        float3 spotLightDir = lightToPixel / distance; // 正規化を効率化
-        
-        // 距離減衰
-        float spotFactor = pow(saturate(1.0f - distance / gSpotLights[k].distance), gSpotLights[k].decay);
-        
-        // フォールオフ計算
-        float cosAngle = dot(spotLightDir, gSpotLights[k].direction);
-        float falloffFactor = saturate((cosAngle - gSpotLights[k].cosAngle) / (gSpotLights[k].cosFalloffStart - gSpotLights[k].cosAngle));
-        
-        float combinedFactor = spotFactor * falloffFactor;
-        
-        // 結合された減衰が十分小さい場合はスキップ
-        if (combinedFactor < 0.01f)
-            continue;
-        
-        float spotNdotL = CalculateHalfLambert(normal, -spotLightDir);
-        float3 spotDiffuse = baseColor * gSpotLights[k].color.rgb * spotNdotL * gSpotLights[k].intensity * combinedFactor;
-        float3 spotSpecular = CalculateSpecular(normal, -spotLightDir, toEye, gSpotLights[k].color.rgb, gSpotLights[k].intensity, gMaterial.shininess) * combinedFactor;
-        
-        totalSpotDiffuse += spotDiffuse;
-        totalSpotSpecular += spotSpecular;
+        uint k = gLightCluster.isEnabled != 0 ? gClusterLightIndices[indexOffset + pointLightCount + n] : n;
+        AccumulateSpotLight(gSpotLights[k], k, input.worldPos, normal, toEye, baseColor, totalSpotDiffuse, totalSpotSpecular);
     }
 
     // ライティング結果の合成
@@ -23,5 +23,7 @@ VertexShaderOutput main(VertexShaderInput input)
     output.texcoord = input.texxcoord;
     output.normal = normalize(mul(input.normal,(float32_t3x3)gTransformationMatrix.WorldInverseTranspose));
     output.worldPos = mul(input.position, gTransformationMatrix.World).xyz;
+    // 1つずつ描く時はマテリアルを1つだけ送る
+    output.materialIndex = 0;
 	return output;
 }
\ No newline at end of file
@@ -4,4 +4,5 @@ struct VertexShaderOutput
     float32_t2 texcoord : TEXCOORD0;
     float32_t3 normal : NORMAL0;
     float32_t3 worldPos : POSITION0;
+    nointerpolation uint32_t materialIndex : MATERIAL0; // gMaterialsの添字
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "Object3d.hlsli"
+
+struct TransformationMatrix
+{
+    float32_t4x4 WVP;
+    float32_t4x4 World;
+    float32_t4x4 WorldInverseTranspose;
+};
+
+struct InstanceData
+{
+    TransformationMatrix transform;
+    uint32_t materialIndex; // gMaterialsの添字
+    uint32_t3 padding;
+};
+
+// バッチの先頭を指すので、SV_InstanceIDがそのまま添字になる
+StructuredBuffer<InstanceData> gInstances : register(t0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texxcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+};
+
+VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
+{
+    InstanceData instance = gInstances[instanceId];
+    TransformationMatrix transformationMatrix = instance.transform;
+    VertexShaderOutput output;
+    output.position = mul(input.position, transformationMatrix.WVP);
+    output.texcoord = input.texxcoord;
+    output.normal = normalize(mul(input.normal, (float32_t3x3)transformationMatrix.WorldInverseTranspose));
+    output.worldPos = mul(input.position, transformationMatrix.World).xyz;
+    output.materialIndex = instance.materialIndex;
+    return output;
+}
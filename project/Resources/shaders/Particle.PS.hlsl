@@ -5,6 +5,9 @@ struct Material
     float32_t4 color;
     int32_t enableLighting;
     float32_t4x4 uvTransform;
+    float32_t shininess;
+    float32_t reflectivity;
+    uint32_t textureIndex; // gTexturesの添字（SRVヒープでの番号）
 };
 
 struct DirectionalLight
@@ -16,7 +19,7 @@ struct DirectionalLight
 
 
 ConstantBuffer<Material> gMaterial : register(b0);
-Texture2D<float32_t4> gTexture : register(t0);
+Texture2D<float32_t4> gTextures[] : register(t0, space1); // SRVヒープ全体
 SamplerState gSampler : register(s0);
 struct PixelShaderOutput
 {
@@ -27,7 +30,7 @@ PixelShaderOutput main(VertexShaderOutput input)
 {
     PixelShaderOutput output;
     float32_t4 transformedUV = mul(float32_t4(input.texcoord, 0.0f, 1.0f), gMaterial.uvTransform);
-    float32_t4 textureColor = gTexture.Sample(gSampler, transformedUV.xy);
+    float32_t4 textureColor = gTextures[gMaterial.textureIndex].Sample(gSampler, transformedUV.xy);
 
     if (textureColor.a == 0.0)
     {
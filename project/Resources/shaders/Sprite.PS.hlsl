@@ -1,22 +1,5 @@
 #include "Sprite.hlsli"
 
-struct Material
-{
-    float32_t4 color;
-    int32_t enableLighting;
-    float32_t4x4 uvTransform;
-};
-
-struct DirectionalLight
-{
-    float32_t4 color;
-    float32_t3 direction;
-    float intensity;
-};
-
-
-ConstantBuffer<Material> gMaterial : register(b0);
-ConstantBuffer<DirectionalLight> gDirectionalLight : register(b1);
 Texture2D<float32_t4> gTexture : register(t0);
 SamplerState gSampler : register(s0);
 struct PixelShaderOutput
@@ -27,25 +10,13 @@ struct PixelShaderOutput
 PixelShaderOutput main(VertexShaderOutput input)
 {
     PixelShaderOutput output;
-    float3 transformedUV = mul(float32_t4(input.texcoord,0.0f, 1.0f), gMaterial.uvTransform);
-    float32_t4 textureColor = gTexture.Sample(gSampler, transformedUV.xy);
+    float32_t4 textureColor = gTexture.Sample(gSampler, input.texcoord);
     //テクスチャの透明度が0以下の場合は描画しない
 	if(textureColor.a == 0.0)
     {
         discard;
     }
-    //ライティングを有効にしている場合はライティングを適用
-	if(gMaterial.enableLighting != 0)
-    {
-        float NdotL = dot(normalize(input.normal), -gDirectionalLight.direction);
-        float cos = pow(NdotL * 0.5f + 0.5f, 2.0f);
-        output.color.rgb = gMaterial.color.rgb * textureColor.rgb * gDirectionalLight.color.rgb * cos * gDirectionalLight.intensity;
-        output.color.a = gMaterial.color.a * textureColor.a;
-    }else
-
-    {
-        output.color = gMaterial.color * textureColor;
-    }
+    output.color = input.color * textureColor;
     //Output.colorが透明度0以下の場合は描画しない
     if (output.color.a == 0.0)
     {
@@ -1,25 +1,18 @@
 #include "Sprite.hlsli"
 
-struct TransformationMatrix
-{
-    float32_t4x4 WVP;
-    float32_t4x4 World;
-};
-
-ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
-
+//座標はCPUでクリップ空間に変換済み。色も頂点ごとに持つので、バッチ全体を1本の頂点列で描ける
 struct VertexShaderInput
 {
     float32_t4 position : POSITION0;
-    float32_t2 texxcoord : TEXCOORD0;
-    float32_t3 normal : NORMAL0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
 };
 
 VertexShaderOutput main(VertexShaderInput input)
 {
     VertexShaderOutput output;
-    output.position = mul(input.position, gTransformationMatrix.WVP);
-    output.texcoord = input.texxcoord;
-    output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrix.World));
+    output.position = input.position;
+    output.texcoord = input.texcoord;
+    output.color = input.color;
     return output;
 }
\ No newline at end of file
@@ -2,52 +2,254 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
 struct BuffValue
 {
-    float value;      // 加算量、または割合
-    bool isPercent;   // trueなら割合バフ、falseなら加算バフ
-    float duration;   // 残り効果時間（秒、永続なら-1.0fなどで表現）
+    float value = 0.0f;         // 加算量、または割合
+    bool isPercent = false;     // trueなら割合バフ、falseなら加算バフ
+    float duration = -1.0f;     // 効果時間（秒。0なら次のUpdateで失効、永続なら-1.0fなど負の値で表現）
+    uint32_t id = 0;            // 識別子（AddBuffで割り当て）
 
+    BuffValue() = default;
     BuffValue(float v, bool percent, float dur = -1.0f)
         : value(v), isPercent(percent), duration(dur)
     {
     }
 };
 
-struct StatusValue
+/**
+ * \brief 要素数がN以下の間は内部配列を使い、超えたらヒープへ移る可変長配列
+ */
+template<typename T, size_t N>
+class InlineVector
+{
+public:
+    InlineVector() = default;
+    InlineVector(const InlineVector& other) { *this = other; }
+    InlineVector& operator=(const InlineVector& other)
+    {
+        if (this == &other) return *this;
+        clear();
+        for (const T& v : other) push_back(v);
+        return *this;
+    }
+
+    void push_back(const T& value)
+    {
+        if (!onHeap_ && size_ == N)
+        {
+            // 内部配列があふれたらヒープに移す
+            heap_.assign(inline_, inline_ + N);
+            onHeap_ = true;
+        }
+        if (onHeap_)
+        {
+            heap_.push_back(value);
+        }
+        else
+        {
+            inline_[size_] = value;
+        }
+        ++size_;
+    }
+
+    void pop_back()
+    {
+        --size_;
+        if (onHeap_) heap_.pop_back();
+    }
+
+    // 順序を保たずに削除（末尾と入れ替えて削除）
+    void swap_erase(size_t index)
+    {
+        data()[index] = data()[size_ - 1];
+        pop_back();
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        heap_.clear();
+        onHeap_ = false;
+    }
+
+    T* data() { return onHeap_ ? heap_.data() : inline_; }
+    const T* data() const { return onHeap_ ? heap_.data() : inline_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T& front() { return data()[0]; }
+    const T& front() const { return data()[0]; }
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+private:
+    T inline_[N] = {};
+    std::vector<T> heap_;
+    size_t size_ = 0;
+    bool onHeap_ = false;
+};
+
+/**
+ * \brief バフ付きのステータス値
+ * \note バフの合計はバフが追加・削除・失効した時だけ再計算し、失効は期限順の最小ヒープで管理する
+ * \tparam InlineCapacity ヒープ確保せずに保持できるバフ数
+ */
+template<size_t InlineCapacity>
+struct BasicStatusValue
 {
     float base = 0.0f;
-    std::vector<BuffValue> buffs;
 
-    // 最新の値を返す
+    // 最新の値を返す（バフの合計はキャッシュ済み）
     float Calc() const
     {
-        float add = 0.0f;
-        float percent = 1.0f;
-        for (const auto& b : buffs)
+        return (base + cachedAdd_) * cachedPercent_;
+    }
+
+    /**
+     * \brief バフを追加する
+     * \param buff 追加するバフ（durationが0以上なら時間経過で失効する。0なら次のUpdateで失効）
+     * \return 追加したバフの識別子
+     */
+    uint32_t AddBuff(BuffValue buff)
+    {
+        buff.id = ++nextId_;
+        buffs_.push_back(buff);
+        if (buff.duration >= 0.0f)
         {
-            if (b.isPercent) percent += b.value;
-            else add += b.value;
+            // 失効時刻を最小ヒープに登録
+            expiries_.push_back({ elapsed_ + buff.duration, buff.id });
+            std::push_heap(expiries_.begin(), expiries_.end(), ExpiryGreater);
+        }
+        Recalculate();
+        return buff.id;
+    }
+
+    // 識別子を指定してバフを削除する
+    bool RemoveBuff(uint32_t id)
+    {
+        for (size_t i = 0; i < buffs_.size(); ++i)
+        {
+            if (buffs_[i].id == id)
+            {
+                buffs_.swap_erase(i);
+                EraseExpiry(id);
+                Recalculate();
+                return true;
+            }
         }
-        return (base + add) * percent;
+        return false;
     }
 
+    // バフの値を変更する
+    bool SetBuffValue(uint32_t id, float value)
+    {
+        for (auto& b : buffs_)
+        {
+            if (b.id == id)
+            {
+                b.value = value;
+                Recalculate();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 全てのバフを削除する
+    void ClearBuffs()
+    {
+        buffs_.clear();
+        expiries_.clear();
+        cachedAdd_ = 0.0f;
+        cachedPercent_ = 1.0f;
+    }
+
+    // バフの残り時間を取得（永続・存在しない場合は-1）
+    float GetRemainingTime(uint32_t id) const
+    {
+        for (const auto& e : expiries_)
+        {
+            if (e.id == id) return static_cast<float>(e.expireTime - elapsed_);
+        }
+        return -1.0f;
+    }
+
+    size_t GetBuffCount() const { return buffs_.size(); }
+    const BuffValue* begin() const { return buffs_.begin(); }
+    const BuffValue* end() const { return buffs_.end(); }
+
     // バフ管理: 経過時間（秒）を与えて更新＆切れたバフを削除
     void Update(float deltaTime)
     {
-        for (auto& b : buffs)
+        elapsed_ += deltaTime;
+        // 期限が来たものだけを取り出す
+        while (!expiries_.empty() && expiries_.front().expireTime <= elapsed_)
+        {
+            uint32_t id = expiries_.front().id;
+            std::pop_heap(expiries_.begin(), expiries_.end(), ExpiryGreater);
+            expiries_.pop_back();
+            for (size_t i = 0; i < buffs_.size(); ++i)
+            {
+                if (buffs_[i].id == id)
+                {
+                    buffs_.swap_erase(i);
+                    Recalculate();
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    struct Expiry
+    {
+        double expireTime = 0.0;
+        uint32_t id = 0;
+    };
+
+    static bool ExpiryGreater(const Expiry& a, const Expiry& b) { return a.expireTime > b.expireTime; }
+
+    // 削除したバフの失効予定をヒープから取り除く（ヒープに削除済みのバフを残さない）
+    void EraseExpiry(uint32_t id)
+    {
+        for (size_t i = 0; i < expiries_.size(); ++i)
         {
-            if (b.duration > 0.0f)
+            if (expiries_[i].id == id)
             {
-                b.duration -= deltaTime;
+                expiries_.swap_erase(i);
+                std::make_heap(expiries_.begin(), expiries_.end(), ExpiryGreater);
+                return;
             }
         }
-        // durationが0以下のものを削除
-        buffs.erase(
-            std::remove_if(buffs.begin(), buffs.end(),
-                           [](const BuffValue& b) { return b.duration >= 0.0f && b.duration <= 0.0f; }),
-            buffs.end()
-        );
     }
-};
\ No newline at end of file
+
+    // バフの合計を再計算（バフに変化があった時だけ呼ぶ）
+    void Recalculate()
+    {
+        float add = 0.0f;
+        float percent = 1.0f;
+        for (const auto& b : buffs_)
+        {
+            if (b.isPercent) percent += b.value;
+            else add += b.value;
+        }
+        cachedAdd_ = add;
+        cachedPercent_ = percent;
+    }
+
+private:
+    InlineVector<BuffValue, InlineCapacity> buffs_;
+    InlineVector<Expiry, InlineCapacity> expiries_;
+    float cachedAdd_ = 0.0f;
+    float cachedPercent_ = 1.0f;
+    double elapsed_ = 0.0;
+    uint32_t nextId_ = 0;
+};
+
+// 通常はバフ4つまでをヒープ確保なしで保持する
+using StatusValue = BasicStatusValue<4>;
@@ -14,14 +14,6 @@ public:
 	virtual void Draw(CameraManager* camera);
 	void AddComponent(const std::string& name, std::unique_ptr<IGameObjectComponent> comp);
 
-	// トランスフォーム
-	const Vector3& GetPosition() const { return transform_.translate; }
-	void SetPosition(const Vector3& position) { transform_.translate = position; }
-	const Vector3& GetRotation() const { return transform_.rotate; }
-	void SetRotation(const Vector3& rotation) { transform_.rotate = rotation; }
-	const Vector3& GetScale() const { return transform_.scale; }
-	void SetScale(const Vector3& scale) { transform_.scale = scale; }
-
 	// 無敵状態
 	void SetInvincible(float duration); // 無敵状態を設定
 	bool IsInvincible() const { return isInvincible_; }
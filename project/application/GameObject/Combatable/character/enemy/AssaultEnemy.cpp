@@ -32,6 +32,8 @@ void AssaultEnemy::CollisionSettings(ICollisionComponent* collider)
 {
 	// スイープ判定を使用
 	collider->SetUseSubstep(true);
+	// 敵同士の判定はCrowdSeparationで処理する
+	collider->SetCollisionGroup(CollisionGroup::Enemy);
 	// 衝突時の処理を設定
 	collider->SetOnEnter([this](GameObject* other) {
 		// 衝突した瞬間の処理
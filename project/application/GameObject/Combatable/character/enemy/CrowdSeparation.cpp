@@ -0,0 +1,235 @@
+#include "CrowdSeparation.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define CROWD_USE_SSE
+#endif
+
+namespace
+{
+	// 4bitのマスクに立っているビット数
+	constexpr uint32_t kBitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+}
+
+void CrowdSeparation::Solve(const std::vector<Vector3>& currentPositions, const std::vector<Vector3>& previousPositions, float deltaTime, std::vector<Vector3>& outCorrections)
+{
+	neighborChecks_ = 0;
+	overlaps_ = 0;
+
+	const size_t count = currentPositions.size();
+	outCorrections.assign(count, Vector3{ 0.0f, 0.0f, 0.0f });
+	if (count < 2 || deltaTime <= 0.0f)
+	{
+		return;
+	}
+
+	// XZ平面の位置と速度をSoAに展開
+	posX_.resize(count); posZ_.resize(count);
+	velX_.resize(count); velZ_.resize(count);
+	outX_.assign(count, 0.0f); outZ_.assign(count, 0.0f);
+	const float invDt = 1.0f / deltaTime;
+	const bool hasPrevious = previousPositions.size() == count;
+	for (size_t i = 0; i < count; ++i)
+	{
+		posX_[i] = currentPositions[i].x;
+		posZ_[i] = currentPositions[i].z;
+		velX_[i] = hasPrevious ? (currentPositions[i].x - previousPositions[i].x) * invDt : 0.0f;
+		velZ_[i] = hasPrevious ? (currentPositions[i].z - previousPositions[i].z) * invDt : 0.0f;
+	}
+
+	// 2体分の半径をセルサイズにすると、近傍は周囲3x3セルに収まる
+	const float diameter = settings_.radius * 2.0f;
+	const float diameterSq = diameter * diameter;
+	cellSize_ = diameter;
+	BuildHash(count);
+
+	// 押し戻しは重なりの深さ×強さ×時間をお互いに半分ずつ（1フレームで重なりを全て解消するわけではない）
+	const float separation = settings_.separationStrength * deltaTime * 0.5f;
+	const float avoidance = std::clamp(settings_.avoidanceStrength, 0.0f, 1.0f) * 0.5f * deltaTime;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		// 周囲3x3セルの候補を連続した配列に集める
+		GatherNeighbors(i);
+		const uint32_t neighborCount = static_cast<uint32_t>(nbX_.size());
+		neighborChecks_ += neighborCount;
+
+		const float px = posX_[i];
+		const float pz = posZ_[i];
+		const float vx = velX_[i];
+		const float vz = velZ_[i];
+		float dx = 0.0f;
+		float dz = 0.0f;
+		uint32_t k = 0;
+
+#ifdef CROWD_USE_SSE
+		// 4体ずつ同時に計算し、重なっていないレーンは0で足す
+		const __m128 posXi = _mm_set1_ps(px), posZi = _mm_set1_ps(pz);
+		const __m128 velXi = _mm_set1_ps(vx), velZi = _mm_set1_ps(vz);
+		const __m128 diameter4 = _mm_set1_ps(diameter);
+		const __m128 diameterSq4 = _mm_set1_ps(diameterSq);
+		const __m128 epsilon = _mm_set1_ps(1e-4f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		__m128 sumX = zero, sumZ = zero;
+		for (; k + 4 <= neighborCount; k += 4)
+		{
+			const __m128 rx = _mm_sub_ps(posXi, _mm_loadu_ps(nbX_.data() + k));
+			const __m128 rz = _mm_sub_ps(posZi, _mm_loadu_ps(nbZ_.data() + k));
+			const __m128 distSq = _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(rz, rz));
+			const __m128 overlap = _mm_cmplt_ps(distSq, diameterSq4);
+			overlaps_ += kBitCount[_mm_movemask_ps(overlap)];
+
+			// 完全に重なっている場合は添字から決まる方向に押し出す
+			const __m128 dist = _mm_sqrt_ps(distSq);
+			const __m128 separated = _mm_cmpgt_ps(dist, epsilon);
+			const __m128 invDist = _mm_div_ps(one, _mm_or_ps(_mm_and_ps(separated, dist), _mm_andnot_ps(separated, one)));
+			const __m128 nx = _mm_or_ps(_mm_and_ps(separated, _mm_mul_ps(rx, invDist)), _mm_andnot_ps(separated, _mm_loadu_ps(nbSign_.data() + k)));
+			const __m128 nz = _mm_and_ps(separated, _mm_mul_ps(rz, invDist));
+
+			// 重なりの深さ（直径 - 距離）に比例した押し戻し
+			const __m128 push = _mm_mul_ps(_mm_sub_ps(diameter4, dist), _mm_set1_ps(separation));
+
+			// 相対速度のうち接近する成分を打ち消す（RVOの簡易版）
+			const __m128 relVX = _mm_sub_ps(velXi, _mm_loadu_ps(nbVX_.data() + k));
+			const __m128 relVZ = _mm_sub_ps(velZi, _mm_loadu_ps(nbVZ_.data() + k));
+			const __m128 closing = _mm_max_ps(_mm_sub_ps(zero, _mm_add_ps(_mm_mul_ps(relVX, nx), _mm_mul_ps(relVZ, nz))), zero);
+
+			const __m128 amount = _mm_and_ps(overlap, _mm_add_ps(push, _mm_mul_ps(closing, _mm_set1_ps(avoidance))));
+			sumX = _mm_add_ps(sumX, _mm_mul_ps(nx, amount));
+			sumZ = _mm_add_ps(sumZ, _mm_mul_ps(nz, amount));
+		}
+		alignas(16) float laneX[4], laneZ[4];
+		_mm_store_ps(laneX, sumX);
+		_mm_store_ps(laneZ, sumZ);
+		dx = (laneX[0] + laneX[1]) + (laneX[2] + laneX[3]);
+		dz = (laneZ[0] + laneZ[1]) + (laneZ[2] + laneZ[3]);
+#endif
+
+		// 4体に満たない残り（SSEが使えない環境では全て）
+		for (; k < neighborCount; ++k)
+		{
+			float rx = px - nbX_[k];
+			float rz = pz - nbZ_[k];
+			float distSq = rx * rx + rz * rz;
+			if (distSq >= diameterSq)
+			{
+				continue;
+			}
+			++overlaps_;
+
+			float dist = std::sqrt(distSq);
+			float nx = nbSign_[k];
+			float nz = 0.0f;
+			if (dist > 1e-4f)
+			{
+				nx = rx / dist;
+				nz = rz / dist;
+			}
+
+			float push = (diameter - dist) * separation;
+			float closing = std::max(-((vx - nbVX_[k]) * nx + (vz - nbVZ_[k]) * nz), 0.0f);
+			float amount = push + closing * avoidance;
+			dx += nx * amount;
+			dz += nz * amount;
+		}
+
+		outX_[i] = dx;
+		outZ_[i] = dz;
+	}
+
+	// 補正量を制限して書き出す
+	const float maxSq = settings_.maxCorrection * settings_.maxCorrection;
+	for (size_t i = 0; i < count; ++i)
+	{
+		float lenSq = outX_[i] * outX_[i] + outZ_[i] * outZ_[i];
+		float scale = (lenSq > maxSq) ? settings_.maxCorrection / std::sqrt(lenSq) : 1.0f;
+		outCorrections[i] = Vector3{ outX_[i] * scale, 0.0f, outZ_[i] * scale };
+	}
+}
+
+void CrowdSeparation::GatherNeighbors(uint32_t agent)
+{
+	nbX_.clear(); nbZ_.clear();
+	nbVX_.clear(); nbVZ_.clear();
+	nbSign_.clear();
+
+	// 同じバケットを二重に走査しないよう記録する
+	uint32_t visited[9];
+	int visitedCount = 0;
+
+	for (int32_t oz = -1; oz <= 1; ++oz)
+	{
+		for (int32_t ox = -1; ox <= 1; ++ox)
+		{
+			uint32_t bucket = HashCell(cellX_[agent] + ox, cellZ_[agent] + oz);
+			if (std::find(visited, visited + visitedCount, bucket) != visited + visitedCount)
+			{
+				continue;
+			}
+			visited[visitedCount++] = bucket;
+
+			for (uint32_t k = bucketStart_[bucket]; k < bucketStart_[bucket + 1]; ++k)
+			{
+				uint32_t j = sortedAgents_[k];
+				if (j == agent)
+				{
+					continue;
+				}
+				nbX_.push_back(posX_[j]);
+				nbZ_.push_back(posZ_[j]);
+				nbVX_.push_back(velX_[j]);
+				nbVZ_.push_back(velZ_[j]);
+				nbSign_.push_back(agent < j ? 1.0f : -1.0f);
+			}
+		}
+	}
+}
+
+void CrowdSeparation::BuildHash(size_t count)
+{
+	// バケット数は敵の数の2倍以上の2の累乗
+	uint32_t bucketCount = 16;
+	while (bucketCount < count * 2)
+	{
+		bucketCount <<= 1;
+	}
+	bucketMask_ = bucketCount - 1;
+
+	cellX_.resize(count);
+	cellZ_.resize(count);
+	bucketOfAgent_.resize(count);
+	sortedAgents_.resize(count);
+	bucketStart_.assign(bucketCount + 1, 0);
+
+	// 各敵のセルとバケットを求めて数える
+	const float invCell = 1.0f / cellSize_;
+	for (size_t i = 0; i < count; ++i)
+	{
+		cellX_[i] = static_cast<int32_t>(std::floor(posX_[i] * invCell));
+		cellZ_[i] = static_cast<int32_t>(std::floor(posZ_[i] * invCell));
+		bucketOfAgent_[i] = HashCell(cellX_[i], cellZ_[i]);
+		++bucketStart_[bucketOfAgent_[i] + 1];
+	}
+
+	// 累積和で各バケットの開始位置を求める
+	for (uint32_t b = 0; b < bucketCount; ++b)
+	{
+		bucketStart_[b + 1] += bucketStart_[b];
+	}
+
+	// バケット順に並べる（計数ソート）
+	bucketCursor_.assign(bucketStart_.begin(), bucketStart_.end() - 1);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		sortedAgents_[bucketCursor_[bucketOfAgent_[i]]++] = i;
+	}
+}
+
+uint32_t CrowdSeparation::HashCell(int32_t cx, int32_t cz) const
+{
+	uint32_t h = static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cz) * 19349663u;
+	return h & bucketMask_;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "math/Vector3.h"
+
+/**
+ * \brief 敵同士の押し合い・回避を一括で処理するクラス
+ * \note 空間ハッシュで近傍を探すので、敵の数に対してほぼO(n)で処理できる。近傍との計算はSSEで4体ずつ行う
+ */
+class CrowdSeparation
+{
+public:
+	// 調整用パラメータ
+	struct Settings
+	{
+		float radius = 1.2f;				// 1体あたりの占有半径
+		float separationStrength = 6.0f;	// 重なりを押し戻す強さ
+		float avoidanceStrength = 0.5f;		// 接近速度を打ち消す割合（0～1）
+		float maxCorrection = 0.25f;		// 1フレームの最大補正量
+	};
+
+	/**
+	 * \brief 押し合い・回避の補正量を計算する
+	 * \param currentPositions 今フレームの位置
+	 * \param previousPositions 前フレームの位置（速度の算出に使用）
+	 * \param deltaTime フレーム時間
+	 * \param outCorrections 各敵の位置補正量（XZ平面のみ）
+	 */
+	void Solve(const std::vector<Vector3>& currentPositions, const std::vector<Vector3>& previousPositions, float deltaTime, std::vector<Vector3>& outCorrections);
+
+public: //アクセッサ
+	Settings& GetSettings() { return settings_; }
+	uint32_t GetNeighborCheckCount() const { return neighborChecks_; }
+	uint32_t GetOverlapCount() const { return overlaps_; }
+
+private:
+	// 空間ハッシュの構築
+	void BuildHash(size_t count);
+	// 周囲3x3セルにいる敵の位置と速度をnbX_などに集める
+	void GatherNeighbors(uint32_t agent);
+	// セル座標からハッシュ値を求める
+	uint32_t HashCell(int32_t cx, int32_t cz) const;
+
+private:
+	Settings settings_;
+
+	// 計算用（SoA）
+	std::vector<float> posX_, posZ_;
+	std::vector<float> velX_, velZ_;
+	std::vector<float> outX_, outZ_;
+	// 1体分の近傍（SSEで4体ずつ読めるよう連続に並べる）
+	std::vector<float> nbX_, nbZ_;
+	std::vector<float> nbVX_, nbVZ_;
+	std::vector<float> nbSign_;		// 完全に重なったときに押し出す向き
+
+	// 空間ハッシュ
+	std::vector<int32_t> cellX_, cellZ_;
+	std::vector<uint32_t> bucketOfAgent_;
+	std::vector<uint32_t> bucketStart_;
+	std::vector<uint32_t> bucketCursor_;
+	std::vector<uint32_t> sortedAgents_;
+	uint32_t bucketMask_ = 0;
+	float cellSize_ = 1.0f;
+
+	// 統計
+	uint32_t neighborChecks_ = 0;
+	uint32_t overlaps_ = 0;
+};
@@ -1,10 +1,14 @@
 #include "EnemyManager.h"
+#include <algorithm>
+#include <cassert>
 
 #include "AssaultEnemy.h"
 #include "PistolEnemy.h"
 #include "ShotgunEnemy.h"
+#include "base/Node/BTProfiler.h"
 #include "ImGui/imgui_internal.h"
 #include "math/MathUtils.h"
+#include "time/TimeManager.h"
 
 void EnemyManager::Initialize(Object3dCommon* object3dCommon, LightManager* lightManager, GameObject* target)
 {
@@ -41,6 +45,59 @@ void EnemyManager::Update()
 		AddShotgunEnemy(1); // ショットガン敵を1体追加
 	}
 
+	ImGui::SeparatorText("Pool");
+	{
+		// 種類ごとの出現中・待機中の数
+		std::array<uint32_t, kEnemyTypeCount> activeCounts = {};
+		for (const auto& enemy : enemies_)
+		{
+			++activeCounts[static_cast<size_t>(enemy->GetEnemyType())];
+		}
+		static const char* kTypeNames[kEnemyTypeCount] = { "Pistol", "Assault", "Shotgun" };
+		if (ImGui::BeginTable("EnemyPool", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("Type");
+			ImGui::TableSetupColumn("Active");
+			ImGui::TableSetupColumn("Pooled");
+			ImGui::TableHeadersRow();
+			for (size_t type = 0; type < kEnemyTypeCount; ++type)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::Text("%s", kTypeNames[type]);
+				ImGui::TableNextColumn(); ImGui::Text("%u", activeCounts[type]);
+				ImGui::TableNextColumn(); ImGui::Text("%zu", pools_[type].size());
+			}
+			ImGui::EndTable();
+		}
+		ImGui::Text("Last Spawn: %u enemies in %.3f ms", spawnStats_.lastSpawnCount, spawnStats_.lastSpawnMs);
+		ImGui::Text("Max Spawn: %.3f ms", spawnStats_.maxSpawnMs);
+		ImGui::Text("Created: %u  Reused: %u", spawnStats_.createdCount, spawnStats_.reusedCount);
+		static int spawnCount = 20;
+		ImGui::SliderInt("Spawn Count", &spawnCount, 1, 100);
+		if (ImGui::Button("Spawn Wave"))
+		{
+			SpawnRandom(EnemyType::Assault, static_cast<uint32_t>(spawnCount));
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Prewarm"))
+		{
+			for (size_t type = 0; type < kEnemyTypeCount; ++type)
+			{
+				Prewarm(static_cast<EnemyType>(type), kPrewarmCount);
+			}
+		}
+	}
+
+	ImGui::SeparatorText("Crowd Separation");
+	ImGui::Checkbox("Enable", &enableCrowdSeparation_);
+	auto& crowdSettings = crowdSeparation_.GetSettings();
+	ImGui::DragFloat("Radius", &crowdSettings.radius, 0.01f, 0.1f, 10.0f);
+	ImGui::DragFloat("Separation Strength", &crowdSettings.separationStrength, 0.1f, 0.0f, 50.0f);
+	ImGui::SliderFloat("Avoidance Strength", &crowdSettings.avoidanceStrength, 0.0f, 1.0f);
+	ImGui::DragFloat("Max Correction", &crowdSettings.maxCorrection, 0.01f, 0.0f, 2.0f);
+	ImGui::Text("Neighbor Checks: %u", crowdSeparation_.GetNeighborCheckCount());
+	ImGui::Text("Overlapping Pairs: %u", crowdSeparation_.GetOverlapCount() / 2);
+
 	ImGui::SeparatorText("Enemies Info");
 
 	// 各敵の情報表示
@@ -55,24 +112,62 @@ void EnemyManager::Update()
 	}
 	ImGui::End();
 
+	// ビヘイビアツリーの計測結果
+	BTProfiler::GetInstance().NewFrame();
+	BTProfiler::GetInstance().DrawImGui();
 #endif
 
+	// 更新前の位置を保存（速度の算出に使用）
+	previousPositions_.resize(enemies_.size());
+	for (size_t i = 0; i < enemies_.size(); ++i)
+	{
+		previousPositions_[i] = enemies_[i]->GetPosition();
+	}
+
 	for (auto& enemy : enemies_)
 	{
 		enemy->Update(); // 各敵キャラクターの更新
 	}
 
-	// 敵キャラクターのリストから死亡した敵を削除
-	for (auto it = enemies_.begin(); it != enemies_.end();)
+	// 敵同士の押し合い・回避をまとめて処理
+	if (enableCrowdSeparation_)
 	{
-		if (!(*it)->IsAlive())
+		ApplyCrowdSeparation();
+	}
+
+	// 死亡した敵をプールに戻す（末尾と入れ替えて削除するので順序は保たない）
+	for (size_t i = 0; i < enemies_.size();)
+	{
+		if (!enemies_[i]->IsAlive())
 		{
-			deathEffect_->PlayDeathEffect((*it)->GetPosition(),EnemyDeathEffect::EffectType::Electric); // 死亡エフェクトを再生
-			it = enemies_.erase(it); // 死亡した敵を削除
+			deathEffect_->PlayDeathEffect(enemies_[i]->GetPosition(),EnemyDeathEffect::EffectType::Electric); // 死亡エフェクトを再生
+			enemies_[i]->Despawn();
+			pools_[static_cast<size_t>(enemies_[i]->GetEnemyType())].push_back(std::move(enemies_[i]));
+			enemies_[i] = std::move(enemies_.back());
+			enemies_.pop_back();
 		}
 		else
 		{
-			++it; // 次の敵へ
+			++i; // 次の敵へ
+		}
+	}
+}
+
+void EnemyManager::ApplyCrowdSeparation()
+{
+	currentPositions_.resize(enemies_.size());
+	for (size_t i = 0; i < enemies_.size(); ++i)
+	{
+		currentPositions_[i] = enemies_[i]->GetPosition();
+	}
+
+	crowdSeparation_.Solve(currentPositions_, previousPositions_, TimeManager::GetInstance().GetDeltaTime(), corrections_);
+
+	for (size_t i = 0; i < enemies_.size(); ++i)
+	{
+		if (!corrections_[i].IsZero())
+		{
+			enemies_[i]->SetPosition(currentPositions_[i] + corrections_[i]);
 		}
 	}
 }
@@ -95,68 +190,142 @@ void EnemyManager::Draw(CameraManager* camera)
 
 void EnemyManager::AddPistolEnemy(uint32_t count)
 {
-	for (uint32_t i = 0; i < count; ++i)
-	{
-		auto enemy = std::make_unique<PistolEnemy>();
-		enemy->Initialize(object3dCommon_, lightManager_, target_);
-		//ランダムな位置を設定
-		Vector3 randomPosition = MathUtils::RandomVector3(emitRange_.min_, emitRange_.max_);
-		enemy->SetPosition(randomPosition);
-		// 敵キャラクターを追加
-		enemies_.push_back(std::move(enemy));
-	}
+	SpawnRandom(EnemyType::Pistol, count);
 }
 
 void EnemyManager::AddAssaultEnemy(uint32_t count)
 {
-	for (uint32_t i = 0; i < count; ++i)
-	{
-		auto enemy = std::make_unique<AssaultEnemy>();
-		enemy->Initialize(object3dCommon_, lightManager_, target_);
-		//ランダムな位置を設定
-		Vector3 randomPosition = MathUtils::RandomVector3(emitRange_.min_, emitRange_.max_);
-		enemy->SetPosition(randomPosition);
-		// 敵キャラクターを追加
-		enemies_.push_back(std::move(enemy));
-	}
+	SpawnRandom(EnemyType::Assault, count);
 }
 
 void EnemyManager::AddShotgunEnemy(uint32_t count)
 {
-	for (uint32_t i = 0; i < count; ++i)
-	{
-		auto enemy = std::make_unique<ShotgunEnemy>();
-		enemy->Initialize(object3dCommon_, lightManager_, target_);
-		//ランダムな位置を設定
-		Vector3 randomPosition = MathUtils::RandomVector3(emitRange_.min_, emitRange_.max_);
-		enemy->SetPosition(randomPosition);
-		// 敵キャラクターを追加
-		enemies_.push_back(std::move(enemy));
-	}
+	SpawnRandom(EnemyType::Shotgun, count);
 }
 
 void EnemyManager::SetEnemyData(const std::vector<GameObjectInfo>& data)
 {
 	enemyData_ = data;
-	enemies_.clear();
+	Clear();
+
+	// ステージ読み込み時にまとめて生成しておき、ウェーブ中の生成を避ける
+	for (size_t type = 0; type < kEnemyTypeCount; ++type)
+	{
+		Prewarm(static_cast<EnemyType>(type), kPrewarmCount);
+	}
+	Prewarm(EnemyType::Assault, static_cast<uint32_t>(enemyData_.size()) + kPrewarmCount);
+
+	auto start = std::chrono::steady_clock::now();
 	CreateAssaultEnemyFromData();
+	RecordSpawnTime(start, static_cast<uint32_t>(enemyData_.size()));
+}
+
+void EnemyManager::SetTarget(GameObject* target)
+{
+	// 待機中の敵は古いターゲットを保持しているので破棄する
+	if (target_ != target)
+	{
+		for (auto& pool : pools_)
+		{
+			pool.clear();
+		}
+	}
+	target_ = target;
 }
 
 void EnemyManager::Clear()
 {
-	enemies_.clear(); // 敵キャラクターのリストをクリア
+	// 出現中の敵を全てプールに戻す
+	for (auto& enemy : enemies_)
+	{
+		enemy->Despawn();
+		pools_[static_cast<size_t>(enemy->GetEnemyType())].push_back(std::move(enemy));
+	}
+	enemies_.clear();
+}
+
+EnemyBase* EnemyManager::Spawn(EnemyType type, const Vector3& position)
+{
+	auto& pool = pools_[static_cast<size_t>(type)];
+	std::unique_ptr<EnemyBase> enemy;
+	if (!pool.empty())
+	{
+		enemy = std::move(pool.back());
+		pool.pop_back();
+		++spawnStats_.reusedCount;
+	}
+	else
+	{
+		enemy = CreateEnemy(type);
+		++spawnStats_.createdCount;
+	}
+
+	enemy->Respawn(position);
+	enemies_.push_back(std::move(enemy));
+	return enemies_.back().get();
+}
+
+void EnemyManager::Prewarm(EnemyType type, uint32_t count)
+{
+	auto& pool = pools_[static_cast<size_t>(type)];
+	pool.reserve(count);
+	while (pool.size() < count)
+	{
+		auto enemy = CreateEnemy(type);
+		enemy->Despawn();
+		pool.push_back(std::move(enemy));
+	}
+}
+
+std::unique_ptr<EnemyBase> EnemyManager::CreateEnemy(EnemyType type)
+{
+	std::unique_ptr<EnemyBase> enemy;
+	switch (type)
+	{
+	case EnemyType::Pistol:
+		enemy = std::make_unique<PistolEnemy>();
+		break;
+	case EnemyType::Assault:
+		enemy = std::make_unique<AssaultEnemy>();
+		break;
+	case EnemyType::Shotgun:
+		enemy = std::make_unique<ShotgunEnemy>();
+		break;
+	default:
+		assert(false && "ERROR: EnemyManager::CreateEnemy() - Unknown enemy type.");
+		return nullptr;
+	}
+	enemy->Initialize(object3dCommon_, lightManager_, target_);
+	return enemy;
+}
+
+void EnemyManager::SpawnRandom(EnemyType type, uint32_t count)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		//ランダムな位置に出現させる
+		Vector3 randomPosition = MathUtils::RandomVector3(emitRange_.min_, emitRange_.max_);
+		Spawn(type, randomPosition);
+	}
+	RecordSpawnTime(start, count);
+}
+
+void EnemyManager::RecordSpawnTime(std::chrono::steady_clock::time_point start, uint32_t count)
+{
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	spawnStats_.lastSpawnMs = ms;
+	spawnStats_.lastSpawnCount = count;
+	spawnStats_.maxSpawnMs = (std::max)(spawnStats_.maxSpawnMs, ms);
 }
 
 void EnemyManager::CreateAssaultEnemyFromData()
 {
 	for(int i = 0;i < enemyData_.size();i++)
 	{
-		auto enemy = std::make_unique<AssaultEnemy>();
-		enemy->Initialize(object3dCommon_, lightManager_, target_);
+		EnemyBase* enemy = Spawn(EnemyType::Assault, enemyData_[i].transform.translate);
 		enemy->SetModel(enemyData_[i].fileName);
-		enemy->SetPosition(enemyData_[i].transform.translate);
 		enemy->SetRotation(enemyData_[i].transform.rotate);
 		enemy->SetScale(enemyData_[i].transform.scale);
-		enemies_.push_back(std::move(enemy));
 	}
 }
@@ -1,6 +1,10 @@
 #pragma once
+#include <array>
+#include <chrono>
+
 #include "application/effect/EnemyDeathEffect.h"
 #include "application/stage/StageData.h"
+#include "CrowdSeparation.h"
 #include "base/EnemyBase.h"
 #include "math/AABB.h"
 
@@ -20,11 +24,24 @@ public:
 	void AddAssaultEnemy(uint32_t count);
 	void AddShotgunEnemy(uint32_t count);
 	void SetEnemyData(const std::vector<GameObjectInfo>& data);
-	void SetTarget(GameObject* target) { target_ = target; }
+	void SetTarget(GameObject* target);
 	void Clear();
 
+	// 敵をプールから取り出して出現させる（プールが空なら生成する）
+	EnemyBase* Spawn(EnemyType type, const Vector3& position);
+	// プールに指定数の待機中の敵を用意しておく
+	void Prewarm(EnemyType type, uint32_t count);
+
 private:
 	void CreateAssaultEnemyFromData();
+	// 敵を生成して初期化する
+	std::unique_ptr<EnemyBase> CreateEnemy(EnemyType type);
+	// ランダムな位置に敵をまとめて出現させる
+	void SpawnRandom(EnemyType type, uint32_t count);
+	// 出現にかかった時間を記録
+	void RecordSpawnTime(std::chrono::steady_clock::time_point start, uint32_t count);
+	// 敵同士の押し合い・回避を適用
+	void ApplyCrowdSeparation();
 
 private:
 	Object3dCommon* object3dCommon_ = nullptr; // 3Dオブジェクト共通処理
@@ -33,9 +50,29 @@ private:
 	AABB emitRange_ = {};
 	// 敵リスト
 	std::vector<std::unique_ptr<EnemyBase>> enemies_;
+	// 種類ごとの待機中の敵
+	static constexpr size_t kEnemyTypeCount = static_cast<size_t>(EnemyType::Count);
+	static constexpr uint32_t kPrewarmCount = 16; // ステージ読み込み時に種類ごとに用意する数
+	std::array<std::vector<std::unique_ptr<EnemyBase>>, kEnemyTypeCount> pools_;
+	// 出現の統計
+	struct SpawnStats
+	{
+		double lastSpawnMs = 0.0;	// 直近のまとめて出現させた時間
+		double maxSpawnMs = 0.0;	// 最大の出現時間
+		uint32_t lastSpawnCount = 0;
+		uint32_t createdCount = 0;	// 新しく生成した数
+		uint32_t reusedCount = 0;	// プールから再利用した数
+	};
+	SpawnStats spawnStats_;
 	// 敵データ
 	std::vector<GameObjectInfo> enemyData_;
 	// 死亡パーティクル
 	std::unique_ptr<EnemyDeathEffect> deathEffect_;
+	// 群衆制御
+	CrowdSeparation crowdSeparation_;
+	bool enableCrowdSeparation_ = true;
+	std::vector<Vector3> previousPositions_;
+	std::vector<Vector3> currentPositions_;
+	std::vector<Vector3> corrections_;
 };
 
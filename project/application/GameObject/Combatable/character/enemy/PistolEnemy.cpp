@@ -13,6 +13,7 @@ void PistolEnemy::Initialize(Object3dCommon* object3dCommon, LightManager* light
 
 	// 衝突判定コンポーネントを追加
 	auto collider = std::make_unique<OBBColliderComponent>(this);
+	collider->SetCollisionGroup(CollisionGroup::Enemy);
 	collider->SetOnEnter([this](GameObject* other) {
 		if (other->GetTag() == "PlayerBullet")
 		{
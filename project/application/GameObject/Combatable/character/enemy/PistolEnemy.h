@@ -9,5 +9,6 @@ public:
 	void Initialize(Object3dCommon* object3dCommon, LightManager* lightManager, GameObject* target) override;
 	void Update() override;
 	void Draw(CameraManager* camera) override;
+	EnemyType GetEnemyType() const override { return EnemyType::Pistol; }
 };
 
@@ -10,6 +10,7 @@ void ShotgunEnemy::Initialize(Object3dCommon* object3dCommon, LightManager* ligh
 	AddComponent("ShotgunComponent", std::make_unique<ShotgunComponent>(object3dCommon, lightManager));
 	// 衝突判定コンポーネントを追加
 	auto collider = std::make_unique<OBBColliderComponent>(this);
+	collider->SetCollisionGroup(CollisionGroup::Enemy);
 	collider->SetOnEnter([this](GameObject* other) {
 		if (other->GetTag() == "PlayerBullet")
 		{
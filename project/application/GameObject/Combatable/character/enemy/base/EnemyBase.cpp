@@ -27,3 +27,35 @@ void EnemyBase::Draw(CameraManager* camera)
 {
 	Character::Draw(camera);
 }
+
+void EnemyBase::Respawn(const Vector3& position)
+{
+	// ステータスを初期化
+	hp_.ClearBuffs();
+	maxHp_.ClearBuffs();
+	attackPower_.ClearBuffs();
+	hp_.base = maxHp_.base;
+	isAlive_ = true;
+
+	// 状態を初期化
+	isInvincible_ = false;
+	invincibleTimer_ = 0.0f;
+	isGrounded_ = false;
+
+	// モデルとトランスフォームを初期化（モデルは呼び出し側で必要なら差し替える）
+	ResetObject3d();
+	SetScale(Vector3{ 1.0f, 1.0f, 1.0f });
+	SetRotation(Vector3{ 0.0f, 0.0f, 0.0f });
+	SetPosition(position);
+
+	// コンポーネントを初期化して当たり判定を戻す
+	ResetComponents();
+	SetCollidersEnabled(true);
+}
+
+void EnemyBase::Despawn()
+{
+	isAlive_ = false;
+	SetCollidersEnabled(false);
+	ResetComponents();
+}
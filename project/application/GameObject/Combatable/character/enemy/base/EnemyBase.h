@@ -1,6 +1,15 @@
 #pragma once
 #include "application/GameObject/Combatable/character/base/Character.h"
 
+// 敵の種類（プールの振り分けに使用）
+enum class EnemyType
+{
+	Pistol,
+	Assault,
+	Shotgun,
+	Count
+};
+
 class EnemyBase : virtual public Character
 {
 public:
@@ -10,9 +19,14 @@ public:
 	void Update() override;
 	void Draw(CameraManager* camera) override;
 
+	// プールから取り出した時に状態を初期化して出現させる
+	virtual void Respawn(const Vector3& position);
+	// プールに戻す時に当たり判定を止めて弾などを片付ける
+	virtual void Despawn();
+
+	virtual EnemyType GetEnemyType() const = 0;
 	GameObject* GetTarget() const { return target_; }
 
 protected:
 	GameObject* target_ = nullptr; // ターゲットとなるプレイヤーや他のオブジェクト
 };
-
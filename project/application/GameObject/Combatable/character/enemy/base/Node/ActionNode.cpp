@@ -1,6 +1,6 @@
 #include "ActionNode.h"
 
-NodeStatus ActionNode::Tick(Blackboard& blackboard)
+NodeStatus ActionNode::OnTick(Blackboard& blackboard)
 {
 	return action(blackboard);
 }
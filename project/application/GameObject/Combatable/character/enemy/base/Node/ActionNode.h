@@ -10,15 +10,16 @@ class ActionNode : public BTNode
 public:
     using ActionFunction = std::function<NodeStatus(Blackboard&)>;
 
-	ActionNode(ActionFunction func) : action(func) {}
-
-    NodeStatus Tick(Blackboard& blackboard) override;
+	ActionNode(ActionFunction func, const char* name) : BTNode(name), action(func) {}
 
     void Reset() override
     {
 	    /* アクションには状態を保持しないので特になし */
     }
 
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
+
 private:
     ActionFunction action;
 
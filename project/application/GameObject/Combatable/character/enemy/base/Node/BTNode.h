@@ -1,5 +1,8 @@
 #pragma once
+#include <vector>
+
 #include "BlackBoard.h"
+#include "BTProfiler.h"
 
 // ノードのステータスを表す
 enum class NodeStatus { Success, Failure, Running };
@@ -10,7 +13,47 @@ enum class NodeStatus { Success, Failure, Running };
 class BTNode
 {
 public:
+    // nameはBT_NAME("...")で渡す（計測が無効なビルドではnullptrになり、名前を保持しない）
+    explicit BTNode(const char* name)
+    {
+#if BT_ENABLE_PROFILER
+        name_ = name;
+        profileId_ = BTProfiler::GetInstance().Register(name_);
+#else
+        (void)name;
+#endif
+    }
     virtual ~BTNode() = default;
-	virtual NodeStatus Tick(Blackboard& blackboard) = 0; // ノードの実行
+
+    // ノードの実行（計測が有効な場合はここで集計する）
+    NodeStatus Tick(Blackboard& blackboard)
+    {
+#if BT_ENABLE_PROFILER
+        BTProfiler& profiler = BTProfiler::GetInstance();
+        profiler.Begin();
+        NodeStatus status = OnTick(blackboard);
+        profiler.End(profileId_, status);
+        return status;
+#else
+        return OnTick(blackboard);
+#endif
+    }
+
     virtual void Reset() {} // 状態のリセットなどに使用
-};
\ No newline at end of file
+
+#if BT_ENABLE_PROFILER
+    const char* GetName() const { return name_; }
+
+    // 自身と子孫のノード名を集める（名前の重複チェックに使用）
+    virtual void CollectNames(std::vector<const char*>& names) const { names.push_back(name_); }
+#endif
+
+protected:
+	virtual NodeStatus OnTick(Blackboard& blackboard) = 0; // ノードごとの処理
+
+private:
+#if BT_ENABLE_PROFILER
+    const char* name_ = nullptr;
+    uint32_t profileId_ = 0;
+#endif
+};
@@ -0,0 +1,173 @@
+#include "BTProfiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#include "BTNode.h"
+#include "base/Logger.h"
+#include "imgui/imgui.h"
+
+BTProfiler& BTProfiler::GetInstance()
+{
+	static BTProfiler instance;
+	return instance;
+}
+
+uint32_t BTProfiler::Register(const char* name)
+{
+	assert(name && name[0] != '\0' && "ERROR: BTProfiler::Register() - Node name is empty. Pass a unique name with BT_NAME().");
+	auto it = nameToId_.find(name);
+	if (it != nameToId_.end())
+	{
+		return it->second;
+	}
+	uint32_t id = static_cast<uint32_t>(stats_.size());
+	NodeStats stats;
+	stats.name = name;
+	stats_.push_back(stats);
+	nameToId_[name] = id;
+	return id;
+}
+
+void BTProfiler::ValidateUniqueNames(const BTNode& root)
+{
+#if BT_ENABLE_PROFILER
+	std::vector<const char*> names;
+	root.CollectNames(names);
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		for (size_t j = i + 1; j < names.size(); ++j)
+		{
+			if (std::strcmp(names[i], names[j]) == 0)
+			{
+				Logger::Log(std::string("ERROR: BTProfiler::ValidateUniqueNames() - Duplicate node name: ") + names[i] + "\n");
+				assert(false && "ERROR: BTProfiler::ValidateUniqueNames() - Node names must be unique within a tree.");
+			}
+		}
+	}
+#else
+	(void)root;
+#endif
+}
+
+void BTProfiler::Begin()
+{
+	stack_.push_back({ std::chrono::steady_clock::now(), 0 });
+}
+
+void BTProfiler::End(uint32_t id, NodeStatus status)
+{
+	Frame frame = stack_.back();
+	stack_.pop_back();
+	int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frame.start).count();
+
+	NodeStats& stats = stats_[id];
+	++stats.calls;
+	switch (status)
+	{
+	case NodeStatus::Success: ++stats.success; break;
+	case NodeStatus::Failure: ++stats.failure; break;
+	case NodeStatus::Running: ++stats.running; break;
+	}
+	stats.totalNs += elapsed;
+	stats.selfNs += elapsed - frame.childNs;
+
+	// 親ノードの子ノード時間に加算
+	if (!stack_.empty())
+	{
+		stack_.back().childNs += elapsed;
+	}
+}
+
+void BTProfiler::Reset()
+{
+	for (auto& stats : stats_)
+	{
+		std::string name = stats.name;
+		stats = NodeStats{};
+		stats.name = name;
+	}
+	frameCount_ = 0;
+}
+
+bool BTProfiler::ExportCSV(const std::string& filePath) const
+{
+	std::ofstream ofs(filePath);
+	if (!ofs)
+	{
+		Logger::Log("Failed to open CSV file for writing: " + filePath);
+		return false;
+	}
+
+	ofs << "name,calls,calls_per_frame,success,failure,running,total_ms,self_ms,avg_us\n";
+	for (const auto& stats : stats_)
+	{
+		double callsPerFrame = frameCount_ > 0 ? static_cast<double>(stats.calls) / frameCount_ : 0.0;
+		double avgUs = stats.calls > 0 ? stats.totalNs / 1000.0 / stats.calls : 0.0;
+		ofs << stats.name << ','
+			<< stats.calls << ','
+			<< callsPerFrame << ','
+			<< stats.success << ','
+			<< stats.failure << ','
+			<< stats.running << ','
+			<< stats.totalNs / 1.0e6 << ','
+			<< stats.selfNs / 1.0e6 << ','
+			<< avgUs << '\n';
+	}
+	Logger::Log("BehaviorTree profile exported: " + filePath);
+	return true;
+}
+
+void BTProfiler::DrawImGui()
+{
+#ifdef _DEBUG
+	ImGui::Begin("Behavior Tree Profiler");
+	ImGui::Text("Frames: %llu  Nodes: %zu", static_cast<unsigned long long>(frameCount_), stats_.size());
+	if (ImGui::Button("Reset"))
+	{
+		Reset();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV"))
+	{
+		ExportCSV("bt_profile.csv");
+	}
+
+	// 自己時間の大きい順に表示
+	std::vector<const NodeStats*> sorted;
+	sorted.reserve(stats_.size());
+	for (const auto& stats : stats_)
+	{
+		sorted.push_back(&stats);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const NodeStats* a, const NodeStats* b) { return a->selfNs > b->selfNs; });
+
+	if (ImGui::BeginTable("BTProfile", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY))
+	{
+		ImGui::TableSetupColumn("Node");
+		ImGui::TableSetupColumn("Calls/Frame");
+		ImGui::TableSetupColumn("Success%");
+		ImGui::TableSetupColumn("Failure%");
+		ImGui::TableSetupColumn("Running%");
+		ImGui::TableSetupColumn("Total ms");
+		ImGui::TableSetupColumn("Self ms");
+		ImGui::TableHeadersRow();
+
+		for (const NodeStats* stats : sorted)
+		{
+			double calls = stats->calls > 0 ? static_cast<double>(stats->calls) : 1.0;
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s", stats->name.c_str());
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", frameCount_ > 0 ? stats->calls / static_cast<double>(frameCount_) : 0.0);
+			ImGui::TableNextColumn(); ImGui::Text("%.1f", stats->success * 100.0 / calls);
+			ImGui::TableNextColumn(); ImGui::Text("%.1f", stats->failure * 100.0 / calls);
+			ImGui::TableNextColumn(); ImGui::Text("%.1f", stats->running * 100.0 / calls);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats->totalNs / 1.0e6);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats->selfNs / 1.0e6);
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+#endif
+}
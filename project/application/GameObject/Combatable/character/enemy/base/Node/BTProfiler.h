@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ビヘイビアツリーの計測を有効にするか（リリースビルドでは計測コードを含めない）
+#ifdef _DEBUG
+#define BT_ENABLE_PROFILER 1
+#else
+#define BT_ENABLE_PROFILER 0
+#endif
+
+// ノード名（計測が無効なビルドでは文字列ごと消える。ツリーの中で一意な文字列リテラルを渡す）
+#if BT_ENABLE_PROFILER
+#define BT_NAME(name) name
+#else
+#define BT_NAME(name) nullptr
+#endif
+
+class BTNode;
+
+enum class NodeStatus;
+
+/**
+ * \brief ビヘイビアツリーのノードごとの実行回数・結果・時間を集計するクラス
+ * \note 同じ名前のノードは全エージェント分をまとめて集計する
+ */
+class BTProfiler
+{
+public:
+	// ノードごとの集計結果
+	struct NodeStats
+	{
+		std::string name;
+		uint64_t calls = 0;
+		uint64_t success = 0;
+		uint64_t failure = 0;
+		uint64_t running = 0;
+		int64_t totalNs = 0;	// 子ノードを含む時間
+		int64_t selfNs = 0;		// 子ノードを除いた時間
+	};
+
+	static BTProfiler& GetInstance();
+
+	// ノード名を登録してIDを取得
+	uint32_t Register(const char* name);
+
+	// 1つのツリーの中にノード名の重複が無いか確かめる（重複すると別のノードの集計が混ざる）
+	static void ValidateUniqueNames(const BTNode& root);
+
+	// 計測開始・終了（BTNode::Tickから呼ばれる）
+	void Begin();
+	void End(uint32_t id, NodeStatus status);
+
+	// フレームの区切り（1フレームあたりの値の算出に使用）
+	void NewFrame() { ++frameCount_; }
+
+	// 集計結果をリセット
+	void Reset();
+
+	// CSVに書き出す
+	bool ExportCSV(const std::string& filePath) const;
+
+	// ImGuiで表示
+	void DrawImGui();
+
+	const std::vector<NodeStats>& GetStats() const { return stats_; }
+
+private:
+	BTProfiler() = default;
+	~BTProfiler() = default;
+	BTProfiler(const BTProfiler&) = delete;
+	BTProfiler& operator=(const BTProfiler&) = delete;
+
+	// 計測中のノード
+	struct Frame
+	{
+		std::chrono::steady_clock::time_point start;
+		int64_t childNs;
+	};
+
+	std::vector<NodeStats> stats_;
+	std::unordered_map<std::string, uint32_t> nameToId_;
+	std::vector<Frame> stack_;
+	uint64_t frameCount_ = 0;
+};
@@ -3,6 +3,12 @@
 void BehaviorTree::SetRoot(std::unique_ptr<BTNode> rootNode)
 {
 	root = std::move(rootNode);
+#if BT_ENABLE_PROFILER
+	if (root)
+	{
+		BTProfiler::ValidateUniqueNames(*root);
+	}
+#endif
 }
 
 void BehaviorTree::Tick()
@@ -12,8 +12,8 @@ public:
     BehaviorTree() = default;
 
     explicit BehaviorTree(std::unique_ptr<BTNode> rootNode)
-        : root(std::move(rootNode))
     {
+        SetRoot(std::move(rootNode));
     }
 
     void SetRoot(std::unique_ptr<BTNode> rootNode);
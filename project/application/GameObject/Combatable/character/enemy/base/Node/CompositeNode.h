@@ -14,9 +14,19 @@ protected:
     size_t currentIndex = 0;
 
 public:
+    explicit CompositeNode(const char* name) : BTNode(name) {}
+
     void AddChild(std::unique_ptr<BTNode> child);
 
     void Reset() override;
+
+#if BT_ENABLE_PROFILER
+    void CollectNames(std::vector<const char*>& names) const override
+    {
+        BTNode::CollectNames(names);
+        for (const auto& child : children) { child->CollectNames(names); }
+    }
+#endif
 };
 
 
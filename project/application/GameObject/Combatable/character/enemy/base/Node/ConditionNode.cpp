@@ -1,6 +1,6 @@
 #include "ConditionNode.h"
 
-NodeStatus ConditionNode::Tick(Blackboard& blackboard)
+NodeStatus ConditionNode::OnTick(Blackboard& blackboard)
 {
 	return condition(blackboard) ? NodeStatus::Success : NodeStatus::Failure;
 }
@@ -11,15 +11,16 @@ class ConditionNode : public BTNode
 public:
     using ConditionFunction = std::function<bool(Blackboard&)>;
 
-    ConditionNode(ConditionFunction func) : condition(func) {}
-
-    NodeStatus Tick(Blackboard& blackboard) override;
+    ConditionNode(ConditionFunction func, const char* name) : BTNode(name), condition(func) {}
 
     void Reset() override
     {
         // 条件ノードも状態は持たないので特になし
     }
 
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
+
 private:
     ConditionFunction condition;
 
@@ -1,6 +1,6 @@
 #include "InverterNode.h"
 
-NodeStatus InverterNode::Tick(Blackboard& blackboard)
+NodeStatus InverterNode::OnTick(Blackboard& blackboard)
 {
     NodeStatus status = child_->Tick(blackboard);
     switch (status)
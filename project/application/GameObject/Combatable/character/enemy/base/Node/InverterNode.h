@@ -9,15 +9,24 @@
 class InverterNode : public BTNode
 {
 public:
-    explicit InverterNode(std::unique_ptr<BTNode> child)
-        : child_(std::move(child))
+    InverterNode(std::unique_ptr<BTNode> child, const char* name)
+        : BTNode(name), child_(std::move(child))
     {
     }
 
-    NodeStatus Tick(Blackboard& blackboard) override;
-
     void Reset() override;
 
+#if BT_ENABLE_PROFILER
+    void CollectNames(std::vector<const char*>& names) const override
+    {
+        BTNode::CollectNames(names);
+        if (child_) { child_->CollectNames(names); }
+    }
+#endif
+
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
+
 private:
     std::unique_ptr<BTNode> child_;
 };
\ No newline at end of file
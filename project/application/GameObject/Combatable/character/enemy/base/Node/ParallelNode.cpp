@@ -1,6 +1,6 @@
 #include "ParallelNode.h"
 
-NodeStatus ParallelNode::Tick(Blackboard& blackboard)
+NodeStatus ParallelNode::OnTick(Blackboard& blackboard)
 {
 	size_t successCount = 0;
 	size_t failureCount = 0;
@@ -9,15 +9,16 @@
 class ParallelNode : public CompositeNode
 {
 public:
-    ParallelNode(size_t successThreshold, size_t failureThreshold)
-        : successThreshold_(successThreshold), failureThreshold_(failureThreshold)
+    ParallelNode(size_t successThreshold, size_t failureThreshold, const char* name)
+        : CompositeNode(name), successThreshold_(successThreshold), failureThreshold_(failureThreshold)
     {
     }
 
-    NodeStatus Tick(Blackboard& blackboard) override;
-
     void Reset() override;
 
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
+
 private:
     size_t successThreshold_;
     size_t failureThreshold_;
@@ -1,6 +1,6 @@
 #include "SelectorNode.h"
 
-NodeStatus SelectorNode::Tick(Blackboard& blackboard)
+NodeStatus SelectorNode::OnTick(Blackboard& blackboard)
 {
     while (currentIndex < children.size())
     {
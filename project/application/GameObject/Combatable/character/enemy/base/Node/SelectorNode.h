@@ -8,5 +8,8 @@
 class SelectorNode : public CompositeNode
 {
 public:
-    NodeStatus Tick(Blackboard& blackboard) override;
+    explicit SelectorNode(const char* name) : CompositeNode(name) {}
+
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
 };
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "SequenceNode.h"
 
-NodeStatus SequenceNode::Tick(Blackboard& blackboard)
+NodeStatus SequenceNode::OnTick(Blackboard& blackboard)
 {
     while (currentIndex < children.size())
     {
@@ -7,5 +7,8 @@
 class SequenceNode : public CompositeNode
 {
 public:
-    NodeStatus Tick(Blackboard& blackboard) override;
+    explicit SequenceNode(const char* name) : CompositeNode(name) {}
+
+protected:
+    NodeStatus OnTick(Blackboard& blackboard) override;
 };
\ No newline at end of file
@@ -14,7 +14,7 @@ void Player::Initialize(Object3dCommon* object3dCommon, LightManager* lightManag
 {
 	Character::Initialize(object3dCommon, lightManager);
 	//初期位置を設定
-	transform_.translate = { 0.0f, 1.0f, 0.0f };
+	SetPosition({ 0.0f, 1.0f, 0.0f });
 
 
 	// 試しに腕を追加
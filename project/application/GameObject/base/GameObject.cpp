@@ -2,6 +2,7 @@
 
 // component
 #include "application/GameObject/component/base/IActionComponent.h"
+#include "application/GameObject/component/base/ICollisionComponent.h"
 // system
 #include "base/Logger.h"
 #include "imgui/imgui.h"
@@ -11,6 +12,7 @@ GameObject::~GameObject()
 	components_.clear(); // コンポーネントのクリア
 	isActive_ = false;    // 非アクティブ状態に設定
 	object3d_.reset(); // Object3Dのリセット
+	GetTransformHierarchy().Destroy(transformHandle_); // 階層から外す（子は親なしになる）
 }
 
 GameObject::GameObject(std::string tag)
@@ -20,6 +22,14 @@ GameObject::GameObject(std::string tag)
 	// タグの初期化
 	assert(!tag.empty() && "ERROR: GameObject::GameObject() - Tag should not be empty. Ensure that you provide a valid tag.");
 	tag_ = tag;
+	// トランスフォームの階層にノードを作る
+	transformHandle_ = GetTransformHierarchy().Create();
+}
+
+TransformHierarchy& GameObject::GetTransformHierarchy()
+{
+	static TransformHierarchy hierarchy;
+	return hierarchy;
 }
 
 void GameObject::Initialize(Object3dCommon* object3dCommon, LightManager* lightManager, Camera* camera)
@@ -28,7 +38,7 @@ void GameObject::Initialize(Object3dCommon* object3dCommon, LightManager* lightM
 	object3d_ = std::make_unique<Object3d>();
 	object3d_->Initialize(object3dCommon, camera);
 	// デフォルトで立方体モデルを設定
-	object3d_->SetModel("cube");
+	object3d_->SetModel(kDefaultModelName);
 	object3d_->SetLightManager(lightManager);
 	// Transformの初期化
 	transform_ = {
@@ -106,6 +116,12 @@ void GameObject::AddComponent(const std::string& name, std::unique_ptr<IGameObje
 	components_[name] = std::move(comp);
 }
 
+void GameObject::SetParent(GameObject* parent)
+{
+	parent_ = parent;
+	GetTransformHierarchy().SetParent(transformHandle_, parent ? parent->transformHandle_ : TransformHierarchy::kInvalidHandle);
+}
+
 void GameObject::AddChild(std::unique_ptr<GameObject> child)
 {
 	if (child)
@@ -124,28 +140,50 @@ void GameObject::ApplyTransformToObject3D(CameraManager* camera)
 	object3d_->SetRotate(transform_.rotate);
 	object3d_->SetScale(transform_.scale);
 
-	if (parent_)
+	TransformHierarchy& hierarchy = GetTransformHierarchy();
+
+	// SRTを階層に渡す（変わっていなければ自分と子孫のワールド行列は計算し直されない）
+	// 静的なオブジェクトはセッターで変更された時だけ渡す
+	if (!isStatic_ || isTransformDirty_)
 	{
-		// 親がある場合の処理
-		// 自分のローカル行列を作成
-		Matrix4x4 localMatrix = MakeAffineMatrix(
-			transform_.scale,
-			transform_.rotate,
-			transform_.translate
-		);
-
-		// 親のワールド行列を取得
-		Matrix4x4 parentWorldMatrix = parent_->object3d_->GetWorldMatrix();
-
-		// 正しい順序で行列を掛ける: localMatrix * parentWorldMatrix
-		Matrix4x4 worldMatrix = localMatrix * parentWorldMatrix;
-
-		// Object3Dに計算済みのワールド行列を設定
-		object3d_->UpdateMatrixWithWorld(worldMatrix, camera->GetActiveCamera());
+		hierarchy.SetLocal(transformHandle_, transform_);
+		isTransformDirty_ = false;
 	}
-	else
+
+	// 親がいれば親から順にワールド行列が求まる
+	object3d_->UpdateMatrixWithWorld(
+		hierarchy.GetWorldMatrix(transformHandle_),
+		hierarchy.GetWorldInverseTranspose(transformHandle_),
+		camera ? camera->GetActiveCamera() : nullptr
+	);
+}
+
+void GameObject::ResetComponents()
+{
+	for (auto& [name, comp] : components_)
 	{
-		// 親がない場合は通常の更新
-		object3d_->Update(camera);
+		comp->Reset(this);
+	}
+}
+
+void GameObject::ResetObject3d()
+{
+	// 初期化時と同じモデルと描画設定に戻す
+	object3d_->SetModel(kDefaultModelName);
+	object3d_->ResetState();
+	isStatic_ = false;
+	isTransformDirty_ = true;
+}
+
+void GameObject::SetCollidersEnabled(bool enabled)
+{
+	for (auto& [name, comp] : components_)
+	{
+		if (auto collider = dynamic_cast<ICollisionComponent*>(comp.get()))
+		{
+			collider->SetEnabled(enabled);
+			// 無効の間はCollisionManagerからも外して総当たりの対象にしない
+			collider->SetRegistered(enabled);
+		}
 	}
 }
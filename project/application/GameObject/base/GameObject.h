@@ -6,6 +6,7 @@
 #include "graphics/3d/Object3d.h"
 // math
 #include "base/GraphicsTypes.h"
+#include "math/TransformHierarchy.h"
 // component
 #include "application/GameObject/component/base/IGameObjectComponent.h"
 
@@ -21,11 +22,14 @@ public:
 	void AddComponent(const std::string& name, std::unique_ptr<IGameObjectComponent> comp);	// コンポーネントの追加
 	template<typename T>
 	std::shared_ptr<T> GetComponent() const;
+	void ResetComponents();	// コンポーネントの状態を初期化（再利用時）
+	void ResetObject3d();	// モデルと描画の状態を初期化（再利用時）
+	void SetCollidersEnabled(bool enabled);	// 当たり判定コンポーネントの有効・無効を切り替え（無効の間は登録も外す）
 public: //アクセッサ
 	//トランスフォーム
-	virtual void SetPosition(const Vector3& pos) { transform_.translate = pos; }
-	virtual void SetRotation(const Vector3& rot) { transform_.rotate = rot; }
-	virtual void SetScale(const Vector3& scale) { transform_.scale = scale; }
+	virtual void SetPosition(const Vector3& pos) { transform_.translate = pos; isTransformDirty_ = true; }
+	virtual void SetRotation(const Vector3& rot) { transform_.rotate = rot; isTransformDirty_ = true; }
+	virtual void SetScale(const Vector3& scale) { transform_.scale = scale; isTransformDirty_ = true; }
 	virtual const Vector3& GetPosition() const { return transform_.translate; }
 	virtual const Vector3& GetRotation() const { return transform_.rotate; }
 	virtual const Vector3& GetScale() const { return transform_.scale; }
@@ -42,10 +46,21 @@ public: //アクセッサ
 	bool IsActive() const { return isActive_; }	// アクティブ状態の取得
 
 	// 親子関係
-	void SetParent(GameObject* parent) { parent_ = parent; }	// 親オブジェクトの設定
+	void SetParent(GameObject* parent);	// 親オブジェクトの設定
 	void AddChild(std::unique_ptr<GameObject> child);	// 子オブジェクトの追加
 
+	// 静的なオブジェクト（セッター以外で動かないもの）はSRTの比較も省略する
+	// 影は、静的なオブジェクトの並びが変わった時と、動くオブジェクトが動いた時だけ描き直される
+	void SetStatic(bool isStatic) { isStatic_ = isStatic; isTransformDirty_ = true; if (object3d_) { object3d_->SetStatic(isStatic); } }
+	bool IsStatic() const { return isStatic_; }
+
+	// 全GameObjectのトランスフォームをまとめて持つ階層
+	static TransformHierarchy& GetTransformHierarchy();
+
 protected:
+	static constexpr const char* kDefaultModelName = "cube";								// 初期化時のモデル
+	// ローカルのSRTはGameObjectが持つ（座標のアドレスをカメラやパーティクルの追従先に渡しているため、
+	// 配列が伸びると動いてしまう階層側には置かない）。階層には変わった時だけ写す
 	Transform transform_;																	// Transform情報
 	std::unique_ptr<Object3d> object3d_;													// 3Dオブジェクト
 
@@ -58,6 +73,9 @@ private:
 	bool isActive_;																			// アクティブ状態
 	std::vector<std::unique_ptr<GameObject>> children_;  // 子オブジェクトのリスト
 	GameObject* parent_ = nullptr;  // 親オブジェクト
+	TransformHierarchy::Handle transformHandle_ = TransformHierarchy::kInvalidHandle;	// 階層内のノード
+	bool isStatic_ = false;			// 静的なオブジェクトか
+	bool isTransformDirty_ = true;	// セッターでSRTが変更されたか
 };
 
 template <typename T>
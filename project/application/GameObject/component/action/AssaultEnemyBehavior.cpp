@@ -1,6 +1,7 @@
 #include "AssaultEnemyBehavior.h"
 #include "AssaultRifleComponent.h"
 #include "application/GameObject/base/GameObject.h"
+#include "application/GameObject/component/collision/SceneQueryManager.h"
 #include "math/MathUtils.h"
 #include "time/TimeManager.h"
 #include <cmath>
@@ -31,6 +32,9 @@ void AssaultEnemyBehavior::Update(GameObject* owner)
     if (actionCooldown_ > 0) actionCooldown_ -= deltaTime;
     lastPosition_ = owner->GetPosition();
 
+    // ターゲットまでの距離は1フレームに1回だけ計算する
+    distanceToTarget_ = target_ ? (target_->GetPosition() - owner->GetPosition()).Length() : 0.0f;
+
     // Blackboardへ情報セット
     auto& bb = behaviorTree_->GetBlackboard();
     bb.Set<GameObject*>("Owner", owner);
@@ -56,6 +60,35 @@ void AssaultEnemyBehavior::Update(GameObject* owner)
     behaviorTree_->Tick();
 }
 
+// --- Reset ---
+void AssaultEnemyBehavior::Reset(GameObject* owner)
+{
+    // 再利用時に前回の行動状態を持ち越さないよう初期化する
+    stateTimer_ = 0.0f;
+    strafeTimer_ = 0.0f;
+    actionCooldown_ = 0.0f;
+    positionCheckTimer_ = 0.0f;
+    combatStateTimer_ = 0.0f;
+    repositionSpeed_ = 0.0f;
+    isStrafing_ = false;
+    stuckTimer_ = 0.0f;
+    potentiallyStuck_ = false;
+    distanceToTarget_ = 0.0f;
+
+    // パトロール地点は出現位置を基準に作り直す
+    patrolPoints_.clear();
+    currentPatrolIndex_ = 0;
+    patrolInitialized_ = false;
+
+    lastPosition_ = owner->GetPosition();
+    lastValidPosition_ = owner->GetPosition();
+
+    // 前回の出現時の視線判定の結果を使わない
+    SceneQueryManager::GetInstance()->ClearResults(this);
+
+    behaviorTree_->Reset();
+}
+
 void AssaultEnemyBehavior::ContinuousStrafAction(GameObject* owner)
 {
     if (!target_)
@@ -101,64 +134,60 @@ void AssaultEnemyBehavior::ContinuousStrafAction(GameObject* owner)
 // --- BT構築 ---
 void AssaultEnemyBehavior::BuildBehaviorTree()
 {
-    auto root = std::make_unique<SelectorNode>();
+    auto root = std::make_unique<SelectorNode>(BT_NAME("Assault/Root"));
 
     // 1. スタック検知で強制移動
-    auto stuckSeq = std::make_unique<SequenceNode>();
+    auto stuckSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Stuck"));
     stuckSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         return IsStuck(owner);
-                                                       }));
+                                                       }, BT_NAME("Assault/Stuck/IsStuck")));
     stuckSeq->AddChild(std::make_unique<ActionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         ForceMovement(owner);
         return NodeStatus::Success;
-                                                    }));
+                                                    }, BT_NAME("Assault/Stuck/ForceMove")));
     root->AddChild(std::move(stuckSeq));
 
     // 2. 距離による後退
-    auto retreatSeq = std::make_unique<SequenceNode>();
+    auto retreatSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Retreat"));
     retreatSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
-        auto owner = bb.Get<GameObject*>("Owner");
         auto target = bb.Get<GameObject*>("Target");
         if (!target) return false;
-        float dist = (target->GetPosition() - owner->GetPosition()).Length();
-        return dist < minRange_;
-                                                         }));
+        return distanceToTarget_ < minRange_;
+                                                         }, BT_NAME("Assault/Retreat/TooClose")));
     retreatSeq->AddChild(std::make_unique<ActionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         RetreatAction(owner);
         return NodeStatus::Success;
-                                                      }));
+                                                      }, BT_NAME("Assault/Retreat/Move")));
     root->AddChild(std::move(retreatSeq));
 
     // 3. 距離によるリポジション
-    auto repositionSeq = std::make_unique<SequenceNode>();
+    auto repositionSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Reposition"));
     repositionSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
-        auto owner = bb.Get<GameObject*>("Owner");
         auto target = bb.Get<GameObject*>("Target");
         if (!target) return false;
-        float dist = (target->GetPosition() - owner->GetPosition()).Length();
-        return dist > maxRange_;
-                                                            }));
+        return distanceToTarget_ > maxRange_;
+                                                            }, BT_NAME("Assault/Reposition/TooFar")));
     repositionSeq->AddChild(std::make_unique<ActionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         RepositionAction(owner);
         return NodeStatus::Success;
-                                                         }));
+                                                         }, BT_NAME("Assault/Reposition/Move")));
     root->AddChild(std::move(repositionSeq));
 
     // 4. 戦闘：ターゲットが見えて攻撃範囲内
-    auto combatSeq = std::make_unique<SequenceNode>();
+    auto combatSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Combat"));
     combatSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
         return bb.Get<bool>("IsTargetVisible") && bb.Get<bool>("IsInAttackRange");
-                                                        }));
+                                                        }, BT_NAME("Assault/Combat/CanEngage")));
 
     // 戦闘時のセレクター（継続的なストレイフまたは射撃）
-    auto combatSelector = std::make_unique<SelectorNode>();
+    auto combatSelector = std::make_unique<SelectorNode>(BT_NAME("Assault/Combat/Select"));
 
     // 4a. 継続的ストレイフ（一定期間継続）
-    auto continuousStrafSeq = std::make_unique<SequenceNode>();
+    auto continuousStrafSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Combat/Strafe"));
     continuousStrafSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
         // ストレイフ状態が継続中、または新たにストレイフを開始する条件
         if (isStrafing_)
@@ -178,12 +207,12 @@ void AssaultEnemyBehavior::BuildBehaviorTree()
             }
         }
         return false;
-                                                                 }));
+                                                                 }, BT_NAME("Assault/Combat/Strafe/ShouldStrafe")));
     continuousStrafSeq->AddChild(std::make_unique<ActionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         ContinuousStrafAction(owner);
         return NodeStatus::Running; // 継続実行
-                                                              }));
+                                                              }, BT_NAME("Assault/Combat/Strafe/Move")));
     combatSelector->AddChild(std::move(continuousStrafSeq));
 
     // 4b. 通常射撃（ストレイフしていない時）
@@ -193,21 +222,21 @@ void AssaultEnemyBehavior::BuildBehaviorTree()
         FireWeapon(owner);
         AimAtTarget(owner);
         return NodeStatus::Success;
-                                                          }));
+                                                          }, BT_NAME("Assault/Combat/Fire")));
 
     combatSeq->AddChild(std::move(combatSelector));
     root->AddChild(std::move(combatSeq));
 
     // 5. パトロール：ターゲットが見えていなければ
-    auto patrolSeq = std::make_unique<SequenceNode>();
+    auto patrolSeq = std::make_unique<SequenceNode>(BT_NAME("Assault/Patrol"));
     patrolSeq->AddChild(std::make_unique<ConditionNode>([this](Blackboard& bb) {
         return !bb.Get<bool>("IsTargetVisible");
-                                                        }));
+                                                        }, BT_NAME("Assault/Patrol/TargetLost")));
     patrolSeq->AddChild(std::make_unique<ActionNode>([this](Blackboard& bb) {
         auto owner = bb.Get<GameObject*>("Owner");
         PatrolAction(owner);
         return NodeStatus::Success;
-                                                     }));
+                                                     }, BT_NAME("Assault/Patrol/Move")));
     root->AddChild(std::move(patrolSeq));
 
     // 6. Idle
@@ -215,7 +244,7 @@ void AssaultEnemyBehavior::BuildBehaviorTree()
         auto owner = bb.Get<GameObject*>("Owner");
         IdleAction(owner);
         return NodeStatus::Running;
-                                                }));
+                                                }, BT_NAME("Assault/Idle")));
 
     behaviorTree_ = std::make_unique<BehaviorTree>(std::move(root));
 }
@@ -323,28 +352,24 @@ void AssaultEnemyBehavior::FireWeapon(GameObject* owner)
 bool AssaultEnemyBehavior::IsTargetVisible(GameObject* owner)
 {
     if (!target_) return false;
-    Vector3 targetPos = target_->GetPosition();
-    Vector3 direction = targetPos - owner->GetPosition();
-    float distance = direction.Length();
-    return (distance <= detectionRange_);
+    if (distanceToTarget_ > detectionRange_) return false;
+
+    // 視線判定はシーンクエリにまとめて要求し、前フレームの結果を使う
+    SceneQueryManager* sceneQuery = SceneQueryManager::GetInstance();
+    sceneQuery->RequestRaycast(this, owner->GetPosition(), target_->GetPosition(), owner, target_);
+    return sceneQuery->HasLineOfSight(this);
 }
 
 bool AssaultEnemyBehavior::IsInAttackRange(GameObject* owner)
 {
     if (!target_) return false;
-    Vector3 targetPos = target_->GetPosition();
-    Vector3 direction = targetPos - owner->GetPosition();
-    float distance = direction.Length();
-    return (distance >= minRange_ && distance <= maxRange_);
+    return (distanceToTarget_ >= minRange_ && distanceToTarget_ <= maxRange_);
 }
 
 bool AssaultEnemyBehavior::IsInExtendedAttackRange(GameObject* owner)
 {
     if (!target_) return false;
-    Vector3 targetPos = target_->GetPosition();
-    Vector3 direction = targetPos - owner->GetPosition();
-    float distance = direction.Length();
-    return (distance >= extendedMinRange_ && distance <= extendedMaxRange_);
+    return (distanceToTarget_ >= extendedMinRange_ && distanceToTarget_ <= extendedMaxRange_);
 }
 
 Vector3 AssaultEnemyBehavior::GetRandomStrafeDirection(GameObject* owner)
@@ -15,6 +15,7 @@ public:
     AssaultEnemyBehavior(GameObject* target);
 
     void Update(GameObject* owner) override;
+    void Reset(GameObject* owner) override;
 
     void SetTarget(GameObject* target) { target_ = target; }
     void SetMoveSpeed(float speed) { moveSpeed_ = speed; }
@@ -44,6 +45,7 @@ private:
 
     // 状態
     GameObject* target_ = nullptr;
+    float distanceToTarget_ = 0.0f; // 今フレームのターゲットまでの距離
 
     // 行動パラメータ
     float moveSpeed_ = 5.0f;
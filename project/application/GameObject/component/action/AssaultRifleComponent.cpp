@@ -10,6 +10,7 @@
 // component
 #include "BulletComponent.h"
 #include "application/GameObject/component/collision/OBBColliderComponent.h"
+#include "application/GameObject/component/collision/SceneQueryManager.h"
 // math
 #include "math/MathUtils.h"
 #include "time/TimeManager.h"
@@ -110,23 +111,14 @@ void AssaultRifleComponent::FireBullet(GameObject* owner)
 	// マウスのスクリーン座標を取得
 	float mouseX = Input::GetInstance()->GetMouseX();
 	float mouseY = Input::GetInstance()->GetMouseY();
-	// ビューポート行列を作成
-	Matrix4x4 matViewport = MakeViewportMatrix(0, 0, WinApp::kClientWidth, WinApp::kClientHeight, 0, 1);
-	// ビュー行列とプロジェクション行列を取得し、ビューポート行列と合成
-	Matrix4x4 matVPV = (camera->GetViewMatrix() * camera->GetProjectionMatrix()) * matViewport;
-	// 合成行列の逆行列を計算
-	Matrix4x4 matInverseVPV = Inverse(matVPV);
-	// スクリーン座標を定義（近点と遠点）
-	Vector3 posNear = Vector3(mouseX, mouseY, 0.0f); // 近クリップ面
-	Vector3 posFar = Vector3(mouseX, mouseY, 1.0f);  // 遠クリップ面
-	// スクリーン座標をワールド座標に変換
-	posNear = MathUtils::Transform(posNear, matInverseVPV);
-	posFar = MathUtils::Transform(posFar, matInverseVPV);
+	// スクリーン座標をワールド空間のレイに変換（逆VPV行列はカメラごとにフレーム内でキャッシュされる）
+	Vector3 posNear;
+	Vector3 rayDir;
+	SceneQueryManager::GetInstance()->ScreenPointToRay(camera, mouseX, mouseY, posNear, rayDir);
 	// プレイヤーの位置を取得
 	Vector3 playerPos = owner->GetPosition();
 
 	// プレイヤーの高さを考慮した交点計算
-	Vector3 rayDir = Vector3::Normalize(posFar - posNear);
 
 	// プレイヤーと同じ高さの平面との交点を計算
 	float t = (playerPos.y - posNear.y) / rayDir.y;
@@ -234,3 +226,13 @@ void AssaultRifleComponent::Reload(float deltaTime)
 		isReloading_ = false;
 	}
 }
+
+void AssaultRifleComponent::Reset(GameObject* owner)
+{
+	// 弾を破棄して装填状態に戻す
+	bullets_.clear();
+	currentAmmo_ = maxAmmo_;
+	isReloading_ = false;
+	reloadTimer_ = 0.0f;
+	fireCooldownTimer_ = 0.0f;
+}
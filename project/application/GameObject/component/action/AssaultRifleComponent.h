@@ -13,6 +13,7 @@ public:
 
     void Update(GameObject* owner) override;
     void Draw(CameraManager* camera) override;
+    void Reset(GameObject* owner) override;
 
 	// 敵クラスから呼び出すためのメソッド
 	void Fire();
@@ -16,6 +16,9 @@ public:
     /// 描画は不要
     void Draw(CameraManager* camera) override {}
 
+    /// 垂直速度を初期化
+    void Reset(GameObject* owner) override { verticalVelocity_ = 0.0f; }
+
 private:
     float gravity_;            // 重力加速度
     float verticalVelocity_;   // 現在の垂直速度
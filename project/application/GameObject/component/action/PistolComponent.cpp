@@ -228,3 +228,13 @@ void PistolComponent::Reload(float deltaTime)
 		isReloading_ = false;
 	}
 }
+
+void PistolComponent::Reset(GameObject* owner)
+{
+	// 弾を破棄して装填状態に戻す
+	bullets_.clear();
+	currentAmmo_ = maxAmmo_;
+	isReloading_ = false;
+	reloadTimer_ = 0.0f;
+	fireCooldownTimer_ = 0.0f;
+}
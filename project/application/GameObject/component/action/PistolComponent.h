@@ -15,6 +15,7 @@ public:
 
 	void Update(GameObject* owner) override;
 	void Draw(CameraManager* camera) override;
+	void Reset(GameObject* owner) override;
 
 private:
 	void FireBullet(GameObject* owner);
@@ -4,11 +4,28 @@
 ICollisionComponent::~ICollisionComponent()
 {
 	owner_ = nullptr;
-	CollisionManager::GetInstance()->Unregister(this);
+	if (isRegistered_)
+	{
+		CollisionManager::GetInstance()->Unregister(this);
+	}
 }
 
 ICollisionComponent::ICollisionComponent(GameObject* owner)
 {
 	owner_ = owner;
-	CollisionManager::GetInstance()->Register(this);
+	SetRegistered(true);
+}
+
+void ICollisionComponent::SetRegistered(bool registered)
+{
+	if (isRegistered_ == registered) { return; }
+	isRegistered_ = registered;
+	if (registered)
+	{
+		CollisionManager::GetInstance()->Register(this);
+	}
+	else
+	{
+		CollisionManager::GetInstance()->Unregister(this);
+	}
 }
@@ -14,6 +14,13 @@ enum class ColliderType
 	OBB,
 };
 
+//当たり判定のグループ（同じグループ同士は判定しない）
+enum class CollisionGroup
+{
+	None,
+	Enemy,
+};
+
 class ICollisionComponent : public virtual IGameObjectComponent
 {
 public:
@@ -36,6 +43,18 @@ public:
 	void SetSizeOffset(const Vector3& offset) { sizeOffset_ = offset; }
 	Vector3 GetSizeOffset() const { return sizeOffset_; }
 
+	// 判定の有効・無効を設定（無効の間は判定しない）
+	void SetEnabled(bool enabled) { isEnabled_ = enabled; }
+	bool IsEnabled() const { return isEnabled_; }
+
+	// CollisionManagerへの登録・解除（解除中は総当たりのループにも入らない）
+	void SetRegistered(bool registered);
+	bool IsRegistered() const { return isRegistered_; }
+
+	// 当たり判定のグループを設定
+	void SetCollisionGroup(CollisionGroup group) { collisionGroup_ = group; }
+	CollisionGroup GetCollisionGroup() const { return collisionGroup_; }
+
 	using CollisionCallback = std::function<void(GameObject* other)>;
 
 	virtual ColliderType GetColliderType() const = 0;
@@ -63,6 +82,12 @@ protected:
 	bool useSubstep_ = false;
 	// 判定サイズのオフセット
 	Vector3 sizeOffset_ = {};
+	// 当たり判定のグループ
+	CollisionGroup collisionGroup_ = CollisionGroup::None;
+	// 判定が有効か
+	bool isEnabled_ = true;
+	// CollisionManagerに登録されているか
+	bool isRegistered_ = false;
 
 private:
 	CollisionCallback onEnter_ = nullptr;
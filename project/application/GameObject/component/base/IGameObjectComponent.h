@@ -8,4 +8,6 @@ class IGameObjectComponent
 public:
 	virtual ~IGameObjectComponent() = default;
 	virtual void Update(GameObject* owner) = 0;
+	// 状態を初期化する（オブジェクトを再利用する時に呼ばれる）
+	virtual void Reset(GameObject* owner) {}
 };
\ No newline at end of file
@@ -102,6 +102,18 @@ void CollisionManager::CheckCollisions()
 			ICollisionComponent* a = colliders_[i];
 			ICollisionComponent* b = colliders_[j];
 
+			// 無効なコライダーは判定しない
+			if (!a->IsEnabled() || !b->IsEnabled())
+			{
+				continue;
+			}
+
+			// 同じグループ同士は判定しない（敵同士の押し合いはCrowdSeparationで処理）
+			if (a->GetCollisionGroup() != CollisionGroup::None && a->GetCollisionGroup() == b->GetCollisionGroup())
+			{
+				continue;
+			}
+
 			bool isHit = false;
 
 			// 衝突判定のディスパッチ
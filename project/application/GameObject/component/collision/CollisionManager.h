@@ -18,6 +18,9 @@ public:
 	void CheckCollisions();
 	void UpdatePreviousPositions();
 
+	// 登録されているコライダーの取得
+	const std::vector<ICollisionComponent*>& GetColliders() const { return colliders_; }
+
 private:
 	static CollisionManager* instance_; // シングルトンインスタンス
 	CollisionManager() = default;
@@ -0,0 +1,572 @@
+#include "SceneQueryManager.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define SCENE_QUERY_USE_SSE
+#endif
+
+// app
+#include "application/GameObject/base/GameObject.h"
+#include "application/GameObject/component/collision/AABBColliderComponent.h"
+#include "application/GameObject/component/collision/CollisionManager.h"
+#include "application/GameObject/component/collision/OBBColliderComponent.h"
+// system
+#include "base/Camera.h"
+#include "base/WinApp.h"
+#include "imgui/imgui.h"
+// math
+#include "math/MathUtils.h"
+
+namespace
+{
+	// BVHの葉に入れる最大プロキシ数
+	constexpr uint32_t kMaxLeafSize = 4;
+	// 静的コライダーとして扱うタグ
+	const char* kStaticTag = "Obstacle";
+
+	// 0除算を避けた逆数
+	float SafeInverse(float v)
+	{
+		return (std::abs(v) > 1e-8f) ? 1.0f / v : (v >= 0.0f ? FLT_MAX : -FLT_MAX);
+	}
+
+	AABB Merge(const AABB& a, const AABB& b)
+	{
+		return AABB(Vector3::Min(a.min_, b.min_), Vector3::Max(a.max_, b.max_));
+	}
+}
+
+SceneQueryManager* SceneQueryManager::instance_ = nullptr; // シングルトンインスタンス
+
+SceneQueryManager* SceneQueryManager::GetInstance()
+{
+	if (instance_ == nullptr)
+	{
+		instance_ = new SceneQueryManager();
+	}
+	return instance_;
+}
+
+void SceneQueryManager::Initialize()
+{
+	Finalize();
+}
+
+void SceneQueryManager::Finalize()
+{
+	requests_.clear();
+	pendingResults_.clear();
+	results_.clear();
+	staticProxies_.clear();
+	staticNodes_.clear();
+	staticColliders_.clear();
+	dynamicProxies_.clear();
+	cameraCaches_.clear();
+	traversalStack_.clear();
+	isStaticDirty_ = true;
+}
+
+void SceneQueryManager::BeginFrame()
+{
+	// 前フレームで処理した結果を公開する
+	results_.swap(pendingResults_);
+	pendingResults_.clear();
+	requests_.clear();
+
+	++frameIndex_;
+}
+
+void SceneQueryManager::Execute()
+{
+	// 統計のリセット
+	nodeVisits_ = 0;
+	proxyTests_ = 0;
+	lastRayCount_ = static_cast<uint32_t>(requests_.size());
+
+	if (!requests_.empty())
+	{
+		GatherColliders();
+
+		// 要求をまとめて処理
+		pendingResults_.reserve(requests_.size());
+		for (const RayRequest& request : requests_)
+		{
+			pendingResults_[request.key] = Raycast(request);
+		}
+		requests_.clear();
+	}
+
+	lastNodeVisits_ = nodeVisits_;
+	lastProxyTests_ = proxyTests_;
+
+	DrawImGui();
+}
+
+void SceneQueryManager::RequestRaycast(const void* key, const Vector3& start, const Vector3& end, const GameObject* ignoreA, const GameObject* ignoreB, bool includeDynamic)
+{
+	requests_.push_back({ key, start, end, ignoreA, ignoreB, includeDynamic });
+}
+
+bool SceneQueryManager::TryGetResult(const void* key, RaycastHit& outHit) const
+{
+	auto it = results_.find(key);
+	if (it == results_.end())
+	{
+		return false;
+	}
+	outHit = it->second;
+	return true;
+}
+
+bool SceneQueryManager::HasLineOfSight(const void* key, bool defaultValue) const
+{
+	auto it = results_.find(key);
+	if (it == results_.end())
+	{
+		return defaultValue;
+	}
+	return !it->second.isHit;
+}
+
+void SceneQueryManager::ClearResults(const void* key)
+{
+	std::erase_if(requests_, [key](const RayRequest& request) { return request.key == key; });
+	pendingResults_.erase(key);
+	results_.erase(key);
+}
+
+RaycastHit SceneQueryManager::RaycastImmediate(const Vector3& start, const Vector3& end, const GameObject* ignoreA, const GameObject* ignoreB, bool includeDynamic)
+{
+	// 呼ばれた時点の位置で判定するため、毎回展開し直す（Execute()の結果には影響しない）
+	GatherColliders();
+	return Raycast({ nullptr, start, end, ignoreA, ignoreB, includeDynamic });
+}
+
+const Matrix4x4& SceneQueryManager::GetInverseViewProjectionViewport(const Camera* camera)
+{
+	CameraCache& cache = cameraCaches_[camera];
+	const Matrix4x4& viewProjection = camera->GetViewProjectionMatrix();
+
+	// 同じフレームかつカメラが動いていなければキャッシュを使う
+	if (cache.frame == frameIndex_ && std::memcmp(&cache.viewProjection, &viewProjection, sizeof(Matrix4x4)) == 0)
+	{
+		++inverseCacheHits_;
+		return cache.inverseVPV;
+	}
+
+	++inverseCacheMisses_;
+	Matrix4x4 matViewport = MakeViewportMatrix(0, 0, WinApp::kClientWidth, WinApp::kClientHeight, 0, 1);
+	cache.viewProjection = viewProjection;
+	cache.inverseVPV = Inverse(viewProjection * matViewport);
+	cache.frame = frameIndex_;
+	return cache.inverseVPV;
+}
+
+void SceneQueryManager::ScreenPointToRay(const Camera* camera, float screenX, float screenY, Vector3& outOrigin, Vector3& outDirection)
+{
+	const Matrix4x4& matInverseVPV = GetInverseViewProjectionViewport(camera);
+	// スクリーン座標を近クリップ面と遠クリップ面に変換
+	Vector3 posNear = MathUtils::Transform(Vector3(screenX, screenY, 0.0f), matInverseVPV);
+	Vector3 posFar = MathUtils::Transform(Vector3(screenX, screenY, 1.0f), matInverseVPV);
+	outOrigin = posNear;
+	outDirection = Vector3::Normalize(posFar - posNear);
+}
+
+void SceneQueryManager::GatherColliders()
+{
+	const auto& colliders = CollisionManager::GetInstance()->GetColliders();
+
+	// 静的コライダーの集合が変わっていればBVHを作り直す
+	size_t staticCount = 0;
+	for (const ICollisionComponent* collider : colliders)
+	{
+		if (collider->GetOwner() && collider->GetOwner()->GetTag() == kStaticTag)
+		{
+			if (staticCount >= staticColliders_.size() || staticColliders_[staticCount] != collider)
+			{
+				isStaticDirty_ = true;
+			}
+			++staticCount;
+		}
+	}
+	if (staticCount != staticColliders_.size())
+	{
+		isStaticDirty_ = true;
+	}
+	if (isStaticDirty_)
+	{
+		BuildStaticBVH();
+	}
+
+	// 動的コライダーは毎フレーム展開する
+	dynamicProxies_.clear();
+	for (const ICollisionComponent* collider : colliders)
+	{
+		GameObject* owner = collider->GetOwner();
+		if (!owner || owner->GetTag() == kStaticTag || !collider->IsEnabled())
+		{
+			continue;
+		}
+
+		ColliderProxy proxy{};
+		if (!MakeProxy(collider, proxy))
+		{
+			continue;
+		}
+		dynamicProxies_.push_back(proxy);
+	}
+
+	// ブロードフェーズ用にSoAへ展開
+	size_t count = dynamicProxies_.size();
+	dynamicMinX_.resize(count); dynamicMinY_.resize(count); dynamicMinZ_.resize(count);
+	dynamicMaxX_.resize(count); dynamicMaxY_.resize(count); dynamicMaxZ_.resize(count);
+	dynamicCandidate_.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const AABB& b = dynamicProxies_[i].bounds;
+		dynamicMinX_[i] = b.min_.x; dynamicMinY_[i] = b.min_.y; dynamicMinZ_[i] = b.min_.z;
+		dynamicMaxX_[i] = b.max_.x; dynamicMaxY_[i] = b.max_.y; dynamicMaxZ_[i] = b.max_.z;
+	}
+}
+
+bool SceneQueryManager::MakeProxy(const ICollisionComponent* collider, ColliderProxy& outProxy)
+{
+	outProxy.owner = collider->GetOwner();
+	if (collider->GetColliderType() == ColliderType::OBB)
+	{
+		outProxy.isOBB = true;
+		outProxy.obb = static_cast<const OBBColliderComponent*>(collider)->GetOBB();
+		outProxy.bounds = ComputeBounds(outProxy.obb);
+		return true;
+	}
+	if (collider->GetColliderType() == ColliderType::AABB)
+	{
+		outProxy.isOBB = false;
+		outProxy.bounds = static_cast<const AABBColliderComponent*>(collider)->GetAABB();
+		return true;
+	}
+	return false;
+}
+
+void SceneQueryManager::BuildStaticBVH()
+{
+	isStaticDirty_ = false;
+	staticProxies_.clear();
+	staticColliders_.clear();
+	staticNodes_.clear();
+
+	for (const ICollisionComponent* collider : CollisionManager::GetInstance()->GetColliders())
+	{
+		GameObject* owner = collider->GetOwner();
+		if (!owner || owner->GetTag() != kStaticTag)
+		{
+			continue;
+		}
+		staticColliders_.push_back(collider);
+
+		ColliderProxy proxy{};
+		if (!MakeProxy(collider, proxy))
+		{
+			continue;
+		}
+		staticProxies_.push_back(proxy);
+	}
+
+	if (staticProxies_.empty())
+	{
+		return;
+	}
+	staticNodes_.reserve(staticProxies_.size() * 2);
+	BuildBVHRecursive(0, static_cast<uint32_t>(staticProxies_.size()));
+}
+
+uint32_t SceneQueryManager::BuildBVHRecursive(uint32_t first, uint32_t count)
+{
+	uint32_t nodeIndex = static_cast<uint32_t>(staticNodes_.size());
+	staticNodes_.emplace_back();
+
+	// 範囲全体のAABBと中心のAABBを求める
+	AABB bounds = staticProxies_[first].bounds;
+	Vector3 centerMin = bounds.GetCenter();
+	Vector3 centerMax = centerMin;
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		bounds = Merge(bounds, staticProxies_[i].bounds);
+		Vector3 c = staticProxies_[i].bounds.GetCenter();
+		centerMin = Vector3::Min(centerMin, c);
+		centerMax = Vector3::Max(centerMax, c);
+	}
+	staticNodes_[nodeIndex].bounds = bounds;
+
+	if (count <= kMaxLeafSize)
+	{
+		staticNodes_[nodeIndex].first = first;
+		staticNodes_[nodeIndex].count = count;
+		return nodeIndex;
+	}
+
+	// 中心の広がりが最大の軸で中央値分割
+	Vector3 extent = centerMax - centerMin;
+	int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+	auto axisValue = [axis](const ColliderProxy& p) {
+		Vector3 c = p.bounds.GetCenter();
+		return axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+		};
+	uint32_t half = count / 2;
+	std::nth_element(staticProxies_.begin() + first, staticProxies_.begin() + first + half, staticProxies_.begin() + first + count,
+					 [&](const ColliderProxy& a, const ColliderProxy& b) { return axisValue(a) < axisValue(b); });
+
+	uint32_t left = BuildBVHRecursive(first, half);
+	uint32_t right = BuildBVHRecursive(first + half, count - half);
+	staticNodes_[nodeIndex].left = left;
+	staticNodes_[nodeIndex].right = right;
+	return nodeIndex;
+}
+
+RaycastHit SceneQueryManager::Raycast(const RayRequest& request)
+{
+	RaycastHit hit;
+	Vector3 delta = request.end - request.start;
+	float length = delta.Length();
+	if (length <= 0.0f)
+	{
+		return hit;
+	}
+	Vector3 dir = delta / length;
+	Vector3 invDir = { SafeInverse(dir.x), SafeInverse(dir.y), SafeInverse(dir.z) };
+
+	hit.distance = length;
+	TraverseStatic(request.start, invDir, dir, length, request, hit);
+	if (request.includeDynamic)
+	{
+		TestDynamic(request.start, invDir, dir, hit.distance, request, hit);
+	}
+
+	if (hit.isHit)
+	{
+		hit.point = request.start + dir * hit.distance;
+	}
+	else
+	{
+		hit.distance = length;
+		hit.point = request.end;
+	}
+	return hit;
+}
+
+void SceneQueryManager::TraverseStatic(const Vector3& origin, const Vector3& invDir, const Vector3& dir, float maxT, const RayRequest& request, RaycastHit& hit)
+{
+	if (staticNodes_.empty())
+	{
+		return;
+	}
+
+	// スタックで走査（深い木でも部分木を取りこぼさないよう、足りなければ伸ばす）
+	std::vector<uint32_t>& stack = traversalStack_;
+	stack.clear();
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		const BVHNode& node = staticNodes_[stack.back()];
+		stack.pop_back();
+		++nodeVisits_;
+
+		float tNode;
+		if (!IntersectRayAABB(origin, invDir, node.bounds, maxT, tNode))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				const ColliderProxy& proxy = staticProxies_[i];
+				if (proxy.owner == request.ignoreA || proxy.owner == request.ignoreB)
+				{
+					continue;
+				}
+				float t;
+				if (IntersectProxy(proxy, origin, dir, invDir, maxT, t))
+				{
+					maxT = t;
+					hit.isHit = true;
+					hit.distance = t;
+					hit.object = proxy.owner;
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+		}
+	}
+}
+
+void SceneQueryManager::TestDynamic(const Vector3& origin, const Vector3& invDir, const Vector3& dir, float maxT, const RayRequest& request, RaycastHit& hit)
+{
+	size_t count = dynamicProxies_.size();
+	if (count == 0)
+	{
+		return;
+	}
+
+	// ブロードフェーズ：スラブ判定をまとめて行う
+	const float* minX = dynamicMinX_.data(); const float* minY = dynamicMinY_.data(); const float* minZ = dynamicMinZ_.data();
+	const float* maxX = dynamicMaxX_.data(); const float* maxY = dynamicMaxY_.data(); const float* maxZ = dynamicMaxZ_.data();
+	uint8_t* candidate = dynamicCandidate_.data();
+	size_t i = 0;
+
+#ifdef SCENE_QUERY_USE_SSE
+	// 4個のAABBを同時に判定する
+	const __m128 originX = _mm_set1_ps(origin.x), originY = _mm_set1_ps(origin.y), originZ = _mm_set1_ps(origin.z);
+	const __m128 invDirX = _mm_set1_ps(invDir.x), invDirY = _mm_set1_ps(invDir.y), invDirZ = _mm_set1_ps(invDir.z);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 limit = _mm_set1_ps(maxT);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX + i), originX), invDirX);
+		const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX + i), originX), invDirX);
+		const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY + i), originY), invDirY);
+		const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY + i), originY), invDirY);
+		const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minZ + i), originZ), invDirZ);
+		const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxZ + i), originZ), invDirZ);
+		const __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_max_ps(_mm_min_ps(tz1, tz2), zero));
+		const __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_min_ps(_mm_max_ps(tz1, tz2), limit));
+
+		const int hitMask = _mm_movemask_ps(_mm_cmple_ps(tMin, tMax));
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			candidate[i + lane] = static_cast<uint8_t>((hitMask >> lane) & 1);
+		}
+	}
+#endif
+
+	// 4個に満たない残り（SSEが使えない環境では全て）
+	for (; i < count; ++i)
+	{
+		float tx1 = (minX[i] - origin.x) * invDir.x, tx2 = (maxX[i] - origin.x) * invDir.x;
+		float ty1 = (minY[i] - origin.y) * invDir.y, ty2 = (maxY[i] - origin.y) * invDir.y;
+		float tz1 = (minZ[i] - origin.z) * invDir.z, tz2 = (maxZ[i] - origin.z) * invDir.z;
+		float tMin = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+		float tMax = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), maxT));
+		candidate[i] = static_cast<uint8_t>(tMin <= tMax);
+	}
+
+	// 候補のみ詳細判定
+	for (i = 0; i < count; ++i)
+	{
+		if (!candidate[i])
+		{
+			continue;
+		}
+		const ColliderProxy& proxy = dynamicProxies_[i];
+		if (proxy.owner == request.ignoreA || proxy.owner == request.ignoreB)
+		{
+			continue;
+		}
+		float t;
+		if (IntersectProxy(proxy, origin, dir, invDir, maxT, t))
+		{
+			maxT = t;
+			hit.isHit = true;
+			hit.distance = t;
+			hit.object = proxy.owner;
+		}
+	}
+}
+
+bool SceneQueryManager::IntersectProxy(const ColliderProxy& proxy, const Vector3& origin, const Vector3& dir, const Vector3& invDir, float maxT, float& outT)
+{
+	++proxyTests_;
+	if (proxy.isOBB)
+	{
+		return IntersectRayOBB(origin, dir, proxy.obb, maxT, outT);
+	}
+	return IntersectRayAABB(origin, invDir, proxy.bounds, maxT, outT);
+}
+
+bool SceneQueryManager::IntersectRayAABB(const Vector3& origin, const Vector3& invDir, const AABB& aabb, float maxT, float& outT)
+{
+	float tx1 = (aabb.min_.x - origin.x) * invDir.x, tx2 = (aabb.max_.x - origin.x) * invDir.x;
+	float ty1 = (aabb.min_.y - origin.y) * invDir.y, ty2 = (aabb.max_.y - origin.y) * invDir.y;
+	float tz1 = (aabb.min_.z - origin.z) * invDir.z, tz2 = (aabb.max_.z - origin.z) * invDir.z;
+	float tMin = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+	float tMax = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), maxT));
+	outT = tMin;
+	return tMin <= tMax;
+}
+
+bool SceneQueryManager::IntersectRayOBB(const Vector3& origin, const Vector3& dir, const OBB& obb, float maxT, float& outT)
+{
+	// OBBのローカル空間でスラブ判定
+	const Matrix4x4& r = obb.rotate;
+	Vector3 axes[3] = {
+		{ r.m[0][0], r.m[0][1], r.m[0][2] },
+		{ r.m[1][0], r.m[1][1], r.m[1][2] },
+		{ r.m[2][0], r.m[2][1], r.m[2][2] },
+	};
+	float halfSize[3] = { obb.size.x, obb.size.y, obb.size.z };
+	Vector3 toOrigin = origin - obb.center;
+
+	float tMin = 0.0f;
+	float tMax = maxT;
+	for (int i = 0; i < 3; ++i)
+	{
+		float e = Vector3::Dot(axes[i], toOrigin);
+		float f = Vector3::Dot(axes[i], dir);
+		if (std::abs(f) < 1e-8f)
+		{
+			// 軸に平行なレイはスラブ外なら当たらない
+			if (std::abs(e) > halfSize[i]) return false;
+			continue;
+		}
+		float invF = 1.0f / f;
+		float t1 = (-halfSize[i] - e) * invF;
+		float t2 = (halfSize[i] - e) * invF;
+		if (t1 > t2) std::swap(t1, t2);
+		tMin = std::max(tMin, t1);
+		tMax = std::min(tMax, t2);
+		if (tMin > tMax) return false;
+	}
+	outT = tMin;
+	return true;
+}
+
+AABB SceneQueryManager::ComputeBounds(const OBB& obb)
+{
+	// 回転後の各軸の寄与を合計して外接AABBを求める
+	const Matrix4x4& r = obb.rotate;
+	Vector3 extent = {
+		std::abs(r.m[0][0]) * obb.size.x + std::abs(r.m[1][0]) * obb.size.y + std::abs(r.m[2][0]) * obb.size.z,
+		std::abs(r.m[0][1]) * obb.size.x + std::abs(r.m[1][1]) * obb.size.y + std::abs(r.m[2][1]) * obb.size.z,
+		std::abs(r.m[0][2]) * obb.size.x + std::abs(r.m[1][2]) * obb.size.y + std::abs(r.m[2][2]) * obb.size.z,
+	};
+	return AABB(obb.center - extent, obb.center + extent);
+}
+
+void SceneQueryManager::DrawImGui()
+{
+#ifdef _DEBUG
+	ImGui::Begin("SceneQueryManager");
+	ImGui::Text("Rays (last frame): %u", lastRayCount_);
+	ImGui::Text("BVH Node Visits: %u", lastNodeVisits_);
+	ImGui::Text("Narrow Phase Tests: %u", lastProxyTests_);
+	ImGui::Separator();
+	ImGui::Text("Static Colliders: %zu (BVH Nodes: %zu)", staticProxies_.size(), staticNodes_.size());
+	ImGui::Text("Dynamic Colliders: %zu", dynamicProxies_.size());
+	ImGui::Separator();
+	ImGui::Text("Inverse VPV Cache Hit/Miss: %u / %u", inverseCacheHits_, inverseCacheMisses_);
+	if (ImGui::Button("Rebuild Static BVH"))
+	{
+		MarkStaticDirty();
+	}
+	ImGui::End();
+#endif
+}
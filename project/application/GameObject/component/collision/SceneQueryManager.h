@@ -0,0 +1,193 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "math/AABB.h"
+#include "math/MatrixFunc.h"
+#include "math/OBB.h"
+#include "math/Vector3.h"
+
+class Camera;
+class GameObject;
+class ICollisionComponent;
+
+// レイキャストの結果
+struct RaycastHit
+{
+	bool isHit = false;				// 何かに当たったか
+	float distance = 0.0f;			// 始点からの距離
+	Vector3 point = {};				// 当たった位置
+	GameObject* object = nullptr;	// 当たったオブジェクト
+};
+
+/**
+ * \brief シーンクエリ（レイキャスト・視線判定）をまとめて処理するクラス
+ * \note 要求はフレーム中に溜めておき、Execute()で一括処理する。結果は次のフレームで取得する
+ */
+class SceneQueryManager
+{
+public:
+	static SceneQueryManager* GetInstance();
+	void Initialize();
+	void Finalize();
+
+	// フレーム開始処理。前フレームの結果を確定させ、要求とキャッシュをクリアする
+	void BeginFrame();
+
+	// 溜まった要求を一括処理する。CollisionManager::CheckCollisions()の後に呼ぶ
+	void Execute();
+
+	/**
+	 * \brief 線分のレイキャストを要求する
+	 * \param key 結果を受け取るためのキー（要求元のポインタなど）
+	 * \param start 始点
+	 * \param end 終点
+	 * \param ignoreA 判定から除外するオブジェクト
+	 * \param ignoreB 判定から除外するオブジェクト
+	 * \param includeDynamic 動的なコライダーも判定するか（falseの場合は障害物のみ）
+	 */
+	void RequestRaycast(const void* key, const Vector3& start, const Vector3& end,
+						const GameObject* ignoreA = nullptr, const GameObject* ignoreB = nullptr, bool includeDynamic = false);
+
+	/**
+	 * \brief 前フレームのレイキャスト結果を取得する
+	 * \param key 要求時のキー
+	 * \param outHit 結果の格納先
+	 * \return 結果が存在すればtrue
+	 */
+	bool TryGetResult(const void* key, RaycastHit& outHit) const;
+
+	/**
+	 * \brief 前フレームの視線判定結果を取得する
+	 * \param key 要求時のキー
+	 * \param defaultValue 結果がまだ無い場合に返す値
+	 * \return 遮るものが無ければtrue
+	 */
+	bool HasLineOfSight(const void* key, bool defaultValue = true) const;
+
+	/**
+	 * \brief キーの要求と結果を破棄する
+	 * \note プールで使い回すオブジェクトは同じキーを使うので、出し入れの時に前回の結果を消しておく
+	 */
+	void ClearResults(const void* key);
+
+	// 即時にレイキャストを行う（結果を同じフレームで必要とする場合のみ使用。呼ぶたびにコライダーを展開し直す）
+	RaycastHit RaycastImmediate(const Vector3& start, const Vector3& end,
+								const GameObject* ignoreA = nullptr, const GameObject* ignoreB = nullptr, bool includeDynamic = false);
+
+	// 逆（ビュー×プロジェクション×ビューポート）行列を取得。カメラごとにフレーム内でキャッシュする
+	const Matrix4x4& GetInverseViewProjectionViewport(const Camera* camera);
+
+	// スクリーン座標からワールド空間のレイを求める
+	void ScreenPointToRay(const Camera* camera, float screenX, float screenY, Vector3& outOrigin, Vector3& outDirection);
+
+	// 静的コライダー（障害物）の再構築を要求する。障害物を動かした・大きさを変えた時に呼ぶ
+	void MarkStaticDirty() { isStaticDirty_ = true; }
+
+private:
+	static SceneQueryManager* instance_; // シングルトンインスタンス
+	SceneQueryManager() = default;
+	~SceneQueryManager() = default;
+	SceneQueryManager(const SceneQueryManager&) = delete;
+	SceneQueryManager& operator=(const SceneQueryManager&) = delete;
+
+	// レイの要求
+	struct RayRequest
+	{
+		const void* key;
+		Vector3 start;
+		Vector3 end;
+		const GameObject* ignoreA;
+		const GameObject* ignoreB;
+		bool includeDynamic;
+	};
+
+	// 判定用に展開したコライダー
+	struct ColliderProxy
+	{
+		AABB bounds;						// ワールド空間の外接AABB
+		OBB obb;							// OBBコライダーの場合のみ使用
+		bool isOBB;
+		GameObject* owner;
+	};
+
+	// BVHのノード
+	struct BVHNode
+	{
+		AABB bounds;
+		uint32_t left = 0;			// 子ノード（葉の場合は未使用）
+		uint32_t right = 0;
+		uint32_t first = 0;			// 葉の場合のプロキシ開始位置
+		uint32_t count = 0;			// 葉の場合のプロキシ数（0なら内部ノード）
+	};
+
+	// コライダーを静的・動的に振り分ける（呼んだ時点の位置で展開し直す）
+	void GatherColliders();
+	// コライダーから判定用のプロキシを作る
+	static bool MakeProxy(const ICollisionComponent* collider, ColliderProxy& outProxy);
+	// 静的コライダーのBVHを構築
+	void BuildStaticBVH();
+	uint32_t BuildBVHRecursive(uint32_t first, uint32_t count);
+
+	// レイ1本を処理する
+	RaycastHit Raycast(const RayRequest& request);
+	// BVHの走査
+	void TraverseStatic(const Vector3& origin, const Vector3& invDir, const Vector3& dir, float maxT, const RayRequest& request, RaycastHit& hit);
+	// 動的コライダーの判定
+	void TestDynamic(const Vector3& origin, const Vector3& invDir, const Vector3& dir, float maxT, const RayRequest& request, RaycastHit& hit);
+	// プロキシとの詳細判定
+	bool IntersectProxy(const ColliderProxy& proxy, const Vector3& origin, const Vector3& dir, const Vector3& invDir, float maxT, float& outT);
+
+	// 判定関数
+	static bool IntersectRayAABB(const Vector3& origin, const Vector3& invDir, const AABB& aabb, float maxT, float& outT);
+	static bool IntersectRayOBB(const Vector3& origin, const Vector3& dir, const OBB& obb, float maxT, float& outT);
+	static AABB ComputeBounds(const OBB& obb);
+
+	// ImGuiで統計を表示
+	void DrawImGui();
+
+private:
+	// 要求（処理待ち）
+	std::vector<RayRequest> requests_;
+	// 今フレームで処理した結果（次フレームで公開）
+	std::unordered_map<const void*, RaycastHit> pendingResults_;
+	// 公開中の結果（前フレームの要求分）
+	std::unordered_map<const void*, RaycastHit> results_;
+
+	// 静的コライダーとBVH
+	std::vector<ColliderProxy> staticProxies_;
+	std::vector<BVHNode> staticNodes_;
+	std::vector<const ICollisionComponent*> staticColliders_;
+	bool isStaticDirty_ = true;
+
+	// 動的コライダー（SoAで保持してブロードフェーズを一括処理する）
+	std::vector<ColliderProxy> dynamicProxies_;
+	std::vector<float> dynamicMinX_, dynamicMinY_, dynamicMinZ_;
+	std::vector<float> dynamicMaxX_, dynamicMaxY_, dynamicMaxZ_;
+	std::vector<uint8_t> dynamicCandidate_;
+
+	// BVH走査用のスタック（使い回す）
+	std::vector<uint32_t> traversalStack_;
+
+	// カメラごとの逆VPV行列キャッシュ
+	struct CameraCache
+	{
+		Matrix4x4 viewProjection;
+		Matrix4x4 inverseVPV;
+		uint64_t frame;
+	};
+	std::unordered_map<const Camera*, CameraCache> cameraCaches_;
+
+	// フレーム番号
+	uint64_t frameIndex_ = 0;
+
+	// 統計
+	uint32_t lastRayCount_ = 0;
+	uint32_t lastNodeVisits_ = 0;
+	uint32_t lastProxyTests_ = 0;
+	uint32_t nodeVisits_ = 0;
+	uint32_t proxyTests_ = 0;
+	uint32_t inverseCacheHits_ = 0;
+	uint32_t inverseCacheMisses_ = 0;
+};
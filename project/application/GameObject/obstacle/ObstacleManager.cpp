@@ -1,6 +1,7 @@
 #include "ObstacleManager.h"
 
 #include "application/GameObject/component/collision/OBBColliderComponent.h"
+#include "application/GameObject/component/collision/SceneQueryManager.h"
 #include "manager/editor/JsonEditorManager.h"
 
 void ObstacleManager::Initialize(Object3dCommon* object3dCommon, LightManager* lightManager)
@@ -86,6 +87,8 @@ void ObstacleManager::CreateObstacles(const std::string& modelName)
 		obstacle->SetPosition(obstacleData_[i].transform.translate);
 		obstacle->SetRotation(obstacleData_[i].transform.rotate);
 		obstacle->SetScale(obstacleData_[i].transform.scale);
+		// 障害物はデータを反映する時以外動かないので、毎フレームのSRTの比較を省く
+		obstacle->SetStatic(true);
 		if (i == 0)
 		{
 			obstacle->GetModel()->SetUVScale(Vector3(10.0f, 10.0f, 1.0f));
@@ -93,6 +96,9 @@ void ObstacleManager::CreateObstacles(const std::string& modelName)
 		obstacles_.push_back(std::move(obstacle));
 
 	}
+
+	// 解放したコライダーと同じアドレスに作られることもあるので、並びの比較に頼らずBVHを作り直す
+	SceneQueryManager::GetInstance()->MarkStaticDirty();
 }
 
 void ObstacleManager::ApplyObstacleData()
@@ -115,6 +121,9 @@ void ObstacleManager::ApplyObstacleData()
 			break; // データがない場合はループを抜ける
 		}
 	}
+
+	// 障害物の位置・回転・大きさが変わったので、レイキャスト用のBVHを作り直す
+	SceneQueryManager::GetInstance()->MarkStaticDirty();
 }
 
 void ObstacleManager::SetObstacleData(const std::vector<GameObjectInfo>& data)
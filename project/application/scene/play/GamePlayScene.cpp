@@ -4,11 +4,14 @@
 #include "input/Input.h"
 // scene
 #include "engine/scene/manager/SceneManager.h"
+// graphics
+#include "graphics/3d/Object3dCommon.h"
 
 
 void GamePlayScene::Initialize()
 {
-
+	//環境マップ（映り込みに使うキューブマップ）
+	sceneManager_->GetObject3dCommon()->SetEnvironmentMap("./Resources/rostock_laage_airport_4k.dds");
 }
 
 void GamePlayScene::Finalize()
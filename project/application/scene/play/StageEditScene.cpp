@@ -6,9 +6,14 @@
 #include "math/VectorColorCodes.h"
 // scene
 #include "scene/manager/SceneManager.h"
+// graphics
+#include "graphics/3d/Object3dCommon.h"
 
 void StageEditScene::Initialize()
 {
+	//環境マップ（映り込みに使うキューブマップ）
+	sceneManager_->GetObject3dCommon()->SetEnvironmentMap("./Resources/rostock_laage_airport_4k.dds");
+
 	// 障害物マネージャーの初期化
 	stageManager_ = std::make_unique<StageManager>();
 	stageManager_->Initialize(
@@ -4,6 +4,8 @@
 #include "audio/Audio.h"
 // scene
 #include "engine/scene/manager/SceneManager.h"
+// graphics
+#include "graphics/3d/Object3dCommon.h"
 // editor
 #include "externals/imgui/imgui.h"
 // math
@@ -13,6 +15,7 @@
 #include "manager/effect/PostProcessManager.h"
 // app
 #include "application/GameObject/component/collision/CollisionManager.h"
+#include "application/GameObject/component/collision/SceneQueryManager.h"
 // components
 #include "application/GameObject/component/action/PistolComponent.h"
 #include "effects/particle/component/group/MaterialColorComponent.h"
@@ -47,6 +50,18 @@ void CreateTimer()
 	TimerManager::GetInstance().AddTimer(std::move(timer));
 }
 
+void TitleScene::DeclareAssets(AssetManifest& manifest) const
+{
+	//タイトルの背景
+	manifest.AddModel("skydome");
+	manifest.AddModel("terrain");
+
+	//パーティクル
+	manifest.AddTexture("./Resources/star.png");
+	manifest.AddTexture("./Resources/gradationLine.png");
+	manifest.AddTexture("./Resources/circle2.png");
+}
+
 void TitleScene::Initialize()
 {
 	Audio::GetInstance()->LoadWave("fanfare", "game.wav", SoundGroup::BGM);
@@ -55,6 +70,9 @@ void TitleScene::Initialize()
 
 	sceneManager_->GetCameraManager()->GetActiveCamera()->SetTranslate(Vector3(0.0f, 1.5f, -15.0f));
 
+	//環境マップ（映り込みに使うキューブマップ）
+	sceneManager_->GetObject3dCommon()->SetEnvironmentMap("./Resources/rostock_laage_airport_4k.dds");
+
 	//スカイドームの生成
 	skydome_ = std::make_unique<Object3d>();
 	skydome_->Initialize(sceneManager_->GetObject3dCommon());
@@ -75,6 +93,8 @@ void TitleScene::Initialize()
 
 	//当たり判定マネージャーの初期化
 	CollisionManager::GetInstance()->Initialize();
+	//シーンクエリマネージャーの初期化
+	SceneQueryManager::GetInstance()->Initialize();
 
 	// ステージマネージャーの生成
 	stageManager_ = std::make_unique<StageManager>();
@@ -115,6 +135,7 @@ void TitleScene::Initialize()
 void TitleScene::Finalize()
 {
 	CollisionManager::GetInstance()->Finalize();
+	SceneQueryManager::GetInstance()->Finalize();
 }
 
 void TitleScene::Update()
@@ -131,6 +152,9 @@ void TitleScene::Update()
 	// 前フレームの位置を更新
 	CollisionManager::GetInstance()->UpdatePreviousPositions();
 
+	// シーンクエリのフレーム開始（前フレームの結果を公開）
+	SceneQueryManager::GetInstance()->BeginFrame();
+
 	// カメラの更新
 	topDownCamera_->Update();
 
@@ -145,6 +169,9 @@ void TitleScene::Update()
 
 	// 衝突判定開始
 	CollisionManager::GetInstance()->CheckCollisions();
+
+	// シーンクエリを一括処理（結果は次フレームで使用）
+	SceneQueryManager::GetInstance()->Execute();
 }
 
 void TitleScene::Draw3D()
@@ -39,6 +39,8 @@ public:
 	//描画
 	void Draw3D() override;
 	void Draw2D() override;
+	//素材の宣言
+	void DeclareAssets(AssetManifest& manifest) const override;
 
 private:
 	// パーティクルエミッターの初期化
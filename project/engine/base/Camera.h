@@ -16,6 +16,10 @@ public: //ゲッター
 	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
 	Vector3 GetTranslate() const { return transform_.translate; }
 	Vector3 GetRotate() const { return transform_.rotate; }
+	float GetFovY() const { return fovY_; }
+	float GetAspectRatio() const { return aspectRatio_; }
+	float GetNearClip() const { return nearClip_; }
+	float GetFarClip() const { return farClip_; }
 
 public: //セッター
 	//水平方向視野角の設定
@@ -1,10 +1,14 @@
 #include "base/DirectXCommon.h"
 
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <format>
+#include <sstream>
 #include <thread>
 
 //自作クラス
+#include "base/JobSystem.h"
 #include "base/Logger.h"
 #include "base/StringUtility.h"
 
@@ -15,6 +19,32 @@
 #pragma comment(lib,"dxgi.lib")
 #include "externals/DirectXTex/d3dx12.h"
 
+// 古いSDKでは定義されていないので補う（Windows 10 1803以降で有効）
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+thread_local ID3D12GraphicsCommandList* DirectXCommon::threadCommandList_ = nullptr;
+
+namespace
+{
+	// アップロード用リングの容量（GPUの完了待ちのフレーム分も含む）
+	constexpr uint64_t kUploadRingSize = 32ull * 1024ull * 1024ull;
+	// リングが足りない時に追加するバッファの最小サイズ
+	constexpr uint64_t kUploadOverflowPageSize = 4ull * 1024ull * 1024ull;
+
+	// 全てのシェーダーに共通のコンパイルオプション（変えるとキャッシュのキーも変わる）
+	const wchar_t* const kShaderCompileOptions[] = {
+		L"-E", L"main",					//エントリーポイントの指定。基本的にmain以外にはしない
+		L"-Zi", L"-Qembed_debug",		//デバッグ用の情報を埋め込む
+		L"-Od",							//最適化を外しておく
+		L"-Zpr",						//メモリレイアウトは行優先
+	};
+
+	// ホットリロードでシェーダーの更新を確認する間隔
+	constexpr std::chrono::milliseconds kShaderPollInterval(500);
+}
+
 //ImGui
 //#include "externals/imgui/imgui.h"
 //#include "externals/imgui/imgui_impl_dx12.h"
@@ -23,6 +53,26 @@
 
 using namespace Microsoft::WRL;
 
+DirectXCommon::~DirectXCommon()
+{
+	//GPUが処理中のリソースを解放しないように、全てのフレームを待ってから後始末する
+	WaitForGpu();
+
+	//起動後に作ったパイプラインも次回の起動で使えるように書き出す
+	pipelineCache_.Save();
+
+	if (fenceEvent_)
+	{
+		CloseHandle(fenceEvent_);
+		fenceEvent_ = nullptr;
+	}
+	if (frameTimer_)
+	{
+		CloseHandle(frameTimer_);
+		frameTimer_ = nullptr;
+	}
+}
+
 void DirectXCommon::Initialize(WinApp* winApp)
 {
 	//Null検出
@@ -35,6 +85,8 @@ void DirectXCommon::Initialize(WinApp* winApp)
 	InitializeFixFPS();
 	//デバイスの初期化
 	InitializeDevice();
+	//パイプラインのキャッシュの初期化（前回保存したライブラリを読み込む）
+	pipelineCache_.Initialize(device_.Get());
 	//コマンド関連の初期化
 	InitializeCommand();
 	//スワップチェインの生成
@@ -55,6 +107,8 @@ void DirectXCommon::Initialize(WinApp* winApp)
 	InitializeScissorRect();
 	//DXCコンパイラの初期化
 	InitializeDXCCompiler();
+	//アップロード用リングの生成
+	CreateUploadRing();
 }
 
 void DirectXCommon::PreDraw()
@@ -141,9 +195,11 @@ void DirectXCommon::PostDraw()
 
 	/*--------------[ GPUコマンドの実行 ]-----------------*/
 
-	//GPU二コマンドリストの実行を行わせる
-	Microsoft::WRL::ComPtr<ID3D12CommandList> commandLists[] = { commandList_ };
-	commandQueue_->ExecuteCommandLists(1, commandLists->GetAddressOf());
+	//GPU二コマンドリストの実行を行わせる（並列に記録したリストも含め、並べた順に1度で送る）
+	commandQueue_->ExecuteCommandLists(static_cast<UINT>(submitCommandLists_.size()), submitCommandLists_.data());
+	lastCommandListCount_ = static_cast<uint32_t>(submitCommandLists_.size());
+	submitCommandLists_.clear();
+	parallelPassSetup_ = nullptr;
 
 	/*--------------[ GPU画面の交換を通知 ]-----------------*/
 
@@ -159,21 +215,33 @@ void DirectXCommon::PostDraw()
 
 	//GPUがここまでたどり着いたときに、Fenceの値を指定した値を代入するようにSignalを送る
 	commandQueue_->Signal(fence_.Get(), fenceValue_);
+	//このフレームが完了したかどうかはこの値で判定する
+	frameContexts_[frameIndex_].fenceValue = fenceValue_;
+
+	//このフレームで切り出したアップロード領域をフェンス値と結び付ける
+	uploadRing_.EndFrame(fenceValue_);
+	for (UploadOverflowPage& page : uploadOverflowPages_)
+	{
+		if (page.fenceValue == 0)
+		{
+			page.fenceValue = fenceValue_;
+		}
+	}
+
+	/*--------------[ 次のフレームへ ]-----------------*/
+
+	frameIndex_ = (frameIndex_ + 1) % kFrameCount;
+	++frameCount_;
 
 	/*--------------[ コマンド完了待ち ]-----------------*/
 
+	//次に使うフレームのアロケータをGPUが使い終わるまでだけ待つ
+	//（直前に送ったフレームはGPUが描画している間にCPUが次のフレームを進める）
+	WaitForFenceValue(frameContexts_[frameIndex_].fenceValue);
 
-	//Fenceの値が指定したSignal値にたどり着いているか確認する
-	//GetCompleteValueの初期値はFence制作時に渡した初期値
-	if (fence_->GetCompletedValue() < fenceValue_)
-	{
-		HANDLE fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-		//指定したSignalにたどり着いていないので、たどり着くまで待つようにイベントを設定する
-		fence_->SetEventOnCompletion(fenceValue_, fenceEvent);
-		//イベントを待つ
-		WaitForSingleObject(fenceEvent, INFINITE);
-		CloseHandle(fenceEvent);
-	}
+	//GPUが使い終わったアップロード領域を解放
+	uploadRing_.Release(fence_->GetCompletedValue());
+	ReleaseUploadOverflow(fence_->GetCompletedValue());
 
 	/*--------------[ FPS固定 ]-----------------*/
 
@@ -182,14 +250,143 @@ void DirectXCommon::PostDraw()
 	/*--------------[ コマンドアロケータのリセット ]-----------------*/
 
 	//次フレーム用のコマンドリストを準備
-	hr = commandAllocator_->Reset();
+	FrameContext& frameContext = frameContexts_[frameIndex_];
+	hr = frameContext.commandAllocator->Reset();
 	assert(SUCCEEDED(hr));
+	for (auto& threadAllocator : frameContext.threadAllocators)
+	{
+		hr = threadAllocator->Reset();
+		assert(SUCCEEDED(hr));
+	}
+	frameContext.usedCommandListCount = 0;
 
 	/*--------------[ コマンドリストのリセット ]-----------------*/
 
-	hr = commandList_->Reset(commandAllocator_.Get(), nullptr);
+	BeginMainCommandList();
+
+}
+
+void DirectXCommon::WaitForGpu()
+{
+	if (!commandQueue_ || !fence_)
+	{
+		return;
+	}
+
+	//今までに送ったコマンドの後ろにシグナルを積み、そこまで待つ
+	fenceValue_++;
+	commandQueue_->Signal(fence_.Get(), fenceValue_);
+	WaitForFenceValue(fenceValue_);
+
+	uploadRing_.Release(fence_->GetCompletedValue());
+	ReleaseUploadOverflow(fence_->GetCompletedValue());
+}
+
+void DirectXCommon::RecordParallel(uint32_t count, const std::function<void(uint32_t index)>& record)
+{
+	//並列記録の中から呼ぶと、同じアロケータで2本のリストを同時に記録してしまう
+	assert(threadCommandList_ == nullptr && "ERROR: DirectXCommon::RecordParallel() - Cannot be called while recording in parallel.");
+
+	if (count == 0)
+	{
+		return;
+	}
+	//分けないなら今のリストにそのまま記録する
+	if (count == 1)
+	{
+		record(0);
+		return;
+	}
+
+	/*--------------[ ここまでの記録を閉じ、並列に記録するリストを後ろに並べる ]-----------------*/
+
+	HRESULT hr = commandList_->Close();
+	assert(SUCCEEDED(hr));
+
+	std::vector<ID3D12GraphicsCommandList*> commandLists(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		commandLists[i] = AcquireCommandList();
+		submitCommandLists_.push_back(commandLists[i]);
+	}
+
+	/*--------------[ ワーカースレッドで記録 ]-----------------*/
+
+	FrameContext& frameContext = frameContexts_[frameIndex_];
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	JobCounter counter;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		jobSystem->Submit([&, i]()
+			{
+				//アロケータは同時に1本のリストでしか記録できないので、スレッドごとのものを使う
+				ID3D12CommandAllocator* allocator = frameContext.threadAllocators[JobSystem::GetCurrentThreadIndex()].Get();
+				ID3D12GraphicsCommandList* commandList = commandLists[i];
+				HRESULT resetResult = commandList->Reset(allocator, nullptr);
+				assert(SUCCEEDED(resetResult));
+
+				threadCommandList_ = commandList;
+				if (parallelPassSetup_)
+				{
+					parallelPassSetup_();
+				}
+				record(i);
+				threadCommandList_ = nullptr;
+
+				HRESULT closeResult = commandList->Close();
+				assert(SUCCEEDED(closeResult));
+			}, &counter);
+	}
+	//待っている間はメインスレッドも記録を手伝う
+	jobSystem->Wait(counter);
+
+	/*--------------[ 続きは新しいリストに記録する ]-----------------*/
+
+	BeginMainCommandList();
+	//描画先などは引き継がないので設定し直す
+	if (parallelPassSetup_)
+	{
+		parallelPassSetup_();
+	}
+}
+
+ID3D12GraphicsCommandList* DirectXCommon::AcquireCommandList()
+{
+	FrameContext& frameContext = frameContexts_[frameIndex_];
+	if (frameContext.usedCommandListCount == frameContext.commandLists.size())
+	{
+		//足りなければ作る（記録中のリストがない時に呼ぶので、このフレームのアロケータで作ってすぐに閉じる）
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+		HRESULT hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frameContext.commandAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList));
+		//コマンドリストの生成がうまくいかなかった
+		assert(SUCCEEDED(hr));
+		hr = commandList->Close();
+		assert(SUCCEEDED(hr));
+		frameContext.commandLists.push_back(commandList);
+	}
+	return frameContext.commandLists[frameContext.usedCommandListCount++].Get();
+}
+
+void DirectXCommon::BeginMainCommandList()
+{
+	commandList_ = AcquireCommandList();
+	HRESULT hr = commandList_->Reset(frameContexts_[frameIndex_].commandAllocator.Get(), nullptr);
 	assert(SUCCEEDED(hr));
+	submitCommandLists_.push_back(commandList_);
+}
 
+void DirectXCommon::WaitForFenceValue(uint64_t fenceValue)
+{
+	//Fenceの値が指定したSignal値にたどり着いているか確認する
+	//GetCompleteValueの初期値はFence制作時に渡した初期値
+	if (fence_->GetCompletedValue() < fenceValue)
+	{
+		//指定したSignalにたどり着いていないので、たどり着くまで待つようにイベントを設定する
+		HRESULT hr = fence_->SetEventOnCompletion(fenceValue, fenceEvent_);
+		assert(SUCCEEDED(hr));
+		//イベントを待つ
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
 }
 
 void DirectXCommon::InitializeDevice()
@@ -265,6 +462,19 @@ void DirectXCommon::InitializeDevice()
 	assert(device_ != nullptr);
 	Logger::Log("Complete create D3D12Device!!!");//初期化完了のログを出す
 
+	/*--------------[ リソースバインディングの階層を確認 ]-----------------*/
+
+	//テクスチャのテーブルはSRVヒープ全体を指す上限なしの範囲（NumDescriptors = UINT_MAX）なので、Tier2以上が必要
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+	hr = device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+	assert(SUCCEEDED(hr));
+	Logger::Log(std::format("ResourceBindingTier : {}\n", static_cast<int>(options.ResourceBindingTier)));
+	if (options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+	{
+		Logger::Log("ERROR: This GPU supports only resource binding tier 1. Bindless texture tables require tier 2 or higher.\n");
+		assert(false && "ERROR: DirectXCommon::InitializeDevice() - Resource binding tier 2 or higher is required.");
+	}
+
 	/*--------------[ エラー時にブレークを発生させる設定 ]-----------------*/
 
 #ifdef _DEBUG
@@ -305,16 +515,27 @@ void DirectXCommon::InitializeCommand()
 
 	/*--------------[ コマンドアロケータの生成 ]-----------------*/
 
+	//GPUが前のフレームを処理している間に次のフレームを記録できるよう、フレームの数だけ作る
+	//並列記録用には、メインスレッド（ジョブを手伝う時）とワーカースレッドの分も作る
+	const uint32_t threadCount = JobSystem::GetInstance()->GetThreadCount() + 1;
+	for (FrameContext& frameContext : frameContexts_)
+	{
+		hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&frameContext.commandAllocator));
+		//コマンドアロケータの生成がうまくいかなかったので起動できない
+		assert(SUCCEEDED(hr));
 
-	hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	//コマンドアロケータの生成がうまくいかなかったので起動できない
-	assert(SUCCEEDED(hr));
+		frameContext.threadAllocators.resize(threadCount);
+		for (auto& threadAllocator : frameContext.threadAllocators)
+		{
+			hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&threadAllocator));
+			assert(SUCCEEDED(hr));
+		}
+	}
 
 	/*--------------[ コマンドリストの生成 ]-----------------*/
 
-	hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr, IID_PPV_ARGS(&commandList_));
-	//コマンドリストの生成がうまくいかなかったので起動できない
-	assert(SUCCEEDED(hr));
+	//初期化中の転送なども最初のフレームのリストに記録する
+	BeginMainCommandList();
 
 	/*--------------[ コマンドキューの生成 ]-----------------*/
 
@@ -468,9 +689,9 @@ void DirectXCommon::CreateFence()
 	hr = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
 	assert(SUCCEEDED(hr));
 
-	////FenceのSignalを待つためのイベントを作成する
-	//fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
-	//assert(fenceEvent_ != nullptr);
+	//FenceのSignalを待つためのイベントを作成する（毎フレーム使い回す）
+	fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
+	assert(fenceEvent_ != nullptr);
 }
 
 void DirectXCommon::InitializeViewPort()
@@ -519,6 +740,14 @@ void DirectXCommon::InitializeFixFPS()
 {
 	//現在時間を記録する
 	reference_ = std::chrono::steady_clock::now();
+
+	//待機用のタイマーを作る。高精度タイマーが使えない環境では通常のタイマーにする
+	frameTimer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!frameTimer_)
+	{
+		Logger::Log("DirectXCommon: high resolution waitable timer is not available. Falling back to a normal timer.\n");
+		frameTimer_ = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	}
 }
 
 void DirectXCommon::UpdateFixFPS()
@@ -536,11 +765,20 @@ void DirectXCommon::UpdateFixFPS()
 	// 1/60(よりわずかに短い時間) 経っていない場合
 	if(elapsed < kMinCheckTime)
 	{
-		// 1/60秒経過するまで微小なスリープを繰り返す
+		// 残り時間をタイマーでまとめて待つ（相対時間は100ナノ秒単位の負の値で指定する）
+		if (frameTimer_)
+		{
+			LARGE_INTEGER dueTime{};
+			dueTime.QuadPart = -static_cast<LONGLONG>((kMinTime - elapsed).count()) * 10;
+			if (SetWaitableTimer(frameTimer_, &dueTime, 0, nullptr, nullptr, FALSE))
+			{
+				WaitForSingleObject(frameTimer_, INFINITE);
+			}
+		}
+		// タイマーの誤差で残ったわずかな時間だけCPUを譲りながら待つ
 		while(std::chrono::steady_clock::now() - reference_ < kMinTime)
 		{
-			//1マイクロ秒スリープ
-			std::this_thread::sleep_for(std::chrono::microseconds(1));
+			std::this_thread::yield();
 		}
 	}
 	//現在時間の記録をする
@@ -605,6 +843,184 @@ D3D12_GPU_DESCRIPTOR_HANDLE DirectXCommon::GetGPUDescriptorHandle(Microsoft::WRL
 }
 
 Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileSharder(const std::wstring& filePath, const wchar_t* profile)
+{
+	Microsoft::WRL::ComPtr<IDxcBlob> shaderBlob = LoadOrCompileShader(filePath, profile);
+	//警告・エラーダメ絶対
+	assert(shaderBlob != nullptr && "ERROR: DirectXCommon::CompileSharder() - Failed to compile shader.");
+	return shaderBlob;
+}
+
+void DirectXCommon::AddShaderReloadListener(const std::vector<std::wstring>& shaderPaths, std::function<void()> onReload)
+{
+	shaderReloadListeners_.push_back({ shaderPaths, std::move(onReload) });
+}
+
+void DirectXCommon::UpdateShaderHotReload()
+{
+#ifdef _DEBUG
+	//ファイルの更新日時の確認は毎フレームは要らないので間引く
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastShaderPollTime_ < kShaderPollInterval)
+	{
+		return;
+	}
+	lastShaderPollTime_ = now;
+
+	std::vector<ShaderCache::Watcher::Target> changed = shaderWatcher_.CollectChanged();
+	if (changed.empty())
+	{
+		return;
+	}
+
+	//先に変更されたシェーダーをコンパイルしてキャッシュを更新する（作り直しの中のCompileSharderはキャッシュから読む）
+	//失敗したものは今のパイプラインのまま残し、直して保存し直せばもう一度試す
+	std::vector<ShaderCache::Watcher::Target> compiled;
+	std::vector<ShaderCache::Watcher::Target> failed;
+	for (const auto& target : changed)
+	{
+		Logger::Log(StringUtility::ConvertString(std::format(L"Shader changed, path:{}, profile:{}\n", target.filePath, target.profile)));
+		if (LoadOrCompileShader(target.filePath, target.profile.c_str()) == nullptr)
+		{
+			Logger::Log(StringUtility::ConvertString(std::format(L"WARNING: Shader hot reload skipped because of compile errors, path:{}\n", target.filePath)));
+			failed.push_back(target);
+		}
+		else
+		{
+			compiled.push_back(target);
+		}
+	}
+	if (compiled.empty())
+	{
+		return;
+	}
+
+	//リスナーが使うシェーダーに、コンパイルできたものと失敗したものがあるか
+	auto usesAny = [](const ShaderReloadListener& listener, const std::vector<ShaderCache::Watcher::Target>& targets)
+	{
+		for (const auto& target : targets)
+		{
+			for (const std::wstring& path : listener.shaderPaths)
+			{
+				if (std::filesystem::path(path).lexically_normal() == std::filesystem::path(target.filePath).lexically_normal())
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	//GPUが今のパイプラインを使い終わってから作り直す
+	WaitForGpu();
+	pipelineCache_.BeginHotReload();
+	for (const auto& listener : shaderReloadListeners_)
+	{
+		//失敗したシェーダーを使うパイプラインは作り直せないので、今のまま残す
+		if (usesAny(listener, compiled) && !usesAny(listener, failed))
+		{
+			listener.onReload();
+		}
+	}
+	//置き換えられた古いパイプラインを捨てる（作り直したものはライブラリに保存しない）
+	const uint32_t evictedCount = pipelineCache_.EndHotReload();
+	Logger::Log(std::format("Shader hot reload completed ({} shaders, {} failed, {} pipelines evicted)\n", compiled.size(), failed.size(), evictedCount));
+#endif
+}
+
+void DirectXCommon::LogShaderCompileReport() const
+{
+	uint64_t total = 0;
+	uint64_t totalCompile = 0;
+	uint32_t cacheCount = 0;
+	std::stringstream ss;
+	ss << "Shader compile report\n";
+	for (const ShaderRecord& record : shaderRecords_)
+	{
+		ss << "  " << StringUtility::ConvertString(record.filePath) << " " << StringUtility::ConvertString(record.profile)
+			<< (record.isFromCache ? " [cache] " : " [dxc] ") << record.microseconds / 1000.0 << "ms";
+		if (record.isFromCache)
+		{
+			ss << " (dxc " << record.compileMicroseconds / 1000.0 << "ms)";
+			++cacheCount;
+		}
+		ss << "\n";
+		total += record.microseconds;
+		totalCompile += record.compileMicroseconds;
+	}
+	//全てキャッシュから読めていればウォームスタート
+	ss << "  " << (cacheCount == shaderRecords_.size() ? "warm" : "cold") << " start: " << cacheCount << "/" << shaderRecords_.size()
+		<< " from cache, total " << total / 1000.0 << "ms, dxc compile " << totalCompile / 1000.0 << "ms\n";
+	Logger::Log(ss.str());
+}
+
+Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::LoadOrCompileShader(const std::wstring& filePath, const wchar_t* profile)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	auto elapsedMicroseconds = [&startTime]()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+	};
+
+	///===================================================================
+	///1.キャッシュを探す
+	///===================================================================
+
+	//キーにはソースとインクルードしたファイルの中身、プロファイル、コンパイルオプションを全て含める
+	const std::string sourcePath = StringUtility::ConvertString(filePath);
+	const std::vector<std::string> dependencies = ShaderCache::CollectDependencies(sourcePath);
+	const uint64_t key = ShaderCache::MakeKey(dependencies, profile, std::vector<std::wstring>(std::begin(kShaderCompileOptions), std::end(kShaderCompileOptions)));
+	const std::string cachePath = ShaderCache::MakeCachePath(sourcePath, profile);
+
+	//変更を見張る（コンパイルに失敗しても、直して保存したら気付けるように先に記録する）
+	shaderWatcher_.Watch(filePath, profile, dependencies);
+
+	std::vector<uint8_t> bytecode;
+	ShaderCache::LoadInfo cacheInfo;
+	if (key != 0 && ShaderCache::Load(cachePath, key, bytecode, &cacheInfo))
+	{
+		//IDxcBlobとして返すために、読んだバイナリを写したBlobを作る
+		Microsoft::WRL::ComPtr<IDxcBlobEncoding> cachedBlob = nullptr;
+		HRESULT hr = dxcUtils_->CreateBlob(bytecode.data(), static_cast<UINT32>(bytecode.size()), DXC_CP_ACP, &cachedBlob);
+		if (SUCCEEDED(hr))
+		{
+			RecordShaderLoad(filePath, profile, true, elapsedMicroseconds(), cacheInfo.compileMicroseconds);
+			return cachedBlob;
+		}
+	}
+
+	///===================================================================
+	///2.なければコンパイルしてキャッシュに書き出す
+	///===================================================================
+
+	Microsoft::WRL::ComPtr<IDxcBlob> shaderBlob = CompileShaderSource(filePath, profile);
+	if (shaderBlob == nullptr)
+	{
+		return nullptr;
+	}
+
+	const uint64_t compileMicroseconds = elapsedMicroseconds();
+	if (key != 0 && !ShaderCache::Save(cachePath, key, shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(), compileMicroseconds))
+	{
+		Logger::Log("WARNING: Failed to write shader cache: " + cachePath + "\n");
+	}
+	RecordShaderLoad(filePath, profile, false, compileMicroseconds, compileMicroseconds);
+	return shaderBlob;
+}
+
+void DirectXCommon::RecordShaderLoad(const std::wstring& filePath, const wchar_t* profile, bool isFromCache, uint64_t microseconds, uint64_t compileMicroseconds)
+{
+	//パスとプロファイルの組ごとに最初の読み込みだけ残す（複数のパイプラインで共有したり、ホットリロードで読み直しても増えない）
+	for (const ShaderRecord& record : shaderRecords_)
+	{
+		if (record.filePath == filePath && record.profile == profile)
+		{
+			return;
+		}
+	}
+	shaderRecords_.push_back({ filePath, profile, isFromCache, microseconds, compileMicroseconds });
+}
+
+Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileShaderSource(const std::wstring& filePath, const wchar_t* profile)
 {
 	///===================================================================
 	///1.hlslファイルを読む
@@ -613,10 +1029,14 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileSharder(const std::wstrin
 	//これからシェーダーをコンパイルする旨をログに出す
 	Logger::Log(StringUtility::ConvertString(std::format(L"Begin CompileSharder, path:{}, profile:{}\n", filePath, profile)));
 	//hlslファイルを読む
-	IDxcBlobEncoding* shaderSource = nullptr;
+	Microsoft::WRL::ComPtr<IDxcBlobEncoding> shaderSource = nullptr;
 	HRESULT hr = dxcUtils_->LoadFile(filePath.c_str(), nullptr, &shaderSource);
 	//読めなかったら止める
-	assert(SUCCEEDED(hr));
+	if (FAILED(hr))
+	{
+		Logger::Log(StringUtility::ConvertString(std::format(L"ERROR: Failed to load shader, path:{}\n", filePath)));
+		return nullptr;
+	}
 	//読み込んだファイルの内容を設定する
 	DxcBuffer shaderSourceBuffer;
 	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
@@ -627,21 +1047,16 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileSharder(const std::wstrin
 	///2.コンパイルする
 	///===================================================================
 
-	LPCWSTR arguments[] = {
-		filePath.c_str(),				//コンパイル対称のhlslファイル名
-		L"-E", L"main",					//エントリーポイントの指定。基本的にmain以外にはしない
-		L"-T", profile,					//Sharderprofileの設定
-		L"-Zi", L"-Qembed_debug",		//デバッグ用の情報を埋め込む
-		L"-Od",							//最適化を外しておく
-		L"-Zpr",						//メモリレイアウトは行優先
-	};
+	//コンパイル対称のhlslファイル名、Sharderprofileの設定、共通のオプションの順に並べる
+	std::vector<LPCWSTR> arguments = { filePath.c_str(), L"-T", profile };
+	arguments.insert(arguments.end(), std::begin(kShaderCompileOptions), std::end(kShaderCompileOptions));
 
 	//実際にシェーダーをコンパイルする
-	IDxcResult* shaderResult = nullptr;
+	Microsoft::WRL::ComPtr<IDxcResult> shaderResult = nullptr;
 	hr = dxcCompiler_->Compile(
 		&shaderSourceBuffer,
-		arguments,
-		_countof(arguments),
+		arguments.data(),
+		static_cast<UINT32>(arguments.size()),
 		includeHandler_.Get(),
 		IID_PPV_ARGS(&shaderResult)
 	);
@@ -653,14 +1068,13 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileSharder(const std::wstrin
 	///3.警告・エラーが出ていないか確認する
 	///===================================================================
 
-	//警告・エラーが出てたらログに出して止める
-	IDxcBlobUtf8* shaderError = nullptr;
+	//警告・エラーが出てたらログに出して失敗にする
+	Microsoft::WRL::ComPtr<IDxcBlobUtf8> shaderError = nullptr;
 	shaderResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&shaderError), nullptr);
 	if (shaderError != nullptr && shaderError->GetStringLength() != 0)
 	{
 		Logger::Log(shaderError->GetStringPointer());
-		//警告・エラーダメ絶対
-		assert(SUCCEEDED(false));
+		return nullptr;
 	}
 
 
@@ -669,14 +1083,11 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileSharder(const std::wstrin
 	///===================================================================
 
 	//コンパイル結果から実行用のバイナリ部分を取得
-	IDxcBlob* shaderBlob = nullptr;
+	Microsoft::WRL::ComPtr<IDxcBlob> shaderBlob = nullptr;
 	hr = shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
 	assert(SUCCEEDED(hr));
 	//成功したログを出す
 	Logger::Log(StringUtility::ConvertString(std::format(L"Compile Succeeded, path:{}, profile:{}\n", filePath, profile)));
-	//もう使わないリソースを解放
-	shaderSource->Release();
-	shaderResult->Release();
 	//実行用のバイナリを返却
 	return shaderBlob;
 }
@@ -706,6 +1117,75 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateBufferResource(size_
 	return bufferResource;
 }
 
+UploadAllocation DirectXCommon::AllocateUpload(size_t sizeInBytes, size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(uploadMutex_);
+	uint64_t offset = uploadRing_.Allocate(sizeInBytes, alignment);
+	if (offset == UploadRingAllocator::kInvalidOffset)
+	{
+		//リングに収まらない分は追加のバッファに回す（nullを返すと呼び出し側が書き込めない）
+		return AllocateUploadOverflow(sizeInBytes, alignment);
+	}
+
+	UploadAllocation allocation;
+	allocation.cpuAddress = uploadRingData_ + offset;
+	allocation.gpuAddress = uploadRingResource_->GetGPUVirtualAddress() + offset;
+	return allocation;
+}
+
+UploadAllocation DirectXCommon::AllocateUploadOverflow(size_t sizeInBytes, size_t alignment)
+{
+	//今フレームで使っているバッファに空きがあればそこから切り出す
+	for (UploadOverflowPage& page : uploadOverflowPages_)
+	{
+		if (page.fenceValue != 0)
+		{
+			continue;
+		}
+		uint64_t offset = (page.head + alignment - 1) & ~(static_cast<uint64_t>(alignment) - 1);
+		if (offset + sizeInBytes <= page.size)
+		{
+			page.head = offset + sizeInBytes;
+			UploadAllocation allocation;
+			allocation.cpuAddress = page.data + offset;
+			allocation.gpuAddress = page.resource->GetGPUVirtualAddress() + offset;
+			return allocation;
+		}
+	}
+
+	//無ければ新しく作る（バッファの先頭は64KB境界なので、アライメントはそのまま満たす）
+	UploadOverflowPage page;
+	page.size = (std::max)(kUploadOverflowPageSize, static_cast<uint64_t>(sizeInBytes));
+	page.resource = CreateBufferResource(page.size);
+	HRESULT hr = page.resource->Map(0, nullptr, reinterpret_cast<void**>(&page.data));
+	assert(SUCCEEDED(hr));
+	page.head = sizeInBytes;
+	Logger::Log(std::format("Upload ring is exhausted. Added an overflow buffer. size:{} used:{}/{} pages:{}\n",
+							sizeInBytes, uploadRing_.GetUsedSize(), uploadRing_.GetCapacity(), uploadOverflowPages_.size() + 1));
+
+	UploadAllocation allocation;
+	allocation.cpuAddress = page.data;
+	allocation.gpuAddress = page.resource->GetGPUVirtualAddress();
+	uploadOverflowPages_.push_back(std::move(page));
+	return allocation;
+}
+
+void DirectXCommon::ReleaseUploadOverflow(uint64_t completedFenceValue)
+{
+	std::erase_if(uploadOverflowPages_, [completedFenceValue](const UploadOverflowPage& page)
+		{
+			return page.fenceValue != 0 && page.fenceValue <= completedFenceValue;
+		});
+}
+
+void DirectXCommon::CreateUploadRing()
+{
+	//大きなアップロードバッファを1つ作り、常にMapしておく
+	uploadRingResource_ = CreateBufferResource(kUploadRingSize);
+	uploadRingResource_->Map(0, nullptr, reinterpret_cast<void**>(&uploadRingData_));
+	uploadRing_.Initialize(kUploadRingSize);
+}
+
 Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateTextureResource(const DirectX::TexMetadata& metadata)
 {
 	D3D12_RESOURCE_DESC resourceDesc{};
@@ -744,7 +1224,7 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::UploadTextureData(Microsof
 	DirectX::PrepareUpload(device_.Get(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
 	uint64_t intermediateSize = GetRequiredIntermediateSize(texture.Get(), 0, UINT(subresources.size()));
 	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource = CreateBufferResource(intermediateSize);
-	UpdateSubresources(commandList_.Get(), texture.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
+	UpdateSubresources(commandList_, texture.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
 	//Textureへの転送後は利用できるよう、D3D12_RESOURCE_STATE_COPY_DESTからD3D12_RESOURCE_STATE_GENERI_READへResourceStateを変更する
 	D3D12_RESOURCE_BARRIER barrier{};
 	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
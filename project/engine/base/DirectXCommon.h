@@ -1,20 +1,39 @@
 #pragma once
 #include <array>
 #include <chrono>
+#include <cstring>
 #include <d3d12.h>
 #include <dxcapi.h>
 #include <dxgi1_6.h>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <wrl.h>
 
+#include "base/PipelineCache.h"
+#include "base/ShaderCache.h"
+#include "base/UploadRingAllocator.h"
 #include "base/WinApp.h"
 #include "externals/DirectXTex/DirectXTex.h"
 #include "math/Vector4.h"
 
+// アップロード用リングから切り出した領域
+struct UploadAllocation
+{
+	void* cpuAddress = nullptr;					// 書き込み先
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;	// シェーダーから参照するアドレス
+};
 
 class DirectXCommon
 {
+public: //定数
+	// 同時に処理中にできるフレーム数（CPUが記録するフレームとGPUが描画中のフレーム）
+	static constexpr uint32_t kFrameCount = 2;
+
 public: //メンバ関数
+	~DirectXCommon();
+
 	//初期化
 	void Initialize(WinApp *winApp);
 
@@ -24,11 +43,53 @@ public: //メンバ関数
 	//描画後処理
 	void PostDraw();
 
+	/// \brief GPUが全てのコマンドを処理し終えるまで待つ
+	/// \note 毎フレームは呼ばない。終了時や、GPUが使用中のリソースを解放する前に使う
+	void WaitForGpu();
+
 	/// \brief バッファリソースの生成
 	/// \param sizeInBytes 
 	/// \return 
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateBufferResource(size_t sizeInBytes);
 
+	/**
+	 * \brief 今フレームだけ使うアップロード領域を切り出す
+	 * \note GPUがフレームを使い終わると自動で再利用されるので、毎フレーム書き直すデータに使う
+	 *       リングが足りない時は追加のバッファから切り出すので、常に書き込める領域を返す
+	 * \param sizeInBytes バイト数
+	 * \param alignment 先頭のアライメント（定数バッファは256）
+	 */
+	UploadAllocation AllocateUpload(size_t sizeInBytes, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/**
+	 * \brief 定数データをアップロード領域に書き込む
+	 * \return 書き込んだ領域のGPUアドレス
+	 */
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS UploadConstant(const T& data)
+	{
+		UploadAllocation allocation = AllocateUpload(sizeof(T));
+		std::memcpy(allocation.cpuAddress, &data, sizeof(T));
+		return allocation.gpuAddress;
+	}
+
+	/**
+	 * \brief コマンドリストを分けて、ワーカースレッドで並列に記録する（全て記録し終えるまで待つ）
+	 * \note index番目の記録は専用のコマンドリストに行い、リストは呼んだ位置にindexの順で差し込まれる（記録し終えた順ではない）
+	 *       記録中はそのスレッドのGetCommandListがそのリストを返す。描画先などは引き継がないので、先頭でSetParallelPassSetupの設定を呼ぶ。
+	 *       ルートシグネチャやパイプラインはrecordの中で設定し直すこと。呼んだ後の続きのリストにも描画先の設定だけを呼び直す
+	 *       記録の中でテクスチャの読み込みやSRVの確保はしないこと（ヒープが作り直されると他のリストと食い違う）
+	 * \param count 分ける数（1なら今のリストにそのまま記録する）
+	 * \param record index番目（0～count-1）の記録
+	 */
+	void RecordParallel(uint32_t count, const std::function<void(uint32_t index)>& record);
+
+	/**
+	 * \brief 並列に記録するリストの先頭で呼ぶ、描画パスの共通設定（ディスクリプタヒープ・描画先など）
+	 * \note 描画先を切り替えたら設定し直す。PostDrawで解除される
+	 */
+	void SetParallelPassSetup(std::function<void()> setup) { parallelPassSetup_ = std::move(setup); }
+
 	/// \brief テクスチャリソースの生成
 	/// \param metadata 
 	/// \return 
@@ -41,11 +102,29 @@ public: //メンバ関数
 	Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages);
 
 	/// \brief シェーダーのコンパイル
+	/// \note ソース・インクルード・プロファイル・オプションが前回と同じなら、キャッシュのバイナリを読むだけで済ませる
 	/// \param filePath 
 	/// \param profile 
 	/// \return 
 	Microsoft::WRL::ComPtr<IDxcBlob> CompileSharder(const std::wstring& filePath, const wchar_t* profile);
 
+	/**
+	 * \brief シェーダーが変更された時に呼ぶ処理を登録する（開発中のホットリロード用）
+	 * \note アプリの終了まで生きているクラスのパイプラインを作り直すのに使う
+	 * \param shaderPaths 使っているシェーダー（CompileSharderに渡すのと同じパス）
+	 * \param onReload パイプラインを作り直す処理（中でCompileSharderを呼べば、更新済みのキャッシュから読まれる）
+	 */
+	void AddShaderReloadListener(const std::vector<std::wstring>& shaderPaths, std::function<void()> onReload);
+
+	/**
+	 * \brief 変更されたシェーダーをコンパイルし直し、登録した処理を呼ぶ（_DEBUGのみ。毎フレーム呼んでよい）
+	 * \note コンパイルに失敗した時はログに出して、今のパイプラインのまま続ける
+	 */
+	void UpdateShaderHotReload();
+
+	/// \brief シェーダーごとのコンパイル時間とキャッシュの使用状況をログに出す
+	void LogShaderCompileReport() const;
+
 	/**
 	 * \brief ディスクリプタヒープの生成
 	 * \param heapType 
@@ -62,8 +141,17 @@ public://アクセッサ
 	/// \return 
 	ID3D12Device* GetDevice() { return device_.Get(); }
 
-	//コマンドリストの取得
-	ID3D12GraphicsCommandList* GetCommandList() { return commandList_.Get(); }
+	//コマンドリストの取得（RecordParallelの記録中は、そのスレッドが記録しているリスト）
+	ID3D12GraphicsCommandList* GetCommandList() { return threadCommandList_ ? threadCommandList_ : commandList_; }
+
+	//直近のフレームでまとめて実行したコマンドリストの数
+	uint32_t GetLastCommandListCount() const { return lastCommandListCount_; }
+
+	//記録中のフレームの番号（0～kFrameCount-1）。フレームごとに持つリソースの添字に使う
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+
+	//記録中のフレームの通し番号（PostDrawのたびに1つ進む）
+	uint64_t GetFrameCount() const { return frameCount_; }
 
 	//DXCコンパイラの取得
 	IDxcCompiler3* GetDXCCompiler() { return dxcCompiler_.Get(); }
@@ -108,6 +196,17 @@ public://アクセッサ
 	}
 
 	D3D12_CPU_DESCRIPTOR_HANDLE GetDSVHandle() { return dsvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(); }
+
+	//アップロード用リングの取得
+	const UploadRingAllocator& GetUploadRing() const { return uploadRing_; }
+
+	//ルートシグネチャとパイプラインステートのキャッシュ（同じ記述のものを共有する）
+	PipelineCache* GetPipelineCache() { return &pipelineCache_; }
+
+	//最後にシグナルを積んだフェンス値（PostDrawの後なら、送ったばかりのフレームの値）
+	uint64_t GetLastSignaledFenceValue() const { return fenceValue_; }
+	//GPUが完了したフェンス値
+	uint64_t GetCompletedFenceValue() const { return fence_->GetCompletedValue(); }
 	
 private: //メンバ関数
 	/// \brief デバイスの初期化
@@ -132,6 +231,27 @@ private: //メンバ関数
 	void InitializeScissorRect();
 	// DXCコンパイラの初期化
 	void InitializeDXCCompiler();
+	/// \brief アップロード用リングの生成
+	void CreateUploadRing();
+	/// \brief リングが足りない時に、追加のアップロードバッファから切り出す（uploadMutex_を取ってから呼ぶ）
+	UploadAllocation AllocateUploadOverflow(size_t sizeInBytes, size_t alignment);
+	/// \brief GPUが使い終わった追加のアップロードバッファを解放する
+	void ReleaseUploadOverflow(uint64_t completedFenceValue);
+	/// \brief このフレームのコマンドリストを1本取り出す（足りなければ作る。閉じた状態で返す）
+	ID3D12GraphicsCommandList* AcquireCommandList();
+	/// \brief メインスレッドで記録するリストを新しく始め、実行する順に並べる
+	void BeginMainCommandList();
+	/// \brief 指定したフェンス値にGPUが到達するまで待つ
+	void WaitForFenceValue(uint64_t fenceValue);
+	/**
+	 * \brief キャッシュを確認して、なければDXCでコンパイルする
+	 * \return 失敗した時はnullptr（エラーはログに出す）
+	 */
+	Microsoft::WRL::ComPtr<IDxcBlob> LoadOrCompileShader(const std::wstring& filePath, const wchar_t* profile);
+	/// \brief DXCでコンパイルする（失敗した時はnullptr）
+	Microsoft::WRL::ComPtr<IDxcBlob> CompileShaderSource(const std::wstring& filePath, const wchar_t* profile);
+	/// \brief 起動時間の内訳に記録する（同じパスとプロファイルは最初の1回だけ）
+	void RecordShaderLoad(const std::wstring& filePath, const wchar_t* profile, bool isFromCache, uint64_t microseconds, uint64_t compileMicroseconds);
 	/// \brief FPS固定初期化
 	void InitializeFixFPS();
 	/// \brief FPS固定更新
@@ -146,10 +266,31 @@ private: //メンバ変数
 	Microsoft::WRL::ComPtr<ID3D12Device> device_;
 	//DXGIファクトリー
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory_;
-	//コマンドアロケータ
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator_ = nullptr;
-	//コマンドリスト
-	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_ = nullptr;
+	//フレームごとのコマンド記録用データ
+	struct FrameContext
+	{
+		//コマンドアロケータ（GPUがこのフレームを処理し終えるまでリセットできない）
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator = nullptr;
+		//並列記録用のスレッドごとのアロケータ（添字はJobSystem::GetCurrentThreadIndex()）
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> threadAllocators;
+		//このフレームで使い回すコマンドリストと、今フレームに使った数
+		std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> commandLists;
+		uint32_t usedCommandListCount = 0;
+		//このフレームの完了時にシグナルされるフェンス値
+		uint64_t fenceValue = 0;
+	};
+	std::array<FrameContext, kFrameCount> frameContexts_;
+	uint32_t frameIndex_ = 0;
+	uint64_t frameCount_ = 0;
+	//メインスレッドで記録中のコマンドリスト
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+	//RecordParallelで記録中のスレッドのコマンドリスト
+	static thread_local ID3D12GraphicsCommandList* threadCommandList_;
+	//今フレームに実行するコマンドリスト（実行する順）
+	std::vector<ID3D12CommandList*> submitCommandLists_;
+	uint32_t lastCommandListCount_ = 0;
+	//並列に記録するリストの先頭で呼ぶ設定
+	std::function<void()> parallelPassSetup_;
 	//コマンドキュー
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue_ = nullptr;
 	//スワップチェイン
@@ -175,7 +316,7 @@ private: //メンバ変数
 	//フェンス
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence_ = nullptr;
 	uint64_t fenceValue_ = 0;
-	//HANDLE fenceEvent_;
+	HANDLE fenceEvent_ = nullptr;
 	//ビューポート
 	D3D12_VIEWPORT viewport_{};
 	//シザー矩形
@@ -186,9 +327,47 @@ private: //メンバ変数
 	Microsoft::WRL::ComPtr<IDxcCompiler3> dxcCompiler_ = nullptr;
 	//インクルードハンドラ
 	Microsoft::WRL::ComPtr<IDxcIncludeHandler> includeHandler_ = nullptr;
+	//シェーダーごとの読み込み記録（起動時間の内訳）
+	struct ShaderRecord
+	{
+		std::wstring filePath;
+		std::wstring profile;
+		bool isFromCache = false;
+		uint64_t microseconds = 0;			//CompileSharderにかかった時間
+		uint64_t compileMicroseconds = 0;	//DXCでのコンパイル時間（キャッシュの時は作った時の値）
+	};
+	std::vector<ShaderRecord> shaderRecords_;	//パスとプロファイルの組ごとに1件
+	//ホットリロード
+	struct ShaderReloadListener
+	{
+		std::vector<std::wstring> shaderPaths;
+		std::function<void()> onReload;
+	};
+	std::vector<ShaderReloadListener> shaderReloadListeners_;
+	ShaderCache::Watcher shaderWatcher_;
+	std::chrono::steady_clock::time_point lastShaderPollTime_;
+	//ルートシグネチャとパイプラインステートのキャッシュ（デバイスより先に破棄する）
+	PipelineCache pipelineCache_;
+	//アップロード用リング
+	Microsoft::WRL::ComPtr<ID3D12Resource> uploadRingResource_ = nullptr;
+	uint8_t* uploadRingData_ = nullptr;
+	UploadRingAllocator uploadRing_;
+	std::mutex uploadMutex_;	//並列記録中はワーカースレッドからも切り出す
+	//リングが足りない時に使う追加のアップロードバッファ
+	struct UploadOverflowPage
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		uint8_t* data = nullptr;
+		uint64_t size = 0;
+		uint64_t head = 0;			//次に書き込む位置
+		uint64_t fenceValue = 0;	//使い終わりを判定するフェンス値（0なら今フレームで使用中）
+	};
+	std::vector<UploadOverflowPage> uploadOverflowPages_;
 	//リソースバリア
 	D3D12_RESOURCE_BARRIER barrier_{};
+	//FPS固定用
 	std::chrono::steady_clock::time_point reference_;
+	HANDLE frameTimer_ = nullptr;	//高精度の待機可能タイマー
 	//レンダーテクスチャのクリア値
 	D3D12_CLEAR_VALUE clearValue_;
 };
@@ -23,7 +23,16 @@ struct LineVertex
 {
     Vector3 position;                            // 位置
     Vector4 color;                               // 色
-	Vector3 worldPos;                            // ワールド座標
+};
+
+/**
+ * \brief スプライトの頂点データ（座標はクリップ空間に変換済み）
+ */
+struct SpriteVertex
+{
+    Vector4 position;                            // 位置
+    Vector2 texcoord;                            // テクスチャ座標
+    Vector4 color;                               // 色
 };
 
 /**
@@ -37,7 +46,8 @@ struct Material
     Matrix4x4 uvTransform;                       // UV変換行列
     float shininess;                             // 反射強度
 	float reflectivity;                         // 反射率
-    float padding2[2];                           // 12バイト（アラインメント用）
+    uint32_t textureIndex;                       // テクスチャのSRVの番号（ヒープ全体を指すテーブルの添字）
+    float padding2;                              // 4バイト（アラインメント用）
 };
 
 /**
@@ -50,6 +60,16 @@ struct TransformationMatrix
     Matrix4x4 WorldInverseTranspose;             // ワールド逆転置行列
 };
 
+/**
+ * \brief インスタンス描画1つ分のデータ
+ */
+struct InstanceData
+{
+    TransformationMatrix transform;              // 座標変換行列
+    uint32_t materialIndex;                      // マテリアルの番号（マテリアルのStructuredBufferの添字）
+    uint32_t padding[3];                         // 12バイト（アラインメント用）
+};
+
 struct LineTransformationMatrix
 {
 	Matrix4x4 WVP;
@@ -89,6 +109,7 @@ struct Node
 struct ModelData
 {
 	std::vector<VertexData> vertices;			// 頂点データ
+	std::vector<uint32_t> indices;				// インデックスデータ（空なら頂点を順に描画する）
 	MaterialData material;						// マテリアルデータ
 	Node rootNode;								// ノード
 };
@@ -0,0 +1,201 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+JobSystem* JobSystem::instance_ = nullptr;
+
+namespace
+{
+	// 今のスレッドの番号（メインスレッドは0）
+	thread_local uint32_t currentThreadIndex = 0;
+}
+
+JobSystem* JobSystem::GetInstance()
+{
+	if (instance_ == nullptr)
+	{
+		instance_ = new JobSystem();
+	}
+	return instance_;
+}
+
+void JobSystem::Finalize()
+{
+	delete instance_;
+	instance_ = nullptr;
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+	jobAvailable_.notify_all();
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::Initialize(uint32_t threadCount)
+{
+	assert(workers_.empty() && "ERROR: JobSystem::Initialize() - Already initialized.");
+
+	if (threadCount == 0)
+	{
+		// メインスレッドの分を1つ残す
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = (std::max)(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+	}
+
+	workers_.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i)
+	{
+		workers_.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+}
+
+void JobSystem::Submit(std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->remaining.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// ワーカーがいなければその場で実行する
+	if (workers_.empty())
+	{
+		Job immediate{ std::move(job), counter };
+		Run(immediate);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back({ std::move(job), counter });
+	}
+	jobAvailable_.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	while (counter.remaining.load(std::memory_order_acquire) != 0)
+	{
+		// 待つ間も、このカウンタのジョブを手伝う
+		// 関係ないジョブ（テクスチャの読み込みなど）を拾うと、その分だけ待ちが長くなる
+		if (TryRunOne(&counter))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		jobFinished_.wait(lock, [&]()
+			{
+				return counter.remaining.load(std::memory_order_acquire) == 0 || HasQueuedJob(&counter);
+			});
+	}
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// メインスレッドも含めた数に分ける
+	uint32_t batchCount = GetThreadCount() + 1;
+	uint32_t batchSize = (std::max)((std::max)(minBatchSize, 1u), (count + batchCount - 1) / batchCount);
+
+	JobCounter counter;
+	for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+	{
+		uint32_t end = (std::min)(begin + batchSize, count);
+		Submit([&job, begin, end]() { job(begin, end); }, &counter);
+	}
+
+	// 先頭の分はこのスレッドで実行する
+	job(0, (std::min)(batchSize, count));
+	Wait(counter);
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex()
+{
+	return currentThreadIndex;
+}
+
+bool JobSystem::TryRunOne(const JobCounter* counter)
+{
+	Job job;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = counter
+			? std::find_if(jobs_.begin(), jobs_.end(), [counter](const Job& queued) { return queued.counter == counter; })
+			: jobs_.begin();
+		if (it == jobs_.end())
+		{
+			return false;
+		}
+		job = std::move(*it);
+		jobs_.erase(it);
+	}
+	Run(job);
+	return true;
+}
+
+bool JobSystem::HasQueuedJob(const JobCounter* counter) const
+{
+	return std::any_of(jobs_.begin(), jobs_.end(), [counter](const Job& queued) { return queued.counter == counter; });
+}
+
+void JobSystem::WorkerLoop(uint32_t threadIndex)
+{
+	currentThreadIndex = threadIndex;
+#ifdef _WIN32
+	// WICなどのCOMを使う処理のため
+	HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobAvailable_.wait(lock, [this]() { return isStopping_ || !jobs_.empty(); });
+			if (jobs_.empty())
+			{
+				// 終了要求があり、残りのジョブもない
+				break;
+			}
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+		}
+		Run(job);
+	}
+
+#ifdef _WIN32
+	if (SUCCEEDED(hr))
+	{
+		CoUninitialize();
+	}
+#endif
+}
+
+void JobSystem::Run(Job& job)
+{
+	job.function();
+
+	if (job.counter)
+	{
+		// 待っているスレッドが見逃さないよう、ロックを取ってから通知する
+		std::lock_guard<std::mutex> lock(mutex_);
+		job.counter->remaining.fetch_sub(1, std::memory_order_acq_rel);
+	}
+	jobFinished_.notify_all();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief 残りのジョブ数を数えるカウンタ。Waitに渡すと0になるまで待つ
+ */
+struct JobCounter
+{
+	std::atomic<uint32_t> remaining = 0;
+};
+
+/**
+ * \brief 固定数のワーカースレッドでジョブを実行する
+ * \note ワーカースレッドではCOMを初期化しているので、WICでの画像の読み込みもできる
+ */
+class JobSystem
+{
+public:
+	/// \brief インスタンス取得
+	static JobSystem* GetInstance();
+	/// \brief インスタンス解放（実行中のジョブが終わるのを待つ）
+	void Finalize();
+
+	/**
+	 * \brief 初期化
+	 * \param threadCount ワーカースレッド数。0ならコア数-1（最低1）
+	 */
+	void Initialize(uint32_t threadCount = 0);
+
+	/**
+	 * \brief ジョブを追加する
+	 * \param counter 完了を待つためのカウンタ（不要ならnullptr）
+	 */
+	void Submit(std::function<void()> job, JobCounter* counter = nullptr);
+
+	/**
+	 * \brief カウンタが0になるまで待つ
+	 * \note 待っている間は呼び出し元のスレッドも、このカウンタのジョブだけを実行する
+	 */
+	void Wait(JobCounter& counter);
+
+	/**
+	 * \brief 0～count-1の範囲を分けて並列に実行し、全て終わるまで待つ
+	 * \param job 範囲[begin, end)を受け取る関数
+	 * \param minBatchSize 1つのジョブに割り当てる最小の要素数
+	 */
+	void ParallelFor(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& job);
+
+	// ワーカースレッド数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+	/**
+	 * \brief 今のスレッドの番号
+	 * \return メインスレッド（ワーカー以外）は0、ワーカーは1～GetThreadCount()
+	 */
+	static uint32_t GetCurrentThreadIndex();
+
+private:
+	struct Job
+	{
+		std::function<void()> function;
+		JobCounter* counter = nullptr;
+	};
+
+	// キューから1つ取り出して実行する。counterを指定するとそのカウンタのジョブだけを対象にする。無ければfalse
+	bool TryRunOne(const JobCounter* counter = nullptr);
+	// counterのジョブがキューに残っているか（mutex_を取ってから呼ぶ）
+	bool HasQueuedJob(const JobCounter* counter) const;
+	// ワーカースレッドの処理
+	void WorkerLoop(uint32_t threadIndex);
+	// ジョブを実行してカウンタを減らす
+	void Run(Job& job);
+
+private:
+	std::vector<std::thread> workers_;
+	std::deque<Job> jobs_;
+	std::mutex mutex_;
+	std::condition_variable jobAvailable_;		// ジョブが追加された・終了する時に通知
+	std::condition_variable jobFinished_;		// ジョブが完了した時に通知（Wait用）
+	bool isStopping_ = false;
+
+private: //シングルトンインスタンス
+	static JobSystem* instance_;
+
+	JobSystem() = default;
+	~JobSystem();
+	JobSystem(JobSystem&) = delete;
+	JobSystem& operator=(JobSystem&) = delete;
+};
@@ -0,0 +1,414 @@
+#include "PipelineCache.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <type_traits>
+
+#include "base/Logger.h"
+
+namespace
+{
+	/*-----------------------[ ハッシュ ]------------------------*/
+
+	// FNV-1a
+	class Hasher
+	{
+	public:
+		void AddBytes(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash_ ^= bytes[i];
+				hash_ *= 1099511628211ull;
+			}
+		}
+
+		// 詰め物のない値（整数・列挙・浮動小数）だけを渡す
+		template<typename T>
+		void Add(const T& value)
+		{
+			static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+			AddBytes(&value, sizeof(T));
+		}
+
+		// 文字列は中身と長さを混ぜる（nullptrと空を区別する）
+		void AddString(const char* str)
+		{
+			if (str == nullptr)
+			{
+				Add(uint64_t(~0ull));
+				return;
+			}
+			const size_t length = std::strlen(str);
+			Add(uint64_t(length));
+			AddBytes(str, length);
+		}
+
+		void AddShader(const D3D12_SHADER_BYTECODE& shader)
+		{
+			Add(uint64_t(shader.BytecodeLength));
+			if (shader.pShaderBytecode != nullptr)
+			{
+				AddBytes(shader.pShaderBytecode, shader.BytecodeLength);
+			}
+		}
+
+		uint64_t Get() const { return hash_; }
+
+	private:
+		uint64_t hash_ = 14695981039346656037ull;
+	};
+
+	uint64_t ElapsedMicroseconds(std::chrono::steady_clock::time_point start)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	// ライブラリに保存する名前（記述のハッシュ）
+	std::wstring MakePipelineName(uint64_t hash)
+	{
+		return std::format(L"PSO_{:016x}", hash);
+	}
+}
+
+void PipelineCache::Initialize(ID3D12Device* device, const std::string& libraryPath)
+{
+	assert(device && "ERROR: PipelineCache::Initialize() - Device is null.");
+	device_ = device;
+	libraryPath_ = libraryPath;
+
+	//ライブラリはID3D12Device1から使える
+	if (FAILED(device_.As(&device1_)))
+	{
+		Logger::Log("WARNING: ID3D12PipelineLibrary is not supported. Pipelines are shared but not saved.\n");
+		return;
+	}
+
+	//前回保存したライブラリを読み込む
+	std::ifstream file(libraryPath_, std::ios::binary | std::ios::ate);
+	if (file.is_open())
+	{
+		libraryData_.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(libraryData_.data()), libraryData_.size()))
+		{
+			libraryData_.clear();
+		}
+	}
+
+	if (!libraryData_.empty())
+	{
+		HRESULT hr = device1_->CreatePipelineLibrary(libraryData_.data(), libraryData_.size(), IID_PPV_ARGS(&library_));
+		if (SUCCEEDED(hr))
+		{
+			Logger::Log(std::format("Pipeline library loaded: {} ({} bytes)\n", libraryPath_, libraryData_.size()));
+			return;
+		}
+		//ドライバやGPUが変わった、ファイルが壊れているなど。空から作り直して次の保存で上書きする
+		Logger::Log(std::format("Pipeline library discarded (hr=0x{:08x}): {}\n", static_cast<uint32_t>(hr), libraryPath_));
+		libraryData_.clear();
+	}
+	CreateEmptyLibrary();
+}
+
+Microsoft::WRL::ComPtr<ID3D12RootSignature> PipelineCache::GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc)
+{
+	++stats_.rootSignatureRequests;
+
+	//シリアライズしてバイナリする（このバイナリで同じかどうかを判定する）
+	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
+	if (FAILED(hr))
+	{
+		if (errorBlob)
+		{
+			Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
+		}
+		assert(false && "ERROR: PipelineCache::GetRootSignature() - Failed to serialize root signature.");
+		return nullptr;
+	}
+
+	Hasher hasher;
+	hasher.AddBytes(signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize());
+	const uint64_t hash = hasher.Get();
+	auto it = rootSignatures_.find(hash);
+	if (it != rootSignatures_.end())
+	{
+		return it->second;
+	}
+
+	//バイナリをもとに生成
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature = nullptr;
+	hr = device_->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+	assert(SUCCEEDED(hr) && "ERROR: PipelineCache::GetRootSignature() - Failed to create root signature.");
+	++stats_.rootSignatureCreated;
+
+	rootSignatures_[hash] = rootSignature;
+	rootSignatureHashes_[rootSignature.Get()] = hash;
+	return rootSignature;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineCache::GetGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	++stats_.pipelineRequests;
+
+	//ここで作ったルートシグネチャなら、起動をまたいでも同じハッシュになる
+	auto rootIt = rootSignatureHashes_.find(desc.pRootSignature);
+	const bool isPersistent = rootIt != rootSignatureHashes_.end();
+	const uint64_t rootSignatureHash = isPersistent ? rootIt->second : reinterpret_cast<uintptr_t>(desc.pRootSignature);
+	const uint64_t hash = HashGraphicsPipelineDesc(desc, rootSignatureHash);
+
+	//同じ記述で作成済み
+	auto it = pipelineStates_.find(hash);
+	if (it != pipelineStates_.end())
+	{
+		++stats_.pipelineShared;
+		return it->second;
+	}
+
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState = nullptr;
+	const std::wstring name = MakePipelineName(hash);
+	const bool useLibrary = library_ != nullptr && isPersistent && desc.CachedPSO.pCachedBlob == nullptr && !isHotReloading_;
+
+	//前回の起動で保存したもの
+	if (useLibrary)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		if (SUCCEEDED(library_->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState))))
+		{
+			++stats_.pipelineFromLibrary;
+			stats_.loadMicroseconds += ElapsedMicroseconds(startTime);
+		}
+	}
+
+	//なければドライバでコンパイルして、ライブラリに追加する
+	if (pipelineState == nullptr)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		HRESULT hr = device_->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState));
+		assert(SUCCEEDED(hr) && "ERROR: PipelineCache::GetGraphicsPipelineState() - Failed to create pipeline state.");
+		++stats_.pipelineCreated;
+		stats_.createMicroseconds += ElapsedMicroseconds(startTime);
+
+		if (useLibrary)
+		{
+			if (SUCCEEDED(library_->StorePipeline(name.c_str(), pipelineState.Get())))
+			{
+				isLibraryDirty_ = true;
+			}
+			else
+			{
+				Logger::Log("WARNING: Failed to store pipeline to library.\n");
+			}
+		}
+	}
+
+	pipelineStates_[hash] = pipelineState;
+	return pipelineState;
+}
+
+uint32_t PipelineCache::EndHotReload()
+{
+	isHotReloading_ = false;
+
+	//キャッシュしか参照していないものは、置き換えられた古いパイプライン
+	uint32_t evictedCount = 0;
+	for (auto it = pipelineStates_.begin(); it != pipelineStates_.end();)
+	{
+		ID3D12PipelineState* pipelineState = it->second.Get();
+		pipelineState->AddRef();
+		const ULONG refCount = pipelineState->Release();
+		if (refCount == 1)
+		{
+			it = pipelineStates_.erase(it);
+			++evictedCount;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	stats_.pipelineEvicted += evictedCount;
+	return evictedCount;
+}
+
+bool PipelineCache::Save()
+{
+	if (library_ == nullptr || !isLibraryDirty_)
+	{
+		return true;
+	}
+
+	std::vector<uint8_t> data(library_->GetSerializedSize());
+	if (FAILED(library_->Serialize(data.data(), data.size())))
+	{
+		Logger::Log("WARNING: Failed to serialize pipeline library.\n");
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(libraryPath_).parent_path(), error);
+
+	// 途中で失敗しても壊れたファイルを残さないように、一時ファイルに書いてから置き換える
+	std::string tempPath = libraryPath_ + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		if (!file)
+		{
+			return false;
+		}
+	}
+	std::filesystem::rename(tempPath, libraryPath_, error);
+	if (error)
+	{
+		return false;
+	}
+
+	isLibraryDirty_ = false;
+	Logger::Log(std::format("Pipeline library saved: {} ({} bytes)\n", libraryPath_, data.size()));
+	return true;
+}
+
+void PipelineCache::LogReport() const
+{
+	Logger::Log(std::format(
+		"Pipeline cache report\n"
+		"  root signature : {} requested, {} created\n"
+		"  pipeline state : {} requested, {} shared, {} from library ({:.3f}ms), {} compiled ({:.3f}ms), {} evicted\n",
+		stats_.rootSignatureRequests, stats_.rootSignatureCreated,
+		stats_.pipelineRequests, stats_.pipelineShared,
+		stats_.pipelineFromLibrary, stats_.loadMicroseconds / 1000.0,
+		stats_.pipelineCreated, stats_.createMicroseconds / 1000.0,
+		stats_.pipelineEvicted));
+}
+
+uint64_t PipelineCache::HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash)
+{
+	Hasher hasher;
+	hasher.Add(rootSignatureHash);
+
+	//シェーダー
+	hasher.AddShader(desc.VS);
+	hasher.AddShader(desc.PS);
+	hasher.AddShader(desc.DS);
+	hasher.AddShader(desc.HS);
+	hasher.AddShader(desc.GS);
+
+	//ストリーム出力
+	hasher.Add(desc.StreamOutput.NumEntries);
+	for (UINT i = 0; i < desc.StreamOutput.NumEntries; ++i)
+	{
+		const D3D12_SO_DECLARATION_ENTRY& entry = desc.StreamOutput.pSODeclaration[i];
+		hasher.Add(entry.Stream);
+		hasher.AddString(entry.SemanticName);
+		hasher.Add(entry.SemanticIndex);
+		hasher.Add(entry.StartComponent);
+		hasher.Add(entry.ComponentCount);
+		hasher.Add(entry.OutputSlot);
+	}
+	hasher.Add(desc.StreamOutput.NumStrides);
+	for (UINT i = 0; i < desc.StreamOutput.NumStrides; ++i)
+	{
+		hasher.Add(desc.StreamOutput.pBufferStrides[i]);
+	}
+	hasher.Add(desc.StreamOutput.RasterizedStream);
+
+	//ブレンド
+	hasher.Add(desc.BlendState.AlphaToCoverageEnable);
+	hasher.Add(desc.BlendState.IndependentBlendEnable);
+	for (const D3D12_RENDER_TARGET_BLEND_DESC& target : desc.BlendState.RenderTarget)
+	{
+		hasher.Add(target.BlendEnable);
+		hasher.Add(target.LogicOpEnable);
+		hasher.Add(target.SrcBlend);
+		hasher.Add(target.DestBlend);
+		hasher.Add(target.BlendOp);
+		hasher.Add(target.SrcBlendAlpha);
+		hasher.Add(target.DestBlendAlpha);
+		hasher.Add(target.BlendOpAlpha);
+		hasher.Add(target.LogicOp);
+		hasher.Add(target.RenderTargetWriteMask);
+	}
+	hasher.Add(desc.SampleMask);
+
+	//ラスタライザ
+	const D3D12_RASTERIZER_DESC& rasterizer = desc.RasterizerState;
+	hasher.Add(rasterizer.FillMode);
+	hasher.Add(rasterizer.CullMode);
+	hasher.Add(rasterizer.FrontCounterClockwise);
+	hasher.Add(rasterizer.DepthBias);
+	hasher.Add(rasterizer.DepthBiasClamp);
+	hasher.Add(rasterizer.SlopeScaledDepthBias);
+	hasher.Add(rasterizer.DepthClipEnable);
+	hasher.Add(rasterizer.MultisampleEnable);
+	hasher.Add(rasterizer.AntialiasedLineEnable);
+	hasher.Add(rasterizer.ForcedSampleCount);
+	hasher.Add(rasterizer.ConservativeRaster);
+
+	//深度ステンシル
+	const D3D12_DEPTH_STENCIL_DESC& depthStencil = desc.DepthStencilState;
+	hasher.Add(depthStencil.DepthEnable);
+	hasher.Add(depthStencil.DepthWriteMask);
+	hasher.Add(depthStencil.DepthFunc);
+	hasher.Add(depthStencil.StencilEnable);
+	hasher.Add(depthStencil.StencilReadMask);
+	hasher.Add(depthStencil.StencilWriteMask);
+	for (const D3D12_DEPTH_STENCILOP_DESC& face : { depthStencil.FrontFace, depthStencil.BackFace })
+	{
+		hasher.Add(face.StencilFailOp);
+		hasher.Add(face.StencilDepthFailOp);
+		hasher.Add(face.StencilPassOp);
+		hasher.Add(face.StencilFunc);
+	}
+
+	//頂点レイアウト
+	hasher.Add(desc.InputLayout.NumElements);
+	for (UINT i = 0; i < desc.InputLayout.NumElements; ++i)
+	{
+		const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+		hasher.AddString(element.SemanticName);
+		hasher.Add(element.SemanticIndex);
+		hasher.Add(element.Format);
+		hasher.Add(element.InputSlot);
+		hasher.Add(element.AlignedByteOffset);
+		hasher.Add(element.InputSlotClass);
+		hasher.Add(element.InstanceDataStepRate);
+	}
+
+	//出力先など
+	hasher.Add(desc.IBStripCutValue);
+	hasher.Add(desc.PrimitiveTopologyType);
+	hasher.Add(desc.NumRenderTargets);
+	for (DXGI_FORMAT format : desc.RTVFormats)
+	{
+		hasher.Add(format);
+	}
+	hasher.Add(desc.DSVFormat);
+	hasher.Add(desc.SampleDesc.Count);
+	hasher.Add(desc.SampleDesc.Quality);
+	hasher.Add(desc.NodeMask);
+	hasher.Add(desc.Flags);
+	return hasher.Get();
+}
+
+void PipelineCache::CreateEmptyLibrary()
+{
+	HRESULT hr = device1_->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&library_));
+	if (FAILED(hr))
+	{
+		//OSやドライバが対応していない
+		Logger::Log("WARNING: Failed to create pipeline library. Pipelines are shared but not saved.\n");
+		library_.Reset();
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h>
+
+/**
+ * \brief ルートシグネチャとパイプラインステートを記述のハッシュで共有し、パイプラインはディスクにも残すクラス
+ * \note 同じ記述で作ろうとしたら作成済みのものを返す。パイプラインはID3D12PipelineLibraryに保存しておき、
+ *       次回の起動ではドライバでのコンパイルを省く（ドライバが変わった時などは作り直す）
+ */
+class PipelineCache
+{
+public:
+	// ライブラリの保存先
+	static constexpr const char* kLibraryPath = "Resources/cache/pipelines.kpso";
+
+	// 作成と読み込みの集計
+	struct Stats
+	{
+		uint32_t rootSignatureRequests = 0;	// GetRootSignatureを呼んだ回数
+		uint32_t rootSignatureCreated = 0;	// 実際に作った数
+		uint32_t pipelineRequests = 0;		// GetGraphicsPipelineStateを呼んだ回数
+		uint32_t pipelineShared = 0;		// 作成済みのものを返した数
+		uint32_t pipelineFromLibrary = 0;	// ライブラリから読み込んだ数
+		uint32_t pipelineCreated = 0;		// ドライバでコンパイルした数
+		uint32_t pipelineEvicted = 0;		// ホットリロードで置き換えられて捨てた数
+		uint64_t loadMicroseconds = 0;		// ライブラリからの読み込み時間
+		uint64_t createMicroseconds = 0;	// ドライバでのコンパイル時間
+	};
+
+	/**
+	 * \brief 初期化（前回保存したライブラリがあれば読み込む）
+	 * \param device ID3D12Device1に対応していなければライブラリは使わず、共有だけを行う
+	 */
+	void Initialize(ID3D12Device* device, const std::string& libraryPath = kLibraryPath);
+
+	/**
+	 * \brief ルートシグネチャを取得する
+	 * \note シリアライズした結果が同じなら作成済みのものを返す
+	 */
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc);
+
+	/**
+	 * \brief パイプラインステートを取得する
+	 * \note シェーダーのバイナリやInputLayoutの中身まで含めた記述が同じなら作成済みのものを返す。
+	 *       ルートシグネチャはGetRootSignatureで作ったものを使うこと（それ以外はライブラリに保存しない）
+	 */
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> GetGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+	/**
+	 * \brief ライブラリに新しいパイプラインが増えていれば書き出す
+	 * \return 書き出せたか、書き出す必要がなければtrue
+	 */
+	bool Save();
+
+	/**
+	 * \brief シェーダーのホットリロードでの作り直しを始める
+	 * \note EndHotReloadまでに作ったパイプラインはライブラリに保存しない（編集中のシェーダーで毎回増えていくため）
+	 */
+	void BeginHotReload() { isHotReloading_ = true; }
+
+	/**
+	 * \brief ホットリロードでの作り直しを終え、置き換えられて誰も使っていないパイプラインを捨てる
+	 * \note GPUが使い終わってから呼ぶこと
+	 * \return 捨てた数
+	 */
+	uint32_t EndHotReload();
+
+	/// \brief 作成と読み込みの集計をログに出す
+	void LogReport() const;
+
+	/**
+	 * \brief パイプラインの記述のハッシュを求める
+	 * \note ポインタの先（シェーダー、InputLayout、ストリーム出力）は中身で比べる。詰め物は含めない
+	 * \param rootSignatureHash ルートシグネチャをシリアライズしたバイナリのハッシュ
+	 */
+	static uint64_t HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+
+public: //アクセッサ
+	const Stats& GetStats() const { return stats_; }
+	// ライブラリを使えているか
+	bool IsLibraryAvailable() const { return library_ != nullptr; }
+
+private:
+	// ライブラリを空で作り直す
+	void CreateEmptyLibrary();
+
+private:
+	Microsoft::WRL::ComPtr<ID3D12Device> device_;
+	Microsoft::WRL::ComPtr<ID3D12Device1> device1_;
+	Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> library_;
+	//ライブラリは読み込んだデータを参照し続けるので、破棄するまで持っておく
+	std::vector<uint8_t> libraryData_;
+	std::string libraryPath_;
+	//ライブラリに追加して、まだ書き出していないパイプラインがあるか
+	bool isLibraryDirty_ = false;
+	//ホットリロードで作り直している最中か
+	bool isHotReloading_ = false;
+
+	//ハッシュから作成済みのもの
+	std::unordered_map<uint64_t, Microsoft::WRL::ComPtr<ID3D12RootSignature>> rootSignatures_;
+	std::unordered_map<uint64_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>> pipelineStates_;
+	//作ったルートシグネチャからハッシュ（パイプラインのキーに使う）
+	std::unordered_map<ID3D12RootSignature*, uint64_t> rootSignatureHashes_;
+
+	Stats stats_;
+};
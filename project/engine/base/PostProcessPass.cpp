@@ -27,9 +27,8 @@ void PostProcessPass::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc{};
     rootSigDesc.Init(_countof(rootParams), rootParams, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
-    Microsoft::WRL::ComPtr<ID3DBlob> sigBlob, errBlob;
-    D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
-    dxCommon_->GetDevice()->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
+    // 同じ記述のものがあれば共有する
+    rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(rootSigDesc);
 
     auto vs = dxCommon_->CompileSharder(vsPath, L"vs_6_0");
     auto ps = dxCommon_->CompileSharder(psPath, L"ps_6_0");
@@ -50,7 +49,7 @@ void PostProcessPass::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
     psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 
-    dxCommon_->GetDevice()->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState_));
+    pipelineState_ = dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(psoDesc);
 
     // 定数バッファの作成
     D3D12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
@@ -14,6 +14,8 @@ public:
     void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager, uint32_t width, uint32_t height, DXGI_FORMAT format, const Vector4& clearColor);
     void BeginRender();
     void EndRender();
+    // クリアせずに描画先を戻す（途中で別の描画先に切り替えた後に呼ぶ）
+    void ResumeRender();
 	void PreDrawForImGui();
 	void PostDrawForImGui();
 
@@ -0,0 +1,302 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+namespace
+{
+	// ファイルの先頭に置く識別子
+	constexpr char kMagic[4] = { 'K', 'D', 'X', 'L' };
+
+	// ファイルの先頭（この後にシェーダーのバイナリが続く）
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		uint64_t compileMicroseconds;
+		uint64_t bytecodeSize;
+	};
+	static_assert(sizeof(FileHeader) % 16 == 0);
+
+	/*-----------------------[ ハッシュ ]------------------------*/
+
+	constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+	constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+	// FNV-1a
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= kFnvPrime;
+		}
+		return hash;
+	}
+
+	// 長さも混ぜて、"ab"+"c"と"a"+"bc"を区別する
+	uint64_t HashString(const std::wstring& str, uint64_t hash)
+	{
+		uint64_t length = str.size();
+		hash = HashBytes(&length, sizeof(length), hash);
+		return HashBytes(str.data(), str.size() * sizeof(wchar_t), hash);
+	}
+
+	/*-----------------------[ ファイル ]------------------------*/
+
+	bool ReadText(const std::filesystem::path& path, std::string& outText)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		std::stringstream ss;
+		ss << file.rdbuf();
+		outText = ss.str();
+		return true;
+	}
+
+	int64_t GetWriteTime(const std::string& path)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+	}
+
+	std::string NormalizePath(const std::filesystem::path& path)
+	{
+		return path.lexically_normal().generic_string();
+	}
+
+	/**
+	 * \brief 1行が#includeなら、インクルードするファイル名を取り出す
+	 * \return #includeの行でなければ空
+	 */
+	std::string ParseInclude(const std::string& line)
+	{
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line[pos] != '#')
+		{
+			return {};
+		}
+		pos = line.find_first_not_of(" \t", pos + 1);
+		constexpr const char* kDirective = "include";
+		if (pos == std::string::npos || line.compare(pos, std::strlen(kDirective), kDirective) != 0)
+		{
+			return {};
+		}
+		pos = line.find_first_not_of(" \t", pos + std::strlen(kDirective));
+		if (pos == std::string::npos || (line[pos] != '"' && line[pos] != '<'))
+		{
+			return {};
+		}
+		const char close = line[pos] == '"' ? '"' : '>';
+		size_t end = line.find(close, pos + 1);
+		if (end == std::string::npos)
+		{
+			return {};
+		}
+		return line.substr(pos + 1, end - pos - 1);
+	}
+
+	void CollectRecursive(const std::filesystem::path& path, std::unordered_set<std::string>& visited, std::vector<std::string>& outDependencies)
+	{
+		std::string normalized = NormalizePath(path);
+		if (!visited.insert(normalized).second)
+		{
+			return;
+		}
+
+		std::string text;
+		if (!ReadText(path, text))
+		{
+			return;
+		}
+		outDependencies.push_back(normalized);
+
+		std::istringstream lines(text);
+		std::string line;
+		while (std::getline(lines, line))
+		{
+			std::string include = ParseInclude(line);
+			if (include.empty())
+			{
+				continue;
+			}
+
+			// DXCの既定のインクルードハンドラと同じく、インクルードしたファイルのフォルダを先に探す
+			std::error_code error;
+			std::filesystem::path candidate = path.parent_path() / include;
+			if (!std::filesystem::exists(candidate, error))
+			{
+				candidate = include;
+			}
+			if (std::filesystem::exists(candidate, error))
+			{
+				CollectRecursive(candidate, visited, outDependencies);
+			}
+		}
+	}
+}
+
+std::vector<std::string> ShaderCache::CollectDependencies(const std::string& sourcePath)
+{
+	std::vector<std::string> dependencies;
+	std::unordered_set<std::string> visited;
+	CollectRecursive(sourcePath, visited, dependencies);
+	return dependencies;
+}
+
+uint64_t ShaderCache::MakeKey(const std::vector<std::string>& dependencies, const std::wstring& profile, const std::vector<std::wstring>& options)
+{
+	if (dependencies.empty())
+	{
+		return 0;
+	}
+
+	uint64_t hash = HashBytes(&kVersion, sizeof(kVersion), kFnvOffsetBasis);
+	hash = HashString(profile, hash);
+	for (const std::wstring& option : options)
+	{
+		hash = HashString(option, hash);
+	}
+
+	// インクルードするファイルの名前と中身も混ぜる（共通のhlsliだけを変えた時も作り直す）
+	for (const std::string& path : dependencies)
+	{
+		std::string text;
+		if (!ReadText(path, text))
+		{
+			return 0;
+		}
+		hash = HashBytes(path.data(), path.size(), hash);
+		uint64_t size = text.size();
+		hash = HashBytes(&size, sizeof(size), hash);
+		hash = HashBytes(text.data(), text.size(), hash);
+	}
+
+	// 0は「ソースなし」に使うので避ける
+	return hash == 0 ? 1 : hash;
+}
+
+std::string ShaderCache::MakeCachePath(const std::string& sourcePath, const std::wstring& profile)
+{
+	// 同じファイル名の別のシェーダーと混ざらないよう、パスのハッシュも付ける
+	const std::string normalized = NormalizePath(sourcePath);
+	const uint64_t pathHash = HashBytes(normalized.data(), normalized.size(), kFnvOffsetBasis);
+	const std::string profileName = std::filesystem::path(profile).string();
+
+	char hashText[17];
+	std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(pathHash));
+	return std::string(kCacheDirectory) + "/" + std::filesystem::path(normalized).filename().string() + "." + profileName + "." + hashText + kExtension;
+}
+
+bool ShaderCache::Load(const std::string& cachePath, uint64_t key, std::vector<uint8_t>& outBytecode, LoadInfo* outInfo)
+{
+	std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+	file.seekg(0);
+
+	FileHeader header{};
+	if (fileSize < sizeof(FileHeader) ||
+		!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+		header.version != kVersion ||
+		header.key != key ||
+		header.bytecodeSize != fileSize - sizeof(FileHeader))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> bytecode(static_cast<size_t>(header.bytecodeSize));
+	if (!file.read(reinterpret_cast<char*>(bytecode.data()), bytecode.size()))
+	{
+		return false;
+	}
+
+	outBytecode = std::move(bytecode);
+	if (outInfo)
+	{
+		outInfo->compileMicroseconds = header.compileMicroseconds;
+		outInfo->fileSize = fileSize;
+	}
+	return true;
+}
+
+bool ShaderCache::Save(const std::string& cachePath, uint64_t key, const void* bytecode, size_t size, uint64_t compileMicroseconds)
+{
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.key = key;
+	header.compileMicroseconds = compileMicroseconds;
+	header.bytecodeSize = size;
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	// 途中で失敗しても壊れたファイルを残さないように、一時ファイルに書いてから置き換える
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(static_cast<const char*>(bytecode), size);
+		if (!file)
+		{
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath, error);
+	return !error;
+}
+
+void ShaderCache::Watcher::Watch(const std::wstring& filePath, const std::wstring& profile, const std::vector<std::string>& dependencies)
+{
+	Entry entry;
+	entry.target = { filePath, profile };
+	entry.files.reserve(dependencies.size());
+	for (const std::string& path : dependencies)
+	{
+		entry.files.push_back({ path, GetWriteTime(path) });
+	}
+	entries_[filePath + L"|" + profile] = std::move(entry);
+}
+
+std::vector<ShaderCache::Watcher::Target> ShaderCache::Watcher::CollectChanged()
+{
+	std::vector<Target> changed;
+	for (auto& [key, entry] : entries_)
+	{
+		bool isChanged = false;
+		for (WatchedFile& file : entry.files)
+		{
+			const int64_t writeTime = GetWriteTime(file.path);
+			if (writeTime != file.writeTime)
+			{
+				file.writeTime = writeTime;
+				isChanged = true;
+			}
+		}
+		if (isChanged)
+		{
+			changed.push_back(entry.target);
+		}
+	}
+	return changed;
+}
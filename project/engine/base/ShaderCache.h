@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief DXCでコンパイルしたシェーダーのバイナリを、そのまま読み戻せるファイルとして保存する
+ * \note ソースとインクルードしたファイルの内容、プロファイル、コンパイルオプションが全て一致する時だけ使う。
+ *       形式を変えたらkVersionを上げること
+ */
+namespace ShaderCache
+{
+	// キャッシュの形式のバージョン
+	constexpr uint32_t kVersion = 1;
+
+	// キャッシュファイルの置き場所と拡張子
+	constexpr const char* kCacheDirectory = "Resources/cache/shaders";
+	constexpr const char* kExtension = ".kdxil";
+
+	// 読み込んだキャッシュの情報
+	struct LoadInfo
+	{
+		uint64_t compileMicroseconds = 0;	// キャッシュを作った時のDXCでのコンパイル時間
+		uint64_t fileSize = 0;				// キャッシュファイルの大きさ
+	};
+
+	/**
+	 * \brief ソースから#includeを辿って、コンパイル結果に関わるファイルを集める
+	 * \note インクルード先はインクルードしたファイルのフォルダ、作業フォルダの順に探す。
+	 *       #ifで外れるインクルードも含むので、実際より多めになる
+	 * \return 先頭がソース自身。ソースが開けなければ空
+	 */
+	std::vector<std::string> CollectDependencies(const std::string& sourcePath);
+
+	/**
+	 * \brief 依存ファイルの内容、プロファイル、コンパイルオプションからキーを求める
+	 * \return 依存ファイルが開けなければ0
+	 */
+	uint64_t MakeKey(const std::vector<std::string>& dependencies, const std::wstring& profile, const std::vector<std::wstring>& options);
+
+	/// \brief シェーダーとプロファイルの組に対応するキャッシュファイルのパス（組ごとに1ファイルを上書きしていく）
+	std::string MakeCachePath(const std::string& sourcePath, const std::wstring& profile);
+
+	/**
+	 * \brief キャッシュファイルを読み込む
+	 * \param key MakeKeyの値。保存時と違えば読み込まない
+	 * \param outInfo 読み込んだキャッシュの情報（不要ならnullptr）
+	 * \return 読み込めたらtrue。ファイルがない・古い・壊れている場合はfalse
+	 */
+	bool Load(const std::string& cachePath, uint64_t key, std::vector<uint8_t>& outBytecode, LoadInfo* outInfo = nullptr);
+
+	/**
+	 * \brief キャッシュファイルを書き出す
+	 * \param compileMicroseconds DXCでのコンパイルにかかった時間（読み込み時の比較用）
+	 * \return 書き出せたらtrue
+	 */
+	bool Save(const std::string& cachePath, uint64_t key, const void* bytecode, size_t size, uint64_t compileMicroseconds);
+
+	/**
+	 * \brief コンパイルしたシェーダーの依存ファイルの更新日時を覚えておき、変更を見つける（開発中のホットリロード用）
+	 */
+	class Watcher
+	{
+	public:
+		// 見張るシェーダー（パスとプロファイルの組）
+		struct Target
+		{
+			std::wstring filePath;
+			std::wstring profile;
+		};
+
+		/**
+		 * \brief シェーダーの依存ファイルを記録する
+		 * \note 同じシェーダーを記録し直すと、依存ファイルと更新日時を置き換える
+		 */
+		void Watch(const std::wstring& filePath, const std::wstring& profile, const std::vector<std::string>& dependencies);
+
+		/**
+		 * \brief 前回の確認から依存ファイルが更新されたシェーダーを集める
+		 * \note 見つけた時点の更新日時を覚え直すので、同じ変更は一度しか返さない
+		 */
+		std::vector<Target> CollectChanged();
+
+		size_t GetWatchCount() const { return entries_.size(); }
+
+	private:
+		struct WatchedFile
+		{
+			std::string path;
+			int64_t writeTime = 0;
+		};
+
+		struct Entry
+		{
+			Target target;
+			std::vector<WatchedFile> files;
+		};
+
+		//キーはパスとプロファイルをつないだ文字列
+		std::unordered_map<std::wstring, Entry> entries_;
+	};
+}
@@ -0,0 +1,280 @@
+#include "TextureCooker.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "base/Logger.h"
+#include "externals/DirectXTex/DirectXTex.h"
+#include "externals/nlohmann/json.hpp"
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	// マニフェストの形式のバージョン
+	constexpr uint32_t kManifestVersion = 1;
+
+	double ElapsedMilliseconds(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	int64_t GetWriteTime(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+	}
+
+	// ミップマップを含めたVRAM上の大きさ
+	uint64_t CalculateVideoMemory(const DirectX::TexMetadata& metadata)
+	{
+		uint64_t total = 0;
+		for (size_t mip = 0; mip < metadata.mipLevels; ++mip)
+		{
+			size_t width = (std::max)(size_t(1), metadata.width >> mip);
+			size_t height = (std::max)(size_t(1), metadata.height >> mip);
+			size_t rowPitch = 0;
+			size_t slicePitch = 0;
+			if (FAILED(DirectX::ComputePitch(metadata.format, width, height, rowPitch, slicePitch)))
+			{
+				return 0;
+			}
+			total += uint64_t(slicePitch) * metadata.arraySize;
+		}
+		return total;
+	}
+
+	// 実行時と同じ手順で読み込む（WICで読み込んでミップマップを作る）
+	HRESULT LoadSource(const std::filesystem::path& path, DirectX::ScratchImage& outMipImages)
+	{
+		DirectX::ScratchImage image{};
+		HRESULT hr = DirectX::LoadFromWICFile(path.wstring().c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+		return DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, outMipImages);
+	}
+
+	// 変換の結果
+	struct CookResult
+	{
+		std::string source;
+		std::string cooked;
+		DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		uint64_t sourceVideoMemory = 0;		//実行時に作っていたRGBA8+ミップマップの大きさ
+		uint64_t cookedVideoMemory = 0;
+		double sourceLoadMilliseconds = 0.0;	//WICでの読み込み+ミップマップ生成
+		double cookedLoadMilliseconds = 0.0;	//DDSの読み込み
+	};
+
+	bool CookTexture(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, CookResult& result)
+	{
+		/*--------------[ 実行時と同じ手順で読み込んで時間を測る ]-----------------*/
+
+		Clock::time_point start = Clock::now();
+		DirectX::ScratchImage mipImages{};
+		if (FAILED(LoadSource(sourcePath, mipImages)))
+		{
+			return false;
+		}
+		result.sourceLoadMilliseconds = ElapsedMilliseconds(start);
+		const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
+		result.sourceVideoMemory = CalculateVideoMemory(metadata);
+
+		/*--------------[ ブロック圧縮 ]-----------------*/
+
+		//BCは最上位のミップの幅と高さが4の倍数でないとテクスチャを作れないので、その場合は圧縮せずミップマップだけ持たせる
+		DirectX::ScratchImage cooked{};
+		if (metadata.width % 4 == 0 && metadata.height % 4 == 0)
+		{
+			//不透明ならBC1、アルファがあればBC7
+			DXGI_FORMAT format = mipImages.IsAlphaAllOpaque() ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM_SRGB;
+			HRESULT hr = DirectX::Compress(mipImages.GetImages(), mipImages.GetImageCount(), metadata, format,
+				DirectX::TEX_COMPRESS_BC7_QUICK | DirectX::TEX_COMPRESS_PARALLEL, DirectX::TEX_THRESHOLD_DEFAULT, cooked);
+			if (FAILED(hr))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			cooked = std::move(mipImages);
+		}
+		result.format = cooked.GetMetadata().format;
+		result.cookedVideoMemory = CalculateVideoMemory(cooked.GetMetadata());
+
+		/*--------------[ 書き出して、読み込み時間を測る ]-----------------*/
+
+		std::error_code error;
+		std::filesystem::create_directories(cookedPath.parent_path(), error);
+		HRESULT hr = DirectX::SaveToDDSFile(cooked.GetImages(), cooked.GetImageCount(), cooked.GetMetadata(), DirectX::DDS_FLAGS_NONE, cookedPath.wstring().c_str());
+		if (FAILED(hr))
+		{
+			return false;
+		}
+
+		start = Clock::now();
+		DirectX::ScratchImage reloaded{};
+		if (FAILED(DirectX::LoadFromDDSFile(cookedPath.wstring().c_str(), DirectX::DDS_FLAGS_NONE, nullptr, reloaded)))
+		{
+			return false;
+		}
+		result.cookedLoadMilliseconds = ElapsedMilliseconds(start);
+
+		result.sourceSize = std::filesystem::file_size(sourcePath, error);
+		result.sourceTime = GetWriteTime(sourcePath);
+		return true;
+	}
+}
+
+std::string TextureCooker::NormalizePath(const std::string& path)
+{
+	return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+uint32_t TextureCooker::CookDirectory(const std::string& resourceDirectory)
+{
+	namespace fs = std::filesystem;
+	const fs::path cookedDirectory = fs::path(kCookedDirectory).lexically_normal();
+
+	/*--------------[ 変換する画像を集める ]-----------------*/
+
+	std::vector<fs::path> sources;
+	std::error_code error;
+	for (const auto& entry : fs::recursive_directory_iterator(resourceDirectory, error))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() != ".png")
+		{
+			continue;
+		}
+		//変換済みのフォルダの中は対象外
+		fs::path normalized = entry.path().lexically_normal();
+		if (normalized.generic_string().starts_with(cookedDirectory.generic_string() + "/"))
+		{
+			continue;
+		}
+		sources.push_back(normalized);
+	}
+
+	/*--------------[ 変換してマニフェストに書く ]-----------------*/
+
+	nlohmann::json manifest;
+	manifest["version"] = kManifestVersion;
+	manifest["textures"] = nlohmann::json::array();
+
+	uint64_t totalSourceMemory = 0;
+	uint64_t totalCookedMemory = 0;
+	double totalSourceLoad = 0.0;
+	double totalCookedLoad = 0.0;
+	uint32_t cookedCount = 0;
+
+	std::stringstream report;
+	report << "Texture cook report\n";
+	for (const fs::path& source : sources)
+	{
+		//Resources/a/b.png -> Resources/cooked/a/b.dds
+		fs::path relative = source.lexically_relative(fs::path(resourceDirectory).lexically_normal());
+		fs::path cookedPath = cookedDirectory / relative;
+		cookedPath.replace_extension(".dds");
+
+		CookResult result;
+		result.source = source.generic_string();
+		result.cooked = cookedPath.generic_string();
+		if (!CookTexture(source, cookedPath, result))
+		{
+			report << "  failed: " << result.source << "\n";
+			continue;
+		}
+
+		nlohmann::json entry;
+		entry["source"] = result.source;
+		entry["cooked"] = result.cooked;
+		entry["sourceSize"] = result.sourceSize;
+		entry["sourceTime"] = result.sourceTime;
+		entry["format"] = static_cast<uint32_t>(result.format);
+		entry["sourceVideoMemory"] = result.sourceVideoMemory;
+		entry["cookedVideoMemory"] = result.cookedVideoMemory;
+		entry["sourceLoadMs"] = result.sourceLoadMilliseconds;
+		entry["cookedLoadMs"] = result.cookedLoadMilliseconds;
+		manifest["textures"].push_back(entry);
+
+		report << "  " << result.source
+			<< (DirectX::IsCompressed(result.format) ? (result.format == DXGI_FORMAT_BC1_UNORM_SRGB ? " BC1" : " BC7") : " RGBA8")
+			<< " VRAM " << result.sourceVideoMemory / 1024 << "KB -> " << result.cookedVideoMemory / 1024 << "KB"
+			<< ", load " << result.sourceLoadMilliseconds << "ms -> " << result.cookedLoadMilliseconds << "ms\n";
+
+		totalSourceMemory += result.sourceVideoMemory;
+		totalCookedMemory += result.cookedVideoMemory;
+		totalSourceLoad += result.sourceLoadMilliseconds;
+		totalCookedLoad += result.cookedLoadMilliseconds;
+		++cookedCount;
+	}
+
+	report << "  total " << cookedCount << " textures, VRAM " << totalSourceMemory / 1024 << "KB -> " << totalCookedMemory / 1024 << "KB"
+		<< ", load " << totalSourceLoad << "ms -> " << totalCookedLoad << "ms\n";
+	Logger::Log(report.str());
+
+	fs::create_directories(cookedDirectory, error);
+	std::ofstream file(kManifestPath);
+	file << manifest.dump(4);
+
+	//比較結果はログとは別にファイルにも残す
+	std::ofstream reportFile(fs::path(kCookedDirectory) / "texture_report.txt");
+	reportFile << report.str();
+
+	return cookedCount;
+}
+
+void TextureCooker::Manifest::Load(const std::string& manifestPath)
+{
+	entries_.clear();
+
+	std::ifstream file(manifestPath);
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	nlohmann::json manifest = nlohmann::json::parse(file, nullptr, false);
+	if (manifest.is_discarded() || manifest.value("version", 0u) != kManifestVersion || !manifest.contains("textures"))
+	{
+		Logger::Log("Texture manifest is invalid or outdated: " + manifestPath + "\n");
+		return;
+	}
+
+	for (const nlohmann::json& texture : manifest["textures"])
+	{
+		Entry entry;
+		entry.cookedPath = texture.value("cooked", "");
+		entry.sourceSize = texture.value("sourceSize", uint64_t(0));
+		entry.sourceTime = texture.value("sourceTime", int64_t(0));
+		entries_[NormalizePath(texture.value("source", ""))] = entry;
+	}
+}
+
+std::string TextureCooker::Manifest::FindCookedPath(const std::string& sourcePath) const
+{
+	auto it = entries_.find(NormalizePath(sourcePath));
+	if (it == entries_.end())
+	{
+		return "";
+	}
+
+	//元画像が変換後に更新されていたら使わない
+	std::error_code error;
+	const Entry& entry = it->second;
+	if (std::filesystem::file_size(sourcePath, error) != entry.sourceSize || error ||
+		GetWriteTime(sourcePath) != entry.sourceTime ||
+		!std::filesystem::exists(entry.cookedPath, error))
+	{
+		return "";
+	}
+	return entry.cookedPath;
+}
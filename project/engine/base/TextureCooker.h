@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * \brief PNGなどの画像を、ミップマップ込みの圧縮DDSに変換しておく
+ * \note 変換は起動引数 --cook-textures で行う（ゲームは起動しない）。
+ *       TextureManagerはマニフェストを見て、元画像が変わっていなければ変換済みのDDSを読む
+ */
+namespace TextureCooker
+{
+	// 変換済みのファイルとマニフェストの置き場所
+	constexpr const char* kCookedDirectory = "Resources/cooked";
+	constexpr const char* kManifestPath = "Resources/cooked/texture_manifest.json";
+
+	// 起動引数
+	constexpr const char* kCommandLineOption = "--cook-textures";
+
+	/**
+	 * \brief フォルダ以下の.pngを全て変換し、マニフェストと比較結果を書き出す
+	 * \param resourceDirectory 探すフォルダ（変換済みのフォルダは除く）
+	 * \return 変換したテクスチャの数
+	 */
+	uint32_t CookDirectory(const std::string& resourceDirectory);
+
+	/**
+	 * \brief 読み込み時に参照するマニフェスト
+	 */
+	class Manifest
+	{
+	public:
+		/// \brief マニフェストファイルを読み込む（なければ空のまま）
+		void Load(const std::string& manifestPath = kManifestPath);
+
+		/**
+		 * \brief 元画像に対応する変換済みのDDSを探す
+		 * \note 元画像の大きさか更新日時が変換した時と違えば、古いとみなして使わない
+		 * \return 変換済みのDDSのパス。使えるものがなければ空
+		 */
+		std::string FindCookedPath(const std::string& sourcePath) const;
+
+		size_t GetEntryCount() const { return entries_.size(); }
+
+	private:
+		struct Entry
+		{
+			std::string cookedPath;
+			uint64_t sourceSize = 0;
+			int64_t sourceTime = 0;
+		};
+		//キーは正規化した元画像のパス
+		std::unordered_map<std::string, Entry> entries_;
+	};
+
+	/// \brief パスの表記を揃える（"./Resources/a.png"と"Resources/a.png"を同じにする）
+	std::string NormalizePath(const std::string& path);
+}
@@ -0,0 +1,188 @@
+#include "TextureUploader.h"
+
+#include <cassert>
+
+#include "base/DirectXCommon.h"
+#include "externals/DirectXTex/d3dx12.h"
+
+TextureUploader::~TextureUploader()
+{
+	//GPUがステージングバッファを使い終わるまで待つ
+	if (fence_)
+	{
+		WaitIdle();
+	}
+	if (fenceEvent_)
+	{
+		CloseHandle(fenceEvent_);
+	}
+}
+
+void TextureUploader::Initialize(DirectXCommon* dxCommon)
+{
+	dxCommon_ = dxCommon;
+	ID3D12Device* device = dxCommon_->GetDevice();
+
+	/*--------------[ コピーキューの生成 ]-----------------*/
+
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	HRESULT hr = device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&copyQueue_));
+	assert(SUCCEEDED(hr) && "ERROR: TextureUploader::Initialize() - Failed to create copy queue.");
+
+	/*--------------[ フェンスの生成 ]-----------------*/
+
+	hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(hr));
+	fenceEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	assert(fenceEvent_ != nullptr);
+}
+
+uint64_t TextureUploader::Enqueue(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages)
+{
+	if (!isRecording_)
+	{
+		BeginBatch();
+	}
+
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	DirectX::PrepareUpload(dxCommon_->GetDevice(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
+	uint64_t intermediateSize = GetRequiredIntermediateSize(texture, 0, UINT(subresources.size()));
+
+	StagingBuffer staging = AcquireStagingBuffer(intermediateSize);
+	UpdateSubresources(commandList_.Get(), texture, staging.resource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
+	stagingBytesInFlight_ += staging.size;
+	recordingStagingBuffers_.push_back(std::move(staging));
+
+	//このバッチをFlushした時にシグナルする値
+	return nextFenceValue_;
+}
+
+void TextureUploader::Flush()
+{
+	if (!isRecording_)
+	{
+		return;
+	}
+
+	HRESULT hr = commandList_->Close();
+	assert(SUCCEEDED(hr));
+	ID3D12CommandList* commandLists[] = { commandList_.Get() };
+	copyQueue_->ExecuteCommandLists(1, commandLists);
+
+	Batch batch;
+	batch.fenceValue = nextFenceValue_++;
+	batch.allocator = std::move(recordingAllocator_);
+	batch.stagingBuffers = std::move(recordingStagingBuffers_);
+	recordingStagingBuffers_.clear();
+	copyQueue_->Signal(fence_.Get(), batch.fenceValue);
+	batches_.push_back(std::move(batch));
+
+	isRecording_ = false;
+}
+
+void TextureUploader::Update()
+{
+	uint64_t completedValue = fence_->GetCompletedValue();
+
+	//古いバッチから順に、完了したものを回収する
+	while (!batches_.empty() && batches_.front().fenceValue <= completedValue)
+	{
+		Batch& batch = batches_.front();
+		for (StagingBuffer& staging : batch.stagingBuffers)
+		{
+			stagingBytesInFlight_ -= staging.size;
+			ReleaseStagingBuffer(std::move(staging));
+		}
+		freeAllocators_.push_back(std::move(batch.allocator));
+		batches_.pop_front();
+	}
+}
+
+bool TextureUploader::IsCompleted(uint64_t fenceValue) const
+{
+	return fence_->GetCompletedValue() >= fenceValue;
+}
+
+void TextureUploader::WaitIdle()
+{
+	Flush();
+
+	uint64_t lastValue = nextFenceValue_ - 1;
+	if (fence_->GetCompletedValue() < lastValue)
+	{
+		HRESULT hr = fence_->SetEventOnCompletion(lastValue, fenceEvent_);
+		assert(SUCCEEDED(hr));
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
+	Update();
+}
+
+void TextureUploader::BeginBatch()
+{
+	//完了したバッチのアロケータを使い回す
+	if (freeAllocators_.empty())
+	{
+		HRESULT hr = dxCommon_->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&recordingAllocator_));
+		assert(SUCCEEDED(hr));
+	}
+	else
+	{
+		recordingAllocator_ = std::move(freeAllocators_.back());
+		freeAllocators_.pop_back();
+		HRESULT hr = recordingAllocator_->Reset();
+		assert(SUCCEEDED(hr));
+	}
+
+	if (!commandList_)
+	{
+		HRESULT hr = dxCommon_->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, recordingAllocator_.Get(), nullptr, IID_PPV_ARGS(&commandList_));
+		assert(SUCCEEDED(hr));
+	}
+	else
+	{
+		HRESULT hr = commandList_->Reset(recordingAllocator_.Get(), nullptr);
+		assert(SUCCEEDED(hr));
+	}
+
+	isRecording_ = true;
+}
+
+TextureUploader::StagingBuffer TextureUploader::AcquireStagingBuffer(uint64_t size)
+{
+	//サイズを2の累乗に揃えて使い回しやすくする（プールに入らない大きさなら切り上げない）
+	uint64_t alignedSize = kMinStagingSize;
+	if (size > kMaxPooledBytes)
+	{
+		alignedSize = (size + kMinStagingSize - 1) & ~(kMinStagingSize - 1);
+	}
+	while (alignedSize < size)
+	{
+		alignedSize <<= 1;
+	}
+
+	auto it = freeStagingBuffers_.find(alignedSize);
+	if (it != freeStagingBuffers_.end())
+	{
+		StagingBuffer buffer = std::move(it->second);
+		freeStagingBuffers_.erase(it);
+		stagingBytesPooled_ -= buffer.size;
+		return buffer;
+	}
+
+	StagingBuffer buffer;
+	buffer.resource = dxCommon_->CreateBufferResource(alignedSize);
+	buffer.size = alignedSize;
+	return buffer;
+}
+
+void TextureUploader::ReleaseStagingBuffer(StagingBuffer&& buffer)
+{
+	//上限を超えるなら残さずに解放する
+	if (stagingBytesPooled_ + buffer.size > kMaxPooledBytes)
+	{
+		return;
+	}
+	stagingBytesPooled_ += buffer.size;
+	freeStagingBuffers_.emplace(buffer.size, std::move(buffer));
+}
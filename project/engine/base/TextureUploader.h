@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+#include <deque>
+#include <map>
+#include <vector>
+#include <wrl.h>
+
+#include "externals/DirectXTex/DirectXTex.h"
+
+class DirectXCommon;
+
+/**
+ * \brief 専用のコピーキューでテクスチャを転送する
+ * \note 転送元のステージングバッファはサイズごとに使い回し、コピーの完了をフェンスで確認してから返却する。
+ *       転送したテクスチャはコピーキューの実行後にCOMMON状態へ戻るので、グラフィックスキューでは暗黙の状態遷移でSRVとして使える
+ */
+class TextureUploader
+{
+public:
+	~TextureUploader();
+
+	/// \brief 初期化
+	void Initialize(DirectXCommon* dxCommon);
+
+	/**
+	 * \brief テクスチャへの転送を今のバッチに積む
+	 * \param texture 転送先（COPY_DEST状態で作ったもの）
+	 * \return この転送が完了したと判定できるフェンス値（IsCompletedに渡す）
+	 */
+	uint64_t Enqueue(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages);
+
+	/**
+	 * \brief 積んだ転送をコピーキューで実行する
+	 * \note 何も積んでいなければ何もしない
+	 */
+	void Flush();
+
+	/**
+	 * \brief 完了したバッチのステージングバッファとアロケータを回収する
+	 * \note 毎フレーム呼ぶ
+	 */
+	void Update();
+
+	/// \brief フェンス値の転送が完了したか
+	bool IsCompleted(uint64_t fenceValue) const;
+
+	/// \brief 積んだ転送を全て実行して、完了まで待つ
+	void WaitIdle();
+
+public: //アクセッサ
+	//GPUのコピー待ちで使っているステージングバッファのバイト数
+	uint64_t GetStagingBytesInFlight() const { return stagingBytesInFlight_; }
+	//使い回すために残しているステージングバッファのバイト数
+	uint64_t GetStagingBytesPooled() const { return stagingBytesPooled_; }
+	//完了待ちのバッチ数
+	size_t GetPendingBatchCount() const { return batches_.size(); }
+
+private:
+	// ステージングバッファ
+	struct StagingBuffer
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		uint64_t size = 0;
+	};
+
+	// 実行したバッチ
+	struct Batch
+	{
+		uint64_t fenceValue = 0;
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+		std::vector<StagingBuffer> stagingBuffers;
+	};
+
+	// 今のバッチのコマンドリストを開く
+	void BeginBatch();
+	// サイズに合うステージングバッファを取り出す（なければ作る）
+	StagingBuffer AcquireStagingBuffer(uint64_t size);
+	// ステージングバッファをプールに戻す（上限を超える分は解放する）
+	void ReleaseStagingBuffer(StagingBuffer&& buffer);
+
+private:
+	// 使い回すステージングバッファの合計の上限
+	static constexpr uint64_t kMaxPooledBytes = 64ull * 1024 * 1024;
+	// ステージングバッファの最小サイズ（これ以上は2の累乗に切り上げる）
+	static constexpr uint64_t kMinStagingSize = 64ull * 1024;
+
+	DirectXCommon* dxCommon_ = nullptr;
+
+	Microsoft::WRL::ComPtr<ID3D12CommandQueue> copyQueue_;
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
+	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
+	HANDLE fenceEvent_ = nullptr;
+	uint64_t nextFenceValue_ = 1;
+
+	// 記録中のバッチ
+	bool isRecording_ = false;
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> recordingAllocator_;
+	std::vector<StagingBuffer> recordingStagingBuffers_;
+
+	// 完了待ちのバッチ（古い順）
+	std::deque<Batch> batches_;
+	// 空いているコマンドアロケータ
+	std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> freeAllocators_;
+	// 空いているステージングバッファ（サイズごと）
+	std::multimap<uint64_t, StagingBuffer> freeStagingBuffers_;
+
+	// 統計
+	uint64_t stagingBytesInFlight_ = 0;
+	uint64_t stagingBytesPooled_ = 0;
+};
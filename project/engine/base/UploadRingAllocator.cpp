@@ -0,0 +1,74 @@
+#include "UploadRingAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+void UploadRingAllocator::Initialize(uint64_t capacity)
+{
+	capacity_ = capacity;
+	head_ = 0;
+	usedSize_ = 0;
+	frameSize_ = 0;
+	peakUsedSize_ = 0;
+	frames_.clear();
+}
+
+uint64_t UploadRingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	assert((alignment & (alignment - 1)) == 0 && "ERROR: UploadRingAllocator::Allocate() - Alignment must be a power of two.");
+	if (size == 0 || size > capacity_)
+	{
+		return kInvalidOffset;
+	}
+
+	uint64_t offset = (head_ + alignment - 1) & ~(alignment - 1);
+	uint64_t padding = offset - head_;
+
+	// 末尾に収まらなければ先頭に戻る（末尾の余りは詰め物として扱う）
+	if (offset + size > capacity_)
+	{
+		offset = 0;
+		padding = capacity_ - head_;
+	}
+
+	// GPUが使用中の領域に重なるなら割り当てない
+	if (usedSize_ + padding + size > capacity_)
+	{
+		return kInvalidOffset;
+	}
+
+	head_ = offset + size;
+	if (head_ == capacity_)
+	{
+		head_ = 0;
+	}
+	usedSize_ += padding + size;
+	frameSize_ += padding + size;
+	peakUsedSize_ = (std::max)(peakUsedSize_, usedSize_);
+	return offset;
+}
+
+void UploadRingAllocator::EndFrame(uint64_t fenceValue)
+{
+	FrameMark mark;
+	mark.fenceValue = fenceValue;
+	mark.size = frameSize_;
+	frames_.push_back(mark);
+	frameSize_ = 0;
+}
+
+void UploadRingAllocator::Release(uint64_t completedFenceValue)
+{
+	// 古いフレームから順に、完了したものだけ解放する
+	while (!frames_.empty() && frames_.front().fenceValue <= completedFenceValue)
+	{
+		usedSize_ -= frames_.front().size;
+		frames_.pop_front();
+	}
+
+	// 全て空いたら先頭から使い直して、末尾の詰め物を減らす
+	if (usedSize_ == 0)
+	{
+		head_ = 0;
+	}
+}
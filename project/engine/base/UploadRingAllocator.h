@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+/**
+ * \brief アップロード用バッファを先頭から順に切り出し、GPUが使い終わった分を再利用するリングアロケータ
+ * \note オフセットの計算とフェンスによる解放だけを扱い、GPUリソースは持たない
+ */
+class UploadRingAllocator
+{
+public:
+	// 割り当てに失敗した時のオフセット
+	static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+
+	/**
+	 * \brief 初期化
+	 * \param capacity リング全体のバイト数
+	 */
+	void Initialize(uint64_t capacity);
+
+	/**
+	 * \brief 領域を割り当てる
+	 * \param size バイト数
+	 * \param alignment 先頭のアライメント（2の累乗）
+	 * \return バッファ先頭からのオフセット。空きがなければkInvalidOffset
+	 */
+	uint64_t Allocate(uint64_t size, uint64_t alignment = 256);
+
+	/**
+	 * \brief 今フレームの割り当てを締め、GPUに送ったフェンス値と結び付ける
+	 * \param fenceValue このフレームのコマンドの完了時にシグナルされる値
+	 */
+	void EndFrame(uint64_t fenceValue);
+
+	/**
+	 * \brief GPUの処理が完了したフレームの領域を解放する
+	 * \param completedFenceValue ID3D12Fence::GetCompletedValueの値
+	 */
+	void Release(uint64_t completedFenceValue);
+
+public: //アクセッサ
+	uint64_t GetCapacity() const { return capacity_; }
+	uint64_t GetUsedSize() const { return usedSize_; }
+	uint64_t GetPeakUsedSize() const { return peakUsedSize_; }
+	// GPUの完了待ちになっているフレーム数
+	size_t GetPendingFrameCount() const { return frames_.size(); }
+
+private:
+	// 締めたフレームの情報
+	struct FrameMark
+	{
+		uint64_t fenceValue = 0;	// 完了を判定するフェンス値
+		uint64_t size = 0;			// フレーム中に使った量（詰め物を含む）
+	};
+
+	uint64_t capacity_ = 0;
+	uint64_t head_ = 0;				// 次に書き込む位置
+	uint64_t usedSize_ = 0;			// 使用中のバイト数
+	uint64_t frameSize_ = 0;		// 今フレームで使ったバイト数
+	uint64_t peakUsedSize_ = 0;
+	std::deque<FrameMark> frames_;
+};
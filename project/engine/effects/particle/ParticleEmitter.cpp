@@ -34,6 +34,21 @@ void ParticleEmitter::Update(CameraManager* camera)
 	// 発生位置の更新
 	UpdateEmitPosition();
 
+#ifdef _DEBUG
+	// 発生ポイントを描画（描画はワーカースレッドで記録されるので、ラインは更新で積む）
+	LineManager::GetInstance()->DrawSphere(
+		position_,
+		0.1f,
+		VectorColorCodes::Red
+	);
+	LineManager::GetInstance()->DrawAABB(
+		AABB(
+			position_ + emitRangeMin_,
+			position_ + emitRangeMax_),
+		VectorColorCodes::Green
+	);
+#endif
+
 	// パーティクル生成
 	Emit();
 
@@ -63,21 +78,6 @@ void ParticleEmitter::Update(CameraManager* camera)
 
 void ParticleEmitter::Draw(DirectXCommon* dxCommon, SrvManager* srvManager)
 {
-#ifdef _DEBUG
-	// 発生ポイントを描画
-	LineManager::GetInstance()->DrawSphere(
-		position_,
-		0.1f,
-		VectorColorCodes::Red
-	);
-	LineManager::GetInstance()->DrawAABB(
-		AABB(
-			position_ + emitRangeMin_,
-			position_ + emitRangeMax_),
-		VectorColorCodes::Green
-	);
-#endif
-
 	if (!particleGroup_) return;
 	particleGroup_->Draw(dxCommon, srvManager);
 }
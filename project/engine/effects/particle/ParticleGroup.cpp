@@ -18,12 +18,18 @@
 
 ParticleGroup::~ParticleGroup()
 {
+	// SRVの番号を返す（GPUが使い終わってから再利用される）
+	if (srvManager_)
+	{
+		srvManager_->Free(instancingSrvHandle);
+	}
 	// リソースの解放
 	if (instancingResource)
 	{
 		instancingResource->Unmap(0, nullptr);
 		instancingResource.Reset();
 		instancingData = nullptr;
+		frameInstancingData = nullptr;
 	}
 	if (vertexResource)
 	{
@@ -73,23 +79,35 @@ void ParticleGroup::Initialize(const std::string& groupName, const std::string&
 	vertexBufferView.StrideInBytes = sizeof(VertexData);
 	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * rectangleVertices.size());
 
-	// インスタンシング用リソースの初期化
-	instancingResource = ParticleManager::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kMaxParticleCount);
+	// インスタンシング用リソースの初期化（同時に処理中になるフレームの数だけ区画を持つ）
+	instancingResource = ParticleManager::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kMaxParticleCount * DirectXCommon::kFrameCount);
 	instancingResource->Map(0, nullptr, reinterpret_cast<void**>(&instancingData));
-	instancingSrvIndex = ParticleManager::GetInstance()->GetSrvManager()->Allocate();
-	// SRVの生成
-	ParticleManager::GetInstance()->GetSrvManager()->CreateSRVforStructuredBuffer(
-		instancingSrvIndex,
-		instancingResource.Get(),
-		kMaxParticleCount, // numElements: パーティクルの最大数
-		sizeof(ParticleForGPU) // structureByteStride: 各パーティクルのサイズ
-	);
+	frameInstancingData = instancingData;
+	// 区画ごとにSRVを生成
+	srvManager_ = ParticleManager::GetInstance()->GetSrvManager();
+	srvManager_->Free(instancingSrvHandle);
+	instancingSrvHandle = srvManager_->AllocateRange(DirectXCommon::kFrameCount);
+	for (uint32_t frame = 0; frame < DirectXCommon::kFrameCount; ++frame)
+	{
+		srvManager_->CreateSRVforStructuredBuffer(
+			instancingSrvHandle.index + frame,
+			instancingResource.Get(),
+			kMaxParticleCount, // numElements: パーティクルの最大数
+			sizeof(ParticleForGPU), // structureByteStride: 各パーティクルのサイズ
+			frame * kMaxParticleCount // firstElement: 区画の先頭
+		);
+	}
 }
 
 void ParticleGroup::Update(CameraManager* camera)
 {
+	instanceCount = 0; // このグループのインスタンスカウントをリセット
+
 	if (particles.empty()) { return; } // パーティクルがない場合は更新しない
 
+	// 今フレームの区画に書き込む
+	frameInstancingData = instancingData + ParticleManager::GetInstance()->GetDxCommon()->GetFrameIndex() * kMaxParticleCount;
+
 	float kDeltaTime = TimeManager::GetInstance().GetDeltaTime();
 
 	// ビルボード用の行列計算
@@ -105,8 +123,6 @@ void ParticleGroup::Update(CameraManager* camera)
 	// カメラの回転をビルボード行列に適用
 	billboardMatrix = backToFrontMatrix * cameraRotationMatrix;
 
-	instanceCount = 0; // このグループのインスタンスカウントをリセット
-
 	for (auto particleItr = particles.begin(); particleItr != particles.end(); )
 	{
 		// 寿命の更新
@@ -140,9 +156,10 @@ void ParticleGroup::Draw(DirectXCommon* dxCommon, SrvManager* srvManager)
 
 	//描画設定
 	dxCommon->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+	//テクスチャはヒープ全体のテーブルから番号で引く（転送中なら代わりのテクスチャ）
+	materialData_->textureIndex = TextureManager::GetInstance()->GetDrawSrvIndex(modelData_.textureIndex);
 	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
-	dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(1, srvManager->GetGPUDescriptorHandle(instancingSrvIndex));
-	dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(2, srvManager->GetGPUDescriptorHandle(modelData_.textureIndex));
+	dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(1, srvManager->GetGPUDescriptorHandle(instancingSrvHandle, dxCommon->GetFrameIndex()));
 	// インスタンシング描画
 	dxCommon->GetCommandList()->DrawInstanced(vertexCount, instanceCount, 0, 0);
 }
@@ -241,11 +258,11 @@ void ParticleGroup::UpdateInstanceData(Particle& particle, const Matrix4x4& bill
 							 Multiply(camera->GetActiveCamera()->GetViewMatrix(),
 									  camera->GetActiveCamera()->GetProjectionMatrix()));
 	// インスタンシング用データにセット
-	if (instancingData)
+	if (frameInstancingData)
 	{
-		instancingData[instanceCount].World = worldMatrixInstancing;
-		instancingData[instanceCount].WVP = wvp;
-		instancingData[instanceCount].color = particle.color;
+		frameInstancingData[instanceCount].World = worldMatrixInstancing;
+		frameInstancingData[instanceCount].WVP = wvp;
+		frameInstancingData[instanceCount].color = particle.color;
 	}
 }
 
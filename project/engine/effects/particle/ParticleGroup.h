@@ -1,13 +1,14 @@
 #pragma once
+#include <array>
 #include <d3d12.h>
 #include <list>
 #include <memory>
 #include <wrl.h>
 
+#include "base/DirectXCommon.h"
 #include "base/GraphicsTypes.h"
+#include "manager/system/SrvManager.h"
 
-class SrvManager;
-class DirectXCommon;
 class CameraManager;
 
 class ParticleGroup
@@ -68,10 +69,14 @@ private:
 	const uint32_t kMaxParticleCount = 100; // 最大パーティクル数
 
 	MaterialData materialData;
-	uint32_t instancingSrvIndex = 0;
+	// インスタンシング用バッファはフレームごとに区切って使う（GPUが描画中の区画を書き換えないため）
+	// 区画ごとのSRVはフレーム番号順に連続して確保し、破棄する時に返す
+	SrvHandle instancingSrvHandle = {};
+	SrvManager* srvManager_ = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource = nullptr;
 	uint32_t instanceCount = 0;
-	ParticleForGPU* instancingData = nullptr;
+	ParticleForGPU* instancingData = nullptr;			// バッファ全体の先頭
+	ParticleForGPU* frameInstancingData = nullptr;		// 今フレームに書き込む区画の先頭
 	//モデルの頂点データ
 	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = nullptr;
 	VertexData* vertexData = nullptr;
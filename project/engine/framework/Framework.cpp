@@ -1,6 +1,7 @@
 #include "Framework.h"
 
 #include "audio/Audio.h"
+#include "base/JobSystem.h"
 #include "base/Logger.h"
 #include "input/Input.h"
 
@@ -24,6 +25,9 @@
 
 void Framework::Initialize()
 {
+	// ジョブシステムの初期化（素材の並列読み込みなどに使う）
+	JobSystem::GetInstance()->Initialize();
+
 	// ウィンドウアプリケーションの初期化
 	winApp_ = std::make_unique<WinApp>();
 	winApp_->Initialize();
@@ -87,7 +91,7 @@ void Framework::Initialize()
 
 	// ライトマネージャーの初期化
 	lightManager_ = std::make_unique<LightManager>();
-	lightManager_->Initialize(dxCommon_.get());
+	lightManager_->Initialize(dxCommon_.get(), srvManager_.get());
 
 	// ラインマネージャーの初期化
 	LineManager::GetInstance()->Initialize(dxCommon_.get(), cameraManager_.get());
@@ -110,6 +114,7 @@ void Framework::Initialize()
 void Framework::Finalize()
 {
 	//NOTE:ここは基本的に触らない
+	dxCommon_->WaitForGpu();						// 処理中のフレームを待ってからリソースを解放する
 	sceneManager_.reset();							// シーンマネージャーの解放
 	winApp_->Finalize();							// ウィンドウアプリケーションの終了処理
 	winApp_.reset();								// ウィンドウアプリケーションの解放
@@ -128,6 +133,7 @@ void Framework::Finalize()
 	renderTexture_.reset();							// レンダーテクスチャの解放
 	postProcessManager_.reset();					// ポストプロセスマネージャーの解放
 	JsonEditorManager::GetInstance()->Finalize();	// JSONエディターの終了処理
+	JobSystem::GetInstance()->Finalize();			// ジョブシステムの終了処理
 }
 
 void Framework::Update()
@@ -156,6 +162,12 @@ void Framework::Update()
 	//オーディオの更新
 	Audio::GetInstance()->Update();
 
+	//テクスチャの転送状況の更新
+	TextureManager::GetInstance()->Update();
+
+	//書き換えたシェーダーのホットリロード（_DEBUGのみ）
+	dxCommon_->UpdateShaderHotReload();
+
 	//ライトマネージャーの更新
 	lightManager_->Update();
 
@@ -212,13 +224,23 @@ void Framework::ShowPerformanceInfo()
 	// ウィンドウの位置を左上に固定
 	ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
 	// ウィンドウのサイズを固定
-	ImGui::SetNextWindowSize(ImVec2(200, 65), ImGuiCond_Always);
+	ImGui::SetNextWindowSize(ImVec2(200, 165), ImGuiCond_Always);
 	ImGui::Begin("Performance", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
 	ImGui::Text("FPS : %.2f", ImGui::GetIO().Framerate);
 	// メモリ使用量
 	PROCESS_MEMORY_COUNTERS memInfo;
 	GetProcessMemoryInfo(GetCurrentProcess(), &memInfo, sizeof(memInfo));
 	ImGui::Text("Memory Usage : %.2f MB", memInfo.WorkingSetSize / (1024.0f * 1024.0f));
+	// 描画キューの描画コール数
+	ImGui::Text("Draw Calls : %u / %u", objectCommon_->GetLastDrawCallCount(), objectCommon_->GetLastQueuedItemCount());
+	// スプライトバッチの描画コール数
+	ImGui::Text("Sprite Draws : %u / %u", spriteCommon_->GetLastDrawCallCount(), spriteCommon_->GetLastQuadCount());
+	// 1フレームで実行したコマンドリスト数（うち描画キューを分けた数）
+	ImGui::Text("Command Lists : %u (%u)", dxCommon_->GetLastCommandListCount(), objectCommon_->GetLastCommandListCount());
+	// 視錐台カリングで描画したオブジェクト数
+	ImGui::Text("Visible : %u / %u", objectCommon_->GetLastCullVisibleCount(), objectCommon_->GetLastCullTestedCount());
+	// SRVの使用数とヒープの大きさ
+	ImGui::Text("SRV : %u / %u", srvManager_->GetAllocator().GetAllocatedCount(), srvManager_->GetAllocator().GetCapacity());
 	ImGui::End();
 #endif
 }
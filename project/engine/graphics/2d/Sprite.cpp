@@ -3,6 +3,20 @@
 #include "SpriteCommon.h"
 #include "manager/graphics/TextureManager.h"
 
+namespace
+{
+	// 行ベクトルに行列を掛ける（シェーダーのmul(position, WVP)と同じ）
+	Vector4 TransformPoint(const Vector4& v, const Matrix4x4& m)
+	{
+		return {
+			v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + v.w * m.m[3][0],
+			v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + v.w * m.m[3][1],
+			v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + v.w * m.m[3][2],
+			v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + v.w * m.m[3][3]
+		};
+	}
+}
+
 void Sprite::Initialize(SpriteCommon* spriteCommon, std::string textureFilePath)
 {
 	//引数で受け取ってメンバ変数に記録する
@@ -29,33 +43,16 @@ void Sprite::Update()
 
 void Sprite::Draw()
 {
-	/*--------------[ VertexBufferViewを設定 ]-----------------*/
-
-	spriteCommon_->GetDXCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
-
-	/*--------------[ IndexBufferViewを設定 ]-----------------*/
-
-	spriteCommon_->GetDXCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView_);
-
-	/*--------------[ マテリアルCBufferの場所を設定 ]-----------------*/
-
-	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
-	
-	/*--------------[ 座標変換行列CBufferの場所を設定 ]-----------------*/
-
-	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, wvpResource_->GetGPUVirtualAddress());
-
-	/*--------------[ ShaderResourceViewの設定 ]-----------------*/
-
-	spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex_));
-
-	/*--------------[ ライティングの設定。今はしない ]-----------------*/
-
-	//spriteCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
-
-	/*--------------[ 描画(DrawCall//ドローコール) ]-----------------*/
+	//頂点をクリップ空間に変換して色を持たせる（スプライトごとの定数バッファを使わずに1本の頂点列で描けるように）
+	SpriteVertex vertices[SpriteBatch::kVerticesPerQuad];
+	for (uint32_t i = 0; i < SpriteBatch::kVerticesPerQuad; ++i)
+	{
+		vertices[i].position = TransformPoint(vertexData_[i].position, worldViewProjection_);
+		vertices[i].texcoord = vertexData_[i].texcoord;
+		vertices[i].color = color_;
+	}
 
-	spriteCommon_->GetDXCommon()->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
+	spriteCommon_->Submit(textureIndex_, layer_, vertices);
 }
 
 void Sprite::SetTexture(std::string filePath)
@@ -70,88 +67,9 @@ void Sprite::SetTexture(std::string filePath)
 
 void Sprite::CreateVertexData()
 {
-	/*--------------[ MaterialResourceを作る ]-----------------*/
-
-	materialResource_ = spriteCommon_->GetDXCommon()->CreateBufferResource(sizeof(Material));
-
-	/*--------------[ VertexResourceを作る ]-----------------*/
-	
-	vertexResource_ = spriteCommon_->GetDXCommon()->CreateBufferResource(sizeof(VertexData) * 4);
-
-	/*--------------[ IndexResourceを作る ]-----------------*/
-
-	indexResource_ = spriteCommon_->GetDXCommon()->CreateBufferResource(sizeof(uint32_t) * 6);
-
-	/*--------------[ 座標変換行列リソースを作る ]-----------------*/
-
-	wvpResource_ = spriteCommon_->GetDXCommon()->CreateBufferResource(sizeof(TransformationMatrix));
-
-	/*--------------[ VertexBufferViewを作成する（値を設定するだけ） ]-----------------*/
-
-	//リソースの先頭アドレスから使う
-	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
-	//使用するリソースのサイズは頂点３つ分のサイズ
-	vertexBufferView_.SizeInBytes = sizeof(VertexData) * 4;
-	//1頂点当たりのサイズ
-	vertexBufferView_.StrideInBytes = sizeof(VertexData);
-
-	/*--------------[ IndexBufferViewを作成する（値を設定するだけ） ]-----------------*/
-
-	//リソースの先頭のアドレスから使う
-	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
-	//使用するリソースのサイズをインデックス6つ分のサイズ
-	indexBufferView_.SizeInBytes = sizeof(uint32_t) * 6;
-	//インデックスはuint32_tとする
-	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
-
-	/*--------------[ MaterialResourceにデータを書き込むためのアドレスを取得してvertexDataに割り当てる ]-----------------*/
-
-	materialResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&materialData_)
-	);
-
-	/*--------------[ マテリアルデータの初期値を書き込む ]-----------------*/
-
-	materialData_->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData_->enableLighting = false;
-	materialData_->uvTransform = MakeIdentity4x4();
-
-	/*--------------[ VertexResourceにデータを書き込むためのアドレスを取得してvertexDataに割り当てる ]-----------------*/
-
-	vertexResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&vertexData_)
-	);
-
-	/*--------------[ IndexResourceにデータを書き込むためのアドレスを取得してindexDataに割り当てる ]-----------------*/
-
-	indexResource_->Map(
-		0, 
-		nullptr, 
-		reinterpret_cast<void**>(&indexData_)
-	);
-
-	/*--------------[ 座標変換行列にデータを書き込むためのアドレスを取得してindexDataに割り当てる ]-----------------*/
-
-	wvpResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&transformationMatrixData_)
-	);
-
 	/*--------------[ 座標変換行列の初期値を書き込む ]-----------------*/
 
-	transformationMatrixData_->WVP = MakeIdentity4x4();
-	transformationMatrixData_->World = MakeIdentity4x4();
-
-	/*--------------[ インデックスリソースにデータを書き込む ]-----------------*/
-
-	indexData_[0] = 0;		indexData_[1] = 1;		indexData_[2] = 2;
-	indexData_[3] = 1;		indexData_[4] = 3;		indexData_[5] = 2;
-
+	worldViewProjection_ = MakeIdentity4x4();
 }
 
 void Sprite::UpdateVertexData()
@@ -199,12 +117,6 @@ void Sprite::UpdateVertexData()
 	vertexData_[1].texcoord = { tex_left,tex_top };
 	vertexData_[2].texcoord = { tex_right,tex_bottom };
 	vertexData_[3].texcoord = { tex_right,tex_top };
-
-	//頂点データの法線
-	vertexData_[0].normal = { 0.0f,0.0f,-1.0f };
-	vertexData_[1].normal = { 0.0f,0.0f,-1.0f };
-	vertexData_[3].normal = { 0.0f,0.0f,-1.0f };	
-	vertexData_[3].normal = { 0.0f,0.0f,-1.0f };
 }
 
 void Sprite::UpdateMatrix()
@@ -225,8 +137,7 @@ void Sprite::UpdateMatrix()
 	Matrix4x4 viewMatrixSprite = MakeIdentity4x4();
 	Matrix4x4 projectionMatrixSprite = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
 	Matrix4x4 worldViewProjectionMatrixSprite = Multiply(worldMatrixSprite, Multiply(viewMatrixSprite, projectionMatrixSprite));
-	transformationMatrixData_->WVP = worldViewProjectionMatrixSprite;
-	transformationMatrixData_->World = worldMatrixSprite;
+	worldViewProjection_ = worldViewProjectionMatrixSprite;
 }
 
 void Sprite::AdjustTextureSize()
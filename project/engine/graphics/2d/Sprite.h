@@ -26,7 +26,7 @@ public: //メンバ関数
 	void Update();
 
 	/**
-	 * \brief 描画
+	 * \brief 描画（SpriteCommonのバッチに積み、2D描画の最後にまとめて描画される）
 	 */
 	void Draw();
 
@@ -40,7 +40,7 @@ public: //アクセッサ
 	float GetRotation() const { return rotation_; }
 
 	//// \brief 色の取得
-	const Vector4& GetColor() const { return materialData_->color; }
+	const Vector4& GetColor() const { return color_; }
 
 	//// \brief サイズの取得
 	const Vector2& GetSize() const { return size_; }
@@ -60,6 +60,9 @@ public: //アクセッサ
 	/// \brief テクスチャ切り出しサイズの取得
 	const Vector2& GetTextureSize() const { return textureSize_; }
 
+	/// \brief 描画レイヤーの取得
+	int32_t GetLayer() const { return layer_; }
+
 	/*---------------[ セッター ]---------------*/
 
 	/// \brief テクスチャの差し替え
@@ -72,7 +75,7 @@ public: //アクセッサ
 	void SetRotation(float rotation) { rotation_ = rotation; }
 
 	/// \brief 色の設定
-	void SetColor(const Vector4& color) { materialData_->color = color; }
+	void SetColor(const Vector4& color) { color_ = color; }
 
 	//// \brief サイズの設定
 	void SetSize(const Vector2& size) { size_ = size; }
@@ -92,6 +95,9 @@ public: //アクセッサ
 	/// \brief テクスチャ切り出しサイズの設定
 	void SetTextureSize(const Vector2& textureSize) { textureSize_ = textureSize; }
 
+	/// \brief 描画レイヤーの設定（小さいほど先に描く。重なりの順が必要なスプライトはレイヤーを分ける）
+	void SetLayer(int32_t layer) { layer_ = layer; }
+
 private: //メンバ関数
 	/// \brief 頂点データ作成
 	void CreateVertexData();
@@ -110,19 +116,10 @@ private: //メンバ関数
 private: //描画用変数
 	SpriteCommon* spriteCommon_ = nullptr;
 
-	//バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource_;
-	//バッファリソース内のデータを指すポインタ
-	Material* materialData_ = nullptr;
-	VertexData* vertexData_ = nullptr;
-	uint32_t* indexData_ = nullptr;
-	TransformationMatrix* transformationMatrixData_ = nullptr;
-	//バッファリソースの使い道を補足するバッファビュー
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_;
-	D3D12_INDEX_BUFFER_VIEW indexBufferView_;
+	//描画時にクリップ空間へ変換してバッチに積むデータ
+	Vector4 color_ = { 1.0f,1.0f,1.0f,1.0f };
+	VertexData vertexData_[4]{};
+	Matrix4x4 worldViewProjection_{};
 
 private: //メンバ変数
 	//テクスチャ番号
@@ -152,5 +149,8 @@ private: //メンバ変数
 	//テクスチャ切り出しサイズ
 	Vector2 textureSize_ = { 0.0f,0.0f };
 
+	//描画レイヤー
+	int32_t layer_ = 0;
+
 };
 
@@ -0,0 +1,64 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool SpriteBatch::Add(uint32_t textureIndex, int32_t layer, const SpriteVertex (&vertices)[kVerticesPerQuad])
+{
+	if (items_.size() >= kMaxQuadCount)
+	{
+		return false;
+	}
+
+	// 符号ビットを反転すると、負のレイヤーも符号なしのまま大小を比べられる
+	const uint64_t layerKey = static_cast<uint32_t>(layer) ^ 0x80000000u;
+
+	Item item;
+	item.sortKey = (layerKey << 32) | textureIndex;
+	item.quadIndex = static_cast<uint32_t>(items_.size());
+	item.textureIndex = textureIndex;
+	items_.push_back(item);
+	vertices_.insert(vertices_.end(), vertices, vertices + kVerticesPerQuad);
+	return true;
+}
+
+void SpriteBatch::Clear()
+{
+	items_.clear();
+	vertices_.clear();
+	runs_.clear();
+}
+
+void SpriteBatch::Build()
+{
+	runs_.clear();
+	if (items_.empty())
+	{
+		return;
+	}
+
+	// 同じキーの間は積んだ順を保つ
+	std::stable_sort(items_.begin(), items_.end(), [](const Item& a, const Item& b) { return a.sortKey < b.sortKey; });
+
+	// 同じテクスチャが連続する範囲を1回の描画にまとめる（レイヤーをまたいでも並びが続いていればよい）
+	for (uint32_t i = 0; i < items_.size(); ++i)
+	{
+		if (runs_.empty() || runs_.back().textureIndex != items_[i].textureIndex)
+		{
+			Run run;
+			run.textureIndex = items_[i].textureIndex;
+			run.firstQuad = i;
+			runs_.push_back(run);
+		}
+		++runs_.back().quadCount;
+	}
+}
+
+void SpriteBatch::WriteVertices(SpriteVertex* destination) const
+{
+	for (const Item& item : items_)
+	{
+		std::memcpy(destination, &vertices_[static_cast<size_t>(item.quadIndex) * kVerticesPerQuad], sizeof(SpriteVertex) * kVerticesPerQuad);
+		destination += kVerticesPerQuad;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief 1フレーム分のスプライトの矩形を溜めて、レイヤーとテクスチャで並べ替えるクラス
+ * \note GPUには触れないので、積む・並べる・まとめる処理だけを単体で確認できる。
+ *       レイヤーの小さい順に描画し、同じレイヤーの中ではテクスチャごとにまとめる（同じテクスチャの間は積んだ順）。
+ *       同じレイヤーでテクスチャが違う矩形の前後は保証しないので、重なりの順が必要ならレイヤーを分ける
+ */
+class SpriteBatch
+{
+public:
+	// 1フレームに積める最大の矩形数（これを超えた矩形は捨てる）
+	static constexpr uint32_t kMaxQuadCount = 16384;
+	// 1矩形の頂点数
+	static constexpr uint32_t kVerticesPerQuad = 4;
+
+	// 同じテクスチャの矩形が連続する範囲（1回の描画の単位）
+	struct Run
+	{
+		uint32_t textureIndex = 0;
+		uint32_t firstQuad = 0;		// Build後の並びの先頭からの位置
+		uint32_t quadCount = 0;
+	};
+
+	/**
+	 * \brief 矩形を積む
+	 * \param textureIndex テクスチャの番号
+	 * \param layer 描画レイヤー（小さいほど先に描く）
+	 * \param vertices 左下・左上・右下・右上の順の頂点
+	 * \return 上限を超えて積めなかったらfalse
+	 */
+	bool Add(uint32_t textureIndex, int32_t layer, const SpriteVertex (&vertices)[kVerticesPerQuad]);
+
+	// 積んだ矩形を全て破棄する
+	void Clear();
+
+	// ソートして描画の単位にまとめる
+	void Build();
+
+	/**
+	 * \brief Build後の並び順で頂点を書き込む
+	 * \param destination GetQuadCount() * kVerticesPerQuad 個の頂点を書ける領域
+	 */
+	void WriteVertices(SpriteVertex* destination) const;
+
+public: //アクセッサ
+	const std::vector<Run>& GetRuns() const { return runs_; }
+	uint32_t GetQuadCount() const { return static_cast<uint32_t>(items_.size()); }
+	uint32_t GetRunCount() const { return static_cast<uint32_t>(runs_.size()); }
+	bool IsEmpty() const { return items_.empty(); }
+
+private:
+	// 積んだ矩形1つ分
+	struct Item
+	{
+		uint64_t sortKey = 0;		// [レイヤー32bit][テクスチャ32bit]
+		uint32_t quadIndex = 0;		// vertices_の矩形の位置
+		uint32_t textureIndex = 0;
+	};
+
+	std::vector<Item> items_;
+	std::vector<SpriteVertex> vertices_;	// 積んだ順
+	std::vector<Run> runs_;
+};
@@ -1,8 +1,12 @@
 #include "SpriteCommon.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <format>
 
 #include "base/Logger.h"
+#include "manager/graphics/TextureManager.h"
 
 void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 {
@@ -11,6 +15,13 @@ void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 
 	//グラフィックスパイプラインの生成
 	CreateGraphicsPipelineState();
+	//シェーダーを書き換えたら作り直す
+	dxCommon_->AddShaderReloadListener(
+		{ L"Resources/shaders/Sprite.VS.hlsl", L"Resources/shaders/Sprite.PS.hlsl" },
+		[this]() { CreateGraphicsPipelineState(); });
+
+	//矩形の並びのインデックスバッファの生成
+	CreateIndexBuffer();
 }
 
 void SpriteCommon::CommonRenderingSetting()
@@ -26,6 +37,91 @@ void SpriteCommon::CommonRenderingSetting()
 
 }
 
+void SpriteCommon::Submit(uint32_t textureIndex, int32_t layer, const SpriteVertex (&vertices)[SpriteBatch::kVerticesPerQuad])
+{
+	if (!batch_.Add(textureIndex, layer, vertices) && !hasWarnedOverflow_)
+	{
+		Logger::Log(std::format("WARNING: Sprites exceeded {} in a frame. The rest are not drawn.\n", SpriteBatch::kMaxQuadCount));
+		hasWarnedOverflow_ = true;
+	}
+}
+
+void SpriteCommon::FlushBatch()
+{
+	lastDrawCallCount_ = 0;
+	lastQuadCount_ = batch_.GetQuadCount();
+	if (batch_.IsEmpty())
+	{
+		return;
+	}
+
+	//レイヤーとテクスチャで並べ替える
+	batch_.Build();
+
+	/*--------------[ 全ての頂点を1度にリングへ書く ]-----------------*/
+
+	const uint32_t vertexCount = batch_.GetQuadCount() * SpriteBatch::kVerticesPerQuad;
+	UploadAllocation allocation = dxCommon_->AllocateUpload(sizeof(SpriteVertex) * vertexCount, 16);
+	if (allocation.cpuAddress)
+	{
+		batch_.WriteVertices(static_cast<SpriteVertex*>(allocation.cpuAddress));
+
+		D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+		vertexBufferView.BufferLocation = allocation.gpuAddress;
+		vertexBufferView.SizeInBytes = static_cast<UINT>(sizeof(SpriteVertex) * vertexCount);
+		vertexBufferView.StrideInBytes = sizeof(SpriteVertex);
+
+		CommonRenderingSetting();
+		auto commandList = dxCommon_->GetCommandList();
+		commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+		commandList->IASetIndexBuffer(&indexBufferView_);
+
+		/*--------------[ テクスチャの並びごとに描画 ]-----------------*/
+
+		for (const SpriteBatch::Run& run : batch_.GetRuns())
+		{
+			commandList->SetGraphicsRootDescriptorTable(0, TextureManager::GetInstance()->GetSrvHandleGPU(run.textureIndex));
+
+			//インデックスは矩形kMaxQuadsPerDraw個分なので、それより長い並びは頂点の開始位置をずらして分ける
+			for (uint32_t offset = 0; offset < run.quadCount; offset += kMaxQuadsPerDraw)
+			{
+				const uint32_t quadCount = (std::min)(run.quadCount - offset, kMaxQuadsPerDraw);
+				const INT baseVertex = static_cast<INT>((run.firstQuad + offset) * SpriteBatch::kVerticesPerQuad);
+				commandList->DrawIndexedInstanced(quadCount * 6, 1, 0, baseVertex, 0);
+				++lastDrawCallCount_;
+			}
+		}
+	}
+
+	batch_.Clear();
+	hasWarnedOverflow_ = false;
+}
+
+void SpriteCommon::CreateIndexBuffer()
+{
+	//矩形を2枚の三角形で描くインデックスを、矩形の数だけ頂点をずらして並べる
+	constexpr uint16_t kQuadIndices[6] = { 0, 1, 2, 1, 3, 2 };
+	std::vector<uint16_t> indices(kMaxQuadsPerDraw * 6);
+	for (uint32_t quad = 0; quad < kMaxQuadsPerDraw; ++quad)
+	{
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			indices[quad * 6 + i] = static_cast<uint16_t>(quad * SpriteBatch::kVerticesPerQuad + kQuadIndices[i]);
+		}
+	}
+
+	const UINT sizeInBytes = static_cast<UINT>(sizeof(uint16_t) * indices.size());
+	indexResource_ = dxCommon_->CreateBufferResource(sizeInBytes);
+	void* mappedData = nullptr;
+	indexResource_->Map(0, nullptr, &mappedData);
+	std::memcpy(mappedData, indices.data(), sizeInBytes);
+	indexResource_->Unmap(0, nullptr);
+
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = sizeInBytes;
+	indexBufferView_.Format = DXGI_FORMAT_R16_UINT;
+}
+
 void SpriteCommon::CreateRootSignature()
 {
 	///===================================================================
@@ -46,25 +142,12 @@ void SpriteCommon::CreateRootSignature()
 	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
 	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
-	//RootParameter作成。複数設定できるので配列。今回は結果１つだけなので長さ１の配列
-	D3D12_ROOT_PARAMETER rootParameters[4] = {};
-	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;		//CBVを使う
-	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;		//PixelShaderで使う
-	rootParameters[0].Descriptor.ShaderRegister = 0;						//レジスタ番号０とバインド
-
-	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
-	rootParameters[1].Descriptor.ShaderRegister = 0;
-
-	rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;			//DescriptorTableを使う
-	rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;						//PixelShaderで使う
-	rootParameters[2].DescriptorTable.pDescriptorRanges = descriptorRange;					//Tableの中身の配列を指定
-	rootParameters[2].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange);		//Tableで利用する数
-
-	rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-	rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	rootParameters[3].Descriptor.RegisterSpace = 0;
-	rootParameters[3].Descriptor.ShaderRegister = 1;
+	//RootParameter作成。頂点に色と変換済みの座標を持たせるので、描画の並びごとに変わるテクスチャだけを渡す
+	D3D12_ROOT_PARAMETER rootParameters[1] = {};
+	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;			//DescriptorTableを使う
+	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;						//PixelShaderで使う
+	rootParameters[0].DescriptorTable.pDescriptorRanges = descriptorRange;					//Tableの中身の配列を指定
+	rootParameters[0].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange);		//Tableで利用する数
 
 	//Smaplerの設定
 	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
@@ -82,21 +165,8 @@ void SpriteCommon::CreateRootSignature()
 	descriptionRootSignature.pParameters = rootParameters;					//ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters);		//配列の長さ
 
-	HRESULT hr;
-
-	//シリアライズしてバイナリする
-	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
-	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-	hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
-	if (FAILED(hr))
-	{
-		Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
-		assert(false);
-	}
-	//バイナリをもとに生成
-
-	hr = dxCommon_->GetDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
-	assert(SUCCEEDED(hr));
+	//生成（同じ記述のものがあれば共有する）
+	rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(descriptionRootSignature);
 }
 
 void SpriteCommon::CreateGraphicsPipelineState()
@@ -104,8 +174,6 @@ void SpriteCommon::CreateGraphicsPipelineState()
 	//ルートシグネチャ
 	CreateRootSignature();
 
-	HRESULT hr;
-
 	///===================================================================
 	///InputLayout(インプットレイアウト)
 	///===================================================================
@@ -122,9 +190,9 @@ void SpriteCommon::CreateGraphicsPipelineState()
 	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
 	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
-	inputElementDescs[2].SemanticName = "NORMAL";
+	inputElementDescs[2].SemanticName = "COLOR";
 	inputElementDescs[2].SemanticIndex = 0;
-	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
 	inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
@@ -210,8 +278,6 @@ void SpriteCommon::CreateGraphicsPipelineState()
 	//どのように画面に色を打ち込むかの設定（気にしなくていい）
 	graphicsPipelineStateDesc.SampleDesc.Count = 1;
 	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
-	//実際に生成
-
-	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineState_));
-	assert(SUCCEEDED(hr));
+	//実際に生成（同じ記述のものがあれば共有する）
+	graphicsPipelineState_ = dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(graphicsPipelineStateDesc);
 }
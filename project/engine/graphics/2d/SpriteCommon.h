@@ -3,6 +3,7 @@
 #include <wrl.h>
 
 #include "base/DirectXCommon.h"
+#include "SpriteBatch.h"
 
 //スプライト共通部分
 class SpriteCommon
@@ -14,14 +15,33 @@ public: //メンバ関数
 	//共通描画設定
 	void CommonRenderingSetting();
 
+	/**
+	 * \brief 矩形を今フレームのバッチに積む
+	 * \param textureIndex テクスチャの番号
+	 * \param layer 描画レイヤー（小さいほど先に描く）
+	 * \param vertices 左下・左上・右下・右上の順の頂点
+	 */
+	void Submit(uint32_t textureIndex, int32_t layer, const SpriteVertex (&vertices)[SpriteBatch::kVerticesPerQuad]);
+
+	/**
+	 * \brief 積んだ矩形を1本の頂点列にまとめて、テクスチャの並びごとに1回ずつ描画する
+	 * \note 2D描画の最後に、積んだのと同じコマンドリストで1度だけ呼ぶ
+	 */
+	void FlushBatch();
+
 public: //アクセッサ
 	DirectXCommon* GetDXCommon() const { return dxCommon_; }
+	// 前回のFlushBatchの描画コール数と矩形数
+	uint32_t GetLastDrawCallCount() const { return lastDrawCallCount_; }
+	uint32_t GetLastQuadCount() const { return lastQuadCount_; }
 
 private: //メンバ関数
 	/// \brief ルートシグネチャの生成
 	void CreateRootSignature();
 	/// \brief グラフィックスパイプラインステートの生成
 	void CreateGraphicsPipelineState();
+	/// \brief 矩形の並びのインデックスバッファの生成
+	void CreateIndexBuffer();
 
 private: //メンバ変数
 	//DirectXコマンド
@@ -32,6 +52,18 @@ private: //メンバ変数
 	//グラフィックスパイプラインステート
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_ = nullptr;
 
+	//1回の描画で使う最大の矩形数（16bitのインデックスで頂点を指せる数）
+	static constexpr uint32_t kMaxQuadsPerDraw = 4096;
+	//矩形kMaxQuadsPerDraw個分のインデックス（描画ごとに頂点の開始位置をずらして使い回す）
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_ = nullptr;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	//今フレームに積んだ矩形
+	SpriteBatch batch_;
+	//上限を超えた警告を出したか（フレームに1度だけ出す）
+	bool hasWarnedOverflow_ = false;
+	uint32_t lastDrawCallCount_ = 0;
+	uint32_t lastQuadCount_ = 0;
 
 };
 
@@ -0,0 +1,59 @@
+#include "MaterialRegistry.h"
+
+#include <cstring>
+
+uint32_t MaterialRegistry::Register(const Material& material)
+{
+	++registerCount_;
+
+	const Material normalized = Normalize(material);
+	const uint64_t hash = Hash(normalized);
+
+	auto [first, last] = lookup_.equal_range(hash);
+	for (auto it = first; it != last; ++it)
+	{
+		if (std::memcmp(&materials_[it->second], &normalized, sizeof(Material)) == 0)
+		{
+			return it->second;
+		}
+	}
+
+	const uint32_t index = static_cast<uint32_t>(materials_.size());
+	materials_.push_back(normalized);
+	lookup_.emplace(hash, index);
+	return index;
+}
+
+void MaterialRegistry::Clear()
+{
+	materials_.clear();
+	lookup_.clear();
+	registerCount_ = 0;
+}
+
+Material MaterialRegistry::Normalize(const Material& material)
+{
+	//詰め物に残ったゴミで別のマテリアルと判定されないよう、0で埋めてから値だけを写す
+	Material normalized;
+	std::memset(&normalized, 0, sizeof(Material));
+	normalized.color = material.color;
+	normalized.enableLighting = material.enableLighting;
+	normalized.uvTransform = material.uvTransform;
+	normalized.shininess = material.shininess;
+	normalized.reflectivity = material.reflectivity;
+	normalized.textureIndex = material.textureIndex;
+	return normalized;
+}
+
+uint64_t MaterialRegistry::Hash(const Material& material)
+{
+	//FNV-1a
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&material);
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < sizeof(Material); ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief 1フレーム分のマテリアルを、中身が同じものは1つにまとめて番号を振るクラス
+ * \note 並べたマテリアルはそのままStructuredBufferとしてGPUに送り、インスタンスごとの番号で引く。
+ *       GPUには触れないので、まとめ方だけを単体で確認できる
+ */
+class MaterialRegistry
+{
+public:
+	/**
+	 * \brief マテリアルを登録する
+	 * \note 詰め物の中身は比べない
+	 * \return マテリアルの番号（同じ中身なら同じ番号）
+	 */
+	uint32_t Register(const Material& material);
+
+	/// \brief 登録したマテリアルを全て破棄する（フレームの最後に呼ぶ）
+	void Clear();
+
+public: //アクセッサ
+	// 番号順のマテリアル（詰め物は0）
+	const std::vector<Material>& GetMaterials() const { return materials_; }
+	uint32_t GetMaterialCount() const { return static_cast<uint32_t>(materials_.size()); }
+	// Registerを呼んだ回数（重複を含む）
+	uint32_t GetRegisterCount() const { return registerCount_; }
+
+private:
+	// 詰め物を0にした複製を作る
+	static Material Normalize(const Material& material);
+	// 詰め物を0にしたマテリアルのハッシュ
+	static uint64_t Hash(const Material& material);
+
+private:
+	std::vector<Material> materials_;
+	//ハッシュから番号（衝突した時は中身を比べて次を探す）
+	std::unordered_multimap<uint64_t, uint32_t> lookup_;
+	uint32_t registerCount_ = 0;
+};
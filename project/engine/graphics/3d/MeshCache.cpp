@@ -0,0 +1,357 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace
+{
+	// ファイルの先頭に置く識別子
+	constexpr char kMagic[4] = { 'K', 'M', 'S', 'H' };
+
+	// ファイルの先頭（この後に頂点、インデックス、テクスチャパス、ノードの順で並ぶ）
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint64_t importMicroseconds;
+		uint32_t vertexStride;		// sizeof(VertexData)。構造体が変わったら読み込まない
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t texturePathLength;
+		uint32_t nodeBytes;
+		uint32_t reserved;
+	};
+	static_assert(sizeof(FileHeader) % 16 == 0);
+
+	/*-----------------------[ ハッシュ ]------------------------*/
+
+	constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+	constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+	// FNV-1a
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= kFnvPrime;
+		}
+		return hash;
+	}
+
+	bool HashFile(const std::filesystem::path& path, uint64_t& hash)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		std::vector<char> buffer(64 * 1024);
+		while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+		{
+			hash = HashBytes(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+		}
+		return true;
+	}
+
+	/*-----------------------[ メモリマップ ]------------------------*/
+
+	// ファイルを読み取り専用でメモリに割り当てる（Windows以外では丸ごと読み込む）
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::string& path)
+		{
+#ifdef _WIN32
+			std::wstring widePath = std::filesystem::path(path).wstring();
+			file_ = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+			LARGE_INTEGER size{};
+			if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+			{
+				return;
+			}
+			mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping_ == nullptr)
+			{
+				return;
+			}
+			data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				return;
+			}
+			buffer_.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(buffer_.data()), buffer_.size());
+			data_ = buffer_.data();
+			size_ = buffer_.size();
+#endif
+		}
+
+		~MappedFile()
+		{
+#ifdef _WIN32
+			if (data_) { UnmapViewOfFile(data_); }
+			if (mapping_) { CloseHandle(mapping_); }
+			if (file_ != INVALID_HANDLE_VALUE) { CloseHandle(file_); }
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const uint8_t* GetData() const { return data_; }
+		size_t GetSize() const { return size_; }
+
+	private:
+		const uint8_t* data_ = nullptr;
+		size_t size_ = 0;
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#else
+		std::vector<uint8_t> buffer_;
+#endif
+	};
+
+	/*-----------------------[ 読み書き ]------------------------*/
+
+	// 範囲外を読まないように確認しながら先頭から読む
+	class Reader
+	{
+	public:
+		Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+		const uint8_t* Take(size_t bytes)
+		{
+			if (bytes > size_ - cursor_)
+			{
+				failed_ = true;
+				return nullptr;
+			}
+			const uint8_t* result = data_ + cursor_;
+			cursor_ += bytes;
+			return result;
+		}
+
+		template<typename T>
+		bool Read(T& out)
+		{
+			const uint8_t* src = Take(sizeof(T));
+			if (src == nullptr)
+			{
+				return false;
+			}
+			std::memcpy(&out, src, sizeof(T));
+			return true;
+		}
+
+		bool IsFailed() const { return failed_; }
+
+	private:
+		const uint8_t* data_;
+		size_t size_;
+		size_t cursor_ = 0;
+		bool failed_ = false;
+	};
+
+	// ノードの木を深さ優先で書き出す
+	void WriteNode(std::vector<uint8_t>& out, const Node& node)
+	{
+		auto append = [&out](const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			out.insert(out.end(), bytes, bytes + size);
+		};
+
+		uint32_t nameLength = static_cast<uint32_t>(node.name.size());
+		uint32_t childCount = static_cast<uint32_t>(node.children.size());
+		append(&node.localMatrix, sizeof(Matrix4x4));
+		append(&nameLength, sizeof(nameLength));
+		append(node.name.data(), nameLength);
+		append(&childCount, sizeof(childCount));
+		for (const Node& child : node.children)
+		{
+			WriteNode(out, child);
+		}
+	}
+
+	bool ReadNode(Reader& reader, Node& node, uint32_t depth)
+	{
+		// 壊れたファイルで再帰が止まらないようにする
+		constexpr uint32_t kMaxDepth = 256;
+		if (depth > kMaxDepth)
+		{
+			return false;
+		}
+
+		uint32_t nameLength = 0;
+		uint32_t childCount = 0;
+		if (!reader.Read(node.localMatrix) || !reader.Read(nameLength))
+		{
+			return false;
+		}
+		const uint8_t* name = reader.Take(nameLength);
+		if (name == nullptr || !reader.Read(childCount))
+		{
+			return false;
+		}
+		node.name.assign(reinterpret_cast<const char*>(name), nameLength);
+
+		node.children.resize(childCount);
+		for (Node& child : node.children)
+		{
+			if (!ReadNode(reader, child, depth + 1))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+uint64_t MeshCache::HashSourceFiles(const std::string& sourceFilePath)
+{
+	uint64_t hash = kFnvOffsetBasis;
+	if (!HashFile(sourceFilePath, hash))
+	{
+		return 0;
+	}
+
+	// テクスチャのパスは.mtlから読むので、同じフォルダの.mtlも含める（名前順にして結果を安定させる）
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::path(sourceFilePath).parent_path();
+	std::vector<std::filesystem::path> materialFiles;
+	for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".mtl")
+		{
+			materialFiles.push_back(entry.path());
+		}
+	}
+	std::sort(materialFiles.begin(), materialFiles.end());
+	for (const auto& path : materialFiles)
+	{
+		HashFile(path, hash);
+	}
+
+	// 0は「元ファイルなし」に使うので避ける
+	return hash == 0 ? 1 : hash;
+}
+
+bool MeshCache::Load(const std::string& cachePath, uint64_t sourceHash, ModelData& outModelData, LoadInfo* outInfo)
+{
+	MappedFile file(cachePath);
+	if (file.GetData() == nullptr)
+	{
+		return false;
+	}
+
+	Reader reader(file.GetData(), file.GetSize());
+	FileHeader header{};
+	if (!reader.Read(header) ||
+		std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+		header.version != kVersion ||
+		header.vertexStride != sizeof(VertexData) ||
+		header.sourceHash != sourceHash)
+	{
+		return false;
+	}
+
+	// 頂点とインデックスはファイルの並びのままなので、まとめてコピーするだけで済む
+	const uint8_t* vertices = reader.Take(size_t(header.vertexCount) * sizeof(VertexData));
+	const uint8_t* indices = reader.Take(size_t(header.indexCount) * sizeof(uint32_t));
+	const uint8_t* texturePath = reader.Take(header.texturePathLength);
+	if (reader.IsFailed())
+	{
+		return false;
+	}
+
+	ModelData modelData;
+	modelData.vertices.resize(header.vertexCount);
+	std::memcpy(modelData.vertices.data(), vertices, size_t(header.vertexCount) * sizeof(VertexData));
+	modelData.indices.resize(header.indexCount);
+	std::memcpy(modelData.indices.data(), indices, size_t(header.indexCount) * sizeof(uint32_t));
+	modelData.material.textureFilePath.assign(reinterpret_cast<const char*>(texturePath), header.texturePathLength);
+
+	// インデックスが頂点の範囲外を指していたら壊れている
+	for (uint32_t index : modelData.indices)
+	{
+		if (index >= header.vertexCount)
+		{
+			return false;
+		}
+	}
+
+	Reader nodeReader(reader.Take(header.nodeBytes), header.nodeBytes);
+	if (reader.IsFailed() || !ReadNode(nodeReader, modelData.rootNode, 0))
+	{
+		return false;
+	}
+
+	outModelData = std::move(modelData);
+	if (outInfo)
+	{
+		outInfo->importMicroseconds = header.importMicroseconds;
+		outInfo->fileSize = file.GetSize();
+	}
+	return true;
+}
+
+bool MeshCache::Save(const std::string& cachePath, uint64_t sourceHash, const ModelData& modelData, uint64_t importMicroseconds)
+{
+	std::vector<uint8_t> nodeBytes;
+	WriteNode(nodeBytes, modelData.rootNode);
+
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.sourceHash = sourceHash;
+	header.importMicroseconds = importMicroseconds;
+	header.vertexStride = sizeof(VertexData);
+	header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+	header.texturePathLength = static_cast<uint32_t>(modelData.material.textureFilePath.size());
+	header.nodeBytes = static_cast<uint32_t>(nodeBytes.size());
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	// 途中で失敗しても壊れたファイルを残さないように、一時ファイルに書いてから置き換える
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(modelData.vertices.data()), modelData.vertices.size() * sizeof(VertexData));
+		file.write(reinterpret_cast<const char*>(modelData.indices.data()), modelData.indices.size() * sizeof(uint32_t));
+		file.write(modelData.material.textureFilePath.data(), modelData.material.textureFilePath.size());
+		file.write(reinterpret_cast<const char*>(nodeBytes.data()), nodeBytes.size());
+		if (!file)
+		{
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath, error);
+	return !error;
+}
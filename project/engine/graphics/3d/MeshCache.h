@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief Assimpで読み込んで最適化した後のModelDataを、そのまま読み戻せるバイナリとして保存する
+ * \note 元ファイルのハッシュが一致する時だけ使う。形式を変えたらkVersionを上げること
+ */
+namespace MeshCache
+{
+	// キャッシュの形式のバージョン（VertexDataや最適化の内容を変えたら上げる）
+	constexpr uint32_t kVersion = 1;
+
+	// キャッシュファイルの拡張子
+	constexpr const char* kExtension = ".kmesh";
+
+	// 読み込んだキャッシュの情報
+	struct LoadInfo
+	{
+		uint64_t importMicroseconds = 0;	// キャッシュを作った時のAssimpでの読み込み時間
+		uint64_t fileSize = 0;				// キャッシュファイルの大きさ
+	};
+
+	/**
+	 * \brief 元のモデルファイルと、同じフォルダの.mtlファイルの内容からハッシュを求める
+	 * \return 元ファイルが開けなければ0
+	 */
+	uint64_t HashSourceFiles(const std::string& sourceFilePath);
+
+	/**
+	 * \brief キャッシュファイルを読み込む
+	 * \param sourceHash 元ファイルのハッシュ。保存時と違えば読み込まない
+	 * \param outInfo 読み込んだキャッシュの情報（不要ならnullptr）
+	 * \return 読み込めたらtrue。ファイルがない・古い・壊れている場合はfalse
+	 */
+	bool Load(const std::string& cachePath, uint64_t sourceHash, ModelData& outModelData, LoadInfo* outInfo = nullptr);
+
+	/**
+	 * \brief キャッシュファイルを書き出す
+	 * \param importMicroseconds Assimpでの読み込みにかかった時間（読み込み時の比較用）
+	 * \return 書き出せたらtrue
+	 */
+	bool Save(const std::string& cachePath, uint64_t sourceHash, const ModelData& modelData, uint64_t importMicroseconds);
+}
@@ -0,0 +1,378 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	/*-----------------------[ 頂点キャッシュ最適化のパラメータ ]------------------------*/
+
+	// スコア計算で想定するキャッシュの大きさ
+	constexpr int32_t kScoringCacheSize = 32;
+	// 直前の三角形で使った頂点（キャッシュ先頭の3つ）のスコア
+	constexpr float kLastTriangleScore = 0.75f;
+	// キャッシュ内の位置によるスコアの減り方
+	constexpr float kCacheDecayPower = 1.5f;
+	// 残りの三角形が少ない頂点を優先する強さ
+	constexpr float kValenceBoostScale = 2.0f;
+	constexpr float kValenceBoostPower = 0.5f;
+
+	Vector3 ToVector3(const Vector4& v) { return { v.x, v.y, v.z }; }
+
+	// 頂点のスコア（高いほど早く使いたい）
+	float CalculateVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		// もう使う三角形がない
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				score = kLastTriangleScore;
+			}
+			else
+			{
+				const float scaler = 1.0f / static_cast<float>(kScoringCacheSize - 3);
+				score = 1.0f - static_cast<float>(cachePosition - 3) * scaler;
+				score = std::pow(score, kCacheDecayPower);
+			}
+		}
+
+		score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+		return score;
+	}
+}
+
+float MeshOptimizer::CalculateACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return 0.0f;
+	}
+
+	// 頂点ごとに、キャッシュに入った時刻を覚えておく（時刻の差がキャッシュの大きさ未満なら当たり）
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	uint32_t misses = 0;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		uint32_t index = indices[i];
+		assert(index < vertexCount && "ERROR: MeshOptimizer::CalculateACMR() - Index out of range.");
+		if (time - timestamps[index] > cacheSize)
+		{
+			timestamps[index] = time++;
+			++misses;
+		}
+	}
+
+	return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	/*--------------[ 頂点から三角形を引けるようにする ]-----------------*/
+
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+	for (uint32_t index : indices)
+	{
+		++triangleOffsets[index + 1];
+	}
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		triangleOffsets[v + 1] += triangleOffsets[v];
+	}
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = indices[t * 3 + k];
+			adjacency[triangleOffsets[v] + remaining[v]++] = static_cast<uint32_t>(t);
+		}
+	}
+
+	/*--------------[ 初期スコア ]-----------------*/
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		vertexScores[v] = CalculateVertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+	}
+
+	/*--------------[ スコアが一番高い三角形から順に出力する ]-----------------*/
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	// キャッシュ（先頭が最新）。新しい三角形の3頂点が入る分だけ余裕を持たせる
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> nextCache;
+	cache.reserve(kScoringCacheSize + 3);
+	nextCache.reserve(kScoringCacheSize + 3);
+
+	size_t scanCursor = 0;
+	int64_t bestTriangle = 0;
+	{
+		// 最初の三角形は全体から選ぶ
+		float bestScore = -1.0f;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			if (triangleScores[t] > bestScore)
+			{
+				bestScore = triangleScores[t];
+				bestTriangle = static_cast<int64_t>(t);
+			}
+		}
+	}
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		// キャッシュの近くに候補がなければ、まだ出力していない三角形を先頭から探す
+		if (bestTriangle < 0)
+		{
+			while (emitted[scanCursor])
+			{
+				++scanCursor;
+			}
+			bestTriangle = static_cast<int64_t>(scanCursor);
+		}
+
+		const uint32_t triangle = static_cast<uint32_t>(bestTriangle);
+		const uint32_t* corners = &indices[triangle * 3];
+		result.insert(result.end(), corners, corners + 3);
+		emitted[triangle] = true;
+
+		// 使った頂点をキャッシュの先頭に入れ、残りの三角形リストから外す
+		nextCache.clear();
+		for (size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = corners[k];
+			nextCache.push_back(v);
+
+			uint32_t* begin = &adjacency[triangleOffsets[v]];
+			uint32_t* end = begin + remaining[v];
+			uint32_t* found = std::find(begin, end, triangle);
+			assert(found != end);
+			std::swap(*found, *(end - 1));
+			--remaining[v];
+		}
+		for (uint32_t v : cache)
+		{
+			if (v != corners[0] && v != corners[1] && v != corners[2])
+			{
+				nextCache.push_back(v);
+			}
+		}
+		std::swap(cache, nextCache);
+
+		// キャッシュから溢れた頂点の位置を戻す
+		for (size_t i = kScoringCacheSize; i < cache.size(); ++i)
+		{
+			cachePositions[cache[i]] = -1;
+			vertexScores[cache[i]] = CalculateVertexScore(-1, remaining[cache[i]]);
+		}
+		if (cache.size() > static_cast<size_t>(kScoringCacheSize))
+		{
+			// 溢れた頂点に関わる三角形のスコアも更新する
+			for (size_t i = kScoringCacheSize; i < cache.size(); ++i)
+			{
+				uint32_t v = cache[i];
+				for (uint32_t a = 0; a < remaining[v]; ++a)
+				{
+					uint32_t t = adjacency[triangleOffsets[v] + a];
+					triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				}
+			}
+			cache.resize(kScoringCacheSize);
+		}
+
+		// キャッシュ内の頂点のスコアを更新
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			cachePositions[cache[i]] = static_cast<int32_t>(i);
+			vertexScores[cache[i]] = CalculateVertexScore(static_cast<int32_t>(i), remaining[cache[i]]);
+		}
+
+		// キャッシュ内の頂点を使う三角形から次を選ぶ
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t a = 0; a < remaining[v]; ++a)
+			{
+				uint32_t t = adjacency[triangleOffsets[v] + a];
+				float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				triangleScores[t] = score;
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices, float threshold)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	/*--------------[ キャッシュが全て外れた三角形で区切ってまとまりを作る ]-----------------*/
+
+	std::vector<uint32_t> clusterStarts;
+	{
+		std::vector<uint32_t> timestamps(vertices.size(), 0);
+		uint32_t time = kDefaultCacheSize + 1;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			uint32_t misses = 0;
+			for (size_t k = 0; k < 3; ++k)
+			{
+				uint32_t v = indices[t * 3 + k];
+				if (time - timestamps[v] > kDefaultCacheSize)
+				{
+					timestamps[v] = time++;
+					++misses;
+				}
+			}
+			if (t == 0 || misses == 3)
+			{
+				clusterStarts.push_back(static_cast<uint32_t>(t));
+			}
+		}
+	}
+	if (clusterStarts.size() < 2)
+	{
+		return;
+	}
+
+	/*--------------[ まとまりがメッシュの外側を向いている度合いを求める ]-----------------*/
+
+	// メッシュ全体の中心（面積の重み付き）
+	Vector3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		Vector3 p0 = ToVector3(vertices[indices[t * 3]].position);
+		Vector3 p1 = ToVector3(vertices[indices[t * 3 + 1]].position);
+		Vector3 p2 = ToVector3(vertices[indices[t * 3 + 2]].position);
+		float area = Vector3::Cross(p1 - p0, p2 - p0).Length();
+		meshCentroid += (p0 + p1 + p2) * (area / 3.0f);
+		meshArea += area;
+	}
+	if (meshArea <= 0.0f)
+	{
+		return;
+	}
+	meshCentroid /= meshArea;
+
+	const size_t clusterCount = clusterStarts.size();
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c)
+	{
+		size_t begin = clusterStarts[c];
+		size_t end = (c + 1 < clusterCount) ? clusterStarts[c + 1] : triangleCount;
+
+		Vector3 centroid = { 0.0f, 0.0f, 0.0f };
+		Vector3 normal = { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+		for (size_t t = begin; t < end; ++t)
+		{
+			const VertexData& v0 = vertices[indices[t * 3]];
+			const VertexData& v1 = vertices[indices[t * 3 + 1]];
+			const VertexData& v2 = vertices[indices[t * 3 + 2]];
+			Vector3 p0 = ToVector3(v0.position);
+			Vector3 p1 = ToVector3(v1.position);
+			Vector3 p2 = ToVector3(v2.position);
+			float triangleArea = Vector3::Cross(p1 - p0, p2 - p0).Length();
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			//巻き順の変換に左右されないように、頂点の法線で向きを決める
+			normal += (v0.normal + v1.normal + v2.normal) * triangleArea;
+			area += triangleArea;
+		}
+
+		if (area <= 0.0f || normal.IsZero())
+		{
+			sortKeys[c] = 0.0f;
+			continue;
+		}
+		centroid /= area;
+		sortKeys[c] = Vector3::Dot(centroid - meshCentroid, normal.Normalize());
+	}
+
+	/*--------------[ 外を向いたまとまりから順に並べる ]-----------------*/
+
+	std::vector<uint32_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c)
+	{
+		order[c] = static_cast<uint32_t>(c);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t c : order)
+	{
+		size_t begin = clusterStarts[c];
+		size_t end = (c + 1 < clusterCount) ? clusterStarts[c + 1] : triangleCount;
+		result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+	}
+
+	// 頂点キャッシュの効率を大きく落とすなら元の並びのままにする
+	float before = CalculateACMR(indices.data(), indices.size(), vertices.size());
+	float after = CalculateACMR(result.data(), result.size(), vertices.size());
+	if (after <= before * threshold)
+	{
+		indices.swap(result);
+	}
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices)
+{
+	constexpr uint32_t kUnused = UINT32_MAX;
+	std::vector<uint32_t> remap(vertices.size(), kUnused);
+
+	std::vector<VertexData> result;
+	result.reserve(vertices.size());
+	for (uint32_t& index : indices)
+	{
+		assert(index < vertices.size() && "ERROR: MeshOptimizer::OptimizeVertexFetch() - Index out of range.");
+		if (remap[index] == kUnused)
+		{
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.swap(result);
+}
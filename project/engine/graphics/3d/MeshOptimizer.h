@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief インデックス付きメッシュの並びを、GPUの頂点キャッシュとオーバードローに合わせて整える
+ * \note 三角形リスト（インデックス3つで1枚）だけを扱う
+ */
+namespace MeshOptimizer
+{
+	// ACMRの計算に使う頂点キャッシュの大きさ（一般的なGPUのFIFOに合わせる）
+	constexpr uint32_t kDefaultCacheSize = 16;
+
+	/**
+	 * \brief FIFOの頂点キャッシュを真似て、三角形1枚あたりに変換される頂点数（ACMR）を求める
+	 * \note 0.5に近いほど良く、3.0がキャッシュが全く効いていない状態
+	 */
+	float CalculateACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+	/**
+	 * \brief 頂点キャッシュに当たりやすい順に三角形を並び替える（Forsythの手法）
+	 * \param indices 並び替えるインデックス。結果で上書きする
+	 */
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+	/**
+	 * \brief キャッシュの切れ目で三角形をまとめ、外を向いたまとまりから先に描くように並び替える
+	 * \note 頂点キャッシュ最適化の後に使う。ACMRがthreshold倍より悪くなるなら並び替えない
+	 * \param threshold 許容するACMRの悪化率
+	 */
+	void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices, float threshold = 1.05f);
+
+	/**
+	 * \brief インデックスから初めて参照される順に頂点を並べ直す（参照されない頂点は取り除く）
+	 * \note 三角形の並びを決めた後に使う
+	 */
+	void OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices);
+}
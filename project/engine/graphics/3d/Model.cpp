@@ -1,5 +1,6 @@
 #include "Model.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <sstream>
@@ -9,17 +10,32 @@
 // Assimp
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+// graphics
+#include "MeshOptimizer.h"
 // manager
 #include "manager/graphics/TextureManager.h"
+// base
+#include "base/Logger.h"
 
 void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename, const std::string& modelType)
 {
-	modelCommon_ = modelCommon;
-
 	std::string objFilePath = filename + "/" + filename + modelType;
 
 	//モデルの読み込み
-	modelData_ = LoadModelFile(directoryPath,objFilePath);
+	Initialize(modelCommon, directoryPath, filename, LoadModelFile(directoryPath, objFilePath));
+}
+
+void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename, ModelData&& modelData)
+{
+	modelCommon_ = modelCommon;
+
+	//描画キュー用の番号を割り当てる
+	static uint32_t nextRenderId = 0;
+	renderId_ = nextRenderId++;
+
+	modelData_ = std::move(modelData);
+	//カリング用の境界を求める
+	CalculateLocalBounds();
 
 	//テクスチャの読み込み
 	//.objの参照しているテクスチャファイル読み込み
@@ -32,16 +48,18 @@ void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPat
 	InitializeRenderingSettings();
 }
 
-void Model::Draw()
+void Model::Draw(uint32_t instanceCount)
 {
 	//3D描画
 	modelCommon_->GetDXCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
-	//マテリアルCBufferの場所を設定
-	modelCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
-	//SRVのDescriptorTableの先頭を設定。2はrootPatameter[2]である。
-	modelCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(modelData_.material.textureIndex));
 	//描画！
-	modelCommon_->GetDXCommon()->GetCommandList()->DrawInstanced(UINT(modelData_.vertices.size()), 1, 0, 0);
+	if (modelData_.indices.empty())
+	{
+		modelCommon_->GetDXCommon()->GetCommandList()->DrawInstanced(UINT(modelData_.vertices.size()), instanceCount, 0, 0);
+		return;
+	}
+	modelCommon_->GetDXCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView_);
+	modelCommon_->GetDXCommon()->GetCommandList()->DrawIndexedInstanced(UINT(modelData_.indices.size()), instanceCount, 0, 0, 0);
 }
 
 MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
@@ -76,9 +94,21 @@ ModelData Model::LoadModelFile(const std::string& directoryPath, const std::stri
 	ModelData modelData;				//構築するModelData
 	Assimp::Importer importer;
 	std::string filePath = directoryPath + "/" + filename;
-	const aiScene* scene = importer.ReadFile(filePath.c_str(), aiProcess_FlipWindingOrder | aiProcess_FlipUVs);
+	//同じ値の頂点はAssimpに溶接させて、インデックスで共有する
+	const aiScene* scene = importer.ReadFile(filePath.c_str(), aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
 	assert(scene->HasMeshes());
 
+	//先に全メッシュの頂点数とインデックス数を数えて確保しておく
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+	{
+		vertexCount += scene->mMeshes[meshIndex]->mNumVertices;
+		indexCount += size_t(scene->mMeshes[meshIndex]->mNumFaces) * 3;
+	}
+	modelData.vertices.reserve(vertexCount);
+	modelData.indices.reserve(indexCount);
+
 	//メッシュの解析
 	for(uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
 	{
@@ -86,31 +116,56 @@ ModelData Model::LoadModelFile(const std::string& directoryPath, const std::stri
 		assert(mesh->HasNormals());		//法線がないMeshは非対応
 		assert(mesh->HasTextureCoords(0));	//テクスチャ座標がないMeshは非対応
 
+		//複数メッシュは1つの頂点バッファにまとめるので、インデックスをずらす
+		uint32_t baseVertex = static_cast<uint32_t>(modelData.vertices.size());
+
+		//頂点の解析
+		for (uint32_t vertexIndex = 0; vertexIndex < mesh->mNumVertices; ++vertexIndex)
+		{
+			aiVector3D& position = mesh->mVertices[vertexIndex];
+			aiVector3D& normal = mesh->mNormals[vertexIndex];
+			aiVector3D& texcoord = mesh->mTextureCoords[0][vertexIndex];
+			VertexData vertex;
+			vertex.position = { position.x,position.y,position.z,1.0f };
+			vertex.normal = { normal.x,normal.y,normal.z };
+			vertex.texcoord = { texcoord.x,texcoord.y };
+			//airProcess_MakeLeftHandedはz*=-1で、右て->左手に変換するので手動で処理
+			vertex.position.x *= -1.0f;
+			vertex.normal.x *= -1.0f;
+			modelData.vertices.push_back(vertex);
+		}
+
 		//faceの解析
 		for(uint32_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex)
 		{
 			aiFace& face = mesh->mFaces[faceIndex];
 			assert(face.mNumIndices == 3);	//三角形以外は非対応
 
-			//三角形の頂点を解析
 			for(uint32_t element = 0; element < face.mNumIndices; ++element)
 			{
-				uint32_t vertexIndex = face.mIndices[element];
-				aiVector3D& position = mesh->mVertices[vertexIndex];
-				aiVector3D& normal = mesh->mNormals[vertexIndex];
-				aiVector3D& texcoord = mesh->mTextureCoords[0][vertexIndex];
-				VertexData vertex;
-				vertex.position = { position.x,position.y,position.z,1.0f };
-				vertex.normal = { normal.x,normal.y,normal.z };
-				vertex.texcoord = { texcoord.x,texcoord.y };
-				//airProcess_MakeLeftHandedはz*=-1で、右て->左手に変換するので手動で処理
-				vertex.position.x *= -1.0f;
-				vertex.normal.x *= -1.0f;
-                modelData.vertices.push_back(vertex);
+				modelData.indices.push_back(baseVertex + face.mIndices[element]);
 			}
 		}
 	}
 
+	//頂点キャッシュとオーバードローに合わせて並びを整える
+	float acmrBefore = MeshOptimizer::CalculateACMR(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+	MeshOptimizer::OptimizeVertexCache(modelData.indices, modelData.vertices.size());
+	MeshOptimizer::OptimizeOverdraw(modelData.indices, modelData.vertices);
+	MeshOptimizer::OptimizeVertexFetch(modelData.vertices, modelData.indices);
+	float acmrAfter = MeshOptimizer::CalculateACMR(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+
+	//三角形ごとに頂点を展開していた時との比較を出力
+	size_t expandedBytes = sizeof(VertexData) * modelData.indices.size();
+	size_t indexedBytes = sizeof(VertexData) * modelData.vertices.size() + GetIndexStride(modelData.vertices.size()) * modelData.indices.size();
+	std::stringstream ss;
+	ss << "Model: " << filePath
+		<< " vertices " << modelData.indices.size() << " -> " << modelData.vertices.size()
+		<< ", indices " << modelData.indices.size()
+		<< ", memory " << expandedBytes / 1024.0f << "KB -> " << indexedBytes / 1024.0f << "KB"
+		<< ", ACMR " << acmrBefore << " -> " << acmrAfter << "\n";
+	Logger::Log(ss.str());
+
 	//Materialの解析
 	for (uint32_t materialIndex = 0; materialIndex < scene->mNumMaterials; ++materialIndex)
 	{
@@ -153,25 +208,56 @@ void Model::CreateVertexData()
 	std::memcpy(vertexData_, modelData_.vertices.data(), sizeof(VertexData) * modelData_.vertices.size());
 }
 
-void Model::CreateMaterialData()
+void Model::CreateIndexData()
 {
-	/*--------------[ MaterialResourceを作る ]-----------------*/
+	if (modelData_.indices.empty())
+	{
+		return;
+	}
 
-	materialResource_ = modelCommon_->GetDXCommon()->CreateBufferResource(sizeof(Material));
+	//頂点数が16bitに収まるならインデックスも16bitにする
+	size_t stride = GetIndexStride(modelData_.vertices.size());
+	size_t sizeInBytes = stride * modelData_.indices.size();
 
-	/*--------------[ MaterialResourceにデータを書き込むためのアドレスを取得してmaterialDataに割り当てる ]-----------------*/
+	/*--------------[ IndexResourceを作る ]-----------------*/
 
-	materialResource_->Map(0,
-		nullptr,
-		reinterpret_cast<void**>(&materialData_)
-	);
+	indexResource_ = modelCommon_->GetDXCommon()->CreateBufferResource(sizeInBytes);
 
-	//マテリアルデータの初期値を書き込む
-	materialData_->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData_->enableLighting = true;
-	materialData_->uvTransform = MakeIdentity4x4();
-	materialData_->shininess = 30.0f;
-	materialData_->reflectivity = 0.0f;
+	/*--------------[ IndexBufferViewを作る ]-----------------*/
+
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = UINT(sizeInBytes);
+	indexBufferView_.Format = (stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	/*--------------[ インデックスを書き込む ]-----------------*/
+
+	void* indexData = nullptr;
+	indexResource_->Map(0, nullptr, &indexData);
+	if (stride == sizeof(uint16_t))
+	{
+		uint16_t* dst = static_cast<uint16_t*>(indexData);
+		for (size_t i = 0; i < modelData_.indices.size(); ++i)
+		{
+			dst[i] = static_cast<uint16_t>(modelData_.indices[i]);
+		}
+	}
+	else
+	{
+		std::memcpy(indexData, modelData_.indices.data(), sizeInBytes);
+	}
+	//書き込んだ後は使わないので閉じる
+	indexResource_->Unmap(0, nullptr);
+}
+
+void Model::CreateMaterialData()
+{
+	//マテリアルデータの初期値を書き込む（GPUへは描画時にオブジェクトごとにまとめて送る）
+	material_.color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	material_.enableLighting = true;
+	material_.uvTransform = MakeIdentity4x4();
+	material_.shininess = 30.0f;
+	material_.reflectivity = 0.0f;
+	material_.textureIndex = modelData_.material.textureIndex;
 }
 
 void Model::InitializeRenderingSettings()
@@ -179,10 +265,35 @@ void Model::InitializeRenderingSettings()
 	//頂点データの生成
 	CreateVertexData();
 
+	//インデックスデータの生成
+	CreateIndexData();
+
 	//マテリアルデータの生成
 	CreateMaterialData();
 }
 
+void Model::CalculateLocalBounds()
+{
+	if (modelData_.vertices.empty())
+	{
+		localBounds_ = AABB();
+		return;
+	}
+
+	Vector3 min = { modelData_.vertices[0].position.x, modelData_.vertices[0].position.y, modelData_.vertices[0].position.z };
+	Vector3 max = min;
+	for (const VertexData& vertex : modelData_.vertices)
+	{
+		min.x = (std::min)(min.x, vertex.position.x);
+		min.y = (std::min)(min.y, vertex.position.y);
+		min.z = (std::min)(min.z, vertex.position.z);
+		max.x = (std::max)(max.x, vertex.position.x);
+		max.y = (std::max)(max.y, vertex.position.y);
+		max.z = (std::max)(max.z, vertex.position.z);
+	}
+	localBounds_ = AABB(min, max);
+}
+
 Node Model::ReadNode(aiNode* node)
 {
 	Node result;
@@ -8,6 +8,7 @@
 #include "ModelCommon.h"
 // math
 #include "base/GraphicsTypes.h"
+#include "math/AABB.h"
 #include "math/MathUtils.h"
 
 class Model
@@ -20,10 +21,18 @@ public:
 	 */
 	void Initialize(ModelCommon* modelCommon,const std::string& directoryPath, const std::string& filename, const std::string& modelType);
 
+	/**
+	 * \brief 読み込み済みのモデルデータで初期化
+	 * \param modelData LoadModelFileかキャッシュから作ったデータ（テクスチャパスはモデルのフォルダからの相対パス）
+	 */
+	void Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename, ModelData&& modelData);
+
 	/**
 	 * \brief 描画
+	 * \note 頂点とインデックスだけを設定する。マテリアルとテクスチャは呼び出し側がマテリアルのStructuredBufferで設定する
+	 * \param instanceCount インスタンス数（インスタンス描画時のみ2以上）
 	 */
-	void Draw();
+	void Draw(uint32_t instanceCount = 1);
 
 	/**
 	 * \brief .mtlファイルの読み取り
@@ -48,29 +57,44 @@ public:
 	 */
 	static Node ReadNode(aiNode* node);
 
+	/**
+	 * \brief インデックス1つ分のバイト数
+	 * \note 頂点数が16bitで表せるなら16bitインデックスを使う
+	 */
+	static size_t GetIndexStride(size_t vertexCount) { return vertexCount <= UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t); }
+
 public: //アクセッサ
-	Vector4 GetColor() const { return materialData_->color; }
-	void SetColor(const Vector4& color) { materialData_->color = color; }
+	Vector4 GetColor() const { return material_.color; }
+	void SetColor(const Vector4& color) { material_.color = color; }
 
 	//ライティングの有効無効
-	bool IsEnableLighting() const { return materialData_->enableLighting; }
-	void SetEnableLighting(bool enable) { materialData_->enableLighting = enable; }
+	bool IsEnableLighting() const { return material_.enableLighting; }
+	void SetEnableLighting(bool enable) { material_.enableLighting = enable; }
 
 	//反射強度
-	void SetShininess(float shininess) { materialData_->shininess = shininess; }
-	float GetShininess() const { return materialData_->shininess; }
+	void SetShininess(float shininess) { material_.shininess = shininess; }
+	float GetShininess() const { return material_.shininess; }
 
 	//モデルデータ
 	ModelData& GetModelData() { return modelData_; }
+	uint32_t GetIndexCount() const { return static_cast<uint32_t>(modelData_.indices.size()); }
+
+	//描画キューのソートに使う番号
+	uint32_t GetRenderId() const { return renderId_; }
+	uint32_t GetTextureIndex() const { return modelData_.material.textureIndex; }
+
+	//頂点の範囲から求めたローカル空間の境界（視錐台カリングに使う）
+	const AABB& GetLocalBounds() const { return localBounds_; }
 
 	//マテリアルデータ
-	Material* GetMaterialData() { return materialData_; }
-	Vector3 GetUVTranslate() const { return MathUtils::GetMatrixTranslate(materialData_->uvTransform); }
-	Vector3 GetUVScale() const { return MathUtils::GetMatrixScale(materialData_->uvTransform); }
-	Vector3 GetUVRotate() const { return MathUtils::GetMatrixRotate(materialData_->uvTransform); }
-	void SetUVTranslate(const Vector3& translate) { materialData_->uvTransform = MakeAffineMatrix(GetUVScale(), GetUVRotate(), translate); }
-	void SetUVScale(const Vector3& scale) { materialData_->uvTransform = MakeAffineMatrix(scale, GetUVRotate(), GetUVTranslate()); }
-	void SetUVRotate(const Vector3& rotate) { materialData_->uvTransform = MakeAffineMatrix(GetUVScale(), rotate, GetUVTranslate()); }
+	Material* GetMaterialData() { return &material_; }
+	const Material& GetMaterial() const { return material_; }
+	Vector3 GetUVTranslate() const { return MathUtils::GetMatrixTranslate(material_.uvTransform); }
+	Vector3 GetUVScale() const { return MathUtils::GetMatrixScale(material_.uvTransform); }
+	Vector3 GetUVRotate() const { return MathUtils::GetMatrixRotate(material_.uvTransform); }
+	void SetUVTranslate(const Vector3& translate) { material_.uvTransform = MakeAffineMatrix(GetUVScale(), GetUVRotate(), translate); }
+	void SetUVScale(const Vector3& scale) { material_.uvTransform = MakeAffineMatrix(scale, GetUVRotate(), GetUVTranslate()); }
+	void SetUVRotate(const Vector3& rotate) { material_.uvTransform = MakeAffineMatrix(GetUVScale(), rotate, GetUVTranslate()); }
 
 private: //メンバ関数
 	/**
@@ -79,7 +103,12 @@ private: //メンバ関数
 	void CreateVertexData();
 
 	/**
-	 * \brief マテリアルデータの生成
+	 * \brief インデックスデータの生成
+	 */
+	void CreateIndexData();
+
+	/**
+	 * \brief マテリアルデータの初期化
 	 */
 	void CreateMaterialData();
 
@@ -88,6 +117,11 @@ private: //メンバ関数
 	 */
 	void InitializeRenderingSettings();
 
+	/**
+	 * \brief 頂点の範囲からローカル空間の境界を求める
+	 */
+	void CalculateLocalBounds();
+
 	
 
 private:
@@ -97,6 +131,12 @@ private:
 	//Objファイルのデータ
 	ModelData modelData_;
 
+	//描画キューのソートに使う番号（読み込み順に割り当てる）
+	uint32_t renderId_ = 0;
+
+	//ローカル空間の境界
+	AABB localBounds_;
+
 	/*-----------------------[ 頂点 ]------------------------*/
 
 	//バッファのリソース
@@ -106,12 +146,17 @@ private:
 	//頂点バッファビュー
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_;
 
-	/*-----------------------[ マテリアル ]------------------------*/
+	/*-----------------------[ インデックス ]------------------------*/
 
 	//バッファのリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_;
-	//データ
-	Material* materialData_ = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+	//インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	/*-----------------------[ マテリアル ]------------------------*/
+
+	//データ（描画時にオブジェクトごとのマテリアルとしてまとめてGPUに送る）
+	Material material_{};
 
 };
 
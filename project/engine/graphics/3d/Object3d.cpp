@@ -1,45 +1,19 @@
 #include "Object3d.h"
 
+#include <cstring>
+
 // system
 #include "Object3dCommon.h"
 // math
 #include "math/MathUtils.h"
 // graphics
+#include "manager/graphics/TextureManager.h"
 #include "manager/scene/LightManager.h"
 
 ///////////////////////////////////////////////////////////////////////
 ///						>>>基本的な処理<<<							///
 ///////////////////////////////////////////////////////////////////////
 
-Object3d::~Object3d()
-{
-	//座標変換行列のリソースを解放
-	if (wvpResource_)
-	{
-		wvpResource_->Unmap(0, nullptr);
-		wvpResource_.Reset();
-	}
-	//平行光源のリソースを解放
-	if (directionalLightResource_)
-	{
-		directionalLightResource_->Unmap(0, nullptr);
-		directionalLightResource_.Reset();
-	}
-	//カメラのリソースを解放
-	if (cameraResource_)
-	{
-		cameraResource_->Unmap(0, nullptr);
-		cameraResource_.Reset();
-	}
-	//ディレクショナルライトのリソースを解放
-	if (directionalLightResource_)
-	{
-		directionalLightResource_->Unmap(0, nullptr);
-		directionalLightResource_.Reset();
-	}
-	
-}
-
 void Object3d::Initialize(Object3dCommon* object3dCommon,Camera* camera)
 {
 	//引数で受け取った物を記録する
@@ -68,12 +42,33 @@ void Object3d::Update(CameraManager* camera)
 
 void Object3d::Draw()
 {
+	//不透明なモデルはスポットライトの影を落とす（視錐台の外にあっても影は映るので、判定より先に積む）
+	if (model_ && lightManager_ && model_->GetColor().w >= 1.0f)
+	{
+		object3dCommon_->SubmitShadowCaster(model_, transformationMatrix_.World, worldBounds_, isStatic_);
+	}
+
+	//共通の平行光源を使うオブジェクトは描画キューに積み、同じモデルをまとめて描画する
+	//（視錐台の判定はキューを描画する時にまとめて行う）
+	if (model_ && lightManager_ && object3dCommon_->IsRenderQueueEnabled() && object3dCommon_->IsSharedDirectionalLight(directionalLight_))
+	{
+		object3dCommon_->SubmitToRenderQueue(model_, MakeMaterial(), transformationMatrix_, worldBounds_);
+		return;
+	}
+
+	//視錐台の外にあれば描画しない
+	if (model_ && !object3dCommon_->TestVisibility(camera_, worldBounds_))
+	{
+		return;
+	}
+
+	DirectXCommon* dxCommon = object3dCommon_->GetDXCommon();
 	//座標変換行列CBufferの場所を設定
-	object3dCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, wvpResource_->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(1, dxCommon->UploadConstant(transformationMatrix_));
 	//平行光源CBufferの場所を設定
-	object3dCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource_->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(3, dxCommon->UploadConstant(directionalLight_));
 	//カメラCBufferの場所を設定
-	object3dCommon_->GetDXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(4, cameraResource_->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(4, dxCommon->UploadConstant(cameraData_));
 
 	//ライトマネージャーがあればライトの描画を行う
 	if (lightManager_)
@@ -84,10 +79,34 @@ void Object3d::Draw()
 	//3Dモデルが割り当てられていれば描画する
 	if(model_)
 	{
+		//マテリアルは1つだけのStructuredBufferとして送る（テクスチャは転送中なら代わりのテクスチャ）
+		Material material = MakeMaterial();
+		material.textureIndex = TextureManager::GetInstance()->GetDrawSrvIndex(material.textureIndex);
+		dxCommon->GetCommandList()->SetGraphicsRootShaderResourceView(0, dxCommon->UploadConstant(material));
 		model_->Draw();
 	}
 }
 
+void Object3d::SetTexture(const std::string& filePath)
+{
+	if (filePath.empty())
+	{
+		hasTextureOverride_ = false;
+		return;
+	}
+	TextureManager::GetInstance()->LoadTexture(filePath);
+	textureIndex_ = TextureManager::GetInstance()->GetTextureIndexByFilePath(filePath);
+	hasTextureOverride_ = true;
+}
+
+void Object3d::ResetState()
+{
+	CreateDirectionalLightData();
+	hasTextureOverride_ = false;
+	isStatic_ = false;
+	isTransformationMatrixValid_ = false;
+}
+
 ///////////////////////////////////////////////////////////////////////
 ///						>>>その他関数の処理<<<							///
 ///////////////////////////////////////////////////////////////////////
@@ -97,104 +116,83 @@ void Object3d::UpdateMatrix(Camera* camera)
 	//引数が指定されていれば引数のカメラを使う。指定されていなければデフォルトのカメラを使う
 	camera_ = camera ? camera : object3dCommon_->GetDefaultCamera();
 
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
-	Matrix4x4 worldViewProjectionMatrix;
-	Matrix4x4 worldInverseTransposeMatrix = MathUtils::Transpose(Inverse(worldMatrix));
-
-	if(camera)
+	//SRTが変わった時だけワールド行列を作り直す
+	if (!isWorldFromTransform_ || std::memcmp(&cachedTransform_, &transform_, sizeof(Transform)) != 0)
 	{
-		const Matrix4x4& viewProjectionMatrix = camera->GetViewProjectionMatrix();
-		worldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
-		cameraData_->worldPos = { camera->GetWorldMatrix().m[3][0],camera->GetWorldMatrix().m[3][1],camera->GetWorldMatrix().m[3][2]};
-	} else {
-		worldViewProjectionMatrix = worldMatrix;
+		worldMatrix_ = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
+		worldInverseTranspose_ = MakeInverseTransposeMatrix(worldMatrix_);
+		cachedTransform_ = transform_;
+		isWorldFromTransform_ = true;
+		isTransformationMatrixValid_ = false;
 	}
 
-	transformationMatrixData_->WVP = model_->GetModelData().rootNode.localMatrix * worldViewProjectionMatrix;
-	transformationMatrixData_->World = model_->GetModelData().rootNode.localMatrix * worldMatrix;
-	transformationMatrixData_->WorldInverseTranspose = worldInverseTransposeMatrix;
+	UpdateTransformationMatrix(camera);
 }
 
-void Object3d::UpdateMatrixWithWorld(const Matrix4x4& worldMatrix, Camera* camera)
+void Object3d::UpdateMatrixWithWorld(const Matrix4x4& worldMatrix, const Matrix4x4& worldInverseTranspose, Camera* camera)
 {
 	camera_ = camera ? camera : object3dCommon_->GetDefaultCamera();
-	// ここでworldMatrixを使ってWVPなどを計算
-	Matrix4x4 worldViewProjectionMatrix;
-	Matrix4x4 worldInverseTransposeMatrix = MathUtils::Transpose(Inverse(worldMatrix));
 
-	if (camera_)
-	{
-		const Matrix4x4& viewProjectionMatrix = camera_->GetViewProjectionMatrix();
-		worldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
-		cameraData_->worldPos = { camera_->GetWorldMatrix().m[3][0],camera_->GetWorldMatrix().m[3][1],camera_->GetWorldMatrix().m[3][2] };
-	}
-	else
+	//外から渡された行列が変わった時だけ作り直す
+	if (isWorldFromTransform_ || std::memcmp(&worldMatrix_, &worldMatrix, sizeof(Matrix4x4)) != 0)
 	{
-		worldViewProjectionMatrix = worldMatrix;
+		worldMatrix_ = worldMatrix;
+		worldInverseTranspose_ = worldInverseTranspose;
+		isWorldFromTransform_ = false;
+		isTransformationMatrixValid_ = false;
 	}
 
-	transformationMatrixData_->WVP = model_->GetModelData().rootNode.localMatrix * worldViewProjectionMatrix;
-	transformationMatrixData_->World = model_->GetModelData().rootNode.localMatrix * worldMatrix;
-	transformationMatrixData_->WorldInverseTranspose = worldInverseTransposeMatrix;
+	UpdateTransformationMatrix(camera_);
 }
 
-void Object3d::CreateWvpData()
+void Object3d::UpdateTransformationMatrix(Camera* camera)
 {
-	/*--------------[ 座標変換行列リソースを作る ]-----------------*/
+	const Matrix4x4 viewProjectionMatrix = camera ? camera->GetViewProjectionMatrix() : MakeIdentity4x4();
+	if (isTransformationMatrixValid_ && cachedModel_ == model_ && cachedCamera_ == camera &&
+		std::memcmp(&cachedViewProjection_, &viewProjectionMatrix, sizeof(Matrix4x4)) == 0)
+	{
+		return;
+	}
 
-	wvpResource_ = object3dCommon_->GetDXCommon()->CreateBufferResource(sizeof(TransformationMatrix));
+	if (camera)
+	{
+		cameraData_.worldPos = { camera->GetWorldMatrix().m[3][0],camera->GetWorldMatrix().m[3][1],camera->GetWorldMatrix().m[3][2] };
+	}
 
-	/*--------------[ 座標変換行列リソースにデータを書き込むためのアドレスを取得してtransformationMatrixDataに割り当てる ]-----------------*/
+	transformationMatrix_.World = model_->GetModelData().rootNode.localMatrix * worldMatrix_;
+	transformationMatrix_.WVP = transformationMatrix_.World * viewProjectionMatrix;
+	transformationMatrix_.WorldInverseTranspose = worldInverseTranspose_;
+	//カリング用の境界
+	worldBounds_ = TransformAABB(model_->GetLocalBounds(), transformationMatrix_.World);
 
-	wvpResource_->Map(0,
-		nullptr,
-		reinterpret_cast<void**>(&transformationMatrixData_)
-	);
+	cachedViewProjection_ = viewProjectionMatrix;
+	cachedCamera_ = camera;
+	cachedModel_ = model_;
+	isTransformationMatrixValid_ = true;
+}
 
+void Object3d::CreateWvpData()
+{
 	//単位行列を書き込んでおく
-	transformationMatrixData_->WVP = MakeIdentity4x4();
-	transformationMatrixData_->World = MakeIdentity4x4();
+	transformationMatrix_.WVP = MakeIdentity4x4();
+	transformationMatrix_.World = MakeIdentity4x4();
+	transformationMatrix_.WorldInverseTranspose = MakeIdentity4x4();
 }
 
 void Object3d::CreateDirectionalLightData()
 {
-	/*--------------[ 平行光源リソースを作る ]-----------------*/
-
-	directionalLightResource_ = object3dCommon_->GetDXCommon()->CreateBufferResource(sizeof(DirectionalLight));
-
-	/*--------------[ 平行光源リソースにデータを書き込むためのアドレスを取得してdirectionalLightDataに割り当てる ]-----------------*/
-
-	directionalLightResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&directionalLightData_)
-	);
-
 	//デフォルト値は以下のようにしておく
-	directionalLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	directionalLightData_->direction = Vector3::Normalize({ 0.0f,-1.0f,0.0f });
-	directionalLightData_->intensity = 0.5f;
+	directionalLight_.color = { 1.0f,1.0f,1.0f,1.0f };
+	directionalLight_.direction = Vector3::Normalize({ 0.0f,-1.0f,0.0f });
+	directionalLight_.intensity = 0.5f;
 }
 
 void Object3d::CreateCameraData()
 {
-	/*--------------[ カメラリソースを作る ]-----------------*/
-
-	cameraResource_ = object3dCommon_->GetDXCommon()->CreateBufferResource(sizeof(CameraForGPU));
-
-	/*--------------[ カメラリソースにデータを書き込むためのアドレスを取得してcameraDataに割り当てる ]-----------------*/
-
-	cameraResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&cameraData_)
-	);
-  
 	//デフォルト値は以下のようにしておく
-	cameraData_->worldPos = {};
+	cameraData_.worldPos = {};
 }
 
-
 void Object3d::InitializeRenderingSettings()
 {
 	//座標変換行列の生成
@@ -206,3 +204,10 @@ void Object3d::InitializeRenderingSettings()
 	//カメラデータの生成
 	CreateCameraData();
 }
+
+Material Object3d::MakeMaterial() const
+{
+	Material material = model_->GetMaterial();
+	material.textureIndex = hasTextureOverride_ ? textureIndex_ : model_->GetTextureIndex();
+	return material;
+}
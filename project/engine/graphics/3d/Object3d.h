@@ -19,7 +19,6 @@ class Object3dCommon;
 class Object3d
 {
 public:	/*========[ メンバ関数 ]========*/
-	~Object3d();
 	/**
 	 * \brief 初期化
 	 */
@@ -32,21 +31,23 @@ public:	/*========[ メンバ関数 ]========*/
 
 	/**
 	 * \brief 描画
-	 * \param commandList 
+	 * \note 平行光源を個別に変えていなければ描画キューに積まれ、Object3dCommon::FlushRenderQueueでまとめて描画される
 	 */
 	void Draw();
 
 	/**
 	 * \brief 行列の更新
+	 * \note SRTが前回と同じならワールド行列は計算し直さない
 	 */
 	void UpdateMatrix(Camera* camera = nullptr);
 
 	/**
-	 * \brief 行列の更新
-	 * \param worldMatrix 
+	 * \brief 計算済みのワールド行列で行列を更新
+	 * \param worldMatrix ワールド行列
+	 * \param worldInverseTranspose 法線変換用の逆転置行列
 	 * \param camera 
 	 */
-	void UpdateMatrixWithWorld(const Matrix4x4& worldMatrix, Camera* camera = nullptr);
+	void UpdateMatrixWithWorld(const Matrix4x4& worldMatrix, const Matrix4x4& worldInverseTranspose, Camera* camera = nullptr);
 
 public: /*========[ ゲッター ]========*/
 	//Transform
@@ -61,13 +62,13 @@ public: /*========[ ゲッター ]========*/
 	bool IsEnableLighting() const { return model_->IsEnableLighting(); }
 
 	//ライティングのカラー
-	Vector4 GetLightingColor() const { return directionalLightData_->color; }
+	Vector4 GetLightingColor() const { return directionalLight_.color; }
 
 	//ライティングの強さ
-	float GetLightingIntensity() const { return directionalLightData_->intensity; }
+	float GetLightingIntensity() const { return directionalLight_.intensity; }
 
 	//ライティングの向き
-	Vector3 GetLightingDirection() const { return directionalLightData_->direction; }
+	Vector3 GetLightingDirection() const { return directionalLight_.direction; }
 
 	//反射強度
 	float GetShininess() const { return model_->GetShininess(); }
@@ -86,7 +87,7 @@ public: /*========[ セッター ]========*/
 	void SetRotate(const Vector3& rotate) { transform_.rotate = rotate; }
 	void SetTranslate(const Vector3& translate) { transform_.translate = translate; }
 
-	Matrix4x4 GetWorldMatrix() const { return transformationMatrixData_ ? transformationMatrixData_->World : MakeIdentity4x4(); }
+	Matrix4x4 GetWorldMatrix() const { return transformationMatrix_.World; }
 
 	//色
 	void SetColor(const Vector4& color) const { model_->SetColor(color); }
@@ -95,25 +96,42 @@ public: /*========[ セッター ]========*/
 	void SetEnableLighting(bool enable) const { model_->SetEnableLighting(enable); }
 
 	//ライティングのカラー
-	void SetLightingColor(const Vector4& color) const { directionalLightData_->color  = color; }
+	void SetLightingColor(const Vector4& color) { directionalLight_.color  = color; }
 
 	//ライティングの強さ
-	void SetLightingIntensity(float intensity) const { directionalLightData_->intensity = intensity; }
+	void SetLightingIntensity(float intensity) { directionalLight_.intensity = intensity; }
 
 	//ライティングの向き
-	void SetLightingDirection(const Vector3& direction) const { directionalLightData_->direction = direction; }
+	void SetLightingDirection(const Vector3& direction) { directionalLight_.direction = direction; }
 
 	//反射強度
 	void SetShininess(float shininess) const { model_->SetShininess(shininess); }
 
 	//ライト
-	void SetDirectionalLightColor(const Vector4& color) { directionalLightData_->color = color; }
-	void SetDirectionalLightDirection(const Vector3& direction) { directionalLightData_->direction = direction; }
-	void SetDirectionalLightIntensity(float intensity) { directionalLightData_->intensity = intensity; }
-	void SetDirectionalLight(const DirectionalLight& light) { *directionalLightData_ = light; }
+	void SetDirectionalLightColor(const Vector4& color) { directionalLight_.color = color; }
+	void SetDirectionalLightDirection(const Vector3& direction) { directionalLight_.direction = direction; }
+	void SetDirectionalLightIntensity(float intensity) { directionalLight_.intensity = intensity; }
+	void SetDirectionalLight(const DirectionalLight& light) { directionalLight_ = light; }
 
 	void SetLightManager(LightManager* lightManager) { lightManager_ = lightManager; }
 
+	/**
+	 * \brief このオブジェクトだけテクスチャを差し替える
+	 * \note マテリアルはインスタンスごとに引くので、同じモデルなら差し替えていても1回の描画にまとめられる
+	 * \param filePath テクスチャのパス（空ならモデルのテクスチャに戻す）
+	 */
+	void SetTexture(const std::string& filePath);
+
+	//置いたまま動かないオブジェクトか（影の描き直しの判定に使う）
+	void SetStatic(bool isStatic) { isStatic_ = isStatic; }
+	bool IsStatic() const { return isStatic_; }
+
+	/**
+	 * \brief オブジェクトごとの設定（平行光源・テクスチャ差し替え・静的フラグ）を初期値に戻す
+	 * \note プールから再利用する時に前の状態を持ち越さないようにする
+	 */
+	void ResetState();
+
 private: /*========[ プライベートメンバ関数(このクラス内でしか使わない関数)  ]========*/
 
 	/**
@@ -135,21 +153,29 @@ private: /*========[ プライベートメンバ関数(このクラス内でし
 	 * \brief 描画設定の初期化
 	 */
 	void InitializeRenderingSettings();
+
+	/**
+	 * \brief ワールド行列とカメラから定数バッファに送る行列を求める
+	 * \note ワールド行列・モデル・カメラの行列が前回と同じなら何もしない
+	 */
+	void UpdateTransformationMatrix(Camera* camera);
+
+	/**
+	 * \brief 描画に使うマテリアル（モデルのマテリアルに、差し替えたテクスチャを反映したもの）
+	 */
+	Material MakeMaterial() const;
 	
 
 private: /*========[ 描画用変数 ]========*/
 	//オブジェクトのコマンド
 	Object3dCommon* object3dCommon_ = nullptr;
 
-	//バッファリソース	
-	Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> cameraResource_;
-
-	//バッファリソース内のデータを指すポインタ
-	TransformationMatrix* transformationMatrixData_ = nullptr;
-	DirectionalLight* directionalLightData_ = nullptr;
-	CameraForGPU* cameraData_ = nullptr;
+	//定数バッファに送るデータ（描画時にフレーム用のアップロード領域へ書き込む）
+	TransformationMatrix transformationMatrix_{};
+	DirectionalLight directionalLight_{};
+	CameraForGPU cameraData_{};
+	//ワールド空間の境界（視錐台カリングに使う）
+	AABB worldBounds_;
 
 
 private: /*========[ メンバ変数 ]========*/
@@ -165,5 +191,22 @@ private: /*========[ メンバ変数 ]========*/
 	//座標変換行列
 	Transform transform_;
 
+	//置いたまま動かないオブジェクトか
+	bool isStatic_ = false;
+
+	//差し替えたテクスチャの番号
+	uint32_t textureIndex_ = 0;
+	bool hasTextureOverride_ = false;
+
+	//行列のキャッシュ
+	Matrix4x4 worldMatrix_ = MakeIdentity4x4();				//モデルのルート行列を含まないワールド行列
+	Matrix4x4 worldInverseTranspose_ = MakeIdentity4x4();
+	Transform cachedTransform_{};							//worldMatrix_の元になったSRT
+	bool isWorldFromTransform_ = false;						//worldMatrix_がcachedTransform_から作られたか
+	Matrix4x4 cachedViewProjection_{};
+	Camera* cachedCamera_ = nullptr;
+	Model* cachedModel_ = nullptr;
+	bool isTransformationMatrixValid_ = false;				//transformationMatrix_が今の行列・カメラと一致しているか
+
 };
 
@@ -1,9 +1,16 @@
 #include "Object3dCommon.h"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstring>
 // system
+#include "base/JobSystem.h"
 #include "base/Logger.h"
+#include "Model.h"
 #include "manager/graphics/TextureManager.h"
+#include "manager/scene/LightManager.h"
+#include "manager/system/SrvManager.h"
 
 void Object3dCommon::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 {
@@ -11,10 +18,17 @@ void Object3dCommon::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 	dxCommon_ = dxCommon;
 	//SRVマネージャーの初期化
 	srvManager_ = srvManager;
-	//ルートシグネチャの生成
-	CreateRootSignature();
-	//グラフィックスパイプラインの生成
-	CreateGraphicsPipelineState();
+	//ルートシグネチャとパイプラインの生成
+	CreatePipelines();
+	//シェーダーを書き換えたら作り直す
+	dxCommon_->AddShaderReloadListener(
+		{ L"Resources/shaders/Object3d.VS.hlsl", L"Resources/shaders/Object3dInstanced.VS.hlsl", L"Resources/shaders/Object3d.PS.hlsl" },
+		[this]() { CreatePipelines(); });
+
+	//キューで共有する平行光源
+	sharedLight_.color = { 1.0f,1.0f,1.0f,1.0f };
+	sharedLight_.direction = Vector3::Normalize({ 0.0f,-1.0f,0.0f });
+	sharedLight_.intensity = 0.5f;
 }
 
 void Object3dCommon::CommonRenderingSetting()
@@ -28,25 +42,309 @@ void Object3dCommon::CommonRenderingSetting()
 	//プリミティブトポロジーをセットするコマンド
 	dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
+	//テクスチャはマテリアルの番号でヒープ全体から引くので、描画ごとには設定しない
+	SetBindlessTextureTable();
+
 	// 環境マップのテクスチャをセットするコマンド
 	dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(
 		8, // ピクセルシェーダのルートパラメータ8
-		srvManager_->GetGPUDescriptorHandle(TextureManager::GetInstance()->GetSRVIndex("./Resources/rostock_laage_airport_4k.dds")) // 環境マップのSRVハンドル
+		GetEnvironmentMapHandle() // 環境マップのSRVハンドル（転送中は代わりのテクスチャ）
 	);
 }
 
-void Object3dCommon::CreateRootSignature()
+void Object3dCommon::SubmitToRenderQueue(Model* model, const Material& material, const TransformationMatrix& transform, const AABB& worldBounds)
+{
+	//マテリアルの色が半透明なら奥から描く
+	RenderQueue::Layer layer = material.color.w < 1.0f ? RenderQueue::Layer::Transparent : RenderQueue::Layer::Opaque;
+	//原点をWVPで変換した時のwがカメラからの奥行き
+	float viewDepth = transform.WVP.m[3][3];
+	//同じ中身のマテリアルは同じ番号になる
+	uint32_t materialIndex = materialRegistry_.Register(material);
+	renderQueue_.Submit(model, layer, materialIndex, model->GetRenderId(), viewDepth, transform, worldBounds);
+}
+
+void Object3dCommon::SubmitShadowCaster(Model* model, const Matrix4x4& world, const AABB& worldBounds, bool isStatic)
+{
+	ShadowCaster caster;
+	caster.model = model;
+	caster.world = world;
+	caster.bounds = worldBounds;
+	caster.isStatic = isStatic;
+	shadowCasters_.push_back(caster);
+}
+
+bool Object3dCommon::RenderShadows(LightManager* lightManager)
+{
+	if (!lightManager)
+	{
+		shadowCasters_.clear();
+		return false;
+	}
+
+	//ライトも範囲内のオブジェクトも動いていないタイルは描かない
+	const auto& requests = lightManager->CollectShadowRenderRequests(shadowCasters_);
+	if (requests.empty())
+	{
+		shadowCasters_.clear();
+		return false;
+	}
+
+	ShadowAtlas& shadowAtlas = lightManager->GetShadowAtlas();
+	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+	shadowAtlas.BeginRender(commandList);
+	commandList->SetGraphicsRootSignature(instancedRootSignature_.Get());
+	commandList->SetPipelineState(shadowPipelineState_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	for (const ShadowAtlas::RenderRequest& request : requests)
+	{
+		shadowAtlas.BeginTile(commandList, request.tile);
+
+		//照らす範囲にあるオブジェクトを、同じモデルが並ぶように集める
+		shadowCasterIndices_.clear();
+		for (uint32_t i = 0; i < shadowCasters_.size(); ++i)
+		{
+			if (ShadowAtlas::IntersectsSphere(shadowCasters_[i].bounds, request.boundsCenter, request.boundsRadius))
+			{
+				shadowCasterIndices_.push_back(i);
+			}
+		}
+		if (shadowCasterIndices_.empty())
+		{
+			continue;
+		}
+		std::sort(shadowCasterIndices_.begin(), shadowCasterIndices_.end(), [this](uint32_t a, uint32_t b) {
+			return shadowCasters_[a].model < shadowCasters_[b].model;
+		});
+
+		//ライトから見た行列をまとめて書き込む
+		shadowInstances_.resize(shadowCasterIndices_.size());
+		for (size_t i = 0; i < shadowCasterIndices_.size(); ++i)
+		{
+			const ShadowCaster& caster = shadowCasters_[shadowCasterIndices_[i]];
+			shadowInstances_[i].transform.WVP = Multiply(caster.world, request.viewProjection);
+			shadowInstances_[i].transform.World = caster.world;
+			shadowInstances_[i].transform.WorldInverseTranspose = MakeIdentity4x4();
+			shadowInstances_[i].materialIndex = 0;	//深度だけを書くので使わない
+		}
+		UploadAllocation instanceAllocation = dxCommon_->AllocateUpload(sizeof(InstanceData) * shadowInstances_.size());
+		std::memcpy(instanceAllocation.cpuAddress, shadowInstances_.data(), sizeof(InstanceData) * shadowInstances_.size());
+
+		//同じモデルが続く範囲を1回のインスタンス描画にまとめる
+		uint32_t first = 0;
+		while (first < shadowCasterIndices_.size())
+		{
+			Model* model = shadowCasters_[shadowCasterIndices_[first]].model;
+			uint32_t last = first + 1;
+			while (last < shadowCasterIndices_.size() && shadowCasters_[shadowCasterIndices_[last]].model == model)
+			{
+				++last;
+			}
+			commandList->SetGraphicsRootShaderResourceView(1, instanceAllocation.gpuAddress + sizeof(InstanceData) * first);
+			model->Draw(last - first);
+			first = last;
+		}
+		shadowAtlas.RecordCasterDraws(static_cast<uint32_t>(shadowCasterIndices_.size()));
+	}
+
+	shadowAtlas.EndRender(commandList);
+	shadowCasters_.clear();
+
+	//通常の描画設定に戻す
+	CommonRenderingSetting();
+	return true;
+}
+
+bool Object3dCommon::TestVisibility(Camera* camera, const AABB& worldBounds)
+{
+	if (!enableFrustumCulling_ || !camera)
+	{
+		return true;
+	}
+
+	++cullTestedCount_;
+	if (!GetFrustum(camera).IsVisible(worldBounds))
+	{
+		return false;
+	}
+	++cullVisibleCount_;
+	return true;
+}
+
+void Object3dCommon::FlushRenderQueue(Camera* camera, LightManager* lightManager)
+{
+	lastQueuedItemCount_ = renderQueue_.GetItemCount();
+	lastDrawCallCount_ = 0;
+	lastCommandListCount_ = 0;
+
+	//キューに積まれた分は視錐台の外をまとめて取り除く
+	if (enableFrustumCulling_ && camera && !renderQueue_.IsEmpty())
+	{
+		cullTestedCount_ += renderQueue_.GetItemCount();
+		cullVisibleCount_ += renderQueue_.Cull(GetFrustum(camera));
+	}
+
+	//このフレームの判定数を確定させる（キューを通さない描画の分も含む）
+	lastCullTestedCount_ = cullTestedCount_;
+	lastCullVisibleCount_ = cullVisibleCount_;
+	cullTestedCount_ = 0;
+	cullVisibleCount_ = 0;
+
+	lastMaterialCount_ = 0;
+	if (renderQueue_.IsEmpty())
+	{
+		renderQueue_.Clear();
+		materialRegistry_.Clear();
+		return;
+	}
+
+	//ソートしてモデルごとにまとめる
+	renderQueue_.Build();
+
+	//並び替えた座標変換行列とマテリアルの番号をまとめて書き込む
+	const auto& instances = renderQueue_.GetInstances();
+	UploadAllocation instanceAllocation = dxCommon_->AllocateUpload(sizeof(InstanceData) * instances.size());
+	std::memcpy(instanceAllocation.cpuAddress, instances.data(), sizeof(InstanceData) * instances.size());
+
+	//マテリアルを書き込む（テクスチャの番号は、転送中なら代わりのテクスチャのSRVの番号に直す）
+	const auto& materials = materialRegistry_.GetMaterials();
+	UploadAllocation materialAllocation = dxCommon_->AllocateUpload(sizeof(Material) * materials.size());
+	Material* materialData = static_cast<Material*>(materialAllocation.cpuAddress);
+	for (size_t i = 0; i < materials.size(); ++i)
+	{
+		materialData[i] = materials[i];
+		materialData[i].textureIndex = TextureManager::GetInstance()->GetDrawSrvIndex(materials[i].textureIndex);
+	}
+	lastMaterialCount_ = static_cast<uint32_t>(materials.size());
+
+	//カメラの位置を書き込む
+	CameraForGPU cameraData{};
+	if (camera)
+	{
+		const Matrix4x4& cameraWorld = camera->GetWorldMatrix();
+		cameraData.worldPos = { cameraWorld.m[3][0], cameraWorld.m[3][1], cameraWorld.m[3][2] };
+	}
+
+	//リスト間で共有するものはメインスレッドで書き込んでおく
+	const D3D12_GPU_VIRTUAL_ADDRESS lightAddress = dxCommon_->UploadConstant(sharedLight_);
+	const D3D12_GPU_VIRTUAL_ADDRESS cameraAddress = dxCommon_->UploadConstant(cameraData);
+	const D3D12_GPU_DESCRIPTOR_HANDLE environmentHandle = GetEnvironmentMapHandle();
+
+	//バッチを分けてワーカースレッドで並列に記録する（リストは分けた順に実行されるので、描画順は変わらない）
+	const auto& batches = renderQueue_.GetBatches();
+	const uint32_t batchCount = static_cast<uint32_t>(batches.size());
+	const uint32_t maxChunkCount = JobSystem::GetInstance()->GetThreadCount() + 1;
+	const uint32_t chunkCount = std::clamp((batchCount + kMinBatchesPerCommandList - 1) / kMinBatchesPerCommandList, 1u, maxChunkCount);
+	const uint32_t chunkSize = (batchCount + chunkCount - 1) / chunkCount;
+	const D3D12_GPU_VIRTUAL_ADDRESS instanceAddress = instanceAllocation.gpuAddress;
+
+	dxCommon_->RecordParallel(chunkCount, [&](uint32_t chunk)
+		{
+			ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+
+			//インスタンス描画用の設定（バッチ間で変わらないものはリストごとに1度だけ設定する）
+			commandList->SetGraphicsRootSignature(instancedRootSignature_.Get());
+			commandList->SetPipelineState(instancedPipelineState_.Get());
+			commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			commandList->SetGraphicsRootShaderResourceView(0, materialAllocation.gpuAddress);
+			SetBindlessTextureTable();
+			commandList->SetGraphicsRootDescriptorTable(8, environmentHandle);
+			commandList->SetGraphicsRootConstantBufferView(3, lightAddress);
+			commandList->SetGraphicsRootConstantBufferView(4, cameraAddress);
+			if (lightManager)
+			{
+				lightManager->Draw();
+			}
+
+			//バッチごとに先頭の行列を指して描画（マテリアルが違ってもモデルが同じなら1回で描く）
+			const uint32_t begin = chunk * chunkSize;
+			const uint32_t end = (std::min)(begin + chunkSize, batchCount);
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				const auto& batch = batches[i];
+				commandList->SetGraphicsRootShaderResourceView(1, instanceAddress + sizeof(InstanceData) * batch.firstInstance);
+				batch.model->Draw(batch.instanceCount);
+			}
+		});
+	lastDrawCallCount_ = batchCount;
+	lastCommandListCount_ = chunkCount;
+
+	renderQueue_.Clear();
+	materialRegistry_.Clear();
+
+	//通常の描画設定に戻す
+	CommonRenderingSetting();
+}
+
+void Object3dCommon::SetBindlessTextureTable()
+{
+	//ヒープの先頭からのテーブルなので、SRVの番号がそのまま添字になる（ヒープを作り直すと先頭が変わるので毎回取得する）
+	dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(2, srvManager_->GetGPUDescriptorHandle(0));
+}
+
+const Frustum& Object3dCommon::GetFrustum(Camera* camera)
+{
+	const Matrix4x4& viewProjection = camera->GetViewProjectionMatrix();
+	if (camera != frustumCamera_ || std::memcmp(&viewProjection, &frustumViewProjection_, sizeof(Matrix4x4)) != 0)
+	{
+		frustum_ = Frustum::FromViewProjection(viewProjection);
+		frustumCamera_ = camera;
+		frustumViewProjection_ = viewProjection;
+	}
+	return frustum_;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE Object3dCommon::GetEnvironmentMapHandle() const
+{
+	TextureManager* textureManager = TextureManager::GetInstance();
+	//シーンが設定していない、または読み込まれていなければ代わりのキューブマップ
+	if (environmentMapPath_.empty() || !textureManager->IsLoaded(environmentMapPath_))
+	{
+		return textureManager->GetFallbackSrvHandleGPU(true);
+	}
+	return textureManager->GetSrvHandleGPU(environmentMapPath_);
+}
+
+bool Object3dCommon::IsSharedDirectionalLight(const DirectionalLight& light) const
+{
+	return std::memcmp(&light, &sharedLight_, sizeof(DirectionalLight)) == 0;
+}
+
+void Object3dCommon::CreatePipelines()
+{
+	//ルートシグネチャの生成
+	rootSignature_ = CreateRootSignature(false);
+	//グラフィックスパイプラインの生成
+	graphicsPipelineState_ = CreateGraphicsPipelineState(rootSignature_.Get(), L"Resources/shaders/Object3d.VS.hlsl");
+
+	//インスタンス描画用のルートシグネチャとパイプラインの生成
+	instancedRootSignature_ = CreateRootSignature(true);
+	instancedPipelineState_ = CreateGraphicsPipelineState(instancedRootSignature_.Get(), L"Resources/shaders/Object3dInstanced.VS.hlsl");
+
+	//影を描くパイプラインの生成（インスタンス描画と同じ頂点シェーダーで深度だけを書く）
+	shadowPipelineState_ = CreateShadowPipelineState(instancedRootSignature_.Get());
+}
+
+Microsoft::WRL::ComPtr<ID3D12RootSignature> Object3dCommon::CreateRootSignature(bool instanced)
 {
 	///===================================================================
 	///ディスクリプタレンジの生成
 	///===================================================================
 
-	// 通常のテクスチャ用
+	// 通常のテクスチャ用（SRVヒープ全体を1つのテーブルにして、マテリアルのtextureIndexで引く）
 	D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
 	descriptorRange[0].BaseShaderRegister = 0;
-	descriptorRange[0].NumDescriptors = 1;
+	descriptorRange[0].RegisterSpace = 1;										// space1（他のテクスチャと分ける）
+	descriptorRange[0].NumDescriptors = UINT_MAX;								// 上限なし（ヒープの大きさまで）
 	descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-	descriptorRange[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+	descriptorRange[0].OffsetInDescriptorsFromTableStart = 0;
+
+	// 影のアトラス用
+	D3D12_DESCRIPTOR_RANGE descriptorRangeShadowAtlas[1] = {};
+	descriptorRangeShadowAtlas[0].BaseShaderRegister = 2; // t2
+	descriptorRangeShadowAtlas[0].NumDescriptors = 1;
+	descriptorRangeShadowAtlas[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	descriptorRangeShadowAtlas[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
 	// 環境マップ用
 	D3D12_DESCRIPTOR_RANGE descriptorRangeEnvMap[1] = {};
@@ -65,19 +363,20 @@ void Object3dCommon::CreateRootSignature()
 	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
 	//RootParameter作成。複数設定できるので配列。`
-	D3D12_ROOT_PARAMETER rootParameters[9] = {};
+	D3D12_ROOT_PARAMETER rootParameters[14] = {};
 
-	//ルートパラメータ1: ピクセルシェーダ用CBV　マテリアル
-	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;		//CBVを使う
+	//ルートパラメータ1: ピクセルシェーダ用SRV　マテリアル（インスタンスごとの番号で引く）
+	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;		//StructuredBufferを使う
 	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;		//PixelShaderで使う
-	rootParameters[0].Descriptor.ShaderRegister = 0;						//レジスタ番号０とバインド
+	rootParameters[0].Descriptor.ShaderRegister = 8;						//レジスタ番号8とバインド
 
 	// ルートパラメータ2: バーテックス用のCBV　ワールドビュープロジェクション行列
-	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	// インスタンス描画ではStructuredBuffer(t0)として受け取り、バッチの先頭アドレスを指す
+	rootParameters[1].ParameterType = instanced ? D3D12_ROOT_PARAMETER_TYPE_SRV : D3D12_ROOT_PARAMETER_TYPE_CBV;
 	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 	rootParameters[1].Descriptor.ShaderRegister = 0;
 
-	// ルートパラメータ3: ピクセルシェーダ用　テクスチャ
+	// ルートパラメータ3: ピクセルシェーダ用　テクスチャ（ヒープ全体）
 	rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;			//DescriptorTableを使う
 	rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;						//PixelShaderで使う
 	rootParameters[2].DescriptorTable.pDescriptorRanges = descriptorRange;					//Tableの中身の配列を指定
@@ -114,8 +413,34 @@ void Object3dCommon::CreateRootSignature()
 	rootParameters[8].DescriptorTable.pDescriptorRanges = descriptorRangeEnvMap;		//Tableの中身の配列を指定
 	rootParameters[8].DescriptorTable.NumDescriptorRanges = _countof(descriptorRangeEnvMap);	//Tableで利用する数
 
+	//ルートパラメータ10: ピクセルシェーダ用CBV　ライトのクラスタの求め方
+	rootParameters[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootParameters[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[9].Descriptor.ShaderRegister = 6;
+
+	//ルートパラメータ11: ピクセルシェーダ用SRV　クラスタごとのライトの範囲
+	rootParameters[10].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootParameters[10].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[10].Descriptor.ShaderRegister = 5;
+
+	//ルートパラメータ12: ピクセルシェーダ用SRV　クラスタに入っているライトの番号
+	rootParameters[11].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootParameters[11].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[11].Descriptor.ShaderRegister = 6;
+
+	//ルートパラメータ13: ピクセルシェーダ用SRV　スポットライトの影の情報
+	rootParameters[12].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootParameters[12].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[12].Descriptor.ShaderRegister = 7;
+
+	//ルートパラメータ14: ピクセルシェーダ用　影のアトラス
+	rootParameters[13].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootParameters[13].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootParameters[13].DescriptorTable.pDescriptorRanges = descriptorRangeShadowAtlas;
+	rootParameters[13].DescriptorTable.NumDescriptorRanges = _countof(descriptorRangeShadowAtlas);
+
 	//Smaplerの設定
-	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
+	D3D12_STATIC_SAMPLER_DESC staticSamplers[2] = {};
 	staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;				//バイリニアフィルタ
 	staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;			//0～1の範囲外をリピート
 	staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
@@ -124,36 +449,27 @@ void Object3dCommon::CreateRootSignature()
 	staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;							//ありったけのMipmapを使う
 	staticSamplers[0].ShaderRegister = 0;									//レジスタ番号0を使う
 	staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;		//PixelShaderを使う
+	//影の比較用（近い4テクセルの比較結果を補間する）
+	staticSamplers[1].Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+	staticSamplers[1].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	staticSamplers[1].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	staticSamplers[1].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	staticSamplers[1].ComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;	//比較する深度が手前なら光が届く
+	staticSamplers[1].MaxLOD = 0.0f;
+	staticSamplers[1].ShaderRegister = 1;
+	staticSamplers[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 	descriptionRootSignature.pStaticSamplers = staticSamplers;
 	descriptionRootSignature.NumStaticSamplers = _countof(staticSamplers);
 
 	descriptionRootSignature.pParameters = rootParameters;					//ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters);		//配列の長さ
 
-	HRESULT hr;
-
-	//シリアライズしてバイナリする
-	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
-	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-	hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
-	if (FAILED(hr))
-	{
-		Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
-		assert(false);
-	}
-	//バイナリをもとに生成
-
-	hr = dxCommon_->GetDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
-	assert(SUCCEEDED(hr));
+	//生成（同じ記述のものがあれば共有する）
+	return dxCommon_->GetPipelineCache()->GetRootSignature(descriptionRootSignature);
 }
 
-void Object3dCommon::CreateGraphicsPipelineState()
+Microsoft::WRL::ComPtr<ID3D12PipelineState> Object3dCommon::CreateGraphicsPipelineState(ID3D12RootSignature* rootSignature, const std::wstring& vertexShaderPath)
 {
-	//ルートシグネチャ
-	CreateRootSignature();
-
-	HRESULT hr;
-
 	///===================================================================
 	///InputLayout(インプットレイアウト)
 	///===================================================================
@@ -213,7 +529,7 @@ void Object3dCommon::CreateGraphicsPipelineState()
 	///===================================================================
 
 	//shaderをコンパイルする
-	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Object3d.VS.hlsl", L"vs_6_0");
+	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileSharder(vertexShaderPath, L"vs_6_0");
 	assert(vertexShaderBlob != nullptr);
 
 	Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Object3d.PS.hlsl", L"ps_6_0");
@@ -238,7 +554,7 @@ void Object3dCommon::CreateGraphicsPipelineState()
 	///===================================================================
 
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
-	graphicsPipelineStateDesc.pRootSignature = rootSignature_.Get();
+	graphicsPipelineStateDesc.pRootSignature = rootSignature;
 	graphicsPipelineStateDesc.InputLayout = inputLayoutDesc;
 	graphicsPipelineStateDesc.VS = { vertexShaderBlob->GetBufferPointer(),vertexShaderBlob->GetBufferSize() };
 	graphicsPipelineStateDesc.PS = { pixelShaderBlob->GetBufferPointer(),pixelShaderBlob->GetBufferSize() };
@@ -256,7 +572,55 @@ void Object3dCommon::CreateGraphicsPipelineState()
 	//どのように画面に色を打ち込むかの設定（気にしなくていい）
 	graphicsPipelineStateDesc.SampleDesc.Count = 1;
 	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
-	//実際に生成
-	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineState_));
-	assert(SUCCEEDED(hr));
+	//実際に生成（同じ記述のものがあれば共有する）
+	return dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(graphicsPipelineStateDesc);
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> Object3dCommon::CreateShadowPipelineState(ID3D12RootSignature* rootSignature)
+{
+	//InputLayout（通常の描画と同じ頂点）
+	D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+	inputElementDescs[0].SemanticName = "POSITION";
+	inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs[1].SemanticName = "TEXCOORD";
+	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs[2].SemanticName = "NORMAL";
+	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
+	inputLayoutDesc.pInputElementDescs = inputElementDescs;
+	inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+	//面の傾きに応じて深度をずらし、自分の影が縞になるのを抑える
+	D3D12_RASTERIZER_DESC rasterizerDesc{};
+	rasterizerDesc.CullMode = D3D12_CULL_MODE_BACK;
+	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+	rasterizerDesc.SlopeScaledDepthBias = 1.5f;
+	rasterizerDesc.DepthClipEnable = TRUE;
+
+	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Object3dInstanced.VS.hlsl", L"vs_6_0");
+	assert(vertexShaderBlob != nullptr);
+
+	D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
+	depthStencilDesc.DepthEnable = true;
+	depthStencilDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+	depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+
+	//ピクセルシェーダーと描画先の色は持たない
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
+	graphicsPipelineStateDesc.pRootSignature = rootSignature;
+	graphicsPipelineStateDesc.InputLayout = inputLayoutDesc;
+	graphicsPipelineStateDesc.VS = { vertexShaderBlob->GetBufferPointer(),vertexShaderBlob->GetBufferSize() };
+	graphicsPipelineStateDesc.RasterizerState = rasterizerDesc;
+	graphicsPipelineStateDesc.DepthStencilState = depthStencilDesc;
+	graphicsPipelineStateDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+	graphicsPipelineStateDesc.NumRenderTargets = 0;
+	graphicsPipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	graphicsPipelineStateDesc.SampleDesc.Count = 1;
+	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+
+	return dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(graphicsPipelineStateDesc);
 }
@@ -1,8 +1,15 @@
 #pragma once
 #include "base/DirectXCommon.h"
 #include "base/Camera.h"
+#include "MaterialRegistry.h"
+#include "RenderQueue.h"
+#include "light/DirectionalLight.h"
+#include "light/ShadowAtlas.h"
+#include "math/Frustum.h"
 
 class SrvManager;
+class LightManager;
+class Model;
 
 class Object3dCommon
 {
@@ -13,17 +20,101 @@ public: //メンバ関数
 	//共通描画設定
 	void CommonRenderingSetting();
 
+	/**
+	 * \brief 描画キューに積む
+	 * \param model 描画するモデル
+	 * \param material このオブジェクトのマテリアル（textureIndexはテクスチャの番号。中身が同じものは1つにまとめる）
+	 * \param transform 座標変換行列
+	 * \param worldBounds ワールド空間の境界（視錐台カリングに使う）
+	 */
+	void SubmitToRenderQueue(Model* model, const Material& material, const TransformationMatrix& transform, const AABB& worldBounds);
+
+	/**
+	 * \brief スポットライトの影を落とすオブジェクトとして積む
+	 * \note カメラの視錐台の外にあっても影は落ちるので、カリングの前に全て積む
+	 * \param model 描画するモデル
+	 * \param world ワールド行列
+	 * \param worldBounds ワールド空間の境界
+	 * \param isStatic 置いたまま動かないオブジェクトか
+	 */
+	void SubmitShadowCaster(Model* model, const Matrix4x4& world, const AABB& worldBounds, bool isStatic);
+
+	/**
+	 * \brief 描き直しが必要なスポットライトの影のタイルだけを描画する
+	 * \note 3Dオブジェクトを全て積んだ後、FlushRenderQueueの前に呼ぶ
+	 * \return 描画先を切り替えたならtrue（呼び出し側で描画先を戻す）
+	 */
+	bool RenderShadows(LightManager* lightManager);
+
+	/**
+	 * \brief キューを通さずに描画するオブジェクトの視錐台判定
+	 * \return 描画するならtrue（カリングが無効なら常にtrue）
+	 */
+	bool TestVisibility(Camera* camera, const AABB& worldBounds);
+
+	/**
+	 * \brief 視錐台の外の要求を取り除いてから、描画キューをソートし、同じモデルをまとめてインスタンス描画する
+	 * \param camera 描画に使うカメラ
+	 * \param lightManager ポイントライト・スポットライトの設定に使うライトマネージャー
+	 */
+	void FlushRenderQueue(Camera* camera, LightManager* lightManager);
+
+	/// \brief キューで共有している平行光源と同じ設定か
+	bool IsSharedDirectionalLight(const DirectionalLight& light) const;
+
 public: //アクセッサ
 	DirectXCommon* GetDXCommon() const { return dxCommon_; }
 
 	void SetDefaultCamera(Camera* camera) { defaultCamera_ = camera; }
 	Camera* GetDefaultCamera() const { return defaultCamera_; }
 
+	//描画キューの有効無効
+	void SetRenderQueueEnabled(bool enable) { enableRenderQueue_ = enable; }
+	bool IsRenderQueueEnabled() const { return enableRenderQueue_; }
+	const RenderQueue& GetRenderQueue() const { return renderQueue_; }
+	const MaterialRegistry& GetMaterialRegistry() const { return materialRegistry_; }
+
+	//直近のフレームでGPUに送ったマテリアルの数
+	uint32_t GetLastMaterialCount() const { return lastMaterialCount_; }
+
+	//直近のフレームで発行した描画コール数
+	uint32_t GetLastDrawCallCount() const { return lastDrawCallCount_; }
+	uint32_t GetLastQueuedItemCount() const { return lastQueuedItemCount_; }
+	//直近のフレームで描画キューを分けて並列に記録したコマンドリストの数
+	uint32_t GetLastCommandListCount() const { return lastCommandListCount_; }
+
+	//視錐台カリングの有効無効
+	void SetFrustumCullingEnabled(bool enable) { enableFrustumCulling_ = enable; }
+	bool IsFrustumCullingEnabled() const { return enableFrustumCulling_; }
+
+	//直近のフレームで視錐台判定したオブジェクト数と、そのうち描画した数
+	uint32_t GetLastCullTestedCount() const { return lastCullTestedCount_; }
+	uint32_t GetLastCullVisibleCount() const { return lastCullVisibleCount_; }
+
+	//環境マップ（キューブマップのパス。シーンが設定する。空なら代わりのキューブマップを使う）
+	void SetEnvironmentMap(const std::string& filePath) { environmentMapPath_ = filePath; }
+	const std::string& GetEnvironmentMap() const { return environmentMapPath_; }
+
+private: //定数
+	//1本のコマンドリストに記録する最低のバッチ数（少ないと分けても記録の手間の方が大きい）
+	static constexpr uint32_t kMinBatchesPerCommandList = 32;
+
 private: //メンバ関数
+	/// \brief ルートシグネチャとパイプラインを全て生成する（シェーダーのホットリロードでも呼ぶ）
+	void CreatePipelines();
 	/// \brief ルートシグネチャの生成
-	void CreateRootSignature();
+	/// \param instanced trueなら座標変換行列をStructuredBufferで受け取る
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> CreateRootSignature(bool instanced);
 	/// \brief グラフィックスパイプラインステートの生成
-	void CreateGraphicsPipelineState();
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> CreateGraphicsPipelineState(ID3D12RootSignature* rootSignature, const std::wstring& vertexShaderPath);
+	/// \brief 影を描くパイプラインステートの生成（深度だけを書く）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> CreateShadowPipelineState(ID3D12RootSignature* rootSignature);
+	/// \brief SRVヒープ全体をテクスチャのテーブルとして設定する（マテリアルのtextureIndexで引く）
+	void SetBindlessTextureTable();
+	/// \brief カメラの視錐台を取得（行列が変わった時だけ作り直す）
+	const Frustum& GetFrustum(Camera* camera);
+	/// \brief 環境マップのSRVハンドルを取得（転送中や未設定なら代わりのキューブマップ）
+	D3D12_GPU_DESCRIPTOR_HANDLE GetEnvironmentMapHandle() const;
 
 private: //メンバ変数
 	// カメラ
@@ -40,5 +131,48 @@ private: //メンバ変数
 	//グラフィックスパイプラインステート
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_ = nullptr;
 
-};
+	/*-----------------------[ 描画キュー ]------------------------*/
+
+	RenderQueue renderQueue_;
+	bool enableRenderQueue_ = true;
+	//キューに積んだマテリアル（インスタンスごとに番号で引く）
+	MaterialRegistry materialRegistry_;
+
+	//インスタンス描画用のルートシグネチャとパイプライン
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> instancedRootSignature_ = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> instancedPipelineState_ = nullptr;
+
+	//キューで共有する平行光源（Object3dの初期値と同じ）
+	DirectionalLight sharedLight_{};
+
+	//環境マップのパス
+	std::string environmentMapPath_;
 
+	/*-----------------------[ 影 ]------------------------*/
+
+	//影を描くパイプライン（インスタンス描画用のルートシグネチャを使う）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> shadowPipelineState_ = nullptr;
+	//今フレームの影を落とすオブジェクト
+	std::vector<ShadowCaster> shadowCasters_;
+	//タイルごとの描画に使う作業用の配列
+	std::vector<uint32_t> shadowCasterIndices_;
+	std::vector<InstanceData> shadowInstances_;
+
+	/*-----------------------[ 視錐台カリング ]------------------------*/
+
+	bool enableFrustumCulling_ = true;
+	//最後に作った視錐台と、その元になったカメラと行列
+	Frustum frustum_;
+	Camera* frustumCamera_ = nullptr;
+	Matrix4x4 frustumViewProjection_{};
+
+	//統計
+	uint32_t lastDrawCallCount_ = 0;
+	uint32_t lastQueuedItemCount_ = 0;
+	uint32_t lastCommandListCount_ = 0;
+	uint32_t lastMaterialCount_ = 0;
+	uint32_t cullTestedCount_ = 0;		//今フレームの判定数
+	uint32_t cullVisibleCount_ = 0;		//今フレームの描画数
+	uint32_t lastCullTestedCount_ = 0;
+	uint32_t lastCullVisibleCount_ = 0;
+};
@@ -0,0 +1,134 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+// math
+#include "math/Frustum.h"
+
+namespace
+{
+	// 正の浮動小数はビット列のまま比較しても大小関係が保たれるので、そのまま30bitに詰める
+	uint64_t QuantizeDepth(float viewDepth)
+	{
+		float depth = (std::max)(viewDepth, 0.0f);
+		uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return static_cast<uint64_t>(bits >> 1) & 0x3FFFFFFFull;
+	}
+}
+
+uint64_t RenderQueue::MakeSortKey(Layer layer, uint32_t materialId, uint32_t modelId, float viewDepth)
+{
+	const uint64_t layerBits = static_cast<uint64_t>(layer) & 0x3ull;
+	const uint64_t material = static_cast<uint64_t>(materialId) & 0xFFFFull;
+	const uint64_t model = static_cast<uint64_t>(modelId) & 0xFFFFull;
+	const uint64_t depth = QuantizeDepth(viewDepth);
+
+	if (layer == Layer::Transparent)
+	{
+		// 半透明は奥から描くので深度を反転して上位に置く
+		return (layerBits << 62) | ((0x3FFFFFFFull - depth) << 32) | (model << 16) | material;
+	}
+	// 不透明は同じモデルが並ぶようにモデルを優先する（テクスチャはヒープ全体のテーブルから引くので、マテリアルが違ってもまとめられる）
+	return (layerBits << 62) | (model << 46) | (material << 30) | depth;
+}
+
+void RenderQueue::Clear()
+{
+	items_.clear();
+	boundsCenterX_.clear();
+	boundsCenterY_.clear();
+	boundsCenterZ_.clear();
+	boundsExtentX_.clear();
+	boundsExtentY_.clear();
+	boundsExtentZ_.clear();
+	transforms_.clear();
+	instances_.clear();
+	batches_.clear();
+}
+
+void RenderQueue::Submit(Model* model, Layer layer, uint32_t materialId, uint32_t modelId, float viewDepth, const TransformationMatrix& transform, const AABB& worldBounds)
+{
+	Item item;
+	item.sortKey = MakeSortKey(layer, materialId, modelId, viewDepth);
+	item.model = model;
+	item.transformIndex = static_cast<uint32_t>(transforms_.size());
+	item.materialIndex = materialId;
+	items_.push_back(item);
+	transforms_.push_back(transform);
+
+	const Vector3 center = worldBounds.GetCenter();
+	const Vector3 extent = worldBounds.GetHalfSize();
+	boundsCenterX_.push_back(center.x);
+	boundsCenterY_.push_back(center.y);
+	boundsCenterZ_.push_back(center.z);
+	boundsExtentX_.push_back(extent.x);
+	boundsExtentY_.push_back(extent.y);
+	boundsExtentZ_.push_back(extent.z);
+}
+
+uint32_t RenderQueue::Cull(const Frustum& frustum)
+{
+	// 境界はitems_と同じ順に積んであるので、判定結果をそのまま使って両方を詰める
+	visible_.resize(items_.size());
+	frustum.CullBoxes(boundsCenterX_.data(), boundsCenterY_.data(), boundsCenterZ_.data(),
+					  boundsExtentX_.data(), boundsExtentY_.data(), boundsExtentZ_.data(),
+					  items_.size(), visible_.data());
+
+	size_t writeIndex = 0;
+	for (size_t i = 0; i < items_.size(); ++i)
+	{
+		if (!visible_[i])
+		{
+			continue;
+		}
+		items_[writeIndex] = items_[i];
+		boundsCenterX_[writeIndex] = boundsCenterX_[i];
+		boundsCenterY_[writeIndex] = boundsCenterY_[i];
+		boundsCenterZ_[writeIndex] = boundsCenterZ_[i];
+		boundsExtentX_[writeIndex] = boundsExtentX_[i];
+		boundsExtentY_[writeIndex] = boundsExtentY_[i];
+		boundsExtentZ_[writeIndex] = boundsExtentZ_[i];
+		++writeIndex;
+	}
+	items_.resize(writeIndex);
+	boundsCenterX_.resize(writeIndex);
+	boundsCenterY_.resize(writeIndex);
+	boundsCenterZ_.resize(writeIndex);
+	boundsExtentX_.resize(writeIndex);
+	boundsExtentY_.resize(writeIndex);
+	boundsExtentZ_.resize(writeIndex);
+	return static_cast<uint32_t>(items_.size());
+}
+
+void RenderQueue::Build()
+{
+	batches_.clear();
+	instances_.clear();
+	if (items_.empty())
+	{
+		return;
+	}
+
+	// 同じキーの間は積んだ順を保つ
+	std::stable_sort(items_.begin(), items_.end(), [](const Item& a, const Item& b) { return a.sortKey < b.sortKey; });
+
+	// 同じモデルが連続する範囲を1回のインスタンス描画にまとめる
+	instances_.reserve(items_.size());
+	for (const Item& item : items_)
+	{
+		if (batches_.empty() || batches_.back().model != item.model)
+		{
+			Batch batch;
+			batch.model = item.model;
+			batch.firstInstance = static_cast<uint32_t>(instances_.size());
+			batches_.push_back(batch);
+		}
+		InstanceData instance{};
+		instance.transform = transforms_[item.transformIndex];
+		instance.materialIndex = item.materialIndex;
+		instances_.push_back(instance);
+		++batches_.back().instanceCount;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// math
+#include "base/GraphicsTypes.h"
+#include "math/AABB.h"
+
+class Frustum;
+class Model;
+
+/**
+ * \brief 1フレーム分の3D描画要求を溜めて、ソートとインスタンシングの単位分けを行うクラス
+ * \note GPUには触れないので、積む・並べる・まとめる処理だけを単体で確認できる
+ */
+class RenderQueue
+{
+public:
+	// 描画レイヤー（ソートキーの最上位に入る）
+	enum class Layer : uint32_t
+	{
+		Opaque = 0,			// 不透明（手前から奥へ）
+		Transparent = 1,	// 半透明（奥から手前へ）
+	};
+
+	// 描画要求1件分
+	struct Item
+	{
+		uint64_t sortKey = 0;
+		Model* model = nullptr;
+		uint32_t transformIndex = 0;	// transforms_の添字
+		uint32_t materialIndex = 0;		// MaterialRegistryの番号
+	};
+
+	// 同じモデルが連続する範囲をまとめた描画単位（マテリアルとテクスチャはインスタンスごとに引くので、違っていてもよい）
+	struct Batch
+	{
+		Model* model = nullptr;
+		uint32_t firstInstance = 0;		// GetInstances()の先頭からの位置
+		uint32_t instanceCount = 0;
+	};
+
+	/**
+	 * \brief ソートキーを作る
+	 * \note 不透明 : [レイヤー2bit][モデル16bit][マテリアル16bit][深度30bit]
+	 *       半透明 : [レイヤー2bit][反転深度30bit][モデル16bit][マテリアル16bit]
+	 * \param layer 描画レイヤー
+	 * \param materialId マテリアルの番号
+	 * \param modelId モデルの番号
+	 * \param viewDepth カメラからの奥行き
+	 */
+	static uint64_t MakeSortKey(Layer layer, uint32_t materialId, uint32_t modelId, float viewDepth);
+
+	// 積んだ要求を全て破棄する（フレームの先頭で呼ぶ）
+	void Clear();
+
+	// 描画要求を積む
+	void Submit(Model* model, Layer layer, uint32_t materialId, uint32_t modelId, float viewDepth, const TransformationMatrix& transform, const AABB& worldBounds);
+
+	/**
+	 * \brief 視錐台の外にある要求をまとめて取り除く（Buildの前に呼ぶ）
+	 * \return 残った要求の数
+	 */
+	uint32_t Cull(const Frustum& frustum);
+
+	// ソートしてインスタンシング単位にまとめる
+	void Build();
+
+public: //アクセッサ
+	const std::vector<Item>& GetItems() const { return items_; }
+	const std::vector<Batch>& GetBatches() const { return batches_; }
+	// Build後の並び順に詰めた変換行列とマテリアルの番号
+	const std::vector<InstanceData>& GetInstances() const { return instances_; }
+	uint32_t GetItemCount() const { return static_cast<uint32_t>(items_.size()); }
+	uint32_t GetBatchCount() const { return static_cast<uint32_t>(batches_.size()); }
+	bool IsEmpty() const { return items_.empty(); }
+
+private:
+	std::vector<Item> items_;
+	// ワールド空間の境界（中心と半径）を成分ごとに並べる（まとめて視錐台判定するため）
+	std::vector<float> boundsCenterX_, boundsCenterY_, boundsCenterZ_;
+	std::vector<float> boundsExtentX_, boundsExtentY_, boundsExtentZ_;
+	std::vector<uint8_t> visible_;
+	std::vector<TransformationMatrix> transforms_;	// 積んだ順
+	std::vector<InstanceData> instances_;			// ソート後の順
+	std::vector<Batch> batches_;
+};
@@ -23,12 +23,6 @@ Skybox::~Skybox()
 		materialResource_.Reset();
 		material_ = nullptr;
 	}
-	if (wvpResource_)
-	{
-		wvpResource_->Unmap(0, nullptr);
-		wvpResource_.Reset();
-		wvpData_ = nullptr;
-	}
 }
 
 Skybox::Skybox()
@@ -50,6 +44,10 @@ void Skybox::Initialize(DirectXCommon* dxCommon, const std::string& textureFileP
 
 	// パイプライン作成
 	CreatePipelineState();
+	// シェーダーを書き換えたら作り直す
+	dxCommon_->AddShaderReloadListener(
+		{ L"Resources/shaders/Skybox.VS.hlsl", L"Resources/shaders/Skybox.PS.hlsl" },
+		[this]() { CreatePipelineState(); });
 
 	transform_.scale = { 10.0f, 10.0f, 10.0f };
 }
@@ -74,9 +72,9 @@ void Skybox::Update(Camera* camera)
 	Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
 	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, viewProjectionMatrix);
 
-	wvpData_->WVP = worldViewProjectionMatrix;
-	wvpData_->World = worldMatrix;
-	wvpData_->WorldInverseTranspose = MathUtils::Transpose(Inverse(worldMatrix));
+	wvpData_.WVP = worldViewProjectionMatrix;
+	wvpData_.World = worldMatrix;
+	wvpData_.WorldInverseTranspose = MathUtils::Transpose(Inverse(worldMatrix));
 }
 
 void Skybox::Draw()
@@ -90,7 +88,7 @@ void Skybox::Draw()
 	// 頂点バッファの設定
 	dxCommon_->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
 	// CBufferの設定
-	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(0, wvpResource_->GetGPUVirtualAddress());
+	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(0, dxCommon_->UploadConstant(wvpData_));
 	// マテリアルCBufferの設定座標変換
 	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(1, materialResource_->GetGPUVirtualAddress());
 	// テクスチャのSRVを設定
@@ -199,12 +197,10 @@ void Skybox::CreateVertexData()
 
 void Skybox::CreateWVPBData()
 {
-	wvpResource_ = dxCommon_->CreateBufferResource(sizeof(TransformationMatrix));
-	wvpResource_->Map(0, nullptr, reinterpret_cast<void**>(&wvpData_));
-
+	// GPUへは描画時にアップロード用リングから渡す
 	// 初期値は単位行列
-	wvpData_->WVP = MakeIdentity4x4();
-	wvpData_->World = MakeIdentity4x4();
+	wvpData_.WVP = MakeIdentity4x4();
+	wvpData_.World = MakeIdentity4x4();
 }
 
 void Skybox::CreateRootSignature()
@@ -268,23 +264,8 @@ void Skybox::CreateRootSignature()
 	descriptionRootSignature.pParameters = rootParameters;					//ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters);		//配列の長さ
 
-	//シリアライズしてバイナリする
-	HRESULT hr;
-	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
-	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-	hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
-	if (FAILED(hr))
-	{
-		Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
-		assert(false);
-	}
-	//バイナリをもとに生成
-	hr = dxCommon_->GetDevice()->CreateRootSignature(
-		0,
-		signatureBlob->GetBufferPointer(),
-		signatureBlob->GetBufferSize(),
-		IID_PPV_ARGS(&rootSignature_));
-	assert(SUCCEEDED(hr));
+	//生成（同じ記述のものがあれば共有する）
+	rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(descriptionRootSignature);
 }
 
 void Skybox::CreatePipelineState()
@@ -292,8 +273,6 @@ void Skybox::CreatePipelineState()
 	// ルートシグネチャの作成
 	CreateRootSignature();
 
-	HRESULT hr;
-
 	///===================================================================
 	///InputLayout(インプットレイアウト)
 	///===================================================================
@@ -395,7 +374,6 @@ void Skybox::CreatePipelineState()
 	//どのように画面に色を打ち込むかの設定（気にしなくていい）
 	graphicsPipelineStateDesc.SampleDesc.Count = 1;
 	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
-	//実際に生成
-	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&pipelineState_));
-	assert(SUCCEEDED(hr));
+	//実際に生成（同じ記述のものがあれば共有する）
+	pipelineState_ = dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(graphicsPipelineStateDesc);
 }
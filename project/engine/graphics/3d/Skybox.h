@@ -44,9 +44,8 @@ private:
 	// テクスチャ
 	ModelData modelData_;
 
-	// 座標変換
-	Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource_;
-	TransformationMatrix* wvpData_ = nullptr;
+	// 座標変換（描画時にアップロード用リングへ書き込む）
+	TransformationMatrix wvpData_{};
 	Transform transform_ = {
 		Vector3(1.0f, 1.0f, 1.0f),
 		Vector3(0.0f, 0.0f, 0.0f),
@@ -0,0 +1,352 @@
+#include "LightCluster.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define LIGHT_CLUSTER_USE_SSE
+#endif
+
+namespace
+{
+	// ビュー空間へ変換する（行ベクトル）
+	Vector3 TransformToView(const Vector3& position, const Matrix4x4& view)
+	{
+		return {
+			position.x * view.m[0][0] + position.y * view.m[1][0] + position.z * view.m[2][0] + view.m[3][0],
+			position.x * view.m[0][1] + position.y * view.m[1][1] + position.z * view.m[2][1] + view.m[3][1],
+			position.x * view.m[0][2] + position.y * view.m[1][2] + position.z * view.m[2][2] + view.m[3][2],
+		};
+	}
+
+	// 向きだけ変換する
+	Vector3 TransformDirectionToView(const Vector3& direction, const Matrix4x4& view)
+	{
+		return {
+			direction.x * view.m[0][0] + direction.y * view.m[1][0] + direction.z * view.m[2][0],
+			direction.x * view.m[0][1] + direction.y * view.m[1][1] + direction.z * view.m[2][1],
+			direction.x * view.m[0][2] + direction.y * view.m[1][2] + direction.z * view.m[2][2],
+		};
+	}
+
+	// 正規化デバイス座標からタイル番号（範囲外はクランプ）
+	int32_t NdcToTile(float ndc, uint32_t count)
+	{
+		int32_t tile = static_cast<int32_t>(std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(count)));
+		return std::clamp(tile, 0, static_cast<int32_t>(count) - 1);
+	}
+}
+
+void LightCluster::SetProjection(float fovY, float aspectRatio, float nearClip, float farClip, float screenWidth, float screenHeight)
+{
+	if (fovY == fovY_ && aspectRatio == aspectRatio_ && nearClip == nearClip_ && farClip == farClip_ &&
+		screenWidth == screenWidth_ && screenHeight == screenHeight_)
+	{
+		return;
+	}
+
+	assert(nearClip > 0.0f && farClip > nearClip && "ERROR: LightCluster::SetProjection() - Invalid clip range.");
+	fovY_ = fovY;
+	aspectRatio_ = aspectRatio;
+	nearClip_ = nearClip;
+	farClip_ = farClip;
+	screenWidth_ = screenWidth;
+	screenHeight_ = screenHeight;
+
+	tanHalfFovY_ = std::tan(fovY * 0.5f);
+	tanHalfFovX_ = tanHalfFovY_ * aspectRatio;
+
+	//奥ほどスライスを厚くする（指数分割）
+	float logDepthRange = std::log(farClip / nearClip);
+	depthScale_ = static_cast<float>(kCountZ) / logDepthRange;
+	depthBias_ = -static_cast<float>(kCountZ) * std::log(nearClip) / logDepthRange;
+
+	BuildClusterBounds();
+}
+
+void LightCluster::Begin(const Matrix4x4& viewMatrix)
+{
+	viewMatrix_ = viewMatrix;
+	lightX_.clear();
+	lightY_.clear();
+	lightZ_.clear();
+	lightRadius_.clear();
+	pointLightCount_ = 0;
+}
+
+void LightCluster::AddPointLight(const Vector3& position, float radius)
+{
+	//番号をポイントライト、スポットライトの順に振るので、スポットライトより先に追加する
+	assert(pointLightCount_ == lightX_.size() && "ERROR: LightCluster::AddPointLight() - Point lights must be added before spot lights.");
+
+	Vector3 center = TransformToView(position, viewMatrix_);
+	lightX_.push_back(center.x);
+	lightY_.push_back(center.y);
+	lightZ_.push_back(center.z);
+	lightRadius_.push_back(radius);
+	++pointLightCount_;
+}
+
+void LightCluster::AddSpotLight(const Vector3& position, const Vector3& direction, float distance, float cosAngle)
+{
+	//照らす範囲（扇形を回転させた形）を包む球
+	Vector3 apex = TransformToView(position, viewMatrix_);
+	Vector3 axis = TransformDirectionToView(direction, viewMatrix_);
+	float axisLength = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+	if (axisLength > 0.0f)
+	{
+		axis = { axis.x / axisLength, axis.y / axisLength, axis.z / axisLength };
+	}
+
+	float centerOffset = 0.0f;
+	float radius = distance;
+	if (cosAngle >= 0.70710678f)
+	{
+		//45度以下なら、頂点と底の円を通る球
+		radius = distance / (2.0f * cosAngle);
+		centerOffset = radius;
+	}
+	else if (cosAngle > 0.0f)
+	{
+		//90度以下なら、底の円を大円とする球
+		radius = distance * std::sqrt(1.0f - cosAngle * cosAngle);
+		centerOffset = distance * cosAngle;
+	}
+
+	lightX_.push_back(apex.x + axis.x * centerOffset);
+	lightY_.push_back(apex.y + axis.y * centerOffset);
+	lightZ_.push_back(apex.z + axis.z * centerOffset);
+	lightRadius_.push_back(radius);
+}
+
+void LightCluster::Build()
+{
+	assert(!boundsCenterX_.empty() && "ERROR: LightCluster::Build() - SetProjection() has not been called.");
+
+	const uint32_t lightCount = static_cast<uint32_t>(lightX_.size());
+	stats_ = {};
+	stats_.pointLightCount = pointLightCount_;
+	stats_.spotLightCount = lightCount - pointLightCount_;
+
+	/*--------------[ ライトごとに入るクラスタを求めて、クラスタごとの数を数える ]-----------------*/
+
+	hits_.clear();
+	hitOffsets_.resize(lightCount + 1);
+	writeCursor_.assign(kClusterCount * 2, 0);
+	for (uint32_t i = 0; i < lightCount; ++i)
+	{
+		const uint32_t first = static_cast<uint32_t>(hits_.size());
+		hitOffsets_[i] = first;
+		BinSphere(lightX_[i], lightY_[i], lightZ_[i], lightRadius_[i]);
+
+		const uint32_t type = i < pointLightCount_ ? 0 : 1;
+		for (size_t h = first; h < hits_.size(); ++h)
+		{
+			++writeCursor_[hits_[h] * 2 + type];
+		}
+		stats_.visibleLightCount += hits_.size() > first ? 1 : 0;
+	}
+	hitOffsets_[lightCount] = static_cast<uint32_t>(hits_.size());
+
+	/*--------------[ 数から書き込み位置を決める ]-----------------*/
+
+	ranges_.resize(kClusterCount);
+	uint32_t offset = 0;
+	for (uint32_t c = 0; c < kClusterCount; ++c)
+	{
+		const uint32_t pointCount = writeCursor_[c * 2];
+		const uint32_t spotCount = writeCursor_[c * 2 + 1];
+		assert(pointCount <= 0xFFFF && spotCount <= 0xFFFF);
+
+		ranges_[c].offset = offset;
+		ranges_[c].counts = pointCount | (spotCount << 16);
+		writeCursor_[c * 2] = offset;
+		writeCursor_[c * 2 + 1] = offset + pointCount;
+		offset += pointCount + spotCount;
+
+		stats_.occupiedClusterCount += (pointCount + spotCount) > 0 ? 1 : 0;
+		stats_.maxLightsPerCluster = (std::max)(stats_.maxLightsPerCluster, pointCount + spotCount);
+	}
+	stats_.indexCount = offset;
+
+	/*--------------[ ライトの番号を書き込む（番号の小さい順に並ぶ） ]-----------------*/
+
+	lightIndices_.resize(offset);
+	for (uint32_t i = 0; i < lightCount; ++i)
+	{
+		const uint32_t type = i < pointLightCount_ ? 0 : 1;
+		const uint32_t lightIndex = type == 0 ? i : i - pointLightCount_;
+		for (uint32_t h = hitOffsets_[i]; h < hitOffsets_[i + 1]; ++h)
+		{
+			lightIndices_[writeCursor_[hits_[h] * 2 + type]++] = lightIndex;
+		}
+	}
+}
+
+LightCluster::GPUParams LightCluster::GetGPUParams() const
+{
+	GPUParams params{};
+	//行ベクトルなので、ビュー空間のzは行列の3列目との内積
+	params.viewDepthAxis = { viewMatrix_.m[0][2], viewMatrix_.m[1][2], viewMatrix_.m[2][2], viewMatrix_.m[3][2] };
+	params.tileScaleX = static_cast<float>(kCountX) / screenWidth_;
+	params.tileScaleY = static_cast<float>(kCountY) / screenHeight_;
+	params.depthScale = depthScale_;
+	params.depthBias = depthBias_;
+	params.countX = kCountX;
+	params.countY = kCountY;
+	params.countZ = kCountZ;
+	params.isEnabled = 1;
+	return params;
+}
+
+uint32_t LightCluster::FindCluster(float pixelX, float pixelY, float viewDepth) const
+{
+	if (viewDepth <= 0.0f)
+	{
+		return kClusterCount;
+	}
+	uint32_t x = (std::min)(static_cast<uint32_t>((std::max)(pixelX, 0.0f) * kCountX / screenWidth_), kCountX - 1);
+	uint32_t y = (std::min)(static_cast<uint32_t>((std::max)(pixelY, 0.0f) * kCountY / screenHeight_), kCountY - 1);
+	uint32_t z = static_cast<uint32_t>(DepthToSlice(viewDepth));
+	return (z * kCountY + y) * kCountX + x;
+}
+
+void LightCluster::BinSphere(float centerX, float centerY, float centerZ, float radius)
+{
+	/*--------------[ 奥行きの範囲 ]-----------------*/
+
+	if (centerZ + radius < nearClip_ || centerZ - radius > farClip_)
+	{
+		return;
+	}
+	const float minDepth = (std::max)(centerZ - radius, nearClip_);
+	const float maxDepth = (std::min)(centerZ + radius, farClip_);
+	const int32_t z0 = DepthToSlice(minDepth);
+	const int32_t z1 = DepthToSlice(maxDepth);
+
+	/*--------------[ 画面上の範囲（奥行きの範囲で一番広がる所を取る） ]-----------------*/
+
+	const float left = centerX - radius;
+	const float right = centerX + radius;
+	const float bottom = centerY - radius;
+	const float top = centerY + radius;
+	const float ndcLeft = left / ((left < 0.0f ? minDepth : centerZ + radius) * tanHalfFovX_);
+	const float ndcRight = right / ((right > 0.0f ? minDepth : centerZ + radius) * tanHalfFovX_);
+	const float ndcBottom = bottom / ((bottom < 0.0f ? minDepth : centerZ + radius) * tanHalfFovY_);
+	const float ndcTop = top / ((top > 0.0f ? minDepth : centerZ + radius) * tanHalfFovY_);
+	if (ndcRight < -1.0f || ndcLeft > 1.0f || ndcTop < -1.0f || ndcBottom > 1.0f)
+	{
+		return;
+	}
+	const int32_t x0 = NdcToTile(ndcLeft, kCountX);
+	const int32_t x1 = NdcToTile(ndcRight, kCountX);
+	//ピクセルのyは下向きなので、上の端が小さい番号になる
+	const int32_t y0 = NdcToTile(-ndcTop, kCountY);
+	const int32_t y1 = NdcToTile(-ndcBottom, kCountY);
+
+	/*--------------[ 範囲内のクラスタのAABBと球の判定 ]-----------------*/
+
+	const float radiusSq = radius * radius;
+	for (int32_t z = z0; z <= z1; ++z)
+	{
+		for (int32_t y = y0; y <= y1; ++y)
+		{
+			const uint32_t rowStart = (static_cast<uint32_t>(z) * kCountY + static_cast<uint32_t>(y)) * kCountX;
+			uint32_t x = static_cast<uint32_t>(x0);
+			const uint32_t xEnd = static_cast<uint32_t>(x1) + 1;
+
+#ifdef LIGHT_CLUSTER_USE_SSE
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 sx = _mm_set1_ps(centerX);
+			const __m128 sy = _mm_set1_ps(centerY);
+			const __m128 sz = _mm_set1_ps(centerZ);
+			const __m128 r2 = _mm_set1_ps(radiusSq);
+			for (; x + 4 <= xEnd; x += 4)
+			{
+				const uint32_t c = rowStart + x;
+				//各軸でAABBの外にはみ出た距離
+				__m128 dx = _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sx, _mm_loadu_ps(&boundsCenterX_[c]))), _mm_loadu_ps(&boundsExtentX_[c]));
+				__m128 dy = _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sy, _mm_loadu_ps(&boundsCenterY_[c]))), _mm_loadu_ps(&boundsExtentY_[c]));
+				__m128 dz = _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sz, _mm_loadu_ps(&boundsCenterZ_[c]))), _mm_loadu_ps(&boundsExtentZ_[c]));
+				dx = _mm_max_ps(dx, zero);
+				dy = _mm_max_ps(dy, zero);
+				dz = _mm_max_ps(dz, zero);
+				const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				const int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSq, r2));
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					if (mask & (1 << lane))
+					{
+						hits_.push_back(c + lane);
+					}
+				}
+			}
+#endif
+
+			// 4個に満たない残り（SSEが使えない環境では全て）
+			for (; x < xEnd; ++x)
+			{
+				const uint32_t c = rowStart + x;
+				const float dx = (std::max)(std::fabs(centerX - boundsCenterX_[c]) - boundsExtentX_[c], 0.0f);
+				const float dy = (std::max)(std::fabs(centerY - boundsCenterY_[c]) - boundsExtentY_[c], 0.0f);
+				const float dz = (std::max)(std::fabs(centerZ - boundsCenterZ_[c]) - boundsExtentZ_[c], 0.0f);
+				if (dx * dx + dy * dy + dz * dz <= radiusSq)
+				{
+					hits_.push_back(c);
+				}
+			}
+		}
+	}
+}
+
+int32_t LightCluster::DepthToSlice(float viewDepth) const
+{
+	int32_t slice = static_cast<int32_t>(std::floor(std::log(viewDepth) * depthScale_ + depthBias_));
+	return std::clamp(slice, 0, static_cast<int32_t>(kCountZ) - 1);
+}
+
+void LightCluster::BuildClusterBounds()
+{
+	boundsCenterX_.resize(kClusterCount);
+	boundsCenterY_.resize(kClusterCount);
+	boundsCenterZ_.resize(kClusterCount);
+	boundsExtentX_.resize(kClusterCount);
+	boundsExtentY_.resize(kClusterCount);
+	boundsExtentZ_.resize(kClusterCount);
+
+	const float depthRatio = farClip_ / nearClip_;
+	for (uint32_t z = 0; z < kCountZ; ++z)
+	{
+		//スライスの手前と奥（境界の誤差で取りこぼさないよう少し広げる）
+		const float sliceNear = nearClip_ * std::pow(depthRatio, static_cast<float>(z) / kCountZ) * 0.999f;
+		const float sliceFar = nearClip_ * std::pow(depthRatio, static_cast<float>(z + 1) / kCountZ) * 1.001f;
+
+		for (uint32_t y = 0; y < kCountY; ++y)
+		{
+			//ピクセルのyは下向きなので、ビュー空間では上から順に並ぶ
+			const float ndcTop = 1.0f - 2.0f * static_cast<float>(y) / kCountY;
+			const float ndcBottom = 1.0f - 2.0f * static_cast<float>(y + 1) / kCountY;
+			const float minY = (std::min)(ndcBottom * sliceNear, ndcBottom * sliceFar) * tanHalfFovY_;
+			const float maxY = (std::max)(ndcTop * sliceNear, ndcTop * sliceFar) * tanHalfFovY_;
+
+			for (uint32_t x = 0; x < kCountX; ++x)
+			{
+				const float ndcLeft = -1.0f + 2.0f * static_cast<float>(x) / kCountX;
+				const float ndcRight = -1.0f + 2.0f * static_cast<float>(x + 1) / kCountX;
+				const float minX = (std::min)(ndcLeft * sliceNear, ndcLeft * sliceFar) * tanHalfFovX_;
+				const float maxX = (std::max)(ndcRight * sliceNear, ndcRight * sliceFar) * tanHalfFovX_;
+
+				const uint32_t c = (z * kCountY + y) * kCountX + x;
+				boundsCenterX_[c] = (minX + maxX) * 0.5f;
+				boundsCenterY_[c] = (minY + maxY) * 0.5f;
+				boundsCenterZ_[c] = (sliceNear + sliceFar) * 0.5f;
+				boundsExtentX_[c] = (maxX - minX) * 0.5f;
+				boundsExtentY_[c] = (maxY - minY) * 0.5f;
+				boundsExtentZ_[c] = (sliceFar - sliceNear) * 0.5f;
+			}
+		}
+	}
+}
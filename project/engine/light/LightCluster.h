@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "math/MatrixFunc.h"
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+/**
+ * \brief 視錐台を画面のタイルと奥行きのスライスで区切ったクラスタ（フロクセル）に、ポイントライトとスポットライトを振り分ける
+ * \note ピクセルシェーダーは自分のクラスタに入っているライトだけを計算する。
+ *       ライトはビュー空間の包む球で判定し、クラスタのAABBはX方向に並べてまとめて判定する（SSEが使える環境では4個ずつ）
+ */
+class LightCluster
+{
+public:
+	// クラスタの分割数
+	static constexpr uint32_t kCountX = 16;
+	static constexpr uint32_t kCountY = 9;
+	static constexpr uint32_t kCountZ = 24;
+	static constexpr uint32_t kClusterCount = kCountX * kCountY * kCountZ;
+
+	/**
+	 * \brief クラスタごとのライトの範囲（GPUにそのまま送る）
+	 * \note lightIndices[offset]からポイントライトがpointCount個、続けてスポットライトがspotCount個並ぶ
+	 */
+	struct ClusterRange
+	{
+		uint32_t offset;
+		uint32_t counts;	//下位16bitがポイントライトの数、上位16bitがスポットライトの数
+	};
+
+	/// \brief シェーダーでクラスタの番号を求めるための定数（GPUにそのまま送る）
+	struct GPUParams
+	{
+		Vector4 viewDepthAxis;		//ワールド座標との内積+wでビュー空間の奥行きになる
+		float tileScaleX;			//ピクセル座標からタイル番号への倍率
+		float tileScaleY;
+		float depthScale;			//スライス番号 = log(奥行き) * depthScale + depthBias
+		float depthBias;
+		uint32_t countX;
+		uint32_t countY;
+		uint32_t countZ;
+		uint32_t isEnabled;			//0なら全てのライトを計算する
+	};
+
+	/// \brief 直近の振り分けの統計
+	struct Stats
+	{
+		uint32_t pointLightCount = 0;
+		uint32_t spotLightCount = 0;
+		uint32_t visibleLightCount = 0;		//どこかのクラスタに入ったライトの数
+		uint32_t indexCount = 0;			//全クラスタのライトの数の合計
+		uint32_t occupiedClusterCount = 0;	//ライトが1つ以上入ったクラスタの数
+		uint32_t maxLightsPerCluster = 0;
+	};
+
+public:
+	/**
+	 * \brief 投影の設定。変わった時だけクラスタのAABBを作り直す
+	 * \param screenWidth 描画先の幅（ピクセル）
+	 */
+	void SetProjection(float fovY, float aspectRatio, float nearClip, float farClip, float screenWidth, float screenHeight);
+
+	/// \brief 振り分けを始める（前回のライトは消える）
+	void Begin(const Matrix4x4& viewMatrix);
+
+	/// \brief ポイントライトを追加する。追加した順番がライトの番号になる
+	void AddPointLight(const Vector3& position, float radius);
+
+	/**
+	 * \brief スポットライトを追加する。追加した順番がライトの番号になる
+	 * \param cosAngle 照らす範囲の外側の余弦
+	 */
+	void AddSpotLight(const Vector3& position, const Vector3& direction, float distance, float cosAngle);
+
+	/// \brief 追加したライトをクラスタに振り分ける
+	void Build();
+
+	/// \brief シェーダーに送る定数
+	GPUParams GetGPUParams() const;
+
+public: //アクセッサ
+	const std::vector<ClusterRange>& GetRanges() const { return ranges_; }
+	const std::vector<uint32_t>& GetLightIndices() const { return lightIndices_; }
+	const Stats& GetStats() const { return stats_; }
+
+	/// \brief ビュー空間の座標からクラスタの番号を求める（シェーダーと同じ計算。範囲外ならkClusterCount）
+	uint32_t FindCluster(float pixelX, float pixelY, float viewDepth) const;
+
+private:
+	/// \brief ビュー空間の球を振り分けて、入ったクラスタの番号をhits_に積む
+	void BinSphere(float centerX, float centerY, float centerZ, float radius);
+
+	/// \brief 奥行きからスライス番号（範囲外はクランプ）
+	int32_t DepthToSlice(float viewDepth) const;
+
+	/// \brief クラスタのAABBを作る
+	void BuildClusterBounds();
+
+private:
+	/*-----------------------[ 投影 ]------------------------*/
+
+	float fovY_ = 0.0f;
+	float aspectRatio_ = 0.0f;
+	float nearClip_ = 0.0f;
+	float farClip_ = 0.0f;
+	float screenWidth_ = 0.0f;
+	float screenHeight_ = 0.0f;
+	float tanHalfFovX_ = 1.0f;
+	float tanHalfFovY_ = 1.0f;
+	float depthScale_ = 0.0f;
+	float depthBias_ = 0.0f;
+	Matrix4x4 viewMatrix_{};
+
+	//クラスタのAABB（ビュー空間、中心と半径。X方向に連続して並ぶ）
+	std::vector<float> boundsCenterX_;
+	std::vector<float> boundsCenterY_;
+	std::vector<float> boundsCenterZ_;
+	std::vector<float> boundsExtentX_;
+	std::vector<float> boundsExtentY_;
+	std::vector<float> boundsExtentZ_;
+
+	/*-----------------------[ ライト ]------------------------*/
+
+	//ビュー空間の包む球（ポイントライト、スポットライトの順に並ぶ）
+	std::vector<float> lightX_;
+	std::vector<float> lightY_;
+	std::vector<float> lightZ_;
+	std::vector<float> lightRadius_;
+	uint32_t pointLightCount_ = 0;
+
+	/*-----------------------[ 結果 ]------------------------*/
+
+	//ライトごとの入ったクラスタ（hitOffsets_[i]～hitOffsets_[i + 1]がライトiの分）
+	std::vector<uint32_t> hits_;
+	std::vector<uint32_t> hitOffsets_;
+	//クラスタごとの書き込み位置（ポイントライト、スポットライトの順）
+	std::vector<uint32_t> writeCursor_;
+
+	std::vector<ClusterRange> ranges_;
+	std::vector<uint32_t> lightIndices_;
+	Stats stats_;
+};
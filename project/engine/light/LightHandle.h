@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * \brief LightManagerのライトを指すハンドル
+ * \note ライトを削除すると世代が進むので、削除済みのライトを指すハンドルは無効になる。
+ *       ライトの並びが詰め直されても、ハンドルはそのまま使える
+ */
+struct LightHandle
+{
+	static constexpr uint32_t kInvalidSlot = 0xFFFFFFFF;
+
+	uint32_t slot = kInvalidSlot;	//スロットの番号
+	uint32_t generation = 0;		//スロットを割り当てた時の世代
+
+	bool IsValid() const { return slot != kInvalidSlot; }
+	bool operator==(const LightHandle& other) const = default;
+};
+
+//ポイントライトとスポットライトのハンドルを取り違えないよう型を分ける
+struct PointLightHandle : LightHandle {};
+struct SpotLightHandle : LightHandle {};
@@ -0,0 +1,101 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "LightHandle.h"
+
+/**
+ * \brief ハンドルのスロットと、詰めて並べたライトの番号を対応させる表
+ * \note ライトのデータ本体は呼び出し側が番号の順に詰めて持つ。
+ *       削除では末尾の要素を空いた場所に移すので、呼び出し側も同じように詰める
+ */
+class LightSlotTable
+{
+public:
+	static constexpr uint32_t kInvalidIndex = 0xFFFFFFFF;
+
+	/// \brief 末尾にライトを追加してハンドルを返す
+	LightHandle Insert()
+	{
+		uint32_t slot;
+		if (freeSlots_.empty())
+		{
+			slot = static_cast<uint32_t>(slotToIndex_.size());
+			slotToIndex_.push_back(kInvalidIndex);
+			generations_.push_back(0);
+		}
+		else
+		{
+			slot = freeSlots_.back();
+			freeSlots_.pop_back();
+		}
+
+		slotToIndex_[slot] = static_cast<uint32_t>(indexToSlot_.size());
+		indexToSlot_.push_back(slot);
+		return LightHandle{ slot, generations_[slot] };
+	}
+
+	/**
+	 * \brief ライトを削除する
+	 * \return 空いた番号。呼び出し側は末尾の要素をこの番号に移して末尾を消す（無効なハンドルならkInvalidIndex）
+	 */
+	uint32_t Remove(const LightHandle& handle)
+	{
+		uint32_t index = GetIndex(handle);
+		if (index == kInvalidIndex)
+		{
+			return kInvalidIndex;
+		}
+
+		//末尾のライトを空いた番号に移す
+		uint32_t lastSlot = indexToSlot_.back();
+		indexToSlot_[index] = lastSlot;
+		slotToIndex_[lastSlot] = index;
+		indexToSlot_.pop_back();
+
+		//スロットは世代を進めてから使い回す
+		slotToIndex_[handle.slot] = kInvalidIndex;
+		++generations_[handle.slot];
+		freeSlots_.push_back(handle.slot);
+		return index;
+	}
+
+	/// \brief ハンドルの指すライトの番号（削除済みならkInvalidIndex）
+	uint32_t GetIndex(const LightHandle& handle) const
+	{
+		if (handle.slot >= slotToIndex_.size() || generations_[handle.slot] != handle.generation)
+		{
+			return kInvalidIndex;
+		}
+		return slotToIndex_[handle.slot];
+	}
+
+	/// \brief 番号のライトのハンドル
+	LightHandle GetHandle(uint32_t index) const
+	{
+		assert(index < indexToSlot_.size());
+		uint32_t slot = indexToSlot_[index];
+		return LightHandle{ slot, generations_[slot] };
+	}
+
+	/// \brief 全て削除する（発行済みのハンドルは全て無効になる）
+	void Clear()
+	{
+		for (uint32_t slot : indexToSlot_)
+		{
+			slotToIndex_[slot] = kInvalidIndex;
+			++generations_[slot];
+			freeSlots_.push_back(slot);
+		}
+		indexToSlot_.clear();
+	}
+
+	uint32_t GetCount() const { return static_cast<uint32_t>(indexToSlot_.size()); }
+
+private:
+	std::vector<uint32_t> slotToIndex_;
+	std::vector<uint32_t> generations_;
+	std::vector<uint32_t> indexToSlot_;
+	std::vector<uint32_t> freeSlots_;
+};
@@ -0,0 +1,498 @@
+#include "ShadowAtlas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include "DirectXTex/d3dx12.h"
+// system
+#include "base/Camera.h"
+#include "manager/system/SrvManager.h"
+// math
+#include "math/Frustum.h"
+// editor
+#include "externals/imgui/imgui.h"
+
+namespace
+{
+	constexpr uint64_t kHashOffset = 14695981039346656037ull;
+	constexpr uint64_t kHashPrime = 1099511628211ull;
+
+	// FNV-1aでバイト列をハッシュに混ぜる
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * kHashPrime;
+		}
+		return hash;
+	}
+
+	// 影の形に関わるパラメータ（色や強さは含めない）
+	uint64_t HashLight(const GPUSpotLight& light)
+	{
+		uint64_t hash = kHashOffset;
+		hash = HashBytes(hash, &light.position, sizeof(light.position));
+		hash = HashBytes(hash, &light.direction, sizeof(light.direction));
+		hash = HashBytes(hash, &light.distance, sizeof(light.distance));
+		hash = HashBytes(hash, &light.cosAngle, sizeof(light.cosAngle));
+		return hash;
+	}
+
+	// 照らす範囲（円錐）を包む球（LightCluster::AddSpotLightと同じ求め方）
+	void ComputeBoundingSphere(const GPUSpotLight& light, Vector3& center, float& radius)
+	{
+		const Vector3 axis = Vector3::Normalize(light.direction);
+		float centerOffset = 0.0f;
+		radius = light.distance;
+		if (light.cosAngle >= 0.70710678f)
+		{
+			radius = light.distance / (2.0f * light.cosAngle);
+			centerOffset = radius;
+		}
+		else if (light.cosAngle > 0.0f)
+		{
+			radius = light.distance * std::sqrt(1.0f - light.cosAngle * light.cosAngle);
+			centerOffset = light.distance * light.cosAngle;
+		}
+		center = light.position + axis * centerOffset;
+	}
+
+	// ライトの位置から向きの方へ見るビュープロジェクション行列
+	Matrix4x4 MakeLightViewProjection(const GPUSpotLight& light)
+	{
+		const Vector3 forward = Vector3::Normalize(light.direction);
+		//真上・真下を向いている時は上方向をZ軸にする
+		const Vector3 worldUp = std::abs(forward.y) > 0.99f ? Vector3{ 0.0f, 0.0f, 1.0f } : Vector3{ 0.0f, 1.0f, 0.0f };
+		const Vector3 right = Vector3::Normalize(Vector3::Cross(worldUp, forward));
+		const Vector3 up = Vector3::Cross(forward, right);
+
+		const Matrix4x4 view{
+			right.x, up.x, forward.x, 0.0f,
+			right.y, up.y, forward.y, 0.0f,
+			right.z, up.z, forward.z, 0.0f,
+			-Vector3::Dot(right, light.position), -Vector3::Dot(up, light.position), -Vector3::Dot(forward, light.position), 1.0f
+		};
+
+		//円錐の開き（90度を超える分は1枚の透視投影に収まらないので抑える）
+		const float halfAngle = std::acos(std::clamp(light.cosAngle, -1.0f, 1.0f));
+		const float fovY = std::clamp(halfAngle * 2.0f, 0.02f, 2.9f);
+		const float farClip = (std::max)(light.distance, 0.1f);
+		const float nearClip = (std::max)(farClip * 0.01f, 0.05f);
+		return Multiply(view, MakePerspectiveFovMatrix(fovY, 1.0f, nearClip, farClip));
+	}
+}
+
+void ShadowAtlas::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
+{
+	dxCommon_ = dxCommon;
+	srvManager_ = srvManager;
+	allocator_.Initialize(kAtlasSize, kMinTileSize);
+
+	/*--------------[ 深度テクスチャ（深度として書き、floatとして読む） ]-----------------*/
+
+	D3D12_RESOURCE_DESC textureDesc{};
+	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	textureDesc.Width = kAtlasSize;
+	textureDesc.Height = kAtlasSize;
+	textureDesc.DepthOrArraySize = 1;
+	textureDesc.MipLevels = 1;
+	textureDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+	D3D12_CLEAR_VALUE clearValue{};
+	clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+	clearValue.DepthStencil.Depth = 1.0f;
+
+	CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr = dxCommon_->GetDevice()->CreateCommittedResource(
+		&heapProperties,
+		D3D12_HEAP_FLAG_NONE,
+		&textureDesc,
+		currentState_,
+		&clearValue,
+		IID_PPV_ARGS(&resource_)
+	);
+	assert(SUCCEEDED(hr) && "ERROR: ShadowAtlas::Initialize() - failed to create the atlas texture.");
+
+	/*--------------[ DSV ]-----------------*/
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+	heapDesc.NumDescriptors = 1;
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	hr = dxCommon_->GetDevice()->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&dsvHeap_));
+	assert(SUCCEEDED(hr) && "ERROR: ShadowAtlas::Initialize() - failed to create the DSV heap.");
+
+	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
+	dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+	dsvHandle_ = dsvHeap_->GetCPUDescriptorHandleForHeapStart();
+	dxCommon_->GetDevice()->CreateDepthStencilView(resource_.Get(), &dsvDesc, dsvHandle_);
+
+	/*--------------[ SRV ]-----------------*/
+
+	srvIndex_ = srvManager_->Allocate();
+	srvManager_->CreateSRVforTexture2D(srvIndex_, resource_.Get(), DXGI_FORMAT_R32_FLOAT, 1);
+}
+
+void ShadowAtlas::AssignTiles(const Camera* camera, const GPUSpotLight* lights, CPUSpotLight* states, uint32_t count)
+{
+	stats_ = {};
+	frameLights_.resize(count);
+	lightOrder_.clear();
+	requests_.clear();
+
+	//影の情報の書き込み先（描き直すタイルが決まった後でもう一度書く）
+	shadowData_ = dxCommon_->AllocateUpload(sizeof(GPUShadow) * (std::max)(count, 1u));
+	shadowDataAddress_ = shadowData_.gpuAddress;
+
+	if (!isEnabled_)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ReleaseTile(states[i]);
+		}
+		WriteShadowData(states, count);
+		return;
+	}
+
+	Frustum frustum;
+	Vector3 cameraPosition{};
+	float tanHalfFovY = 1.0f;
+	if (camera)
+	{
+		frustum = Frustum::FromViewProjection(camera->GetViewProjectionMatrix());
+		const Matrix4x4& cameraWorld = camera->GetWorldMatrix();
+		cameraPosition = { cameraWorld.m[3][0], cameraWorld.m[3][1], cameraWorld.m[3][2] };
+		tanHalfFovY = std::tan(camera->GetFovY() * 0.5f);
+	}
+
+	/*--------------[ 画面上での大きさを求め、合わなくなったタイルを返す ]-----------------*/
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const GPUSpotLight& light = lights[i];
+		CPUSpotLight& state = states[i];
+		FrameLight& frame = frameLights_[i];
+
+		ComputeBoundingSphere(light, frame.boundsCenter, frame.boundsRadius);
+		frame.viewProjection = MakeLightViewProjection(light);
+		frame.lightKey = HashLight(light);
+
+		//照らす範囲の直径が画面の高さに占める割合（画面の外なら0）
+		float importance = 1.0f;
+		if (camera)
+		{
+			const Vector3 extent{ frame.boundsRadius, frame.boundsRadius, frame.boundsRadius };
+			if (!frustum.IsVisible(AABB(frame.boundsCenter - extent, frame.boundsCenter + extent)))
+			{
+				importance = 0.0f;
+			}
+			else
+			{
+				const float distance = Vector3::Distance(frame.boundsCenter, cameraPosition);
+				if (distance > frame.boundsRadius)
+				{
+					importance = (std::min)(frame.boundsRadius / (distance * tanHalfFovY), 1.0f);
+				}
+			}
+		}
+		state.shadowImportance = importance;
+
+		if (importance <= 0.0f)
+		{
+			ReleaseTile(state);
+			continue;
+		}
+		lightOrder_.push_back(i);
+	}
+
+	//全てのライトが欲しい大きさで収まらなければ、収まるまで全体を半分ずつ小さくする
+	float sizeScale = 1.0f;
+	const uint64_t atlasArea = static_cast<uint64_t>(kAtlasSize) * kAtlasSize;
+	for (uint32_t shift = 0; kMaxTileSize >> shift > kMinTileSize; ++shift)
+	{
+		uint64_t totalArea = 0;
+		for (uint32_t index : lightOrder_)
+		{
+			const uint64_t size = ChooseTileSize(states[index].shadowImportance * sizeScale, 0);
+			totalArea += size * size;
+		}
+		if (totalArea <= atlasArea)
+		{
+			break;
+		}
+		sizeScale *= 0.5f;
+	}
+	for (uint32_t index : lightOrder_)
+	{
+		CPUSpotLight& state = states[index];
+		state.shadowImportance *= sizeScale;
+		if (state.shadowTile.IsValid() && state.shadowTile.size != ChooseTileSize(state.shadowImportance, state.shadowTile.size))
+		{
+			ReleaseTile(state);
+		}
+	}
+
+	std::sort(lightOrder_.begin(), lightOrder_.end(), [states](uint32_t a, uint32_t b) {
+		if (states[a].shadowImportance != states[b].shadowImportance)
+		{
+			return states[a].shadowImportance > states[b].shadowImportance;
+		}
+		return a < b;
+	});
+
+	/*--------------[ 重要度の高い順に、タイルのないライトへ割り当てる ]-----------------*/
+
+	for (uint32_t index : lightOrder_)
+	{
+		if (states[index].shadowTile.IsValid())
+		{
+			continue;
+		}
+		if (!AllocateTile(index, ChooseTileSize(states[index].shadowImportance, 0), states))
+		{
+			++stats_.droppedLightCount;
+		}
+	}
+
+	//描き直すタイルが決まるまでは、前に描いた影をそのまま使う
+	WriteShadowData(states, count);
+}
+
+const std::vector<ShadowAtlas::RenderRequest>& ShadowAtlas::CollectRenderRequests(const std::vector<ShadowCaster>& casters, CPUSpotLight* states, uint32_t count)
+{
+	requests_.clear();
+	if (!isEnabled_ || count == 0)
+	{
+		return requests_;
+	}
+	assert(frameLights_.size() == count && "ERROR: ShadowAtlas::CollectRenderRequests() - call AssignTiles() with the same lights first.");
+
+	//置いたまま動かないオブジェクトは、全体の並びが変わった時だけ全てのタイルを描き直す
+	uint64_t staticKey = kHashOffset;
+	for (const ShadowCaster& caster : casters)
+	{
+		if (caster.isStatic)
+		{
+			staticKey = HashBytes(staticKey, &caster.model, sizeof(caster.model));
+			staticKey = HashBytes(staticKey, &caster.bounds, sizeof(caster.bounds));
+		}
+	}
+	staticCasterKey_ = staticKey;
+
+	for (uint32_t index : lightOrder_)
+	{
+		CPUSpotLight& state = states[index];
+		if (!state.shadowTile.IsValid())
+		{
+			continue;
+		}
+		++stats_.shadowedLightCount;
+
+		//照らす範囲にある動くオブジェクトの行列を混ぜる
+		const FrameLight& frame = frameLights_[index];
+		uint64_t casterKey = staticCasterKey_;
+		for (const ShadowCaster& caster : casters)
+		{
+			if (!caster.isStatic && IntersectsSphere(caster.bounds, frame.boundsCenter, frame.boundsRadius))
+			{
+				casterKey = HashBytes(casterKey, &caster.model, sizeof(caster.model));
+				casterKey = HashBytes(casterKey, &caster.world, sizeof(caster.world));
+			}
+		}
+
+		//ライトも範囲内のオブジェクトも動いていなければ、前に描いた影を使う
+		if (state.hasShadow && state.shadowLightKey == frame.lightKey && state.shadowCasterKey == casterKey)
+		{
+			++stats_.reusedTileCount;
+			continue;
+		}
+		//1フレームに描き直す数を超えた分は、重要度の低いものから次のフレームに回す
+		if (requests_.size() >= maxTileUpdates_)
+		{
+			++stats_.deferredTileCount;
+			continue;
+		}
+
+		RenderRequest request;
+		request.lightIndex = index;
+		request.tile = state.shadowTile;
+		request.viewProjection = frame.viewProjection;
+		request.boundsCenter = frame.boundsCenter;
+		request.boundsRadius = frame.boundsRadius;
+		requests_.push_back(request);
+
+		state.shadowViewProjection = frame.viewProjection;
+		state.shadowLightKey = frame.lightKey;
+		state.shadowCasterKey = casterKey;
+		state.hasShadow = true;
+		++stats_.renderedTileCount;
+	}
+
+	WriteShadowData(states, count);
+	return requests_;
+}
+
+void ShadowAtlas::ReleaseTile(CPUSpotLight& state)
+{
+	allocator_.Free(state.shadowTile);
+	state.shadowTile = {};
+	state.hasShadow = false;
+}
+
+void ShadowAtlas::BeginRender(ID3D12GraphicsCommandList* commandList)
+{
+	if (currentState_ != D3D12_RESOURCE_STATE_DEPTH_WRITE)
+	{
+		auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource_.Get(), currentState_, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		commandList->ResourceBarrier(1, &barrier);
+		currentState_ = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+	}
+	//色は書かないので深度だけを設定する
+	commandList->OMSetRenderTargets(0, nullptr, FALSE, &dsvHandle_);
+}
+
+void ShadowAtlas::BeginTile(ID3D12GraphicsCommandList* commandList, const ShadowTileAllocator::Tile& tile)
+{
+	D3D12_VIEWPORT viewport{};
+	viewport.TopLeftX = static_cast<float>(tile.x);
+	viewport.TopLeftY = static_cast<float>(tile.y);
+	viewport.Width = static_cast<float>(tile.size);
+	viewport.Height = static_cast<float>(tile.size);
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+
+	D3D12_RECT scissorRect{};
+	scissorRect.left = tile.x;
+	scissorRect.top = tile.y;
+	scissorRect.right = tile.x + tile.size;
+	scissorRect.bottom = tile.y + tile.size;
+
+	commandList->RSSetViewports(1, &viewport);
+	commandList->RSSetScissorRects(1, &scissorRect);
+	//タイルの範囲だけをクリアする
+	commandList->ClearDepthStencilView(dsvHandle_, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1, &scissorRect);
+}
+
+void ShadowAtlas::EndRender(ID3D12GraphicsCommandList* commandList)
+{
+	if (currentState_ != D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+	{
+		auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource_.Get(), currentState_, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		commandList->ResourceBarrier(1, &barrier);
+		currentState_ = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	}
+}
+
+bool ShadowAtlas::IntersectsSphere(const AABB& box, const Vector3& center, float radius)
+{
+	//球の中心に一番近い箱の上の点までの距離で判定する
+	const Vector3 closest = Vector3::Min(Vector3::Max(center, box.min_), box.max_);
+	return Vector3::DistanceSquared(closest, center) <= radius * radius;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE ShadowAtlas::GetSrvHandleGPU() const
+{
+	return srvManager_->GetGPUDescriptorHandle(srvIndex_);
+}
+
+void ShadowAtlas::ImGuiUpdate()
+{
+#ifdef _DEBUG
+	ImGui::Checkbox("Enable Shadows", &isEnabled_);
+	int maxTileUpdates = static_cast<int>(maxTileUpdates_);
+	if (ImGui::SliderInt("Max Tile Updates", &maxTileUpdates, 1, 32))
+	{
+		maxTileUpdates_ = static_cast<uint32_t>(maxTileUpdates);
+	}
+	ImGui::DragFloat("Depth Bias", &depthBias_, 0.0001f, 0.0f, 0.01f, "%.4f");
+
+	const float atlasArea = static_cast<float>(kAtlasSize) * static_cast<float>(kAtlasSize);
+	ImGui::Text("Atlas : %u x %u (%.1f%% used)", kAtlasSize, kAtlasSize, static_cast<float>(stats_.usedArea) / atlasArea * 100.0f);
+	ImGui::Text("Shadowed Lights : %u (dropped %u)", stats_.shadowedLightCount, stats_.droppedLightCount);
+	ImGui::Text("Tiles Rendered : %u / Reused : %u / Deferred : %u", stats_.renderedTileCount, stats_.reusedTileCount, stats_.deferredTileCount);
+	ImGui::Text("Caster Draws : %u", stats_.casterDrawCount);
+#endif
+}
+
+uint32_t ShadowAtlas::ChooseTileSize(float importance, uint32_t currentSize) const
+{
+	//照らす範囲が画面の高さいっぱいに映るなら最大の大きさ
+	const float desired = importance * static_cast<float>(kMaxTileSize);
+
+	//今のタイルで大きく外れていなければ変えない（境目で大きさが行き来して描き直し続けるのを防ぐ）
+	if (currentSize != 0 && desired >= currentSize * 0.7f && desired < currentSize * 2.8f)
+	{
+		return currentSize;
+	}
+
+	uint32_t size = kMinTileSize;
+	while (size < kMaxTileSize && static_cast<float>(size * 2) <= desired)
+	{
+		size *= 2;
+	}
+	return size;
+}
+
+bool ShadowAtlas::AllocateTile(uint32_t lightIndex, uint32_t size, CPUSpotLight* states)
+{
+	CPUSpotLight& state = states[lightIndex];
+	for (auto candidate = lightOrder_.rbegin();; ++candidate)
+	{
+		//欲しい大きさから小さい方へ順に試す
+		for (uint32_t tileSize = size; tileSize >= kMinTileSize; tileSize /= 2)
+		{
+			ShadowTileAllocator::Tile tile = allocator_.Allocate(tileSize);
+			if (tile.IsValid())
+			{
+				state.shadowTile = tile;
+				state.hasShadow = false;
+				return true;
+			}
+		}
+
+		//空きがなければ、重要度の低い順にタイルを取り上げる
+		while (candidate != lightOrder_.rend() &&
+			(!states[*candidate].shadowTile.IsValid() || states[*candidate].shadowImportance >= state.shadowImportance))
+		{
+			++candidate;
+		}
+		if (candidate == lightOrder_.rend())
+		{
+			return false;
+		}
+		ReleaseTile(states[*candidate]);
+	}
+}
+
+void ShadowAtlas::WriteShadowData(const CPUSpotLight* states, uint32_t count)
+{
+	stats_.usedArea = allocator_.GetUsedArea();
+	if (!shadowData_.cpuAddress)
+	{
+		return;
+	}
+
+	const float texelSize = 1.0f / static_cast<float>(kAtlasSize);
+	GPUShadow* shadowData = static_cast<GPUShadow*>(shadowData_.cpuAddress);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const CPUSpotLight& state = states[i];
+		GPUShadow shadow{};
+		shadow.viewProjection = state.shadowViewProjection;
+		shadow.atlasRect = {
+			state.shadowTile.x * texelSize,
+			state.shadowTile.y * texelSize,
+			state.shadowTile.size * texelSize,
+			state.shadowTile.size * texelSize
+		};
+		shadow.depthBias = depthBias_;
+		shadow.texelSize = texelSize;
+		shadow.isEnabled = (isEnabled_ && state.shadowTile.IsValid() && state.hasShadow) ? 1 : 0;
+		std::memcpy(&shadowData[i], &shadow, sizeof(GPUShadow));
+	}
+}
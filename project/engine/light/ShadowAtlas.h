@@ -0,0 +1,181 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// light
+#include "SpotLight.h"
+#include "ShadowTileAllocator.h"
+// system
+#include "base/DirectXCommon.h"
+// math
+#include "math/AABB.h"
+
+class Camera;
+class Model;
+class SrvManager;
+
+/**
+ * \brief 影を落とすオブジェクト1つ分
+ */
+struct ShadowCaster
+{
+	Model* model = nullptr;
+	Matrix4x4 world;		//モデルのルート行列を含むワールド行列
+	AABB bounds;			//ワールド空間の境界
+	bool isStatic = false;	//置いたまま動かないもの（障害物など）
+};
+
+/**
+ * \brief 全てのスポットライトの影を1枚の深度テクスチャに詰めて持つアトラス
+ * \note 画面上での大きさに応じてタイルの大きさを決め、ライトか照らす範囲のオブジェクトが動いた時だけ描き直す。
+ *       置いたまま動かないオブジェクトは、全体の並びが変わった時だけ描き直しの理由になる
+ */
+class ShadowAtlas
+{
+public:
+	//アトラスの一辺
+	static constexpr uint32_t kAtlasSize = 4096;
+	//タイルの一辺の最大と最小
+	static constexpr uint32_t kMaxTileSize = 1024;
+	static constexpr uint32_t kMinTileSize = 128;
+	//1フレームに描き直すタイルの数の初期値
+	static constexpr uint32_t kDefaultMaxTileUpdates = 8;
+
+	/// \brief GPUに送る、スポットライト1つ分の影の情報（スポットライトと同じ番号で並ぶ）
+	struct GPUShadow
+	{
+		Matrix4x4 viewProjection;	//ワールド座標からライトのクリップ座標へ
+		Vector4 atlasRect;			//xy:タイルの左上のUV zw:タイルの大きさのUV
+		float depthBias;			//比較する深度から引く値
+		float texelSize;			//アトラスの1テクセルのUV
+		uint32_t isEnabled;			//0なら影を付けない
+		float padding;
+	};
+
+	/// \brief 描き直すタイル1枚分
+	struct RenderRequest
+	{
+		uint32_t lightIndex = 0;
+		ShadowTileAllocator::Tile tile;
+		Matrix4x4 viewProjection;
+		//照らす範囲を包む球（影を落とすオブジェクトを選ぶのに使う）
+		Vector3 boundsCenter;
+		float boundsRadius = 0.0f;
+	};
+
+	/// \brief 直近のフレームの統計
+	struct Stats
+	{
+		uint32_t shadowedLightCount = 0;	//タイルを持っているライト
+		uint32_t renderedTileCount = 0;		//描き直したタイル
+		uint32_t reusedTileCount = 0;		//前のフレームの影をそのまま使ったタイル
+		uint32_t deferredTileCount = 0;		//描き直しが必要だったが、次のフレーム以降に回したタイル
+		uint32_t droppedLightCount = 0;		//空きがなくタイルを割り当てられなかったライト
+		uint32_t casterDrawCount = 0;		//影を描くのに描いたオブジェクトの数
+		uint64_t usedArea = 0;				//割り当て中のテクセル数
+	};
+
+public:
+	/// \brief 深度テクスチャとビューを作る
+	void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager);
+
+	/**
+	 * \brief カメラから見た大きさに応じて、ライトにタイルを割り当てる
+	 * \note LightManager::PrepareDrawから、ライトを書き込んだ後に呼ぶ
+	 * \param camera 描画に使うカメラ（nullptrなら全てのライトを同じ重要度として扱う）
+	 * \param lights スポットライト（番号順）
+	 * \param states ライトごとのタイルとキャッシュ（lightsと同じ番号）
+	 * \param count ライトの数
+	 */
+	void AssignTiles(const Camera* camera, const GPUSpotLight* lights, CPUSpotLight* states, uint32_t count);
+
+	/**
+	 * \brief 影を落とすオブジェクトを見て、今フレームに描き直すタイルを決める
+	 * \note AssignTilesと同じフレームに、同じライトで呼ぶ。描き直すタイルは描いたものとして記録する
+	 * \return 描き直すタイル（重要度の高い順）
+	 */
+	const std::vector<RenderRequest>& CollectRenderRequests(const std::vector<ShadowCaster>& casters, CPUSpotLight* states, uint32_t count);
+
+	/// \brief ライトのタイルを返す（ライトを削除する時に呼ぶ）
+	void ReleaseTile(CPUSpotLight& state);
+
+	/// \brief 描画の開始（深度を書き込める状態にする）
+	void BeginRender(ID3D12GraphicsCommandList* commandList);
+	/// \brief タイルに描画範囲を合わせてクリアする
+	void BeginTile(ID3D12GraphicsCommandList* commandList, const ShadowTileAllocator::Tile& tile);
+	/// \brief 描画の終了（シェーダーで読める状態に戻す）
+	void EndRender(ID3D12GraphicsCommandList* commandList);
+
+	/// \brief 影を描くのに描いたオブジェクトの数を統計に足す
+	void RecordCasterDraws(uint32_t count) { stats_.casterDrawCount += count; }
+
+	/// \brief 境界が球と重なるか
+	static bool IntersectsSphere(const AABB& box, const Vector3& center, float radius);
+
+	/// \brief ImGuiに設定と統計を表示する
+	void ImGuiUpdate();
+
+public: //アクセッサ
+	//今フレームの影の情報（ライトと同じ番号で並ぶ）
+	D3D12_GPU_VIRTUAL_ADDRESS GetShadowDataAddress() const { return shadowDataAddress_; }
+	//アトラスのSRV
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU() const;
+
+	void SetEnabled(bool enable) { isEnabled_ = enable; }
+	bool IsEnabled() const { return isEnabled_; }
+
+	void SetMaxTileUpdates(uint32_t count) { maxTileUpdates_ = count; }
+	uint32_t GetMaxTileUpdates() const { return maxTileUpdates_; }
+
+	const Stats& GetStats() const { return stats_; }
+
+private:
+	/// \brief ライトごとの今フレームの計算結果
+	struct FrameLight
+	{
+		Matrix4x4 viewProjection;
+		Vector3 boundsCenter;
+		float boundsRadius = 0.0f;
+		uint64_t lightKey = 0;
+	};
+
+	// 重要度からタイルの一辺を決める（今のタイルに近ければそのまま使う）
+	uint32_t ChooseTileSize(float importance, uint32_t currentSize) const;
+	// タイルを割り当てる（空きがなければ、より重要度の低いライトのタイルを取り上げる）
+	bool AllocateTile(uint32_t lightIndex, uint32_t size, CPUSpotLight* states);
+	// 今フレームの影の情報を書き込む
+	void WriteShadowData(const CPUSpotLight* states, uint32_t count);
+
+private:
+	DirectXCommon* dxCommon_ = nullptr;
+	SrvManager* srvManager_ = nullptr;
+
+	//深度テクスチャ
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource_;
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
+	D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle_{};
+	uint32_t srvIndex_ = 0;
+	D3D12_RESOURCE_STATES currentState_ = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+	//タイルの割り当て
+	ShadowTileAllocator allocator_;
+
+	//今フレームのライトごとの計算結果と、重要度の高い順の番号
+	std::vector<FrameLight> frameLights_;
+	std::vector<uint32_t> lightOrder_;
+	std::vector<RenderRequest> requests_;
+
+	//今フレームの影の情報
+	UploadAllocation shadowData_{};
+	D3D12_GPU_VIRTUAL_ADDRESS shadowDataAddress_ = 0;
+
+	//置いたまま動かないオブジェクト全体のハッシュ（変わったら全てのタイルを描き直す）
+	uint64_t staticCasterKey_ = 0;
+
+	//設定
+	bool isEnabled_ = true;
+	uint32_t maxTileUpdates_ = kDefaultMaxTileUpdates;
+	float depthBias_ = 0.0005f;
+
+	Stats stats_;
+};
@@ -0,0 +1,136 @@
+#include "ShadowTileAllocator.h"
+
+#include <cassert>
+#include <cstddef>
+
+void ShadowTileAllocator::Initialize(uint32_t atlasSize, uint32_t minTileSize)
+{
+	assert((atlasSize & (atlasSize - 1)) == 0 && "ERROR: ShadowTileAllocator::Initialize() - atlas size must be a power of two.");
+	assert((minTileSize & (minTileSize - 1)) == 0 && minTileSize <= atlasSize && "ERROR: ShadowTileAllocator::Initialize() - invalid min tile size.");
+
+	atlasSize_ = atlasSize;
+	minTileSize_ = minTileSize;
+	freeTiles_.assign(GetLevel(minTileSize_) + 1, {});
+	Reset();
+}
+
+ShadowTileAllocator::Tile ShadowTileAllocator::Allocate(uint32_t size)
+{
+	const uint32_t level = GetLevel(RoundSize(size));
+
+	//欲しい大きさから順に、空きのある一番小さい階層を探す
+	uint32_t sourceLevel = level;
+	while (freeTiles_[sourceLevel].empty())
+	{
+		if (sourceLevel == 0)
+		{
+			return {};
+		}
+		--sourceLevel;
+	}
+
+	Tile tile = freeTiles_[sourceLevel].back();
+	freeTiles_[sourceLevel].pop_back();
+
+	//欲しい大きさになるまで4分割し、使わない3つを空きに戻す
+	while (sourceLevel < level)
+	{
+		const uint16_t half = tile.size / 2;
+		++sourceLevel;
+		freeTiles_[sourceLevel].push_back({ static_cast<uint16_t>(tile.x + half), tile.y, half });
+		freeTiles_[sourceLevel].push_back({ tile.x, static_cast<uint16_t>(tile.y + half), half });
+		freeTiles_[sourceLevel].push_back({ static_cast<uint16_t>(tile.x + half), static_cast<uint16_t>(tile.y + half), half });
+		tile.size = half;
+	}
+
+	usedArea_ += static_cast<uint64_t>(tile.size) * tile.size;
+	return tile;
+}
+
+void ShadowTileAllocator::Free(const Tile& tile)
+{
+	if (!tile.IsValid())
+	{
+		return;
+	}
+	assert(usedArea_ >= static_cast<uint64_t>(tile.size) * tile.size && "ERROR: ShadowTileAllocator::Free() - tile was not allocated.");
+	usedArea_ -= static_cast<uint64_t>(tile.size) * tile.size;
+
+	Tile current = tile;
+	uint32_t level = GetLevel(current.size);
+	while (level > 0)
+	{
+		//同じ親を持つ残り3つが全て空いていれば、まとめて親に戻す
+		const uint16_t parentSize = static_cast<uint16_t>(current.size * 2);
+		const uint16_t parentX = static_cast<uint16_t>(current.x & ~(parentSize - 1));
+		const uint16_t parentY = static_cast<uint16_t>(current.y & ~(parentSize - 1));
+
+		std::vector<Tile>& freeList = freeTiles_[level];
+		size_t siblingIndices[3];
+		uint32_t siblingCount = 0;
+		for (size_t i = 0; i < freeList.size() && siblingCount < 3; ++i)
+		{
+			const Tile& other = freeList[i];
+			if ((other.x & ~(parentSize - 1)) == parentX && (other.y & ~(parentSize - 1)) == parentY)
+			{
+				siblingIndices[siblingCount++] = i;
+			}
+		}
+		if (siblingCount < 3)
+		{
+			break;
+		}
+
+		//後ろから消すと前の添字がずれない
+		for (uint32_t i = 3; i-- > 0;)
+		{
+			freeList[siblingIndices[i]] = freeList.back();
+			freeList.pop_back();
+		}
+		current = { parentX, parentY, parentSize };
+		--level;
+	}
+	freeTiles_[level].push_back(current);
+}
+
+void ShadowTileAllocator::Reset()
+{
+	for (auto& freeList : freeTiles_)
+	{
+		freeList.clear();
+	}
+	freeTiles_[0].push_back({ 0, 0, static_cast<uint16_t>(atlasSize_) });
+	usedArea_ = 0;
+}
+
+bool ShadowTileAllocator::CanAllocate(uint32_t size) const
+{
+	for (uint32_t level = GetLevel(RoundSize(size)) + 1; level-- > 0;)
+	{
+		if (!freeTiles_[level].empty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t ShadowTileAllocator::GetLevel(uint32_t size) const
+{
+	uint32_t level = 0;
+	for (uint32_t s = atlasSize_; s > size; s >>= 1)
+	{
+		++level;
+	}
+	return level;
+}
+
+uint32_t ShadowTileAllocator::RoundSize(uint32_t size) const
+{
+	uint32_t rounded = minTileSize_;
+	while (rounded < size && rounded < atlasSize_)
+	{
+		rounded <<= 1;
+	}
+	return rounded;
+}
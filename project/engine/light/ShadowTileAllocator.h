@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief 正方形のアトラスを、2のべき乗の大きさの正方形のタイルに分けて貸し出すクラス
+ * \note 4分木で分割し、返されたタイルは兄弟が全て空いていれば親にまとめ直す。
+ *       GPUには触れないので、割り当てだけを単体で確認できる
+ */
+class ShadowTileAllocator
+{
+public:
+	/// \brief アトラス上のタイル（テクセル単位）
+	struct Tile
+	{
+		uint16_t x = 0;
+		uint16_t y = 0;
+		uint16_t size = 0;	//0なら無効
+
+		bool IsValid() const { return size != 0; }
+		bool operator==(const Tile& other) const = default;
+	};
+
+	/**
+	 * \brief 初期化（全体を1枚の空きタイルにする）
+	 * \param atlasSize アトラスの一辺（2のべき乗）
+	 * \param minTileSize 貸し出す最小の一辺（2のべき乗）
+	 */
+	void Initialize(uint32_t atlasSize, uint32_t minTileSize);
+
+	/**
+	 * \brief タイルを借りる
+	 * \param size 一辺（2のべき乗。最小〜アトラスの一辺に丸める）
+	 * \return 空きがなければ無効なタイル
+	 */
+	Tile Allocate(uint32_t size);
+
+	/// \brief タイルを返す
+	void Free(const Tile& tile);
+
+	/// \brief 全てのタイルを返す
+	void Reset();
+
+public: //アクセッサ
+	uint32_t GetAtlasSize() const { return atlasSize_; }
+	uint32_t GetMinTileSize() const { return minTileSize_; }
+	//貸し出し中のテクセル数
+	uint64_t GetUsedArea() const { return usedArea_; }
+	//その大きさのタイルを今すぐ貸し出せるか（分割すれば取れる場合も含む）
+	bool CanAllocate(uint32_t size) const;
+
+private:
+	// 一辺から階層（0がアトラス全体）を求める
+	uint32_t GetLevel(uint32_t size) const;
+	// 一辺を2のべき乗かつ最小〜最大に丸める
+	uint32_t RoundSize(uint32_t size) const;
+
+private:
+	uint32_t atlasSize_ = 0;
+	uint32_t minTileSize_ = 0;
+	uint64_t usedArea_ = 0;
+	//階層ごとの空きタイル
+	std::vector<std::vector<Tile>> freeTiles_;
+};
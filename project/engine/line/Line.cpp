@@ -1,110 +1,54 @@
 #include "Line.h"
-#include "base/DirectXCommon.h"
-#include "base/Camera.h"
 
-Line::~Line()
-{
-	if (vertexResource_) {
-		vertexResource_->Unmap(0, nullptr);
-		vertexResource_.Reset();
-	}
-	if (wvpResource_) {
-		wvpResource_->Unmap(0, nullptr);
-		wvpResource_.Reset();
-	}
-	vertexData_ = nullptr;
-	wvpData_ = nullptr;
-	vertices_.clear();
-}
+#include <format>
+
+#include "base/DirectXCommon.h"
+#include "base/Logger.h"
 
 void Line::Initialize(LineCommon* lineCommon) {
     lineCommon_ = lineCommon;
-	CreateVertexData();
-    CreateWVPResource();
-}
 
-void Line::AddLine(const Vector3& start, const Vector3& end, const Vector4& color) {
-    vertices_.push_back({ start, color });
-    vertices_.push_back({ end, color });
+    // 塊はアップロード用リングから切り出す
+    DirectXCommon* dxCommon = lineCommon_->GetDirectXCommon();
+    stream_.Initialize([dxCommon]() {
+        UploadAllocation allocation = dxCommon->AllocateUpload(sizeof(LineVertex) * kVerticesPerChunk, 16);
+        LineVertexStream::Chunk chunk;
+        chunk.data = static_cast<LineVertex*>(allocation.cpuAddress);
+        chunk.gpuAddress = allocation.gpuAddress;
+        return chunk;
+    });
 }
 
-void Line::Update(Camera* camera)
-{
-	UpdateVertexData();
-	UpdateMatrix(camera);
-}
-
-void Line::CreateVertexData() {
-    // バッファリソースの作成
-    vertexResource_ = lineCommon_->GetDirectXCommon()->CreateBufferResource(
-        sizeof(LineVertex) * kMaxVertexCount
-    );
-
-    // バッファにデータを書き込む
-    vertexResource_->Map(
-        0, 
-        nullptr,
-		reinterpret_cast<void**>(&vertexData_)
-        );
-
-    // バッファビューの設定
-    vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
-    vertexBufferView_.SizeInBytes = sizeof(LineVertex) * kMaxVertexCount;
-    vertexBufferView_.StrideInBytes = sizeof(LineVertex);
-}
-
-void Line::CreateWVPResource()
-{
-    // 定数バッファの作成
-    wvpResource_ = lineCommon_->GetDirectXCommon()->CreateBufferResource(sizeof(Matrix4x4));
-
-	// バッファにデータを書き込む
-    wvpResource_->Map(0, 
-        nullptr,
-		reinterpret_cast<void**>(&wvpData_)
-    );
-
-    wvpData_->WVP = MakeIdentity4x4();
-    wvpData_->World = MakeIdentity4x4();
-}
-
-void Line::UpdateMatrix(Camera* camera)
-{
-    if (!camera) { return; }
-
-    // カメラのビュー・プロジェクション行列を取得
-    Matrix4x4 viewProjectionMatrix = camera->GetViewProjectionMatrix();
-
-    // ワールド行列とビュー・プロジェクション行列を掛け合わせる
-    wvpData_->WVP = wvpData_->World * viewProjectionMatrix;
-}
-
-void Line::UpdateVertexData()
-{
-    // バッファにデータを書き込む
-    std::memcpy(vertexData_, vertices_.data(), sizeof(LineVertex) * vertices_.size());
+void Line::AddLine(const Vector3& start, const Vector3& end, const Vector4& color) {
+    stream_.AddLine(lineCommon_->GetDirectXCommon()->GetFrameCount(), start, end, color);
 }
 
 void Line::Draw() {
-    if (vertices_.empty() || !vertexResource_ || !wvpResource_) return;
-
-    auto commandList = lineCommon_->GetDirectXCommon()->GetCommandList();
-    commandList->SetPipelineState(lineCommon_->GetPipelineState().Get());
-    commandList->SetGraphicsRootSignature(lineCommon_->GetRootSignature().Get());
+    DirectXCommon* dxCommon = lineCommon_->GetDirectXCommon();
 
-    // バッファが有効かチェック
-    if (vertexBufferView_.BufferLocation == 0) return;
+    const std::vector<LineVertexStream::Chunk>& chunks = stream_.BeginDraw(dxCommon->GetFrameCount());
+    if (stream_.GetDroppedVertexCount() != 0 && !hasWarnedOverflow_) {
+        Logger::Log(std::format("WARNING: Line vertices exceeded {} in a frame. The rest are not drawn.\n", kMaxVertexCount));
+        hasWarnedOverflow_ = true;
+    }
+    if (chunks.empty()) { return; }
 
+    auto commandList = dxCommon->GetCommandList();
+    commandList->SetPipelineState(lineCommon_->GetPipelineState().Get());
     commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-    commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
-
-    // WVP行列をGPUに送る
-    commandList->SetGraphicsRootConstantBufferView(0, wvpResource_->GetGPUVirtualAddress());
 
-    // 描画
-    commandList->DrawInstanced(static_cast<UINT>(vertices_.size()), 1, 0, 0);
+    // 塊ごとに描画
+    for (const LineVertexStream::Chunk& chunk : chunks) {
+        D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+        vertexBufferView.BufferLocation = chunk.gpuAddress;
+        vertexBufferView.SizeInBytes = sizeof(LineVertex) * chunk.vertexCount;
+        vertexBufferView.StrideInBytes = sizeof(LineVertex);
+        commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+        commandList->DrawInstanced(chunk.vertexCount, 1, 0, 0);
+    }
 }
 
 void Line::Clear() {
-    vertices_.clear();
+    stream_.Clear();
+    hasWarnedOverflow_ = false;
 }
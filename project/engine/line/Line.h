@@ -1,52 +1,35 @@
 #pragma once
 #include "LineCommon.h"
-#include <vector>
-#include <wrl.h>
-#include <d3d12.h>
-#include "base/GraphicsTypes.h"
-
-class Camera;
-
-struct LineCube {
-    Vector3 center;
-	Vector4 color;
-	std::vector<Vector3> vertices;
-};
-
-struct LineSphere
-{
-	Vector3 center;
-	float radius;
-	Vector4 color;
-	std::vector<Vector3> vertices;
-};
+#include "LineVertexStream.h"
 
+/**
+ * \brief 線分の頂点をアップロード用リングに直接書き込んで描画するクラス
+ * \note 頂点はkVerticesPerChunkずつリングから切り出して書き、切り出した塊ごとに1回描画する。
+ *       塊の分け方やフレームをまたいだ時の扱いはLineVertexStreamに任せる
+ */
 class Line {
 public:
-    Line() = default;
-	~Line();
+    // リングから1度に切り出す頂点数（1回の描画の頂点数）
+    static constexpr uint32_t kVerticesPerChunk = LineVertexStream::kVerticesPerChunk;
+    // 1フレームに描画できる最大頂点数（これを超えた線は捨てて警告を出す）
+    static constexpr uint32_t kMaxVertexCount = LineVertexStream::kMaxVertexCount;
+
+public:
     void Initialize(LineCommon* lineCommon);
     void AddLine(const Vector3& start, const Vector3& end, const Vector4& color);
-	void Update(Camera* camera);
-	void Draw();
+    /// \brief 書き込んだ線を描画する（ルートシグネチャと行列は呼び出し側で設定しておく）
+    void Draw();
+    /// \brief 描画した線を捨てる（描画の後に追加された線は次の描画まで残す）
     void Clear();
+
+    // 今フレームに書き込んだ頂点数
+    uint32_t GetVertexCount() const { return stream_.GetVertexCount(); }
+    // 描画に使う塊の数（描画コール数）
+    uint32_t GetChunkCount() const { return stream_.GetChunkCount(); }
+
 private:
-	// 頂点データの作成
-    void CreateVertexData();
-	// 行列データの作成
-	void CreateWVPResource();
-	// 行列の更新
-	void UpdateMatrix(Camera* camera);
-	// 頂点データの更新
-	void UpdateVertexData();
-private:
-	// 最大頂点数 ６万頂点（３万ライン）
-	const uint32_t kMaxVertexCount = 60000;
     LineCommon* lineCommon_ = nullptr;
-    Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
-    std::vector<LineVertex> vertices_;
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView_;
-    LineVertex* vertexData_ = nullptr;
-    Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource_;
-	LineTransformationMatrix* wvpData_ = nullptr;
+    LineVertexStream stream_;
+    // 上限を超えた警告を出したか（フレームに1度だけ出す）
+    bool hasWarnedOverflow_ = false;
 };
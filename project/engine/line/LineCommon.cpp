@@ -7,11 +7,13 @@ void LineCommon::Initialize(DirectXCommon* dxCommon) {
     dxCommon_ = dxCommon;
     CreateRootSignature();
     CreateGraphicsPipelineState();
+    // シェーダーを書き換えたら作り直す
+    dxCommon_->AddShaderReloadListener(
+        { L"Resources/shaders/Line.VS.hlsl", L"Resources/shaders/LineShape.VS.hlsl", L"Resources/shaders/Line.PS.hlsl" },
+        [this]() { CreateRootSignature(); CreateGraphicsPipelineState(); });
 }
 
 void LineCommon::CreateRootSignature() {
-    HRESULT hr;
-
     // ルートパラメータの作成
     D3D12_ROOT_PARAMETER rootParameters[1] = {};
 
@@ -26,31 +28,12 @@ void LineCommon::CreateRootSignature() {
     rootSignatureDesc.pParameters = rootParameters;
     rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
-    // シリアライズとルートシグネチャの作成
-    Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob;
-    Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
-    hr = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
-    if (FAILED(hr)) {
-        Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
-        assert(false);
-    }
-
-    hr = dxCommon_->GetDevice()->CreateRootSignature(
-        0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
-    assert(SUCCEEDED(hr));
+    // ルートシグネチャの作成（同じ記述のものがあれば共有する）
+    rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(rootSignatureDesc);
 }
 
 void LineCommon::CreateGraphicsPipelineState() {
-    HRESULT hr;
-
-    // シェーダーのコンパイル
-    Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Line.VS.hlsl", L"vs_6_0");
-    assert(vertexShaderBlob != nullptr);
-
-    Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Line.PS.hlsl", L"ps_6_0");
-    assert(pixelShaderBlob != nullptr);
-
-    // 入力レイアウトの定義
+    // 入力レイアウトの定義（線分の頂点）
     D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
         {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
         {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
@@ -60,6 +43,32 @@ void LineCommon::CreateGraphicsPipelineState() {
     inputLayoutDesc.NumElements = _countof(inputElementDescs);
     inputLayoutDesc.pInputElementDescs = inputElementDescs;
 
+    pipelineState_ = CreatePipelineState(L"Resources/shaders/Line.VS.hlsl", inputLayoutDesc);
+
+    // 入力レイアウトの定義（デバッグ図形。スロット0に単位形状、スロット1にインスタンスの行列と色）
+    D3D12_INPUT_ELEMENT_DESC shapeElementDescs[] = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        {"WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+        {"WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+        {"WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+    };
+
+    D3D12_INPUT_LAYOUT_DESC shapeLayoutDesc = {};
+    shapeLayoutDesc.NumElements = _countof(shapeElementDescs);
+    shapeLayoutDesc.pInputElementDescs = shapeElementDescs;
+
+    shapePipelineState_ = CreatePipelineState(L"Resources/shaders/LineShape.VS.hlsl", shapeLayoutDesc);
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> LineCommon::CreatePipelineState(const std::wstring& vertexShaderPath, const D3D12_INPUT_LAYOUT_DESC& inputLayoutDesc) {
+    // シェーダーのコンパイル
+    Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileSharder(vertexShaderPath, L"vs_6_0");
+    assert(vertexShaderBlob != nullptr);
+
+    Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileSharder(L"Resources/shaders/Line.PS.hlsl", L"ps_6_0");
+    assert(pixelShaderBlob != nullptr);
+
     // ブレンドステートの設定
     D3D12_BLEND_DESC blendDesc = {};
     blendDesc.RenderTarget[0].BlendEnable = TRUE;
@@ -99,6 +108,6 @@ void LineCommon::CreateGraphicsPipelineState() {
     psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;   
 
-    hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState_));
-    assert(SUCCEEDED(hr));
+    // パイプラインステートの作成（同じ記述のものがあれば共有する）
+    return dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(psoDesc);
 }
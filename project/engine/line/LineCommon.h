@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <wrl.h>
 #include <d3d12.h>
 
@@ -8,14 +9,18 @@ class LineCommon {
 public:
     void Initialize(DirectXCommon* dxCommon);
     Microsoft::WRL::ComPtr<ID3D12PipelineState> GetPipelineState() const { return pipelineState_; }
+    // デバッグ図形用（単位形状をインスタンスの行列で置く）
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> GetShapePipelineState() const { return shapePipelineState_; }
     Microsoft::WRL::ComPtr<ID3D12RootSignature> GetRootSignature() const { return rootSignature_; }
     DirectXCommon* GetDirectXCommon() const { return dxCommon_; }
 
 private:
     void CreateGraphicsPipelineState();
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> CreatePipelineState(const std::wstring& vertexShaderPath, const D3D12_INPUT_LAYOUT_DESC& inputLayoutDesc);
     void CreateRootSignature();
 
     DirectXCommon* dxCommon_ = nullptr;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> shapePipelineState_;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
 };
@@ -0,0 +1,89 @@
+#include "LineShapeBatch.h"
+
+#include <cstring>
+#include <format>
+
+#include "base/DirectXCommon.h"
+#include "base/Logger.h"
+
+void LineShapeBatch::Initialize(LineCommon* lineCommon) {
+    lineCommon_ = lineCommon;
+
+    // 単位形状を作って1つの頂点バッファに並べる（sin/cosの計算はここだけ）
+    std::array<std::vector<Vector3>, kShapeTypeCount> meshes;
+    meshes[static_cast<size_t>(LineShapeType::Box)] = LineShapeMesh::BuildBox();
+    meshes[static_cast<size_t>(LineShapeType::Sphere)] = LineShapeMesh::BuildSphere();
+    meshes[static_cast<size_t>(LineShapeType::Circle)] = LineShapeMesh::BuildCircle();
+
+    std::vector<Vector3> vertices;
+    for (size_t i = 0; i < kShapeTypeCount; ++i) {
+        shapeRanges_[i].startVertex = static_cast<uint32_t>(vertices.size());
+        shapeRanges_[i].vertexCount = static_cast<uint32_t>(meshes[i].size());
+        vertices.insert(vertices.end(), meshes[i].begin(), meshes[i].end());
+    }
+
+    const UINT sizeInBytes = static_cast<UINT>(sizeof(Vector3) * vertices.size());
+    meshResource_ = lineCommon_->GetDirectXCommon()->CreateBufferResource(sizeInBytes);
+    void* mappedData = nullptr;
+    meshResource_->Map(0, nullptr, &mappedData);
+    std::memcpy(mappedData, vertices.data(), sizeInBytes);
+    meshResource_->Unmap(0, nullptr);
+
+    meshBufferView_.BufferLocation = meshResource_->GetGPUVirtualAddress();
+    meshBufferView_.SizeInBytes = sizeInBytes;
+    meshBufferView_.StrideInBytes = sizeof(Vector3);
+}
+
+void LineShapeBatch::Add(LineShapeType type, const LineShapeInstance& instance) {
+    if (instanceCount_ >= kMaxInstanceCount) {
+        if (!hasWarnedOverflow_) {
+            Logger::Log(std::format("WARNING: Line shapes exceeded {} in a frame. The rest are not drawn.\n", kMaxInstanceCount));
+            hasWarnedOverflow_ = true;
+        }
+        return;
+    }
+    instances_[static_cast<size_t>(type)].push_back(instance);
+    ++instanceCount_;
+}
+
+void LineShapeBatch::Draw() {
+    if (instanceCount_ == 0) { return; }
+
+    DirectXCommon* dxCommon = lineCommon_->GetDirectXCommon();
+
+    // 全ての種類のインスタンスを1度にリングへ書く
+    UploadAllocation allocation = dxCommon->AllocateUpload(sizeof(LineShapeInstance) * instanceCount_, 16);
+    if (!allocation.cpuAddress) { return; }
+    LineShapeInstance* instanceData = static_cast<LineShapeInstance*>(allocation.cpuAddress);
+    for (const auto& instances : instances_) {
+        std::memcpy(instanceData, instances.data(), sizeof(LineShapeInstance) * instances.size());
+        instanceData += instances.size();
+    }
+
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[2] = { meshBufferView_, {} };
+    vertexBufferViews[1].BufferLocation = allocation.gpuAddress;
+    vertexBufferViews[1].SizeInBytes = static_cast<UINT>(sizeof(LineShapeInstance) * instanceCount_);
+    vertexBufferViews[1].StrideInBytes = sizeof(LineShapeInstance);
+
+    auto commandList = dxCommon->GetCommandList();
+    commandList->SetPipelineState(lineCommon_->GetShapePipelineState().Get());
+    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+    commandList->IASetVertexBuffers(0, 2, vertexBufferViews);
+
+    // 種類ごとに1回描画（インスタンスは書いた順に並んでいる）
+    uint32_t firstInstance = 0;
+    for (size_t i = 0; i < kShapeTypeCount; ++i) {
+        const uint32_t count = static_cast<uint32_t>(instances_[i].size());
+        if (count == 0) { continue; }
+        commandList->DrawInstanced(shapeRanges_[i].vertexCount, count, shapeRanges_[i].startVertex, firstInstance);
+        firstInstance += count;
+    }
+}
+
+void LineShapeBatch::Clear() {
+    for (auto& instances : instances_) {
+        instances.clear();
+    }
+    instanceCount_ = 0;
+    hasWarnedOverflow_ = false;
+}
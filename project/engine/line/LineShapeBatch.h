@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <wrl.h>
+#include <d3d12.h>
+
+#include "LineCommon.h"
+#include "LineShapeMesh.h"
+
+/**
+ * \brief デバッグ図形（箱・球・円）を種類ごとにまとめてインスタンス描画するクラス
+ * \note 単位形状は起動時に1度だけ作ってGPUに置き、1つの図形は行列と色（64バイト）だけを積む。
+ *       描画時にインスタンスをアップロード用リングにまとめて書き、種類ごとに1回だけ描画する
+ */
+class LineShapeBatch {
+public:
+    // 1フレームに描画できる最大の図形数（これを超えた図形は捨てて警告を出す）
+    static constexpr uint32_t kMaxInstanceCount = 16384;
+
+public:
+    void Initialize(LineCommon* lineCommon);
+    /// \brief 図形を積む
+    void Add(LineShapeType type, const LineShapeInstance& instance);
+    /// \brief 積んだ図形を描画する（ルートシグネチャと行列は呼び出し側で設定しておく）
+    void Draw();
+    /// \brief 積んだ図形を捨てる
+    void Clear();
+
+    // 今積んでいる図形の数
+    uint32_t GetInstanceCount() const { return instanceCount_; }
+
+private:
+    // 単位形状の頂点バッファ内の範囲
+    struct ShapeRange {
+        uint32_t startVertex = 0;
+        uint32_t vertexCount = 0;
+    };
+
+    static constexpr size_t kShapeTypeCount = static_cast<size_t>(LineShapeType::kCount);
+
+    LineCommon* lineCommon_ = nullptr;
+    // 全ての単位形状を並べた頂点バッファ
+    Microsoft::WRL::ComPtr<ID3D12Resource> meshResource_;
+    D3D12_VERTEX_BUFFER_VIEW meshBufferView_{};
+    std::array<ShapeRange, kShapeTypeCount> shapeRanges_{};
+    // 種類ごとのインスタンス
+    std::array<std::vector<LineShapeInstance>, kShapeTypeCount> instances_;
+    uint32_t instanceCount_ = 0;
+    bool hasWarnedOverflow_ = false;
+};
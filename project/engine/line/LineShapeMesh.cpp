@@ -0,0 +1,126 @@
+#include "LineShapeMesh.h"
+
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+	// 0～rangeをsegments等分した角度のsin/cos（segments+1個）
+	struct AngleTable
+	{
+		std::vector<float> sin;
+		std::vector<float> cos;
+	};
+
+	/// \param isLoop 一周するならtrue（最後を最初と同じ値にして、誤差で線が閉じなくならないようにする）
+	AngleTable MakeAngleTable(uint32_t segments, float range, bool isLoop)
+	{
+		AngleTable table;
+		table.sin.resize(segments + 1);
+		table.cos.resize(segments + 1);
+		for (uint32_t i = 0; i <= segments; ++i)
+		{
+			const float angle = range * static_cast<float>(i) / static_cast<float>(segments);
+			table.sin[i] = std::sin(angle);
+			table.cos[i] = std::cos(angle);
+		}
+		if (isLoop)
+		{
+			table.sin[segments] = table.sin[0];
+			table.cos[segments] = table.cos[0];
+		}
+		return table;
+	}
+}
+
+std::vector<Vector3> LineShapeMesh::BuildBox()
+{
+	const std::array<Vector3, 8> corners = { {
+		{ -1.0f, -1.0f, -1.0f }, { +1.0f, -1.0f, -1.0f }, { +1.0f, +1.0f, -1.0f }, { -1.0f, +1.0f, -1.0f },
+		{ -1.0f, -1.0f, +1.0f }, { +1.0f, -1.0f, +1.0f }, { +1.0f, +1.0f, +1.0f }, { -1.0f, +1.0f, +1.0f },
+	} };
+	const uint32_t edges[12][2] = {
+		{ 0,1 },{ 1,2 },{ 2,3 },{ 3,0 },
+		{ 4,5 },{ 5,6 },{ 6,7 },{ 7,4 },
+		{ 0,4 },{ 1,5 },{ 2,6 },{ 3,7 },
+	};
+
+	std::vector<Vector3> vertices;
+	vertices.reserve(24);
+	for (const auto& edge : edges)
+	{
+		vertices.push_back(corners[edge[0]]);
+		vertices.push_back(corners[edge[1]]);
+	}
+	return vertices;
+}
+
+std::vector<Vector3> LineShapeMesh::BuildSphere()
+{
+	//経度は0～2π、緯度は北極(0)～南極(π)
+	const AngleTable longitude = MakeAngleTable(kSphereSegments, 2.0f * std::numbers::pi_v<float>, true);
+	const AngleTable latitude = MakeAngleTable(kSphereRings, std::numbers::pi_v<float>, false);
+
+	auto point = [&](uint32_t ring, uint32_t segment)
+		{
+			return Vector3{
+				latitude.sin[ring] * longitude.cos[segment],
+				latitude.cos[ring],
+				latitude.sin[ring] * longitude.sin[segment]
+			};
+		};
+
+	std::vector<Vector3> vertices;
+	vertices.reserve(2 * (kSphereSegments * kSphereRings + kSphereSegments * (kSphereRings - 1)));
+
+	//経線（極から極まで）
+	for (uint32_t segment = 0; segment < kSphereSegments; ++segment)
+	{
+		for (uint32_t ring = 0; ring < kSphereRings; ++ring)
+		{
+			vertices.push_back(point(ring, segment));
+			vertices.push_back(point(ring + 1, segment));
+		}
+	}
+	//緯線（極は点になるので除く）
+	for (uint32_t ring = 1; ring < kSphereRings; ++ring)
+	{
+		for (uint32_t segment = 0; segment < kSphereSegments; ++segment)
+		{
+			vertices.push_back(point(ring, segment));
+			vertices.push_back(point(ring, segment + 1));
+		}
+	}
+	return vertices;
+}
+
+std::vector<Vector3> LineShapeMesh::BuildCircle()
+{
+	const AngleTable table = MakeAngleTable(kCircleSegments, 2.0f * std::numbers::pi_v<float>, true);
+
+	std::vector<Vector3> vertices;
+	vertices.reserve(2 * kCircleSegments);
+	for (uint32_t i = 0; i < kCircleSegments; ++i)
+	{
+		vertices.push_back({ table.cos[i], 0.0f, table.sin[i] });
+		vertices.push_back({ table.cos[i + 1], 0.0f, table.sin[i + 1] });
+	}
+	return vertices;
+}
+
+LineShapeInstance LineShapeMesh::MakeInstance(const Vector3& axisX, const Vector3& axisY, const Vector3& axisZ, const Vector3& translate, const Vector4& color)
+{
+	LineShapeInstance instance;
+	instance.world[0] = { axisX.x, axisY.x, axisZ.x, translate.x };
+	instance.world[1] = { axisX.y, axisY.y, axisZ.y, translate.y };
+	instance.world[2] = { axisX.z, axisY.z, axisZ.z, translate.z };
+	instance.color = color;
+	return instance;
+}
+
+Vector3 LineShapeMesh::Transform(const LineShapeInstance& instance, const Vector3& point)
+{
+	auto row = [&](const Vector4& w) { return w.x * point.x + w.y * point.y + w.z * point.z + w.w; };
+	return { row(instance.world[0]), row(instance.world[1]), row(instance.world[2]) };
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+// 単位形状をインスタンス描画するデバッグ図形の種類
+enum class LineShapeType : uint32_t
+{
+	Box,		// 中心が原点、半分の大きさが1の箱（キューブ・AABB・OBB）
+	Sphere,		// 半径1の球
+	Circle,		// XZ平面上の半径1の円
+
+	kCount
+};
+
+/**
+ * \brief デバッグ図形1つ分のインスタンスデータ（頂点バッファのインスタンス単位のデータとして送る）
+ * \note world[i]はアフィン変換の第i列（x, y, zの軸の第i成分と平行移動の第i成分）
+ */
+struct LineShapeInstance
+{
+	Vector4 world[3];
+	Vector4 color;
+};
+
+/**
+ * \brief デバッグ図形の単位形状（線分リスト）を作る
+ * \note 起動時に1度だけ作ってGPUに置き、描画のたびにsin/cosを計算しないようにする
+ */
+namespace LineShapeMesh
+{
+	// 円の分割数
+	constexpr uint32_t kCircleSegments = 32;
+	// 球の経度方向の分割数
+	constexpr uint32_t kSphereSegments = 12;
+	// 球の緯度方向の分割数
+	constexpr uint32_t kSphereRings = 12;
+
+	/// \brief 中心が原点、各辺の半分が1の箱の12辺（24頂点）
+	std::vector<Vector3> BuildBox();
+
+	/// \brief 半径1の球の経線と緯線（両極は緯線を持たない）
+	std::vector<Vector3> BuildSphere();
+
+	/// \brief XZ平面上の半径1の円
+	std::vector<Vector3> BuildCircle();
+
+	/**
+	 * \brief 単位形状をワールドに置くインスタンスを作る
+	 * \param axisX 単位形状のx軸の行き先（大きさを含む）
+	 * \param axisY 単位形状のy軸の行き先
+	 * \param axisZ 単位形状のz軸の行き先
+	 * \param translate 原点の行き先
+	 */
+	LineShapeInstance MakeInstance(const Vector3& axisX, const Vector3& axisY, const Vector3& axisZ, const Vector3& translate, const Vector4& color);
+
+	/// \brief インスタンスで点を変換する（シェーダーと同じ計算）
+	Vector3 Transform(const LineShapeInstance& instance, const Vector3& point);
+}
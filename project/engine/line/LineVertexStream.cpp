@@ -0,0 +1,75 @@
+#include "LineVertexStream.h"
+
+#include <utility>
+
+void LineVertexStream::Initialize(ChunkAllocator allocator) {
+    allocator_ = std::move(allocator);
+}
+
+bool LineVertexStream::AddLine(uint64_t frame, const Vector3& start, const Vector3& end, const Vector4& color) {
+    // 今フレームの描画が済んだ後に書くと、次のフレームで描画する前に領域が再利用されうるので取っておく
+    if (drawnFrame_ == frame) {
+        lateVertices_.push_back({ start, color });
+        lateVertices_.push_back({ end, color });
+        return true;
+    }
+
+    DiscardStaleChunks(frame);
+
+    // 塊がいっぱいなら次を切り出す（頂点数は偶数なので線分が塊をまたぐことはない）
+    if (chunks_.empty() || chunks_.back().vertexCount == kVerticesPerChunk) {
+        if (!BeginChunk(frame)) {
+            droppedVertexCount_ += 2;
+            return false;
+        }
+    }
+
+    Chunk& chunk = chunks_.back();
+    chunk.data[chunk.vertexCount++] = { start, color };
+    chunk.data[chunk.vertexCount++] = { end, color };
+    vertexCount_ += 2;
+    return true;
+}
+
+const std::vector<LineVertexStream::Chunk>& LineVertexStream::BeginDraw(uint64_t frame) {
+    DiscardStaleChunks(frame);
+
+    // 前のフレームで描画の後に追加された線を、今フレームの塊に書き込む
+    if (!lateVertices_.empty()) {
+        std::vector<LineVertex> lateVertices;
+        lateVertices.swap(lateVertices_);
+        for (size_t i = 0; i + 1 < lateVertices.size(); i += 2) {
+            AddLine(frame, lateVertices[i].position, lateVertices[i + 1].position, lateVertices[i].color);
+        }
+    }
+
+    drawnFrame_ = frame;
+    return chunks_;
+}
+
+void LineVertexStream::Clear() {
+    chunks_.clear();
+    vertexCount_ = 0;
+    droppedVertexCount_ = 0;
+}
+
+bool LineVertexStream::BeginChunk(uint64_t frame) {
+    if (vertexCount_ >= kMaxVertexCount) { return false; }
+
+    Chunk chunk = allocator_();
+    if (!chunk.data) { return false; }
+
+    if (chunks_.empty()) {
+        chunkFrame_ = frame;
+    }
+    chunk.vertexCount = 0;
+    chunks_.push_back(chunk);
+    return true;
+}
+
+void LineVertexStream::DiscardStaleChunks(uint64_t frame) {
+    // 描画されないままフレームが進んだ塊は、領域がもう再利用されているかもしれない
+    if (!chunks_.empty() && chunkFrame_ != frame) {
+        Clear();
+    }
+}
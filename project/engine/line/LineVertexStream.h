@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief 線分の頂点を塊ごとに書き込み、フレームをまたいだ時の扱いを決めるクラス
+ * \note GPUには触れず、塊の領域は渡された関数で切り出すので、分け方や捨て方だけを単体で確認できる。
+ *       描画した後に追加された線は次の描画まで取っておき、描画されないままフレームが進んだ塊は捨てる
+ */
+class LineVertexStream {
+public:
+    // 1度に切り出す頂点数（1回の描画の頂点数）
+    static constexpr uint32_t kVerticesPerChunk = 8192;
+    // 1フレームに書き込める最大頂点数（これを超えた線は捨てる）
+    static constexpr uint32_t kMaxVertexCount = 131072;
+    static_assert(kVerticesPerChunk % 2 == 0 && kMaxVertexCount % kVerticesPerChunk == 0);
+
+    // 切り出した頂点の塊
+    struct Chunk {
+        LineVertex* data = nullptr;
+        uint64_t gpuAddress = 0;
+        uint32_t vertexCount = 0;
+    };
+
+    // kVerticesPerChunk個の頂点を書ける領域を切り出す関数（切り出せなければdataをnullptrにする）
+    using ChunkAllocator = std::function<Chunk()>;
+
+public:
+    void Initialize(ChunkAllocator allocator);
+
+    /**
+     * \brief 線分を書き込む
+     * \param frame 今のフレームの通し番号
+     * \return 上限を超えたなどで捨てたらfalse（描画の後に追加されて次の描画まで取っておく場合はtrue）
+     */
+    bool AddLine(uint64_t frame, const Vector3& start, const Vector3& end, const Vector4& color);
+
+    /**
+     * \brief 描画の前に呼ぶ。古い塊を捨て、前の描画の後に追加された線を書き込む
+     * \param frame 今のフレームの通し番号
+     * \return 描画する塊
+     */
+    const std::vector<Chunk>& BeginDraw(uint64_t frame);
+
+    /// \brief 描画した線を捨てる（描画の後に追加された線は次の描画まで残す）
+    void Clear();
+
+    // 今フレームに書き込んだ頂点数
+    uint32_t GetVertexCount() const { return vertexCount_; }
+    // 塊の数（描画コール数）
+    uint32_t GetChunkCount() const { return static_cast<uint32_t>(chunks_.size()); }
+    // 次の描画まで取っておく頂点数
+    uint32_t GetLateVertexCount() const { return static_cast<uint32_t>(lateVertices_.size()); }
+    // 今フレームに捨てた頂点数
+    uint32_t GetDroppedVertexCount() const { return droppedVertexCount_; }
+
+private:
+    // 次の塊を切り出す（上限に達したか、切り出せなければfalse）
+    bool BeginChunk(uint64_t frame);
+    // 前のフレームに書いたまま描画されなかった塊を捨てる
+    void DiscardStaleChunks(uint64_t frame);
+
+private:
+    ChunkAllocator allocator_;
+    std::vector<Chunk> chunks_;
+    uint32_t vertexCount_ = 0;
+    uint32_t droppedVertexCount_ = 0;
+    // 塊を切り出したフレームの通し番号
+    uint64_t chunkFrame_ = 0;
+    // 最後に描画したフレームの通し番号と、その後に追加された線
+    uint64_t drawnFrame_ = UINT64_MAX;
+    std::vector<LineVertex> lateVertices_;
+};
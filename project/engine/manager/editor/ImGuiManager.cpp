@@ -26,7 +26,7 @@ void ImGuiManager::Initialize([[maybe_unused]] WinApp* winApp, [[maybe_unused]]
 	ImGui_ImplWin32_Init(winApp_->GetHwnd());
 
 	//SRVの確保とインデックスの取得
-	uint32_t srvIndex = srvManager_->Allocate();
+	fontSrvIndex_ = srvManager_->Allocate();
 
 	//DX12用の初期化
 	ImGui_ImplDX12_Init(
@@ -34,9 +34,13 @@ void ImGuiManager::Initialize([[maybe_unused]] WinApp* winApp, [[maybe_unused]]
 		static_cast<int>(dxCommon_->GetBackBufferCount()),
 		DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
 		srvManager_->GetSrvHeap(),
-		srvManager_->GetCPUDescriptorHandle(srvIndex),
-		srvManager_->GetGPUDescriptorHandle(srvIndex)
+		srvManager_->GetCPUDescriptorHandle(fontSrvIndex_),
+		srvManager_->GetGPUDescriptorHandle(fontSrvIndex_)
 	);
+	//フォントのSRVはCPU側のヒープに作られるので、作ってから描画用のヒープに写す
+	ImGui_ImplDX12_CreateDeviceObjects();
+	srvManager_->CommitDescriptor(fontSrvIndex_);
+	fontGrowCount_ = srvManager_->GetGrowCount();
 
 	// ドッキングを有効にする
 	ImGuiIO& io = ImGui::GetIO();
@@ -57,6 +61,9 @@ void ImGuiManager::Finalize()
 void ImGuiManager::Begin()
 {
 #ifdef USE_IMGUI
+	//前のフレームにヒープが作り直されていたら、フォントのハンドルを合わせてから描き始める
+	RefreshFontTexture();
+
 	//ImGuiの描画開始
 	ImGui_ImplDX12_NewFrame();
 	ImGui_ImplWin32_NewFrame();
@@ -77,6 +84,9 @@ void ImGuiManager::Draw()
 #ifdef USE_IMGUI
 	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
 
+	//UIを組み立てた後にヒープが作り直されていたら、積んだ描画コマンドのフォントのハンドルも差し替える
+	RefreshFontTexture();
+
 	//ディスクリプタヒープの配列をセットするコマンド
 	ID3D12DescriptorHeap* ppHeaps[] = { srvManager_->GetSrvHeap() };
 	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
@@ -84,3 +94,36 @@ void ImGuiManager::Draw()
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandList);
 #endif
 }
+
+void ImGuiManager::RefreshFontTexture()
+{
+#ifdef USE_IMGUI
+	if (fontGrowCount_ == srvManager_->GetGrowCount())
+	{
+		return;
+	}
+	fontGrowCount_ = srvManager_->GetGrowCount();
+
+	ImGuiIO& io = ImGui::GetIO();
+	const ImTextureID oldTexId = io.Fonts->TexID;
+	const ImTextureID newTexId = static_cast<ImTextureID>(srvManager_->GetGPUDescriptorHandle(fontSrvIndex_).ptr);
+	io.Fonts->SetTexID(newTexId);
+
+	//Renderの後なら、積まれている描画コマンドも古いハンドルを持っている
+	ImDrawData* drawData = ImGui::GetDrawData();
+	if (!drawData)
+	{
+		return;
+	}
+	for (ImDrawList* drawList : drawData->CmdLists)
+	{
+		for (ImDrawCmd& command : drawList->CmdBuffer)
+		{
+			if (command.TextureId == oldTexId)
+			{
+				command.TextureId = newTexId;
+			}
+		}
+	}
+#endif
+}
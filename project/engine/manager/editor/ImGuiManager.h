@@ -34,6 +34,13 @@ public:
 	 */
 	void Draw();
 
+private:
+	/**
+	 * \brief SRVヒープが作り直されていたら、フォントのテクスチャIDを今のヒープのハンドルにする
+	 * \note ImGuiのDX12実装はテクスチャIDをGPUハンドルとしてそのまま使うので、古いヒープを指したままにしない
+	 */
+	void RefreshFontTexture();
+
 private:
 	//ウィンドウアプリケーションのポインタ
 	WinApp* winApp_ = nullptr;
@@ -43,5 +50,10 @@ private:
 
 	//DirectXCommonのポインタ
 	DirectXCommon* dxCommon_ = nullptr;
+
+	//フォントのSRVの番号（番号はヒープを作り直しても変わらない）
+	uint32_t fontSrvIndex_ = 0;
+	//フォントのテクスチャIDを設定した時のヒープの作り直し回数
+	uint32_t fontGrowCount_ = 0;
 };
 
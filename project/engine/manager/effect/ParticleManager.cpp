@@ -90,6 +90,11 @@ void ParticleManager::Draw()
 
 	dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
+	/*--------------[ テクスチャのテーブルの設定 ]-----------------*/
+
+	//SRVヒープ全体を設定し、グループごとのテクスチャはマテリアルの番号で引く
+	dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(2, srvManager_->GetGPUDescriptorHandle(0));
+
 	/*--------------[ パーティクルの描画 ]-----------------*/
 
 	for (auto& emitter : emitters_)
@@ -1,6 +1,7 @@
 #include "ParticlePipelineManager.h"
 
 #include <cassert>
+#include <climits>
 
 // system
 #include "base/DirectXCommon.h"
@@ -11,6 +12,10 @@ void ParticlePipelineManager::Initialize(DirectXCommon* dxCommon)
 	dxCommon_ = dxCommon;
 	//パイプラインの生成
 	CreateGraphicsPipelineState();
+	//シェーダーを書き換えたら作り直す
+	dxCommon_->AddShaderReloadListener(
+		{ L"Resources/shaders/Particle.VS.hlsl", L"Resources/shaders/Particle.PS.hlsl" },
+		[this]() { CreateGraphicsPipelineState(); });
 }
 
 void ParticlePipelineManager::CreateRootSignature()
@@ -19,11 +24,13 @@ void ParticlePipelineManager::CreateRootSignature()
 	///ディスクリプタレンジの生成
 	///===================================================================
 
+	//テクスチャ用（SRVヒープ全体を1つのテーブルにして、マテリアルのtextureIndexで引く）
 	D3D12_DESCRIPTOR_RANGE descriptorRange[1] = {};
 	descriptorRange[0].BaseShaderRegister = 0;
-	descriptorRange[0].NumDescriptors = 1;
+	descriptorRange[0].RegisterSpace = 1;
+	descriptorRange[0].NumDescriptors = UINT_MAX;
 	descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-	descriptorRange[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+	descriptorRange[0].OffsetInDescriptorsFromTableStart = 0;
 
 	D3D12_DESCRIPTOR_RANGE descriptorRangeForInstancing[1] = {};
 	descriptorRangeForInstancing[0].BaseShaderRegister = 0;	//０から始まる
@@ -80,23 +87,8 @@ void ParticlePipelineManager::CreateRootSignature()
 	descriptionRootSignature.pParameters = rootParameters;					//ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters);		//配列の長さ
 
-	//シリアライズしてバイナリする
-	HRESULT hr;
-	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob = nullptr;
-	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-	hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
-	if (FAILED(hr))
-	{
-		Logger::Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
-		assert(false);
-	}
-	//バイナリをもとに生成
-	hr = dxCommon_->GetDevice()->CreateRootSignature(
-		0,
-		signatureBlob->GetBufferPointer(),
-		signatureBlob->GetBufferSize(),
-		IID_PPV_ARGS(&rootSignature_));
-	assert(SUCCEEDED(hr));
+	//生成（同じ記述のものがあれば共有する）
+	rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(descriptionRootSignature);
 }
 
 void ParticlePipelineManager::CreateGraphicsPipelineState()
@@ -104,8 +96,6 @@ void ParticlePipelineManager::CreateGraphicsPipelineState()
 	//ルートシグネチャ
 	CreateRootSignature();
 
-	HRESULT hr;
-
 	///===================================================================
 	///InputLayout(インプットレイアウト)
 	///===================================================================
@@ -207,12 +197,6 @@ void ParticlePipelineManager::CreateGraphicsPipelineState()
 	//どのように画面に色を打ち込むかの設定（気にしなくていい）
 	graphicsPipelineStateDesc.SampleDesc.Count = 1;
 	graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
-	//実際に生成
-
-	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
-		&graphicsPipelineStateDesc,
-		IID_PPV_ARGS(&graphicsPipelineState_)
-	);
-
-	assert(SUCCEEDED(hr));
+	//実際に生成（同じ記述のものがあれば共有する）
+	graphicsPipelineState_ = dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(graphicsPipelineStateDesc);
 }
@@ -16,6 +16,8 @@ void PostProcessManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvMana
 	srvManager_ = srvManager;
 
 	SetupPipeline(vsPath, psPath);
+	// シェーダーを書き換えたら作り直す
+	dxCommon_->AddShaderReloadListener({ vsPath, psPath }, [this, vsPath, psPath]() { SetupPipeline(vsPath, psPath); });
 
 	CreateConstantBuffer();
 
@@ -45,9 +47,8 @@ void PostProcessManager::SetupPipeline(const std::wstring& vsPath, const std::ws
 	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc{};
 	rootSigDesc.Init(_countof(rootParams), rootParams, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
-	Microsoft::WRL::ComPtr<ID3DBlob> sigBlob, errBlob;
-	D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
-	dxCommon_->GetDevice()->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature_));
+	// 同じ記述のものがあれば共有する
+	rootSignature_ = dxCommon_->GetPipelineCache()->GetRootSignature(rootSigDesc);
 
 	// パイプラインステートの作成
 	auto vs = dxCommon_->CompileSharder(vsPath, L"vs_6_0");
@@ -69,7 +70,7 @@ void PostProcessManager::SetupPipeline(const std::wstring& vsPath, const std::ws
 	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
 	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 
-	dxCommon_->GetDevice()->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState_));
+	pipelineState_ = dxCommon_->GetPipelineCache()->GetGraphicsPipelineState(psoDesc);
 }
 
 void PostProcessManager::Draw(D3D12_GPU_DESCRIPTOR_HANDLE inputTexture)
@@ -2,9 +2,7 @@
 
 
 // math
-#include <numbers>
 #include "math/VectorColorCodes.h"
-#include "math/MathUtils.h"
 // system
 #include "manager/scene/CameraManager.h"
 
@@ -27,14 +25,18 @@ void LineManager::Initialize(DirectXCommon* dxCommon, CameraManager* cameraManag
 	lineCommon_->Initialize(dxCommon_);
 	line_ = std::make_unique<Line>();
 	line_->Initialize(lineCommon_.get());
+	shapeBatch_ = std::make_unique<LineShapeBatch>();
+	shapeBatch_->Initialize(lineCommon_.get());
 }
 
 void LineManager::Clear() {
     line_->Clear();
+    shapeBatch_->Clear();
 }
 
 void LineManager::Finalize()
 {
+	shapeBatch_.reset();
 	line_.reset();
 	lineCommon_.reset();
 	dxCommon_ = nullptr;
@@ -43,10 +45,23 @@ void LineManager::Finalize()
 }
 
 void LineManager::RenderLines() {
-	//頂点データ、行列データの更新
-    line_->Update(cameraManager_->GetActiveCamera());
+	Camera* camera = cameraManager_->GetActiveCamera();
+	if (!camera) {
+		Clear();
+		return;
+	}
+
+	//線分とデバッグ図形で共通の設定
+	LineTransformationMatrix matrix{};
+	matrix.WVP = camera->GetViewProjectionMatrix();
+	matrix.World = MakeIdentity4x4();
+	auto commandList = dxCommon_->GetCommandList();
+	commandList->SetGraphicsRootSignature(lineCommon_->GetRootSignature().Get());
+	commandList->SetGraphicsRootConstantBufferView(0, dxCommon_->UploadConstant(matrix));
+
 	//描画
     line_->Draw();
+	shapeBatch_->Draw();
 	// 描画後にクリア
 	Clear();
 }
@@ -54,85 +69,34 @@ void LineManager::RenderLines() {
 void LineManager::DrawCube(const Vector3& center, float size, const Vector4& color) {
     float halfSize = size / 2.0f;
 
-    // キューブの8つの頂点を計算
-    Vector3 vertices[8] = {
-        {center.x - halfSize, center.y - halfSize, center.z - halfSize},
-        {center.x + halfSize, center.y - halfSize, center.z - halfSize},
-        {center.x + halfSize, center.y + halfSize, center.z - halfSize},
-        {center.x - halfSize, center.y + halfSize, center.z - halfSize},
-        {center.x - halfSize, center.y - halfSize, center.z + halfSize},
-        {center.x + halfSize, center.y - halfSize, center.z + halfSize},
-        {center.x + halfSize, center.y + halfSize, center.z + halfSize},
-        {center.x - halfSize, center.y + halfSize, center.z + halfSize}
-    };
-
-    // キューブの12本の辺を追加
-    line_->AddLine(vertices[0], vertices[1], color);
-    line_->AddLine(vertices[1], vertices[2], color);
-    line_->AddLine(vertices[2], vertices[3], color);
-    line_->AddLine(vertices[3], vertices[0], color);
-
-    line_->AddLine(vertices[4], vertices[5], color);
-    line_->AddLine(vertices[5], vertices[6], color);
-    line_->AddLine(vertices[6], vertices[7], color);
-    line_->AddLine(vertices[7], vertices[4], color);
-
-    line_->AddLine(vertices[0], vertices[4], color);
-    line_->AddLine(vertices[1], vertices[5], color);
-    line_->AddLine(vertices[2], vertices[6], color);
-    line_->AddLine(vertices[3], vertices[7], color);
+    // 単位の箱を大きさだけ変えて置く
+    shapeBatch_->Add(LineShapeType::Box, LineShapeMesh::MakeInstance(
+        { halfSize, 0.0f, 0.0f }, { 0.0f, halfSize, 0.0f }, { 0.0f, 0.0f, halfSize }, center, color));
 }
 
 void LineManager::DrawSphere(const Vector3& center, float radius, const Vector4& color)
 {
-    const int segments = 12;
-    const int rings = 12;
-
-    for (int i = 0; i <= rings; ++i) {
-        float theta1 = i * std::numbers::pi_v<float> / rings;
-        float theta2 = (i + 1) * std::numbers::pi_v<float> / rings;
-
-        for (int j = 0; j <= segments; ++j) {
-            float phi = j * 2 * std::numbers::pi_v<float> / segments;
-
-            Vector3 p1 = {
-                center.x + radius * sinf(theta1) * cosf(phi),
-                center.y + radius * cosf(theta1),
-                center.z + radius * sinf(theta1) * sinf(phi)
-            };
-
-            Vector3 p2 = {
-                center.x + radius * sinf(theta2) * cosf(phi),
-                center.y + radius * cosf(theta2),
-                center.z + radius * sinf(theta2) * sinf(phi)
-            };
-
-            line_->AddLine(p1, p2, color);
-        }
-    }
-
-    for (int i = 0; i <= segments; ++i) {
-        float phi1 = i * 2 * std::numbers::pi_v<float> / segments;
-        float phi2 = (i + 1) * 2 * std::numbers::pi_v<float> / segments;
-
-        for (int j = 0; j <= rings; ++j) {
-            float theta = j * std::numbers::pi_v<float> / rings;
-
-            Vector3 p1 = {
-                center.x + radius * sinf(theta) * cosf(phi1),
-                center.y + radius * cosf(theta),
-                center.z + radius * sinf(theta) * sinf(phi1)
-            };
-
-            Vector3 p2 = {
-                center.x + radius * sinf(theta) * cosf(phi2),
-                center.y + radius * cosf(theta),
-                center.z + radius * sinf(theta) * sinf(phi2)
-            };
+    // 単位球を半径だけ変えて置く
+    shapeBatch_->Add(LineShapeType::Sphere, LineShapeMesh::MakeInstance(
+        { radius, 0.0f, 0.0f }, { 0.0f, radius, 0.0f }, { 0.0f, 0.0f, radius }, center, color));
+}
 
-            line_->AddLine(p1, p2, color);
-        }
+void LineManager::DrawCircle(const Vector3& center, float radius, const Vector3& normal, const Vector4& color)
+{
+    // 単位円はXZ平面上なので、Y軸を法線に向ける
+    Vector3 axisY = Vector3::Normalize(normal);
+    if (axisY.IsZero()) {
+        axisY = { 0.0f, 1.0f, 0.0f };
     }
+    Vector3 axisX = Vector3::Cross(axisY, { 0.0f, 0.0f, 1.0f });
+    if (axisX.IsZero(0.0001f)) {
+        axisX = Vector3::Cross(axisY, { 1.0f, 0.0f, 0.0f });
+    }
+    axisX = Vector3::Normalize(axisX);
+    Vector3 axisZ = Vector3::Cross(axisX, axisY);
+
+    shapeBatch_->Add(LineShapeType::Circle, LineShapeMesh::MakeInstance(
+        axisX * radius, axisY * radius, axisZ * radius, center, color));
 }
 
 void LineManager::DrawGrid(float gridSize, float gridSpacing, const Vector4& color)
@@ -192,60 +156,22 @@ void LineManager::DrawAxis(const Vector3& position, float scale)
 
 void LineManager::DrawAABB(const AABB& aabb, const Vector4& color)
 {
-    // 8頂点を計算
-    Vector3 v[8] = {
-        {aabb.min_.x, aabb.min_.y, aabb.min_.z},
-        {aabb.max_.x, aabb.min_.y, aabb.min_.z},
-        {aabb.max_.x, aabb.max_.y, aabb.min_.z},
-        {aabb.min_.x, aabb.max_.y, aabb.min_.z},
-        {aabb.min_.x, aabb.min_.y, aabb.max_.z},
-        {aabb.max_.x, aabb.min_.y, aabb.max_.z},
-        {aabb.max_.x, aabb.max_.y, aabb.max_.z},
-        {aabb.min_.x, aabb.max_.y, aabb.max_.z},
-    };
-
-    // 12本のエッジを線で描画
-    DrawLine(v[0], v[1], color); DrawLine(v[1], v[2], color);
-    DrawLine(v[2], v[3], color); DrawLine(v[3], v[0], color);
-
-    DrawLine(v[4], v[5], color); DrawLine(v[5], v[6], color);
-    DrawLine(v[6], v[7], color); DrawLine(v[7], v[4], color);
-
-    DrawLine(v[0], v[4], color); DrawLine(v[1], v[5], color);
-    DrawLine(v[2], v[6], color); DrawLine(v[3], v[7], color);
+    // 中心と半分の大きさで単位の箱を置く
+    Vector3 center = (aabb.min_ + aabb.max_) * 0.5f;
+    Vector3 halfSize = (aabb.max_ - aabb.min_) * 0.5f;
+    shapeBatch_->Add(LineShapeType::Box, LineShapeMesh::MakeInstance(
+        { halfSize.x, 0.0f, 0.0f }, { 0.0f, halfSize.y, 0.0f }, { 0.0f, 0.0f, halfSize.z }, center, color));
 }
 
 void LineManager::DrawOBB(const OBB& obb, const Vector4& color)
 {
     Vector3 halfSize = obb.size;
 
-    // ローカル座標での8頂点
-    Vector3 localPoints[8] = {
-        {-halfSize.x, -halfSize.y, -halfSize.z},
-        {+halfSize.x, -halfSize.y, -halfSize.z},
-        {+halfSize.x, +halfSize.y, -halfSize.z},
-        {-halfSize.x, +halfSize.y, -halfSize.z},
-        {-halfSize.x, -halfSize.y, +halfSize.z},
-        {+halfSize.x, -halfSize.y, +halfSize.z},
-        {+halfSize.x, +halfSize.y, +halfSize.z},
-        {-halfSize.x, +halfSize.y, +halfSize.z},
-    };
-
-    // 回転 + 移動適用
-    Vector3 worldPoints[8];
-    for (int i = 0; i < 8; ++i) {
-        worldPoints[i] = MathUtils::Transform(localPoints[i], obb.rotate) + obb.center;
-    }
-
-    // 12本のエッジを描画
-    int indices[12][2] = {
-        {0,1},{1,2},{2,3},{3,0},
-        {4,5},{5,6},{6,7},{7,4},
-        {0,4},{1,5},{2,6},{3,7},
-    };
-    for (int i = 0; i < 12; ++i) {
-        DrawLine(worldPoints[indices[i][0]], worldPoints[indices[i][1]], color);
-    }
+    // 回転行列の各行がローカルの軸の向き（行ベクトルに掛ける形なので、MathUtils::Transformと同じ結果になる）
+    Vector3 axisX = Vector3{ obb.rotate.m[0][0], obb.rotate.m[0][1], obb.rotate.m[0][2] } * halfSize.x;
+    Vector3 axisY = Vector3{ obb.rotate.m[1][0], obb.rotate.m[1][1], obb.rotate.m[1][2] } * halfSize.y;
+    Vector3 axisZ = Vector3{ obb.rotate.m[2][0], obb.rotate.m[2][1], obb.rotate.m[2][2] } * halfSize.z;
+    shapeBatch_->Add(LineShapeType::Box, LineShapeMesh::MakeInstance(axisX, axisY, axisZ, obb.center, color));
 }
 
 void LineManager::DrawLine(const Vector3& start, const Vector3& end, const Vector4& color)
@@ -4,12 +4,18 @@
 // system
 #include "line/Line.h"
 #include "line/LineCommon.h"
+#include "line/LineShapeBatch.h"
 // math
 #include "math/AABB.h"
 #include "math/OBB.h"
 
 class CameraManager;
 
+/**
+ * \brief デバッグ用の線を描画するクラス
+ * \note 線分はアップロード用リングに直接書き、キューブ・球・円・AABB・OBBは単位形状をまとめてインスタンス描画する。
+ *       メインスレッドから呼ぶこと
+ */
 class LineManager {
 public:
 	static LineManager* GetInstance();
@@ -23,6 +29,8 @@ public:
     void DrawCube(const Vector3& center, float size, const Vector4& color);
 	//球の描画
 	void DrawSphere(const Vector3& center, float radius, const Vector4& color);
+	//円の描画（normalに垂直な平面上）
+	void DrawCircle(const Vector3& center, float radius, const Vector3& normal, const Vector4& color);
 	// グリッドの描画
     void DrawGrid(float gridSize, float gridSpacing, const Vector4& color);
 	// 矢印の描画
@@ -37,6 +45,7 @@ public:
 private:
     std::unique_ptr<LineCommon> lineCommon_; ///< LineCommon クラスのインスタンス
     std::unique_ptr<Line> line_;             ///< Line クラスのインスタンス
+    std::unique_ptr<LineShapeBatch> shapeBatch_; ///< デバッグ図形をまとめて描画するクラス
     DirectXCommon* dxCommon_ = nullptr;      ///< DirectXCommon クラスのインスタンス
 	CameraManager* cameraManager_ = nullptr; ///< CameraManager クラスのインスタンス
 
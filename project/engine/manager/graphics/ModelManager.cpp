@@ -1,5 +1,11 @@
 #include "ModelManager.h"
 
+#include <chrono>
+#include <sstream>
+
+#include "base/Logger.h"
+#include "graphics/3d/MeshCache.h"
+
 ModelManager* ModelManager::instance_ = nullptr;
 
 ModelManager* ModelManager::GetInstance()
@@ -36,14 +42,71 @@ void ModelManager::LoadModel(const std::string& filePath, const std::string& mod
 		return;
 	}
 
-	//モデルの生成とファイル読み込み、初期化
+	LoadRecord record;
+	ModelData modelData = ImportModelData(filePath, modelType, record);
+	AddModel(filePath, std::move(modelData), record);
+}
+
+ModelData ModelManager::ImportModelData(const std::string& filePath, const std::string& modelType, LoadRecord& outRecord) const
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+	auto elapsedMicroseconds = [&startTime]()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count());
+	};
+
+	std::string modelFilePath = filePath + "/" + filePath + modelType;
+	std::string cachePath = kCacheDirectory + "/" + filePath + modelType + MeshCache::kExtension;
+
+	outRecord = LoadRecord();
+	outRecord.name = filePath;
+
+	//元ファイルが変わっていなければキャッシュから読む
+	ModelData modelData;
+	uint64_t sourceHash = enableMeshCache_ ? MeshCache::HashSourceFiles(kModelDirectory + "/" + modelFilePath) : 0;
+	MeshCache::LoadInfo cacheInfo;
+	if (sourceHash != 0 && MeshCache::Load(cachePath, sourceHash, modelData, &cacheInfo))
+	{
+		outRecord.isFromCache = true;
+		outRecord.importMicroseconds = cacheInfo.importMicroseconds;
+		outRecord.loadMicroseconds = elapsedMicroseconds();
+	}
+	else
+	{
+		//Assimpで読み込んで、次回のためにキャッシュを作る
+		modelData = Model::LoadModelFile(kModelDirectory, modelFilePath);
+		outRecord.importMicroseconds = elapsedMicroseconds();
+		outRecord.loadMicroseconds = outRecord.importMicroseconds;
+		if (sourceHash != 0 && !MeshCache::Save(cachePath, sourceHash, modelData, outRecord.importMicroseconds))
+		{
+			Logger::Log("Failed to write mesh cache: " + cachePath + "\n");
+		}
+	}
+	return modelData;
+}
+
+void ModelManager::AddModel(const std::string& filePath, ModelData&& modelData, const LoadRecord& record)
+{
+	if (models_.contains(filePath))
+	{
+		return;
+	}
+	loadRecords_.push_back(record);
+
+	//モデルの生成と初期化
 	std::unique_ptr<Model> model = std::make_unique<Model>();
-	model->Initialize(modelCommon_, "Resources/models", filePath,modelType);
+	model->Initialize(modelCommon_, kModelDirectory, filePath, std::move(modelData));
 
 	//モデルをmapコンテナに格納する
 	models_.insert(std::make_pair(filePath, std::move(model)));
 }
 
+std::string ModelManager::GetTextureFilePath(const std::string& filePath, const ModelData& modelData)
+{
+	//Model::Initializeと同じ規則でモデルのフォルダからのパスにする
+	return kModelDirectory + "/" + filePath + "/" + modelData.material.textureFilePath;
+}
+
 Model* ModelManager::FindModel(const std::string& filePath)
 {
 	//読み込み済みモデルを検索
@@ -56,3 +119,25 @@ Model* ModelManager::FindModel(const std::string& filePath)
 	//ファイル名一致なし
 	return nullptr;
 }
+
+void ModelManager::LogLoadReport() const
+{
+	uint64_t totalLoad = 0;
+	uint64_t totalImport = 0;
+	std::stringstream ss;
+	ss << "Model load report\n";
+	for (const LoadRecord& record : loadRecords_)
+	{
+		ss << "  " << record.name << (record.isFromCache ? " [cache] " : " [assimp] ")
+			<< record.loadMicroseconds / 1000.0 << "ms";
+		if (record.isFromCache)
+		{
+			ss << " (assimp " << record.importMicroseconds / 1000.0 << "ms)";
+		}
+		ss << "\n";
+		totalLoad += record.loadMicroseconds;
+		totalImport += record.importMicroseconds;
+	}
+	ss << "  total " << totalLoad / 1000.0 << "ms, assimp import " << totalImport / 1000.0 << "ms\n";
+	Logger::Log(ss.str());
+}
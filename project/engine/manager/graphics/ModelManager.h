@@ -2,6 +2,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 // system
 #include "graphics/3d/Model.h"
@@ -9,6 +10,16 @@
 
 class ModelManager
 {
+public: /*========[ 構造体 ]========*/
+	//読み込みの記録
+	struct LoadRecord
+	{
+		std::string name;
+		bool isFromCache = false;
+		uint64_t loadMicroseconds = 0;		//今回の読み込み時間（ハッシュ計算を含む）
+		uint64_t importMicroseconds = 0;	//Assimpでの読み込み時間
+	};
+
 public: /*========[ メンバ関数 ]========*/
 	//シングルトンのインスタンスを取得
 	static ModelManager* GetInstance();
@@ -32,6 +43,36 @@ public: /*========[ メンバ関数 ]========*/
 	 */
 	Model* FindModel(const std::string& filePath);
 
+	/// \brief 読み込み済みか
+	bool IsLoaded(const std::string& filePath) const { return models_.contains(filePath); }
+
+	/**
+	 * \brief モデルデータをキャッシュかAssimpから読み込む
+	 * \note GPUもモデルの一覧も触らないので、ワーカースレッドから呼べる
+	 * \param outRecord 読み込み時間などの記録
+	 */
+	ModelData ImportModelData(const std::string& filePath, const std::string& modelType, LoadRecord& outRecord) const;
+
+	/**
+	 * \brief ImportModelDataで読み込んだデータからモデルを作って登録する
+	 * \note GPUのバッファを作るので、メインスレッドから呼ぶ
+	 */
+	void AddModel(const std::string& filePath, ModelData&& modelData, const LoadRecord& record);
+
+	/// \brief モデルが参照しているテクスチャのパス（TextureManagerに登録される名前）
+	static std::string GetTextureFilePath(const std::string& filePath, const ModelData& modelData);
+
+	/**
+	 * \brief 読み込んだモデルごとの時間と、キャッシュを使ったかをログに出す
+	 * \note キャッシュから読んだモデルは、キャッシュを作った時のAssimpでの読み込み時間と比べる
+	 */
+	void LogLoadReport() const;
+
+public: /*========[ アクセッサ ]========*/
+	//メッシュキャッシュの有効無効（無効にすると毎回Assimpで読み込む）
+	void SetMeshCacheEnabled(bool enable) { enableMeshCache_ = enable; }
+	bool IsMeshCacheEnabled() const { return enableMeshCache_; }
+
 private: /*========[ シングルトン ]========*/
 	static ModelManager* instance_;
 	
@@ -47,5 +88,15 @@ private: /*========[ メンバ変数 ]========*/
 
 	//モデルデータ
 	std::map<std::string, std::unique_ptr<Model>> models_;
+
+	//モデルファイルとキャッシュの置き場所
+	static inline const std::string kModelDirectory = "Resources/models";
+	static inline const std::string kCacheDirectory = "Resources/cache/models";
+
+	//メッシュキャッシュ
+	bool enableMeshCache_ = true;
+
+	//読み込みの記録
+	std::vector<LoadRecord> loadRecords_;
 };
 
@@ -1,11 +1,11 @@
 #include "TextureManager.h"
 
+#include <algorithm>
+
 // system
+#include "base/JobSystem.h"
+#include "base/Logger.h"
 #include "base/StringUtility.h"
-#include "externals/DirectXTex/d3dx12.h"
-
-// ImGuiで0番を使用するため、1番から開始
-uint32_t TextureManager::kSRVIndexTop = 1;
 
 //テクスチャマネージャーのインスタンス
 TextureManager* TextureManager::instance_ = nullptr;
@@ -29,25 +29,116 @@ void TextureManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 {
 	dxCommon_ = dxCommon;
 	srvManager_ = srvManager;
-	textureDatas_.reserve(srvManager_->kMaxSRVCount);
+	textureDatas_.reserve(srvManager_->kInitialSRVCount);
+
+	//コピーキューの用意
+	uploader_ = std::make_unique<TextureUploader>();
+	uploader_->Initialize(dxCommon_);
+
+	//転送中に使う代わりのテクスチャは、最初に転送を終わらせておく
+	CreateFallbackTexture(fallback2D_, false);
+	CreateFallbackTexture(fallbackCube_, true);
+	uploader_->WaitIdle();
+
+	//変換済みのテクスチャがあれば、元画像の代わりに読む
+	cookedTextures_.Load();
+	if (cookedTextures_.GetEntryCount() > 0)
+	{
+		Logger::Log("Cooked texture manifest: " + std::to_string(cookedTextures_.GetEntryCount()) + " textures\n");
+	}
 }
 
-void TextureManager::LoadTexture(const std::string& filePath)
+void TextureManager::Update()
+{
+	/*--------------[ デコードが終わったテクスチャの転送を積む ]-----------------*/
+
+	for (std::shared_ptr<PendingDecode>& pending : pendingDecodes_)
+	{
+		if (!pending->isDone.load(std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		if (FAILED(pending->result))
+		{
+			//読めなかったテクスチャは代わりのテクスチャのままにする
+			Logger::Log("Failed to load texture: " + pending->filePath + "\n");
+		}
+		else
+		{
+			BeginUpload(textureDatas_.at(pending->filePath), pending->mipImages);
+		}
+		pending.reset();
+	}
+	std::erase(pendingDecodes_, nullptr);
+
+	/*--------------[ 積んだ転送を実行し、終わったものを描画で使えるようにする ]-----------------*/
+
+	uploader_->Flush();
+	uploader_->Update();
+
+	std::erase_if(pendingUploads_, [this](const std::string& filePath)
+		{
+			TextureData& textureData = textureDatas_.at(filePath);
+			if (!uploader_->IsCompleted(textureData.uploadFenceValue))
+			{
+				return false;
+			}
+			//テクスチャ自身のSRVはGPUがまだ参照していないので、描画で使う番号を差し替えるだけでよい
+			textureData.drawSrvIndex = textureData.srvIndex;
+			textureData.isReady = true;
+			return true;
+		});
+}
+
+uint32_t TextureManager::LoadTexture(const std::string& filePath)
 {
 	/*--------------[ 読み込み済みテクスチャを検索 ]-----------------*/
 	if (textureDatas_.contains(filePath))
 	{
 		// 読み込み済みなら何もしない
-		return;
+		return textureDatas_.at(filePath).srvIndex;
 	}
 
-	// テクスチャ枚数上限チェック
-	assert(!srvManager_->IsMaxSRVCount());
+	DirectX::ScratchImage mipImages{};
+	HRESULT hr = DecodeTexture(filePath, mipImages);
+	assert(SUCCEEDED(hr));
+
+	CreateTexture(filePath, mipImages);
+	return textureDatas_.at(filePath).srvIndex;
+}
+
+uint32_t TextureManager::LoadTextureAsync(const std::string& filePath)
+{
+	if (textureDatas_.contains(filePath))
+	{
+		return textureDatas_.at(filePath).srvIndex;
+	}
 
+	//番号だけ先に決めて、デコードが終わるまでは代わりのテクスチャを使う（キューブマップを2Dとして参照しないよう種類は合わせる）
+	TextureData& textureData = RegisterTexture(filePath, IsCubemapFile(filePath));
+
+	std::shared_ptr<PendingDecode> pending = std::make_shared<PendingDecode>();
+	pending->filePath = filePath;
+	pendingDecodes_.push_back(pending);
+	JobSystem::GetInstance()->Submit([pending]()
+		{
+			pending->result = DecodeTexture(pending->filePath, pending->mipImages);
+			pending->isDone.store(true, std::memory_order_release);
+		});
+
+	return textureData.srvIndex;
+}
+
+HRESULT TextureManager::DecodeTexture(const std::string& filePath, DirectX::ScratchImage& outMipImages)
+{
 	/*--------------[ テクスチャファイルを読んでプログラムで扱えるようにする ]-----------------*/
 
+	//元画像が変わっていなければ、ミップマップまで作ってある変換済みのDDSを読む（マニフェストは初期化後に書き換わらないのでワーカーから読める）
+	std::string loadPath = instance_ ? instance_->ResolveLoadPath(filePath) : filePath;
+
 	DirectX::ScratchImage image{};
-	std::wstring filePathW = StringUtility::ConvertString(filePath);
+	std::wstring filePathW = StringUtility::ConvertString(loadPath);
 	HRESULT hr;
 	if (filePathW.ends_with(L".dds"))
 	{
@@ -68,52 +159,97 @@ void TextureManager::LoadTexture(const std::string& filePath)
 			image
 		);
 	}
-	assert(SUCCEEDED(hr));
+	if (FAILED(hr))
+	{
+		return hr;
+	}
 
 	/*--------------[ ミップマップの作成 ]-----------------*/
 
-	DirectX::ScratchImage mipImages{};
-	if (DirectX::IsCompressed(image.GetMetadata().format))
+	if (DirectX::IsCompressed(image.GetMetadata().format) || image.GetMetadata().mipLevels > 1)
 	{
-		// 圧縮フォーマットならそのまま使うのでmoveする
-		mipImages = std::move(image);
+		// 圧縮フォーマットか、ミップマップを持っているならそのまま使うのでmoveする
+		outMipImages = std::move(image);
+		return S_OK;
 	}
-	else
+
+	return DirectX::GenerateMipMaps(
+		image.GetImages(),
+		image.GetImageCount(),
+		image.GetMetadata(),
+		DirectX::TEX_FILTER_SRGB,
+		0,
+		outMipImages
+	);
+}
+
+void TextureManager::CreateTexture(const std::string& filePath, const DirectX::ScratchImage& mipImages)
+{
+	if (textureDatas_.contains(filePath))
 	{
-		hr = DirectX::GenerateMipMaps(
-			image.GetImages(),
-			image.GetImageCount(),
-			image.GetMetadata(),
-			DirectX::TEX_FILTER_SRGB,
-			0,
-			mipImages
-		);
+		// 読み込み済みなら何もしない
+		return;
 	}
-	assert(SUCCEEDED(hr));
 
 	/*--------------[ テクスチャデータを追加 ]-----------------*/
 
-	// 追加したテクスチャデータの参照を取得する
-	TextureData& textureData = textureDatas_[filePath];
+	TextureData& textureData = RegisterTexture(filePath, mipImages.GetMetadata().IsCubemap());
 
 	/*--------------[ テクスチャデータの書き込み ]-----------------*/
 
-	textureData.metadata = mipImages.GetMetadata();
-	textureData.resource = dxCommon_->CreateTextureResource(textureData.metadata);
-	textureData.intermediate = UploadTextureData(textureData.resource, mipImages);
+	BeginUpload(textureData, mipImages);
+}
 
-	/*--------------[ ディスクリプタハンドルの計算 ]-----------------*/
+bool TextureManager::IsReady(const std::string& filePath) const
+{
+	auto it = textureDatas_.find(filePath);
+	return it != textureDatas_.end() && it->second.isReady;
+}
 
-	// テクスチャデータの要素数番号をSRVのインデックスとする
-	uint32_t srvIndex = static_cast<uint32_t>(textureDatas_.size() - 1) + kSRVIndexTop;
+uint32_t TextureManager::GetTextureIndexByFilePath(const std::string& filePath)
+{
+	assert(filePathToIndex_.contains(filePath)); // 存在確認
+	return filePathToIndex_[filePath];
+}
+
+const DirectX::TexMetadata& TextureManager::GetMetadata(uint32_t textureIndex) const
+{
+	// インデックスがマッピング内に存在するか確認
+	assert(indexToFilePath_.contains(textureIndex));
+	const std::string& filePath = indexToFilePath_.at(textureIndex);
+	return textureDatas_.at(filePath).metadata;
+}
 
-	textureData.srvHandleCPU = GetSrvHandleCPU(srvIndex);
-	textureData.srvHandleGPU = GetSrvHandleGPU(srvIndex);
+TextureManager::TextureData& TextureManager::RegisterTexture(const std::string& filePath, bool isCubemap)
+{
+	// テクスチャ枚数上限チェック
+	assert(!srvManager_->IsMaxSRVCount());
 
-	/*--------------[ SRVの生成 ]-----------------*/
+	// 追加したテクスチャデータの参照を取得する
+	TextureData& textureData = textureDatas_[filePath];
+
+	/*--------------[ SRVの番号を決める ]-----------------*/
 
 	textureData.srvIndex = srvManager_->Allocate();
+	SetFallbackHandles(textureData, isCubemap);
+
+	/*--------------[ インデックス管理用マッピング ]-----------------*/
+
+	filePathToIndex_[filePath] = textureData.srvIndex;
+	indexToFilePath_[textureData.srvIndex] = filePath;
+
+	return textureData;
+}
+
+void TextureManager::BeginUpload(TextureData& textureData, const DirectX::ScratchImage& mipImages)
+{
+	textureData.metadata = mipImages.GetMetadata();
+	textureData.resource = dxCommon_->CreateTextureResource(textureData.metadata);
+	textureData.uploadFenceValue = uploader_->Enqueue(textureData.resource.Get(), mipImages);
 
+	/*--------------[ SRVの生成 ]-----------------*/
+
+	//このSRVは転送が終わるまで描画に使わないので、今作っておいてよい
 	if(textureData.metadata.IsCubemap())
 	{
 		// キューブマップテクスチャの場合はキューブマップ用のSRVを生成
@@ -125,45 +261,64 @@ void TextureManager::LoadTexture(const std::string& filePath)
 		srvManager_->CreateSRVforTexture2D(textureData.srvIndex, textureData.resource.Get(), textureData.metadata.format, static_cast<UINT>(textureData.metadata.mipLevels));
 	}
 
-	textureData.srvHandleCPU = srvManager_->GetCPUDescriptorHandle(textureData.srvIndex);
-	textureData.srvHandleGPU = srvManager_->GetGPUDescriptorHandle(textureData.srvIndex);
+	//非同期読み込みで先に代わりの番号を入れていた場合も、種類を合わせておく
+	SetFallbackHandles(textureData, textureData.metadata.IsCubemap());
 
-	/*--------------[ インデックス管理用マッピング ]-----------------*/
+	//転送が終わったら描画で使う番号を差し替える
+	pendingUploads_.push_back(indexToFilePath_.at(textureData.srvIndex));
+}
 
-	filePathToIndex_[filePath] = textureData.srvIndex;
-	indexToFilePath_[textureData.srvIndex] = filePath;
+void TextureManager::CreateFallbackTexture(FallbackTexture& fallback, bool isCubemap)
+{
+	//白の1x1（キューブマップなら6面）
+	DirectX::ScratchImage image{};
+	HRESULT hr = isCubemap
+		? image.InitializeCube(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 1, 1, 1, 1)
+		: image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 1, 1, 1, 1);
+	assert(SUCCEEDED(hr));
+	std::fill_n(image.GetPixels(), image.GetPixelsSize(), uint8_t(0xFF));
+
+	fallback.metadata = image.GetMetadata();
+	fallback.resource = dxCommon_->CreateTextureResource(fallback.metadata);
+	uploader_->Enqueue(fallback.resource.Get(), image);
+
+	fallback.srvIndex = srvManager_->Allocate();
+	if (isCubemap)
+	{
+		srvManager_->CreateSRVforTexture2DCubeMap(fallback.srvIndex, fallback.resource.Get(), fallback.metadata.format, 1);
+	}
+	else
+	{
+		srvManager_->CreateSRVforTexture2D(fallback.srvIndex, fallback.resource.Get(), fallback.metadata.format, 1);
+	}
 }
 
-uint32_t TextureManager::GetTextureIndexByFilePath(const std::string& filePath)
+void TextureManager::SetFallbackHandles(TextureData& textureData, bool isCubemap)
 {
-	assert(filePathToIndex_.contains(filePath)); // 存在確認
-	return filePathToIndex_[filePath];
+	const FallbackTexture& fallback = isCubemap ? fallbackCube_ : fallback2D_;
+	textureData.drawSrvIndex = fallback.srvIndex;
+	//デコード前はメタデータも代わりのテクスチャのものにしておく
+	if (!textureData.resource)
+	{
+		textureData.metadata = fallback.metadata;
+	}
 }
 
-const DirectX::TexMetadata& TextureManager::GetMetadata(uint32_t textureIndex)
+std::string TextureManager::ResolveLoadPath(const std::string& filePath) const
 {
-	// インデックスがマッピング内に存在するか確認
-	assert(indexToFilePath_.contains(textureIndex));
-	const std::string& filePath = indexToFilePath_[textureIndex];
-	return textureDatas_.at(filePath).metadata;
+	std::string cookedPath = cookedTextures_.FindCookedPath(filePath);
+	return cookedPath.empty() ? filePath : cookedPath;
 }
 
-[[nodiscard]]
-Microsoft::WRL::ComPtr<ID3D12Resource> TextureManager::UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages)
-{
-	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-	DirectX::PrepareUpload(dxCommon_->GetDevice(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
-	uint64_t intermediateSize = GetRequiredIntermediateSize(texture.Get(), 0, UINT(subresources.size()));
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource = dxCommon_->CreateBufferResource(intermediateSize);
-	UpdateSubresources(dxCommon_->GetCommandList(), texture.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
-	// Textureへの転送後は利用できるよう、D3D12_RESOURCE_STATE_COPY_DESTからD3D12_RESOURCE_STATE_GENERIC_READへResourceStateを変更する
-	D3D12_RESOURCE_BARRIER barrier{};
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource = texture.Get();
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
-	dxCommon_->GetCommandList()->ResourceBarrier(1, &barrier);
-	return intermediateResource;
+bool TextureManager::IsCubemapFile(const std::string& filePath) const
+{
+	std::wstring filePathW = StringUtility::ConvertString(ResolveLoadPath(filePath));
+	if (!filePathW.ends_with(L".dds"))
+	{
+		return false;
+	}
+
+	DirectX::TexMetadata metadata{};
+	HRESULT hr = DirectX::GetMetadataFromDDSFile(filePathW.c_str(), DirectX::DDS_FLAGS_NONE, metadata);
+	return SUCCEEDED(hr) && metadata.IsCubemap();
 }
@@ -1,15 +1,21 @@
 #pragma once
+#include <atomic>
 #include <d3d12.h>
+#include <memory>
 #include <string>
+#include <vector>
 #include <wrl.h>
 #include <unordered_map>
 
 // system
 #include "base/DirectXCommon.h"
+#include "base/TextureCooker.h"
+#include "base/TextureUploader.h"
 #include "manager/system/SrvManager.h"
 
 /**
  * \brief テクスチャマネージャー
+ * \note GPUへの転送はコピーキューで行い、転送が終わるまでは代わりの白いテクスチャを描画に使う
  */
 class TextureManager
 {
@@ -20,23 +26,74 @@ public:
 	void Finalize();
 	/// \brief 初期化
 	void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager);
-	/// \brief テクスチャの読み込み
-	void LoadTexture(const std::string& filePath);
+
+	/**
+	 * \brief 毎フレームの更新
+	 * \note デコードが終わったテクスチャの転送を積み、転送が終わったテクスチャを描画で使えるようにする
+	 */
+	void Update();
+
+	/**
+	 * \brief テクスチャの読み込み
+	 * \note デコードはその場で行い、GPUへの転送はコピーキューに任せる
+	 * \return テクスチャの番号（すぐに描画に使える）
+	 */
+	uint32_t LoadTexture(const std::string& filePath);
+
+	/**
+	 * \brief テクスチャをワーカースレッドで読み込む
+	 * \note デコードが終わるまでは、メタデータも代わりのテクスチャ（1x1）のものになる。
+	 *       DDSはヘッダーだけ先に読み、キューブマップなら代わりもキューブマップにする。
+	 *       読み込み直後に大きさが必要なテクスチャにはLoadTextureを使う
+	 * \return テクスチャの番号（すぐに描画に使える）
+	 */
+	uint32_t LoadTextureAsync(const std::string& filePath);
+
+	/**
+	 * \brief 画像ファイルを読み込んでミップマップを作る
+	 * \note GPUを使わないので、ワーカースレッドから呼べる。変換済みのDDSがあればそちらを読む
+	 * \param outMipImages ミップマップまで作った画像
+	 */
+	static HRESULT DecodeTexture(const std::string& filePath, DirectX::ScratchImage& outMipImages);
+
+	/**
+	 * \brief DecodeTextureで作った画像からテクスチャとSRVを作る
+	 * \note 転送をコピーキューに積むので、メインスレッドから呼ぶ
+	 */
+	void CreateTexture(const std::string& filePath, const DirectX::ScratchImage& mipImages);
+
+	/// \brief 積んだ転送をすぐにコピーキューで実行する（Updateでも実行される）
+	void FlushUploads() { uploader_->Flush(); }
+
+	/// \brief 読み込み済みか（転送中も含む）
+	bool IsLoaded(const std::string& filePath) const { return textureDatas_.contains(filePath); }
+
+	/// \brief GPUへの転送まで終わって、本来のテクスチャで描画できるか
+	bool IsReady(const std::string& filePath) const;
 
 public: //アクセッサ
 	/// \brief SRVインデックスの開始番号
 	uint32_t GetTextureIndexByFilePath(const std::string& filePath);
 	//メタデータの取得
-	const DirectX::TexMetadata& GetMetadata(uint32_t textureIndex);
-	const DirectX::TexMetadata& GetMetadata(const std::string& filePath) { return textureDatas_[filePath].metadata; }
+	const DirectX::TexMetadata& GetMetadata(uint32_t textureIndex) const;
+	const DirectX::TexMetadata& GetMetadata(const std::string& filePath) const { return textureDatas_.at(filePath).metadata; }
 	//SRVインデックスの取得
-	uint32_t GetSRVIndex(const std::string& filePath) { return textureDatas_[filePath].srvIndex; }
-	//GPUハンドルの取得
-	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(const std::string& filePath) { return textureDatas_[filePath].srvHandleGPU; }
-	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex) { return textureDatas_[indexToFilePath_[textureIndex]].srvHandleGPU; }
+	uint32_t GetSRVIndex(const std::string& filePath) const { return textureDatas_.at(filePath).srvIndex; }
+	//GPUハンドルの取得（転送が終わるまでは代わりのテクスチャのハンドル）
+	//描画の記録中はワーカースレッドからも呼ばれるので、ここから下はマップに要素を足さない（operator[]を使わない）
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(const std::string& filePath) const { return srvManager_->GetGPUDescriptorHandle(textureDatas_.at(filePath).drawSrvIndex); }
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex) const { return srvManager_->GetGPUDescriptorHandle(GetDrawSrvIndex(textureIndex)); }
+	//描画で使うSRVの番号の取得（転送が終わるまでは代わりのテクスチャの番号。ヒープ全体を指すテーブルの添字に使う）
+	uint32_t GetDrawSrvIndex(uint32_t textureIndex) const { return textureDatas_.at(indexToFilePath_.at(textureIndex)).drawSrvIndex; }
+	//代わりのテクスチャのGPUハンドルの取得（白の1x1）
+	D3D12_GPU_DESCRIPTOR_HANDLE GetFallbackSrvHandleGPU(bool isCubemap) const { return srvManager_->GetGPUDescriptorHandle(isCubemap ? fallbackCube_.srvIndex : fallback2D_.srvIndex); }
 	//CPUハンドルの取得
-	D3D12_CPU_DESCRIPTOR_HANDLE GetSrvHandleCPU(const std::string& filePath) { return textureDatas_[filePath].srvHandleCPU; }
-	D3D12_CPU_DESCRIPTOR_HANDLE GetSrvHandleCPU(uint32_t textureIndex) { return textureDatas_[indexToFilePath_[textureIndex]].srvHandleCPU; }
+	D3D12_CPU_DESCRIPTOR_HANDLE GetSrvHandleCPU(const std::string& filePath) const { return srvManager_->GetCPUDescriptorHandle(textureDatas_.at(filePath).drawSrvIndex); }
+	D3D12_CPU_DESCRIPTOR_HANDLE GetSrvHandleCPU(uint32_t textureIndex) const { return srvManager_->GetCPUDescriptorHandle(GetDrawSrvIndex(textureIndex)); }
+
+	//転送の統計
+	const TextureUploader& GetUploader() const { return *uploader_; }
+	size_t GetPendingUploadCount() const { return pendingUploads_.size(); }
 
 private: //構造体
 	/// \brief テクスチャデータ
@@ -44,10 +101,27 @@ private: //構造体
 	{
 		DirectX::TexMetadata metadata;
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
-		Microsoft::WRL::ComPtr<ID3D12Resource> intermediate;
-		uint32_t srvIndex;
-		D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU;
-		D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU;
+		uint32_t srvIndex;								//テクスチャ自身のSRV
+		uint32_t drawSrvIndex;							//描画で使うSRV（転送が終わるまでは代わりのテクスチャ。ヒープが作り直されてもよいようにハンドルは持たない）
+		uint64_t uploadFenceValue = 0;					//転送の完了を判定するフェンス値
+		bool isReady = false;
+	};
+
+	/// \brief ワーカースレッドでのデコード結果
+	struct PendingDecode
+	{
+		std::string filePath;
+		DirectX::ScratchImage mipImages;
+		HRESULT result = E_FAIL;
+		std::atomic<bool> isDone = false;
+	};
+
+	/// \brief 転送が終わるまで使う代わりのテクスチャ
+	struct FallbackTexture
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		DirectX::TexMetadata metadata;
+		uint32_t srvIndex = 0;
 	};
 
 	//テクスチャデータ
@@ -58,15 +132,24 @@ private: //構造体
 	std::unordered_map<uint32_t, std::string> indexToFilePath_;
 
 private: //メンバ関数
-	
-	/**
-	 * \brief 
-	 * \param texture テクスチャリソースの転送
-	 * \param mipImages 
-	 * \return 
-	 */
-	[[nodiscard]]
-	Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(Microsoft::WRL::ComPtr<ID3D12Resource> texture, const DirectX::ScratchImage& mipImages);
+
+	/// \brief テクスチャデータとSRVの番号を用意し、代わりのテクスチャのハンドルを入れておく
+	TextureData& RegisterTexture(const std::string& filePath, bool isCubemap);
+
+	/// \brief リソースを作って転送を積み、テクスチャ自身のSRVを作る
+	void BeginUpload(TextureData& textureData, const DirectX::ScratchImage& mipImages);
+
+	/// \brief 代わりのテクスチャを作る（白の1x1）
+	void CreateFallbackTexture(FallbackTexture& fallback, bool isCubemap);
+
+	/// \brief 代わりのテクスチャのハンドルを設定する
+	void SetFallbackHandles(TextureData& textureData, bool isCubemap);
+
+	/// \brief 実際に読むファイルのパス（変換済みのDDSがあればそちら）
+	std::string ResolveLoadPath(const std::string& filePath) const;
+
+	/// \brief DDSのヘッダーだけを読んでキューブマップか調べる（DDS以外はfalse）
+	bool IsCubemapFile(const std::string& filePath) const;
 
 private: //メンバ変数
 	//DirectXコマンド
@@ -75,8 +158,20 @@ private: //メンバ変数
 	//SRVマネージャー
 	SrvManager* srvManager_ = nullptr;
 
-	//SRVインデックスの開始番号
-	static uint32_t kSRVIndexTop;
+	//コピーキューでの転送
+	std::unique_ptr<TextureUploader> uploader_;
+
+	//変換済みテクスチャのマニフェスト
+	TextureCooker::Manifest cookedTextures_;
+
+	//代わりのテクスチャ
+	FallbackTexture fallback2D_;
+	FallbackTexture fallbackCube_;
+
+	//デコード中のテクスチャ
+	std::vector<std::shared_ptr<PendingDecode>> pendingDecodes_;
+	//転送中のテクスチャ
+	std::vector<std::string> pendingUploads_;
 
 private: //シングルトンインスタンス
 	static TextureManager* instance_;
@@ -89,4 +184,3 @@ private: //シングルトンインスタンス
 
 
 };
-
@@ -1,14 +1,32 @@
 #include "LightManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <numbers>
 #include "DirectXTex/d3dx12.h"
 // system
+#include "base/Camera.h"
 #include "base/Logger.h"
 // math
 #include "math/Easing.h"
 // editor
 #include "externals/imgui/imgui.h"
 
+namespace
+{
+	// 削除で空いた番号に末尾の要素を移して、末尾を消す
+	template <class T>
+	void RemoveSwapBack(std::vector<T>& values, uint32_t index)
+	{
+		if (index + 1 != values.size())
+		{
+			values[index] = std::move(values.back());
+		}
+		values.pop_back();
+	}
+}
+
 LightManager::LightManager()
 {
 	//ライトの数を初期化
@@ -18,38 +36,33 @@ LightManager::LightManager()
 
 LightManager::~LightManager()
 {
-	if (lightCountResource_)
-	{
-		lightCountResource_->Unmap(0, nullptr);
-	}
-	if (pointLightResource_)
-	{
-		pointLightResource_->Unmap(0, nullptr);
-	}
-	if (spotLightResource_)
-	{
-		spotLightResource_->Unmap(0, nullptr);
-	}
 }
 
-void LightManager::Initialize(DirectXCommon* dxCommon)
+void LightManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 {
 	dxCommon_ = dxCommon;
-	//定数バッファの作成
-	CreateConstantBuffer();
+
+	//スポットライトの影のアトラス
+	shadowAtlas_.Initialize(dxCommon_, srvManager);
+
+	//フレームごとのライトのバッファ（最大数分を確保しておく）
+	pointLightBuffer_.Create(dxCommon_, sizeof(GPUPointLight), LightMaxCount::kMaxPointLightCount);
+	spotLightBuffer_.Create(dxCommon_, sizeof(GPUSpotLight), LightMaxCount::kMaxSpotLightCount);
+	pointLightData_.reserve(LightMaxCount::kMaxPointLightCount);
+	spotLightData_.reserve(LightMaxCount::kMaxSpotLightCount);
 
 	//イージング関数の設定
 	pEasingFunc_ = EaseInSine<float>;
 
 	//ポイントライトの追加
-	AddPointLight("pointLight" + std::to_string(pointLights_.size()));
+	PointLightHandle pointLight = AddPointLight("pointLight" + std::to_string(pointLightData_.size()));
 
 	//スポットライトの追加
-	AddSpotLight("spotLight" + std::to_string(spotLights_.size()));
+	SpotLightHandle spotLight = AddSpotLight("spotLight" + std::to_string(spotLightData_.size()));
 
 	//グラデーションしてみる
-	StartGradient("pointLight0", startPointLightColor_, endPointLightColor_, duration_, pEasingFunc_);
-	StartGradient("spotLight0", startSpotLightColor_, endSpotLightColor_, duration_, pEasingFunc_);
+	StartGradient(pointLight, startPointLightColor_, endPointLightColor_, duration_, pEasingFunc_);
+	StartGradient(spotLight, startSpotLightColor_, endSpotLightColor_, duration_, pEasingFunc_);
 
 }
 
@@ -61,85 +74,67 @@ void LightManager::Update()
 	// フレーム間の経過時間を取得（例として固定値を使用）
 	float deltaTime = 1.0f / 60.0f;  // 60FPSの場合
 
-	// ポイントライトの更新
-	for (auto& [name, light] : pointLights_) {
-		if (light.isGradientActive) {
-			// 経過時間を更新
-			light.elapsedTime += deltaTime;
-			if (light.elapsedTime > light.duration) {
-				light.elapsedTime = 0.0f;
-				light.isReversing = !light.isReversing;  // 補間の方向を反転
-			}
-			// 補間係数の計算
-			float t = light.elapsedTime / light.duration;
-			t = light.easingFunction(t);  // イージング関数を適用
-			// 色の補間
-			if (light.isReversing) {
-				light.gpuData.color = Vector4::Lerp(light.endColor, light.startColor, t);
-			} else {
-				light.gpuData.color = Vector4::Lerp(light.startColor, light.endColor, t);
-			}
-		}
-	}
+	// グラデーションの更新
+	UpdateGradients(deltaTime);
+}
 
-	// スポットライトの更新
-	for (auto& [name, light] : spotLights_) {
-		if (light.isGradientActive) {
-			// 経過時間を更新
-			light.elapsedTime += deltaTime;
-			if (light.elapsedTime > light.duration) {
-				light.elapsedTime = 0.0f;
-				light.isReversing = !light.isReversing;  // 補間の方向を反転
-			}
-			// 補間係数の計算
-			float t = light.elapsedTime / light.duration;
-			t = light.easingFunction(t);  // イージング関数を適用
-			// 色の補間
-			if (light.isReversing) {
-				light.gpuData.color = Vector4::Lerp(light.endColor, light.startColor, t);
-			} else {
-				light.gpuData.color = Vector4::Lerp(light.startColor, light.endColor, t);
-			}
-		}
+void LightManager::PrepareDraw(const Camera* camera)
+{
+	//クラスタを使うなら、書き込むのと同じ順番でライトを振り分けに追加する
+	const bool useClusters = enableClustering_ && camera != nullptr;
+	if (useClusters)
+	{
+		lightCluster_.SetProjection(camera->GetFovY(), camera->GetAspectRatio(), camera->GetNearClip(), camera->GetFarClip(),
+			static_cast<float>(WinApp::kClientWidth), static_cast<float>(WinApp::kClientHeight));
+		lightCluster_.Begin(camera->GetViewMatrix());
 	}
 
 	// GPUに送るデータを更新
-	uint32_t pointLightIndex = 0;
-	for (const auto& [name, light] : pointLights_) {
-		pointLightData_[pointLightIndex++] = light.gpuData;
-	}
+	UploadLightData(useClusters);
 
-	uint32_t spotLightIndex = 0;
-	for (const auto& [name, light] : spotLights_) {
-		spotLightData_[spotLightIndex++] = light.gpuData;
-	}
-
-	lightCount_.pointLightCount = pointLightIndex;
-	lightCount_.spotLightCount = spotLightIndex;
+	// クラスタに振り分けて書き込む
+	UploadLightClusters(useClusters);
 
-	// 定数バッファにライトの数を更新
-	lightCountData_->pointLightCount = lightCount_.pointLightCount;
-	lightCountData_->spotLightCount = lightCount_.spotLightCount;
+	// 画面上での大きさに応じて影のタイルを割り当てる
+	shadowAtlas_.AssignTiles(camera, spotLightData_.data(), spotShadowStates_.data(), static_cast<uint32_t>(spotLightData_.size()));
+}
 
+const std::vector<ShadowAtlas::RenderRequest>& LightManager::CollectShadowRenderRequests(const std::vector<ShadowCaster>& casters)
+{
+	return shadowAtlas_.CollectRenderRequests(casters, spotShadowStates_.data(), static_cast<uint32_t>(spotShadowStates_.size()));
 }
 
 void LightManager::Draw()
 {
 	//ポイントライトのCBVを設定
-	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(5, pointLightResource_->GetGPUVirtualAddress());
+	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(5, pointLightAddress_);
 	//スポットライトのCBVを設定
-	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(6, spotLightResource_->GetGPUVirtualAddress());
+	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(6, spotLightAddress_);
 	//ライトの数のCBVを設定
-	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(7, lightCountResource_->GetGPUVirtualAddress());
+	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(7, lightCountAddress_);
+	//クラスタの設定
+	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(9, clusterParamsAddress_);
+	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(10, clusterRangeAddress_);
+	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(11, clusterIndexAddress_);
+	//スポットライトの影
+	dxCommon_->GetCommandList()->SetGraphicsRootShaderResourceView(12, shadowAtlas_.GetShadowDataAddress());
+	dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(13, shadowAtlas_.GetSrvHandleGPU());
 }
 
-void LightManager::AddPointLight(const std::string& name)
+PointLightHandle LightManager::AddPointLight(const std::string& name)
 {
+	//同じ名前があればそれを返す
+	auto it = pointLightHandles_.find(name);
+	if (it != pointLightHandles_.end())
+	{
+		return it->second;
+	}
+
 	//最大個数に達している場合は追加しない
-	if (pointLights_.size() >= LightMaxCount::kMaxPointLightCount)
+	if (pointLightData_.size() >= LightMaxCount::kMaxPointLightCount)
 	{
 		Logger::Log("ポイントライトの最大数に達しているため追加できません\n");
-		return;
+		return {};
 	}
 
 	//ポイントライトを作成と初期化
@@ -149,136 +144,416 @@ void LightManager::AddPointLight(const std::string& name)
 	pointLight.intensity = 1.0f;
 	pointLight.radius = 3.0f;
 	pointLight.decay = 1.0f;
-	pointLights_.emplace(name, pointLight);
-	//名前を保存
+
+	PointLightHandle handle{ pointSlots_.Insert() };
+	pointLightData_.push_back(pointLight);
 	pointLightNames_.push_back(name);
-	//ライトの数をインクリメント
-	++lightCount_.pointLightCount;
+	pointLightHandles_.emplace(name, handle);
+	MarkPointLightDirty(static_cast<uint32_t>(pointLightData_.size() - 1));
+	return handle;
 }
 
-void LightManager::AddSpotLight(const std::string& name)
+SpotLightHandle LightManager::AddSpotLight(const std::string& name)
 {
+	//同じ名前があればそれを返す
+	auto it = spotLightHandles_.find(name);
+	if (it != spotLightHandles_.end())
+	{
+		return it->second;
+	}
+
 	//最大個数に達している場合は追加しない
-	if (spotLights_.size() >= LightMaxCount::kMaxSpotLightCount)
+	if (spotLightData_.size() >= LightMaxCount::kMaxSpotLightCount)
 	{
 		Logger::Log("スポットライトの最大数に達しているため追加できません\n");
-		return;
+		return {};
 	}
 
 	// スポットライトを作成と初期化
-    CPUSpotLight spotLight;
-    spotLight.gpuData.color = { 1.0f, 1.0f, 1.0f, 1.0f };
-    spotLight.gpuData.position = { 0.0f, 1.0f, 0.0f };
-    spotLight.gpuData.distance = 7.0f;
-    spotLight.gpuData.intensity = 4.0f;
-    spotLight.gpuData.direction = Vector3::Normalize({ 0.0f, -1.0f, 1.0f });
-    spotLight.gpuData.cosAngle = std::cos(std::numbers::pi_v<float> / 3.0f);
-    spotLight.gpuData.decay = 2.0f;
-    spotLight.gpuData.cosFalloffStart = 1.0f;
-	spotLight.isGradientActive = false;
-
-    // シャドウマップ用のリソースを初期化
-    spotLight.InitializeShadowMap(dxCommon_->GetDevice());
-	//リストに追加
-	spotLights_.emplace(name, spotLight);
-	//名前を保存
+	GPUSpotLight spotLight;
+	spotLight.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+	spotLight.position = { 0.0f, 1.0f, 0.0f };
+	spotLight.distance = 7.0f;
+	spotLight.intensity = 4.0f;
+	spotLight.direction = Vector3::Normalize({ 0.0f, -1.0f, 1.0f });
+	spotLight.cosAngle = std::cos(std::numbers::pi_v<float> / 3.0f);
+	spotLight.decay = 2.0f;
+	spotLight.cosFalloffStart = 1.0f;
+
+	SpotLightHandle handle{ spotSlots_.Insert() };
+	spotLightData_.push_back(spotLight);
+	spotShadowStates_.emplace_back();
 	spotLightNames_.push_back(name);
-	//ライトの数をインクリメント
-	++lightCount_.spotLightCount;
+	spotLightHandles_.emplace(name, handle);
+	MarkSpotLightDirty(static_cast<uint32_t>(spotLightData_.size() - 1));
+	return handle;
+}
+
+void LightManager::RemovePointLight(PointLightHandle handle)
+{
+	StopGradient(LightType::Point, handle);
+	uint32_t index = pointSlots_.Remove(handle);
+	if (index == LightSlotTable::kInvalidIndex)
+	{
+		return;
+	}
+
+	//末尾のライトが空いた番号に移るので、その番号を書き直す
+	pointLightHandles_.erase(pointLightNames_[index]);
+	RemoveSwapBack(pointLightData_, index);
+	RemoveSwapBack(pointLightNames_, index);
+	if (index < pointLightData_.size())
+	{
+		MarkPointLightDirty(index);
+	}
+}
+
+void LightManager::RemoveSpotLight(SpotLightHandle handle)
+{
+	StopGradient(LightType::Spot, handle);
+	uint32_t index = spotSlots_.Remove(handle);
+	if (index == LightSlotTable::kInvalidIndex)
+	{
+		return;
+	}
+
+	spotLightHandles_.erase(spotLightNames_[index]);
+	shadowAtlas_.ReleaseTile(spotShadowStates_[index]);
+	RemoveSwapBack(spotLightData_, index);
+	RemoveSwapBack(spotShadowStates_, index);
+	RemoveSwapBack(spotLightNames_, index);
+	if (index < spotLightData_.size())
+	{
+		MarkSpotLightDirty(index);
+	}
 }
 
 void LightManager::Clear()
 {
-	pointLights_.clear();
-	spotLights_.clear();
+	ClearPointLights();
+	ClearSpotLights();
+}
+
+void LightManager::ClearPointLights()
+{
+	for (size_t i = gradients_.GetCount(); i-- > 0;)
+	{
+		if (gradients_.types[i] == LightType::Point)
+		{
+			gradients_.RemoveAt(i);
+		}
+	}
+	pointSlots_.Clear();
+	pointLightData_.clear();
 	pointLightNames_.clear();
+	pointLightHandles_.clear();
+}
+
+void LightManager::ClearSpotLights()
+{
+	for (size_t i = gradients_.GetCount(); i-- > 0;)
+	{
+		if (gradients_.types[i] == LightType::Spot)
+		{
+			gradients_.RemoveAt(i);
+		}
+	}
+	spotSlots_.Clear();
+	for (CPUSpotLight& state : spotShadowStates_)
+	{
+		shadowAtlas_.ReleaseTile(state);
+	}
+	spotLightData_.clear();
+	spotShadowStates_.clear();
 	spotLightNames_.clear();
-	lightCount_.pointLightCount = 0;
-	lightCount_.spotLightCount = 0;
+	spotLightHandles_.clear();
+}
+
+PointLightHandle LightManager::FindPointLight(const std::string& name) const
+{
+	auto it = pointLightHandles_.find(name);
+	return it != pointLightHandles_.end() ? it->second : PointLightHandle{};
+}
+
+SpotLightHandle LightManager::FindSpotLight(const std::string& name) const
+{
+	auto it = spotLightHandles_.find(name);
+	return it != spotLightHandles_.end() ? it->second : SpotLightHandle{};
 }
 
-void LightManager::StartGradient(const std::string& name, const Vector4& startColor, const Vector4& endColor, float duration, std::function<float(float)> easingFunction)
+void LightManager::StartGradient(PointLightHandle handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float))
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		auto& light = pointLights_.at(name);
-		light.startColor = startColor;
-		light.endColor = endColor;
-		light.duration = duration;
-		light.elapsedTime = 0.0f;
-		light.isReversing = false;
-		light.isGradientActive = true;
-		light.easingFunction = easingFunction;
-	} else if (spotLights_.find(name) != spotLights_.end()) {
-		auto& light = spotLights_.at(name);
-		light.startColor = startColor;
-		light.endColor = endColor;
-		light.duration = duration;
-		light.elapsedTime = 0.0f;
-		light.isReversing = false;
-		light.isGradientActive = true;
-		light.easingFunction = easingFunction;
-	} else {
-		Logger::Log("ライトが見つかりません: " + name);
+	if (ResolvePointLight(handle) != LightSlotTable::kInvalidIndex)
+	{
+		StartGradient(LightType::Point, handle, startColor, endColor, duration, easingFunction);
 	}
 }
 
-void LightManager::CreateConstantBuffer()
+void LightManager::StartGradient(SpotLightHandle handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float))
 {
-	/*--------------[ ライトの数リソースを作る ]-----------------*/
+	if (ResolveSpotLight(handle) != LightSlotTable::kInvalidIndex)
+	{
+		StartGradient(LightType::Spot, handle, startColor, endColor, duration, easingFunction);
+	}
+}
 
-	lightCountResource_ = dxCommon_->CreateBufferResource(sizeof(LightCount));
+void LightManager::StopGradient(PointLightHandle handle)
+{
+	StopGradient(LightType::Point, handle);
+}
+
+void LightManager::StopGradient(SpotLightHandle handle)
+{
+	StopGradient(LightType::Spot, handle);
+}
+
+void LightManager::StartGradient(LightType type, const LightHandle& handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float))
+{
+	//すでにあれば設定し直す
+	size_t index = gradients_.Find(type, handle);
+	if (index == gradients_.GetCount())
+	{
+		gradients_.types.push_back(type);
+		gradients_.handles.push_back(handle);
+		gradients_.startColors.emplace_back();
+		gradients_.endColors.emplace_back();
+		gradients_.durations.emplace_back();
+		gradients_.elapsedTimes.emplace_back();
+		gradients_.isReversing.emplace_back();
+		gradients_.easingFunctions.emplace_back();
+		gradients_.factors.emplace_back();
+	}
+	gradients_.startColors[index] = startColor;
+	gradients_.endColors[index] = endColor;
+	gradients_.durations[index] = duration;
+	gradients_.elapsedTimes[index] = 0.0f;
+	gradients_.isReversing[index] = 0;
+	gradients_.easingFunctions[index] = easingFunction;
+}
+
+void LightManager::StopGradient(LightType type, const LightHandle& handle)
+{
+	size_t index = gradients_.Find(type, handle);
+	if (index != gradients_.GetCount())
+	{
+		gradients_.RemoveAt(index);
+	}
+}
 
-	/*--------------[ ライトの数リソースにデータを書き込むためのアドレスを取得してlightCountDataに割り当てる ]-----------------*/
+void LightManager::UpdateGradients(float deltaTime)
+{
+	const size_t count = gradients_.GetCount();
+	if (count == 0)
+	{
+		return;
+	}
 
-	lightCountResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&lightCountData_)
-	);
+	/*--------------[ 経過時間と補間係数（分岐のない計算なのでまとめてベクトル化される） ]-----------------*/
 
-	//デフォルト値は以下のようにしておく
-	lightCountData_->pointLightCount = 0;
-	lightCountData_->spotLightCount = 0;
+	float* elapsedTimes = gradients_.elapsedTimes.data();
+	const float* durations = gradients_.durations.data();
+	uint8_t* isReversing = gradients_.isReversing.data();
+	float* factors = gradients_.factors.data();
+	for (size_t i = 0; i < count; ++i)
+	{
+		float elapsed = elapsedTimes[i] + deltaTime;
+		//持続時間を超えたら最初に戻して、補間の方向を反転
+		uint8_t wrapped = elapsed > durations[i] ? 1 : 0;
+		elapsed = wrapped ? 0.0f : elapsed;
+		elapsedTimes[i] = elapsed;
+		isReversing[i] ^= wrapped;
+		factors[i] = elapsed / durations[i];
+	}
 
-	/*--------------[ ポイントライトリソースを作る ]-----------------*/
+	/*--------------[ イージング関数を適用 ]-----------------*/
 
-	pointLightResource_ = dxCommon_->CreateBufferResource(sizeof(GPUPointLight) * LightMaxCount::kMaxPointLightCount);
+	for (size_t i = 0; i < count; ++i)
+	{
+		factors[i] = gradients_.easingFunctions[i](factors[i]);
+	}
 
-	/*--------------[ ポイントライトリソースにデータを書き込むためのアドレスを取得してpointLightDataに割り当てる ]-----------------*/
+	/*--------------[ 色の補間を書き込む ]-----------------*/
 
-	pointLightResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&pointLightData_)
-	);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Vector4& from = isReversing[i] ? gradients_.endColors[i] : gradients_.startColors[i];
+		const Vector4& to = isReversing[i] ? gradients_.startColors[i] : gradients_.endColors[i];
+		Vector4 color = Vector4::Lerp(from, to, factors[i]);
 
-	//デフォルト値は以下のようにしておく
-	pointLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	pointLightData_->position = { 0.0f,0.0f,0.0f };
-	pointLightData_->intensity = 1.0f;
-	pointLightData_->radius = 3.0f;
+		if (gradients_.types[i] == LightType::Point)
+		{
+			uint32_t index = pointSlots_.GetIndex(gradients_.handles[i]);
+			pointLightData_[index].color = color;
+			MarkPointLightDirty(index);
+		}
+		else
+		{
+			uint32_t index = spotSlots_.GetIndex(gradients_.handles[i]);
+			spotLightData_[index].color = color;
+			MarkSpotLightDirty(index);
+		}
+	}
+}
 
-	/*--------------[ スポットライトリソースを作る ]-----------------*/
+void LightManager::UploadLightData(bool addToCluster)
+{
+	// GPUが前のフレームを描画中でも書き換えられるよう、フレームごとのバッファに変更があった範囲だけを書き込む
+	const uint32_t frameIndex = dxCommon_->GetFrameIndex();
+	lastUploadedLightCount_ = 0;
 
-	spotLightResource_ = dxCommon_->CreateBufferResource(sizeof(GPUSpotLight) * LightMaxCount::kMaxSpotLightCount);
+	/*--------------[ ポイントライト ]-----------------*/
 
-	/*--------------[ スポットライトリソースにデータを書き込むためのアドレスを取得してspotLightDataに割り当てる ]-----------------*/
+	const uint32_t pointLightCount = static_cast<uint32_t>(pointLightData_.size());
+	lastUploadedLightCount_ += pointLightBuffer_.Upload(frameIndex, pointLightData_.data(), pointLightCount);
+	pointLightAddress_ = pointLightBuffer_.resources[frameIndex]->GetGPUVirtualAddress();
+	if (addToCluster) {
+		for (const GPUPointLight& light : pointLightData_) {
+			lightCluster_.AddPointLight(light.position, light.radius);
+		}
+	}
 
-	spotLightResource_->Map(
-		0,
-		nullptr,
-		reinterpret_cast<void**>(&spotLightData_)
-	);
+	/*--------------[ スポットライト ]-----------------*/
 
-	//デフォルト値は以下のようにしておく
-	spotLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	spotLightData_->position = { 0.0f,0.0f,0.0f };
-	spotLightData_->intensity = 1.0f;
-	spotLightData_->distance = 3.0f;
-	spotLightData_->decay = 1.0f;
-	spotLightData_->direction = { 0.0f,-1.0f,0.0f };
-	spotLightData_->cosAngle = 0.0f;
-	spotLightData_->cosFalloffStart = 0.0f;
+	const uint32_t spotLightCount = static_cast<uint32_t>(spotLightData_.size());
+	lastUploadedLightCount_ += spotLightBuffer_.Upload(frameIndex, spotLightData_.data(), spotLightCount);
+	spotLightAddress_ = spotLightBuffer_.resources[frameIndex]->GetGPUVirtualAddress();
+	if (addToCluster) {
+		for (const GPUSpotLight& light : spotLightData_) {
+			lightCluster_.AddSpotLight(light.position, light.direction, light.distance, light.cosAngle);
+		}
+	}
+
+	/*--------------[ ライトの数 ]-----------------*/
+
+	lightCount_.pointLightCount = pointLightCount;
+	lightCount_.spotLightCount = spotLightCount;
+	lightCountAddress_ = dxCommon_->UploadConstant(lightCount_);
+}
+
+void LightManager::UploadLightClusters(bool useClusters)
+{
+	LightCluster::GPUParams params{};
+	if (!useClusters)
+	{
+		//クラスタを使わない時は全てのライトを計算させる（SRVは空でも何か指しておく）
+		params.isEnabled = 0;
+		clusterParamsAddress_ = dxCommon_->UploadConstant(params);
+		clusterRangeAddress_ = dxCommon_->AllocateUpload(sizeof(LightCluster::ClusterRange), alignof(LightCluster::ClusterRange)).gpuAddress;
+		clusterIndexAddress_ = dxCommon_->AllocateUpload(sizeof(uint32_t), alignof(uint32_t)).gpuAddress;
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	lightCluster_.Build();
+	clusterBuildMilliseconds_ = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	params = lightCluster_.GetGPUParams();
+	clusterParamsAddress_ = dxCommon_->UploadConstant(params);
+
+	const auto& ranges = lightCluster_.GetRanges();
+	UploadAllocation rangeAllocation = dxCommon_->AllocateUpload(sizeof(LightCluster::ClusterRange) * ranges.size(), alignof(LightCluster::ClusterRange));
+	std::memcpy(rangeAllocation.cpuAddress, ranges.data(), sizeof(LightCluster::ClusterRange) * ranges.size());
+	clusterRangeAddress_ = rangeAllocation.gpuAddress;
+
+	//どのクラスタにもライトがなくても割り当てられるように最低1個分は確保する
+	const auto& indices = lightCluster_.GetLightIndices();
+	UploadAllocation indexAllocation = dxCommon_->AllocateUpload(sizeof(uint32_t) * (std::max)(indices.size(), size_t(1)), alignof(uint32_t));
+	if (!indices.empty())
+	{
+		std::memcpy(indexAllocation.cpuAddress, indices.data(), sizeof(uint32_t) * indices.size());
+	}
+	clusterIndexAddress_ = indexAllocation.gpuAddress;
+}
+
+uint32_t LightManager::ResolvePointLight(PointLightHandle handle) const
+{
+	uint32_t index = pointSlots_.GetIndex(handle);
+	if (index == LightSlotTable::kInvalidIndex)
+	{
+		Logger::Log("ポイントライトが見つかりません\n");
+	}
+	return index;
+}
+
+uint32_t LightManager::ResolveSpotLight(SpotLightHandle handle) const
+{
+	uint32_t index = spotSlots_.GetIndex(handle);
+	if (index == LightSlotTable::kInvalidIndex)
+	{
+		Logger::Log("スポットライトが見つかりません\n");
+	}
+	return index;
+}
+
+void LightManager::LightUploadBuffer::Create(DirectXCommon* dxCommon, uint32_t elementStride, uint32_t capacity)
+{
+	stride = elementStride;
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; ++i)
+	{
+		resources[i] = dxCommon->CreateBufferResource(size_t(elementStride) * capacity);
+		resources[i]->Map(0, nullptr, reinterpret_cast<void**>(&mappedData[i]));
+		dirtyBegin[i] = 0;
+		dirtyEnd[i] = 0;
+	}
+}
+
+void LightManager::LightUploadBuffer::MarkDirty(uint32_t begin, uint32_t end)
+{
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; ++i)
+	{
+		if (dirtyBegin[i] >= dirtyEnd[i])
+		{
+			dirtyBegin[i] = begin;
+			dirtyEnd[i] = end;
+		}
+		else
+		{
+			dirtyBegin[i] = (std::min)(dirtyBegin[i], begin);
+			dirtyEnd[i] = (std::max)(dirtyEnd[i], end);
+		}
+	}
+}
+
+uint32_t LightManager::LightUploadBuffer::Upload(uint32_t frameIndex, const void* source, uint32_t count)
+{
+	//削除で数が減った分は書き込まない（シェーダーは数までしか読まない）
+	uint32_t begin = dirtyBegin[frameIndex];
+	uint32_t end = (std::min)(dirtyEnd[frameIndex], count);
+	dirtyBegin[frameIndex] = 0;
+	dirtyEnd[frameIndex] = 0;
+	if (begin >= end)
+	{
+		return 0;
+	}
+
+	std::memcpy(mappedData[frameIndex] + size_t(begin) * stride, static_cast<const uint8_t*>(source) + size_t(begin) * stride, size_t(end - begin) * stride);
+	return end - begin;
+}
+
+size_t LightManager::GradientTable::Find(LightType type, const LightHandle& handle) const
+{
+	for (size_t i = 0; i < handles.size(); ++i)
+	{
+		if (types[i] == type && handles[i] == handle)
+		{
+			return i;
+		}
+	}
+	return handles.size();
+}
+
+void LightManager::GradientTable::RemoveAt(size_t index)
+{
+	const uint32_t i = static_cast<uint32_t>(index);
+	RemoveSwapBack(types, i);
+	RemoveSwapBack(handles, i);
+	RemoveSwapBack(startColors, i);
+	RemoveSwapBack(endColors, i);
+	RemoveSwapBack(durations, i);
+	RemoveSwapBack(elapsedTimes, i);
+	RemoveSwapBack(isReversing, i);
+	RemoveSwapBack(easingFunctions, i);
+	RemoveSwapBack(factors, i);
 }
 
 void LightManager::ImGuiUpdate()
@@ -343,6 +618,19 @@ void LightManager::ImGuiUpdate()
 				case 20: pEasingFunc_ = EaseInOutBounce<float>; break;
 				}
 			}
+			ImGui::SeparatorText("Clustered Lighting");
+			ImGui::Checkbox("Enable Clustering", &enableClustering_);
+			{
+				const LightCluster::Stats& stats = lightCluster_.GetStats();
+				ImGui::Text("Clusters : %u x %u x %u", LightCluster::kCountX, LightCluster::kCountY, LightCluster::kCountZ);
+				ImGui::Text("Visible Lights : %u / %u", stats.visibleLightCount, stats.pointLightCount + stats.spotLightCount);
+				ImGui::Text("Occupied Clusters : %u / %u", stats.occupiedClusterCount, LightCluster::kClusterCount);
+				ImGui::Text("Light Indices : %u (max %u per cluster)", stats.indexCount, stats.maxLightsPerCluster);
+				ImGui::Text("Build Time : %.3f ms", clusterBuildMilliseconds_);
+				ImGui::Text("Uploaded Lights : %u", lastUploadedLightCount_);
+			}
+			ImGui::SeparatorText("Spot Light Shadows");
+			shadowAtlas_.ImGuiUpdate();
 			ImGui::SeparatorText("List Clear");
 			if (ImGui::Button("clear"))
 			{
@@ -356,23 +644,21 @@ void LightManager::ImGuiUpdate()
 			ImGui::Text("PointLight Count : %d", lightCount_.pointLightCount);
 			if (ImGui::Button("Add PointLight"))
 			{
-				AddPointLight("PointLight" + std::to_string(pointLights_.size()));
+				AddPointLight("PointLight" + std::to_string(pointLightData_.size()));
 			}
 			ImGui::SameLine();
 			if (ImGui::Button("Clear PointLights"))
 			{
-				pointLights_.clear();
-				pointLightNames_.clear();
-				lightCount_.pointLightCount = 0;
+				ClearPointLights();
 			}
 
 			ImGui::SeparatorText("Gradient");
 			if (ImGui::Button("Start Gradient"))
 			{
 				//すべてのポイントライトにグラデーションを適用
-				for (const auto& name : pointLightNames_)
+				for (uint32_t i = 0; i < pointSlots_.GetCount(); ++i)
 				{
-					StartGradient(name, startPointLightColor_, endPointLightColor_, duration_, pEasingFunc_);
+					StartGradient(LightType::Point, pointSlots_.GetHandle(i), startPointLightColor_, endPointLightColor_, duration_, pEasingFunc_);
 				}
 			}
 			//開始色
@@ -382,16 +668,22 @@ void LightManager::ImGuiUpdate()
 
 			ImGui::SeparatorText("List");
 			// ポイントライトの設定
-			for (const auto& name : pointLightNames_)
+			for (uint32_t i = 0; i < pointLightData_.size(); ++i)
 			{
-				ImGui::PushID(name.c_str());
-				if (ImGui::CollapsingHeader(name.c_str()))
+				GPUPointLight& light = pointLightData_[i];
+				ImGui::PushID(pointLightNames_[i].c_str());
+				if (ImGui::CollapsingHeader(pointLightNames_[i].c_str()))
 				{
-					ImGui::ColorEdit4("PointLight Color", &pointLights_.at(name).gpuData.color.x);
-					ImGui::DragFloat3("PointLight Position", &pointLights_.at(name).gpuData.position.x, 0.1f);
-					ImGui::DragFloat("PointLight Intensity", &pointLights_.at(name).gpuData.intensity, 0.1f, 0.0f,100.0f);
-					ImGui::DragFloat("PointLight Radius", &pointLights_.at(name).gpuData.radius, 0.1f, 0.0f,1000.0f);
-					ImGui::DragFloat("PointLight Decay", &pointLights_.at(name).gpuData.decay, 0.1f, 0.0f,10.0f);
+					bool changed = false;
+					changed |= ImGui::ColorEdit4("PointLight Color", &light.color.x);
+					changed |= ImGui::DragFloat3("PointLight Position", &light.position.x, 0.1f);
+					changed |= ImGui::DragFloat("PointLight Intensity", &light.intensity, 0.1f, 0.0f,100.0f);
+					changed |= ImGui::DragFloat("PointLight Radius", &light.radius, 0.1f, 0.0f,1000.0f);
+					changed |= ImGui::DragFloat("PointLight Decay", &light.decay, 0.1f, 0.0f,10.0f);
+					if (changed)
+					{
+						MarkPointLightDirty(i);
+					}
 				}
 				ImGui::PopID();
 			}
@@ -405,14 +697,12 @@ void LightManager::ImGuiUpdate()
 			ImGui::Text("SpotLight Count : %d", lightCount_.spotLightCount);
 			if (ImGui::Button("Add GPUSpotLight"))
 			{
-				AddSpotLight("SpotLight" + std::to_string(spotLights_.size()));
+				AddSpotLight("SpotLight" + std::to_string(spotLightData_.size()));
 			}
 			ImGui::SameLine();
 			if (ImGui::Button("Clear SpotLights"))
 			{
-				spotLights_.clear();
-				spotLightNames_.clear();
-				lightCount_.spotLightCount = 0;
+				ClearSpotLights();
 			}
 
 			ImGui::SeparatorText("Gradient");
@@ -420,9 +710,9 @@ void LightManager::ImGuiUpdate()
 			if (ImGui::Button("Start Gradient"))
 			{
 				//すべてのスポットライトにグラデーションを適用
-				for (const auto& name : spotLightNames_)
+				for (uint32_t i = 0; i < spotSlots_.GetCount(); ++i)
 				{
-					StartGradient(name, startSpotLightColor_, endSpotLightColor_, duration_, pEasingFunc_);
+					StartGradient(LightType::Spot, spotSlots_.GetHandle(i), startSpotLightColor_, endSpotLightColor_, duration_, pEasingFunc_);
 				}
 			}
 			//開始色
@@ -432,19 +722,25 @@ void LightManager::ImGuiUpdate()
 
 			ImGui::SeparatorText("List");
 			// スポットライトの設定
-			for (const auto& name : spotLightNames_)
+			for (uint32_t i = 0; i < spotLightData_.size(); ++i)
 			{
-				ImGui::PushID(name.c_str());
-				if (ImGui::CollapsingHeader(name.c_str()))
+				GPUSpotLight& light = spotLightData_[i];
+				ImGui::PushID(spotLightNames_[i].c_str());
+				if (ImGui::CollapsingHeader(spotLightNames_[i].c_str()))
 				{
-					ImGui::ColorEdit4("SpotLight Color", &spotLights_.at(name).gpuData.color.x);
-					ImGui::DragFloat3("SpotLight Position", &spotLights_.at(name).gpuData.position.x, 0.1f);
-					ImGui::DragFloat3("SpotLight Direction", &spotLights_.at(name).gpuData.direction.x, 0.01f, -1.0f, 1.0f);
-					ImGui::DragFloat("SpotLight Intensity", &spotLights_.at(name).gpuData.intensity, 0.1f, 0.0f,100.0f);
-					ImGui::DragFloat("SpotLight Distance", &spotLights_.at(name).gpuData.distance, 0.1f, 0.0f,1000.0f);
-					ImGui::DragFloat("SpotLight CosAngle", &spotLights_.at(name).gpuData.cosAngle, 0.01f, -3.14f, 3.14f);
-					ImGui::DragFloat("SpotLight Decay", &spotLights_.at(name).gpuData.decay, 0.1f, 0.0f,10.0f);
-					ImGui::DragFloat("SpotLight CosFalloffStart", &spotLights_.at(name).gpuData.cosFalloffStart, 0.01f, -3.14f, 3.14f);
+					bool changed = false;
+					changed |= ImGui::ColorEdit4("SpotLight Color", &light.color.x);
+					changed |= ImGui::DragFloat3("SpotLight Position", &light.position.x, 0.1f);
+					changed |= ImGui::DragFloat3("SpotLight Direction", &light.direction.x, 0.01f, -1.0f, 1.0f);
+					changed |= ImGui::DragFloat("SpotLight Intensity", &light.intensity, 0.1f, 0.0f,100.0f);
+					changed |= ImGui::DragFloat("SpotLight Distance", &light.distance, 0.1f, 0.0f,1000.0f);
+					changed |= ImGui::DragFloat("SpotLight CosAngle", &light.cosAngle, 0.01f, -3.14f, 3.14f);
+					changed |= ImGui::DragFloat("SpotLight Decay", &light.decay, 0.1f, 0.0f,10.0f);
+					changed |= ImGui::DragFloat("SpotLight CosFalloffStart", &light.cosFalloffStart, 0.01f, -3.14f, 3.14f);
+					if (changed)
+					{
+						MarkSpotLightDirty(i);
+					}
 				}
 				ImGui::PopID();
 			}
@@ -461,120 +757,121 @@ void LightManager::ImGuiUpdate()
 }
 
 #pragma region Accessor
-void LightManager::SetPointLightColor(const std::string& name, const Vector4& color)
+
+void LightManager::SetPointLightColor(PointLightHandle handle, const Vector4& color)
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		pointLights_.at(name).gpuData.color = color;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
+	uint32_t index = ResolvePointLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		pointLightData_[index].color = color;
+		MarkPointLightDirty(index);
 	}
 }
 
-void LightManager::SetPointLightPosition(const std::string& name, const Vector3& position)
+void LightManager::SetPointLightPosition(PointLightHandle handle, const Vector3& position)
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		pointLights_.at(name).gpuData.position = position;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
+	uint32_t index = ResolvePointLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		pointLightData_[index].position = position;
+		MarkPointLightDirty(index);
 	}
 }
 
-void LightManager::SetPointLightIntensity(const std::string& name, float intensity)
+void LightManager::SetPointLightIntensity(PointLightHandle handle, float intensity)
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		pointLights_.at(name).gpuData.intensity = intensity;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
+	uint32_t index = ResolvePointLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		pointLightData_[index].intensity = intensity;
+		MarkPointLightDirty(index);
 	}
 }
 
-void LightManager::SetPointLightRadius(const std::string& name, float radius)
+void LightManager::SetPointLightRadius(PointLightHandle handle, float radius)
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		pointLights_.at(name).gpuData.radius = radius;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
+	uint32_t index = ResolvePointLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		pointLightData_[index].radius = radius;
+		MarkPointLightDirty(index);
 	}
 }
 
-void LightManager::SetPointLightDecay(const std::string& name, float decay)
+void LightManager::SetPointLightDecay(PointLightHandle handle, float decay)
 {
-	if (pointLights_.find(name) != pointLights_.end()) {
-		pointLights_.at(name).gpuData.decay = decay;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
+	uint32_t index = ResolvePointLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		pointLightData_[index].decay = decay;
+		MarkPointLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightColor(const std::string& name, const Vector4& color)
+void LightManager::SetSpotLightColor(SpotLightHandle handle, const Vector4& color)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.color = color;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].color = color;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightPosition(const std::string& name, const Vector3& position)
+void LightManager::SetSpotLightPosition(SpotLightHandle handle, const Vector3& position)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.position = position;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].position = position;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightIntensity(const std::string& name, float intensity)
+void LightManager::SetSpotLightIntensity(SpotLightHandle handle, float intensity)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.intensity = intensity;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].intensity = intensity;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightDirection(const std::string& name, const Vector3& direction)
+void LightManager::SetSpotLightDirection(SpotLightHandle handle, const Vector3& direction)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.direction = direction;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].direction = direction;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightDistance(const std::string& name, float distance)
+void LightManager::SetSpotLightDistance(SpotLightHandle handle, float distance)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.distance = distance;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].distance = distance;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightDecay(const std::string& name, float decay)
+void LightManager::SetSpotLightDecay(SpotLightHandle handle, float decay)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.decay = decay;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].decay = decay;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightCosAngle(const std::string& name, float cosAngle)
+void LightManager::SetSpotLightCosAngle(SpotLightHandle handle, float cosAngle)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.cosAngle = cosAngle;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].cosAngle = cosAngle;
+		MarkSpotLightDirty(index);
 	}
 }
 
-void LightManager::SetSpotLightCosFalloffStart(const std::string& name, float cosFalloffStart)
+void LightManager::SetSpotLightCosFalloffStart(SpotLightHandle handle, float cosFalloffStart)
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		spotLights_.at(name).gpuData.cosFalloffStart = cosFalloffStart;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
+	uint32_t index = ResolveSpotLight(handle);
+	if (index != LightSlotTable::kInvalidIndex) {
+		spotLightData_[index].cosFalloffStart = cosFalloffStart;
+		MarkSpotLightDirty(index);
 	}
 }
 
@@ -588,154 +885,20 @@ const uint32_t& LightManager::GetSpotLightCount() const
 	return lightCount_.spotLightCount;
 }
 
-const GPUPointLight& LightManager::GetPointLight(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData;
-	}
-}
-
-const GPUSpotLight& LightManager::GetSpotLight(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData;
-	}
-}
-
-const Vector4& LightManager::GetPointLightColor(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData.color;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData.color;
-	}
-}
-
-const Vector3& LightManager::GetPointLightPosition(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData.position;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData.position;
-	}
-}
-
-float LightManager::GetPointLightIntensity(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData.intensity;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData.intensity;
-	}
-}
-
-float LightManager::GetPointLightRadius(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData.radius;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData.radius;
-	}
-}
-
-float LightManager::GetPointLightDecay(const std::string& name) const
-{
-	if (pointLights_.find(name) != pointLights_.end()) {
-		return pointLights_.at(name).gpuData.decay;
-	} else {
-		Logger::Log("ポイントライトが見つかりません: " + name);
-		return pointLights_.begin()->second.gpuData.decay;
-	}
-}
-
-const Vector4& LightManager::GetSpotLightColor(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.color;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.color;
-	}
-}
-
-const Vector3& LightManager::GetSpotLightPosition(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.position;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.position;
-	}
-}
-
-float LightManager::GetSpotLightIntensity(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.intensity;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.intensity;
-	}
-}
-
-const Vector3& LightManager::GetSpotLightDirection(const std::string& name) const
+const GPUPointLight& LightManager::GetPointLight(PointLightHandle handle) const
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.direction;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.direction;
-	}
-}
-
-float LightManager::GetSpotLightDistance(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.distance;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.distance;
-	}
-}
-
-float LightManager::GetSpotLightDecay(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.decay;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.decay;
-	}
+	//見つからない時に返す値
+	static const GPUPointLight kEmpty{};
+	uint32_t index = ResolvePointLight(handle);
+	return index != LightSlotTable::kInvalidIndex ? pointLightData_[index] : kEmpty;
 }
 
-float LightManager::GetSpotLightCosAngle(const std::string& name) const
+const GPUSpotLight& LightManager::GetSpotLight(SpotLightHandle handle) const
 {
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.cosAngle;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.cosAngle;
-	}
-}
-
-float LightManager::GetSpotLightCosFalloffStart(const std::string& name) const
-{
-	if (spotLights_.find(name) != spotLights_.end()) {
-		return spotLights_.at(name).gpuData.cosFalloffStart;
-	} else {
-		Logger::Log("スポットライトが見つかりません: " + name);
-		return spotLights_.begin()->second.gpuData.cosFalloffStart;
-	}
+	//見つからない時に返す値
+	static const GPUSpotLight kEmpty{};
+	uint32_t index = ResolveSpotLight(handle);
+	return index != LightSlotTable::kInvalidIndex ? spotLightData_[index] : kEmpty;
 }
 
 #pragma endregion
\ No newline at end of file
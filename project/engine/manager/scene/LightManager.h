@@ -1,16 +1,31 @@
 #pragma once
-#include <unordered_map>
+#include <array>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // light
+#include "light/LightCluster.h"
 #include "light/LightConstants.h"
+#include "light/LightHandle.h"
+#include "light/LightSlotTable.h"
 #include "light/PointLight.h"
+#include "light/ShadowAtlas.h"
 #include "light/SpotLight.h"
 // system
 #include "base/DirectXCommon.h"
 // math
 #include "math/VectorColorCodes.h"
 
+class Camera;
+class SrvManager;
+
+/**
+ * \brief ポイントライトとスポットライトの管理
+ * \note ライトは番号順に詰めた配列で持ち、ハンドルで指す（名前で探すのは作る時とFindだけ）。
+ *       GPUへはフレームごとのバッファに、変更があった範囲だけを書き込む。
+ *       スポットライトの影は1枚のアトラスにまとめて持つ
+ */
 class LightManager
 {
 public:
@@ -20,51 +35,86 @@ public:
 	~LightManager();
 
 	//初期化
-	void Initialize(DirectXCommon* dxCommon);
+	void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager);
 
 	//更新
 	void Update();
 
+	/**
+	 * \brief 今フレームのライトを書き込み、カメラから見たクラスタに振り分ける
+	 * \note カメラの更新が終わった後、3Dの描画の前に1度だけ呼ぶ。スポットライトの影のタイルもここで割り当てる
+	 * \param camera 描画に使うカメラ（nullptrならクラスタを使わず全てのライトを計算する）
+	 */
+	void PrepareDraw(const Camera* camera);
+
+	/**
+	 * \brief 影を落とすオブジェクトを見て、今フレームに描き直す影のタイルを決める
+	 * \note PrepareDrawの後、影を描く直前に呼ぶ
+	 */
+	const std::vector<ShadowAtlas::RenderRequest>& CollectShadowRenderRequests(const std::vector<ShadowCaster>& casters);
+
 	//描画
 	void Draw();
 
-	//ポイントライトの追加
-	void AddPointLight(const std::string& name);
+	/**
+	 * \brief ポイントライトの追加
+	 * \note 同じ名前のライトがあれば、そのハンドルを返す
+	 * \return 追加したライトのハンドル（最大数に達していたら無効なハンドル）
+	 */
+	PointLightHandle AddPointLight(const std::string& name);
 
-	// スポットライトの追加
-	void AddSpotLight(const std::string& name);
+	/**
+	 * \brief スポットライトの追加
+	 * \note 同じ名前のライトがあれば、そのハンドルを返す
+	 * \return 追加したライトのハンドル（最大数に達していたら無効なハンドル）
+	 */
+	SpotLightHandle AddSpotLight(const std::string& name);
+
+	// ライトの削除
+	void RemovePointLight(PointLightHandle handle);
+	void RemoveSpotLight(SpotLightHandle handle);
 
 	//ライトの削除
 	void Clear();
+	void ClearPointLights();
+	void ClearSpotLights();
+
+	// 名前からハンドルを探す（見つからなければ無効なハンドル）
+	PointLightHandle FindPointLight(const std::string& name) const;
+	SpotLightHandle FindSpotLight(const std::string& name) const;
 
 	/**
 	 * \brief グラデーション
-	 * \param name ライトの名前
+	 * \param handle ライトのハンドル
 	 * \param startColor 開始したい色
 	 * \param endColor 終了したい色
 	 * \param duration グラデーションにかける時間
 	 * \param easingFunction イージング関数
 	 */
-	void StartGradient(const std::string& name, const Vector4& startColor, const Vector4& endColor, float duration, std::function<float(float)> easingFunction);
+	void StartGradient(PointLightHandle handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float));
+	void StartGradient(SpotLightHandle handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float));
 
+	// グラデーションを止める
+	void StopGradient(PointLightHandle handle);
+	void StopGradient(SpotLightHandle handle);
 
 public: //セッター
 	// ポイントライトのプロパティ設定
-	void SetPointLightColor(const std::string& name, const Vector4& color);
-	void SetPointLightPosition(const std::string& name, const Vector3& position);
-	void SetPointLightIntensity(const std::string& name, float intensity);
-	void SetPointLightRadius(const std::string& name, float radius);
-	void SetPointLightDecay(const std::string& name, float decay);
+	void SetPointLightColor(PointLightHandle handle, const Vector4& color);
+	void SetPointLightPosition(PointLightHandle handle, const Vector3& position);
+	void SetPointLightIntensity(PointLightHandle handle, float intensity);
+	void SetPointLightRadius(PointLightHandle handle, float radius);
+	void SetPointLightDecay(PointLightHandle handle, float decay);
 
 	// スポットライトのプロパティ設定
-	void SetSpotLightColor(const std::string& name, const Vector4& color);
-	void SetSpotLightPosition(const std::string& name, const Vector3& position);
-	void SetSpotLightIntensity(const std::string& name, float intensity);
-	void SetSpotLightDirection(const std::string& name, const Vector3& direction);
-	void SetSpotLightDistance(const std::string& name, float distance);
-	void SetSpotLightDecay(const std::string& name, float decay);
-	void SetSpotLightCosAngle(const std::string& name, float cosAngle);
-	void SetSpotLightCosFalloffStart(const std::string& name, float cosFalloffStart);
+	void SetSpotLightColor(SpotLightHandle handle, const Vector4& color);
+	void SetSpotLightPosition(SpotLightHandle handle, const Vector3& position);
+	void SetSpotLightIntensity(SpotLightHandle handle, float intensity);
+	void SetSpotLightDirection(SpotLightHandle handle, const Vector3& direction);
+	void SetSpotLightDistance(SpotLightHandle handle, float distance);
+	void SetSpotLightDecay(SpotLightHandle handle, float decay);
+	void SetSpotLightCosAngle(SpotLightHandle handle, float cosAngle);
+	void SetSpotLightCosFalloffStart(SpotLightHandle handle, float cosFalloffStart);
 
 public: //ゲッター
 	//ポイントライトの数の取得
@@ -73,44 +123,130 @@ public: //ゲッター
 	const uint32_t& GetSpotLightCount() const;
 
 	//ポイントライトの取得
-	const GPUPointLight& GetPointLight(const std::string& name) const;
+	const GPUPointLight& GetPointLight(PointLightHandle handle) const;
 	//スポットライトの取得
-	const GPUSpotLight& GetSpotLight(const std::string& name) const;
-
-	// ポイントライトのプロパティ取得
-	const Vector4& GetPointLightColor(const std::string& name) const;
-	const Vector3& GetPointLightPosition(const std::string& name) const;
-	float GetPointLightIntensity(const std::string& name) const;
-	float GetPointLightRadius(const std::string& name) const;
-	float GetPointLightDecay(const std::string& name) const;
-
-	// スポットライトのプロパティ取得
-	const Vector4& GetSpotLightColor(const std::string& name) const;
-	const Vector3& GetSpotLightPosition(const std::string& name) const;
-	float GetSpotLightIntensity(const std::string& name) const;
-	const Vector3& GetSpotLightDirection(const std::string& name) const;
-	float GetSpotLightDistance(const std::string& name) const;
-	float GetSpotLightDecay(const std::string& name) const;
-	float GetSpotLightCosAngle(const std::string& name) const;
-	float GetSpotLightCosFalloffStart(const std::string& name) const;
+	const GPUSpotLight& GetSpotLight(SpotLightHandle handle) const;
+
+	//ハンドルがまだ有効か
+	bool IsValid(PointLightHandle handle) const { return pointSlots_.GetIndex(handle) != LightSlotTable::kInvalidIndex; }
+	bool IsValid(SpotLightHandle handle) const { return spotSlots_.GetIndex(handle) != LightSlotTable::kInvalidIndex; }
+
+	//クラスタの振り分けの統計
+	const LightCluster::Stats& GetClusterStats() const { return lightCluster_.GetStats(); }
+
+	//直近のフレームでGPUに書き込んだライトの数
+	uint32_t GetLastUploadedLightCount() const { return lastUploadedLightCount_; }
+
+	//スポットライトの影のアトラス
+	ShadowAtlas& GetShadowAtlas() { return shadowAtlas_; }
+
+private: //構造体
+	/// \brief ライトの種類
+	enum class LightType : uint8_t
+	{
+		Point,
+		Spot,
+	};
+
+	/**
+	 * \brief フレームごとに持つ、ライトを書き込むアップロードバッファ
+	 * \note 変更があった範囲を全てのフレームのバッファに記録しておき、そのフレームの番が来た時に書き込む
+	 */
+	struct LightUploadBuffer
+	{
+		std::array<Microsoft::WRL::ComPtr<ID3D12Resource>, DirectXCommon::kFrameCount> resources;
+		std::array<uint8_t*, DirectXCommon::kFrameCount> mappedData = {};
+		//まだ書き込んでいない範囲[begin, end)
+		std::array<uint32_t, DirectXCommon::kFrameCount> dirtyBegin = {};
+		std::array<uint32_t, DirectXCommon::kFrameCount> dirtyEnd = {};
+		uint32_t stride = 0;
+
+		/// \brief 最大数分のバッファを作る
+		void Create(DirectXCommon* dxCommon, uint32_t elementStride, uint32_t capacity);
+		/// \brief 変更があった範囲を記録する
+		void MarkDirty(uint32_t begin, uint32_t end);
+		/**
+		 * \brief 記録した範囲だけをフレームのバッファに書き込む
+		 * \return 書き込んだ要素の数
+		 */
+		uint32_t Upload(uint32_t frameIndex, const void* source, uint32_t count);
+	};
+
+	/**
+	 * \brief 全てのライトのグラデーション（配列ごとにまとめて持ち、まとめて更新する）
+	 */
+	struct GradientTable
+	{
+		std::vector<LightType> types;
+		std::vector<LightHandle> handles;
+		std::vector<Vector4> startColors;
+		std::vector<Vector4> endColors;
+		std::vector<float> durations;
+		std::vector<float> elapsedTimes;
+		std::vector<uint8_t> isReversing;
+		std::vector<float (*)(float)> easingFunctions;
+		//更新中に使う補間係数
+		std::vector<float> factors;
+
+		/// \brief ライトのグラデーションの番号（なければsize）
+		size_t Find(LightType type, const LightHandle& handle) const;
+		/// \brief 番号のグラデーションを削除する（末尾を詰める）
+		void RemoveAt(size_t index);
+		void Clear();
+		size_t GetCount() const { return handles.size(); }
+	};
 
 private:
 	//ImGui
 	void ImGuiUpdate();
 
-	//定数バッファの作成
-	void CreateConstantBuffer();
+	//グラデーションをまとめて進める
+	void UpdateGradients(float deltaTime);
+
+	//変更があったライトをフレームのバッファに書き込む（addToClusterなら同じ順番でクラスタの振り分けにも追加する）
+	void UploadLightData(bool addToCluster);
+
+	//追加したライトをクラスタに振り分けて書き込む
+	void UploadLightClusters(bool useClusters);
+
+	// ハンドルからライトの番号を取得する（無効ならログを出してkInvalidIndex）
+	uint32_t ResolvePointLight(PointLightHandle handle) const;
+	uint32_t ResolveSpotLight(SpotLightHandle handle) const;
+
+	// ライトのデータを書き換えたことを記録する
+	void MarkPointLightDirty(uint32_t index) { pointLightBuffer_.MarkDirty(index, index + 1); }
+	void MarkSpotLightDirty(uint32_t index) { spotLightBuffer_.MarkDirty(index, index + 1); }
+
+	// グラデーションを設定する
+	void StartGradient(LightType type, const LightHandle& handle, const Vector4& startColor, const Vector4& endColor, float duration, float (*easingFunction)(float));
+	void StopGradient(LightType type, const LightHandle& handle);
 
 private:
-	//ポイントライト
-	std::unordered_map<std::string, CPUPointLight> pointLights_;
-	//ポイントライトの名前
+	/*-----------------------[ ポイントライト ]------------------------*/
+
+	//GPUに送るデータ（番号順に詰めて並ぶ）
+	std::vector<GPUPointLight> pointLightData_;
+	//名前（番号順）
 	std::vector<std::string> pointLightNames_;
+	//ハンドルと番号の対応
+	LightSlotTable pointSlots_;
+	//名前からハンドルを探すマップ（作る時と削除する時だけ使う）
+	std::unordered_map<std::string, PointLightHandle> pointLightHandles_;
 
-	//スポットライト
-	std::unordered_map<std::string, CPUSpotLight> spotLights_;
-	//スポットライトの名前
+	/*-----------------------[ スポットライト ]------------------------*/
+
+	std::vector<GPUSpotLight> spotLightData_;
+	//影のタイルとキャッシュ（番号順）
+	std::vector<CPUSpotLight> spotShadowStates_;
 	std::vector<std::string> spotLightNames_;
+	LightSlotTable spotSlots_;
+	std::unordered_map<std::string, SpotLightHandle> spotLightHandles_;
+
+	/*-----------------------[ グラデーション ]------------------------*/
+
+	GradientTable gradients_;
+
+	/*-----------------------[ GPU ]------------------------*/
 
 	//ライトの数
 	LightCount lightCount_;
@@ -118,15 +254,29 @@ private:
 	//DxCommon
 	DirectXCommon* dxCommon_ = nullptr;
 
-	//定数バッファ
-	Microsoft::WRL::ComPtr<ID3D12Resource> pointLightResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> spotLightResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> lightCountResource_;
+	//フレームごとのライトのバッファ
+	LightUploadBuffer pointLightBuffer_;
+	LightUploadBuffer spotLightBuffer_;
+	uint32_t lastUploadedLightCount_ = 0;
+
+	//今フレームに書き込んだデータのGPUアドレス（PrepareDrawで更新）
+	D3D12_GPU_VIRTUAL_ADDRESS pointLightAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS spotLightAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS lightCountAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS clusterParamsAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS clusterRangeAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS clusterIndexAddress_ = 0;
+
+	//ライトのクラスタ
+	LightCluster lightCluster_;
+	bool enableClustering_ = true;
+	//直近の振り分けにかかった時間
+	float clusterBuildMilliseconds_ = 0.0f;
+
+	//スポットライトの影のアトラス
+	ShadowAtlas shadowAtlas_;
 
-	//書き込むデータ
-	GPUPointLight* pointLightData_ = nullptr;
-	GPUSpotLight* spotLightData_ = nullptr;
-	LightCount* lightCountData_ = nullptr;
+	/*-----------------------[ ImGui ]------------------------*/
 
 	//イージング関数ポインタ
 	float (*pEasingFunc_)(float) = nullptr;
@@ -0,0 +1,206 @@
+#include "AssetLoader.h"
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+#include "base/JobSystem.h"
+#include "base/Logger.h"
+#include "manager/graphics/ModelManager.h"
+#include "manager/graphics/TextureManager.h"
+
+namespace
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	uint64_t ElapsedMicroseconds(Clock::time_point start)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+	}
+
+	// テクスチャ1枚分の読み込み結果
+	struct TextureJob
+	{
+		std::string filePath;
+		DirectX::ScratchImage mipImages;
+		HRESULT result = E_FAIL;
+		uint64_t decodeMicroseconds = 0;	//ワーカーでのデコードとミップマップ生成
+		uint64_t uploadMicroseconds = 0;	//メインスレッドでのリソース作成と転送
+		uint32_t threadIndex = 0;
+	};
+
+	// モデル1つ分の読み込み結果
+	struct ModelJob
+	{
+		AssetManifest::ModelEntry entry;
+		ModelData modelData;
+		ModelManager::LoadRecord record;
+		uint64_t createMicroseconds = 0;	//メインスレッドでのバッファ作成
+		uint32_t threadIndex = 0;
+		//一覧になかったテクスチャをこのジョブで読んだ場合の結果
+		std::unique_ptr<TextureJob> texture;
+	};
+
+	void DecodeTexture(TextureJob& job)
+	{
+		Clock::time_point start = Clock::now();
+		job.result = TextureManager::DecodeTexture(job.filePath, job.mipImages);
+		job.decodeMicroseconds = ElapsedMicroseconds(start);
+		job.threadIndex = JobSystem::GetCurrentThreadIndex();
+	}
+
+	void UploadTexture(TextureJob& job)
+	{
+		if (FAILED(job.result))
+		{
+			Logger::Log("Failed to load texture: " + job.filePath + "\n");
+			assert(false && "ERROR: AssetLoader::Load() - Failed to decode texture.");
+			return;
+		}
+		Clock::time_point start = Clock::now();
+		TextureManager::GetInstance()->CreateTexture(job.filePath, job.mipImages);
+		job.uploadMicroseconds = ElapsedMicroseconds(start);
+		//転送を積んだら画像はいらない
+		job.mipImages.Release();
+	}
+
+	void AppendTextureReport(std::stringstream& ss, const TextureJob& job)
+	{
+		ss << "  [texture] " << job.filePath
+			<< " decode " << job.decodeMicroseconds / 1000.0 << "ms (thread " << job.threadIndex << ")"
+			<< ", upload " << job.uploadMicroseconds / 1000.0 << "ms\n";
+	}
+}
+
+void AssetLoader::Load(const AssetManifest& manifest, const std::string& label)
+{
+	Clock::time_point batchStart = Clock::now();
+	TextureManager* textureManager = TextureManager::GetInstance();
+	ModelManager* modelManager = ModelManager::GetInstance();
+
+	/*--------------[ 読み込み済みと重複を除いて、ジョブを用意する ]-----------------*/
+
+	//読み込むと決めたテクスチャ（モデルのジョブからも追加するのでロックして使う）
+	std::unordered_set<std::string> claimedTextures;
+	std::mutex claimMutex;
+
+	std::vector<TextureJob> textureJobs;
+	textureJobs.reserve(manifest.textures.size());
+	for (const std::string& filePath : manifest.textures)
+	{
+		if (!textureManager->IsLoaded(filePath) && claimedTextures.insert(filePath).second)
+		{
+			textureJobs.emplace_back().filePath = filePath;
+		}
+	}
+
+	std::unordered_set<std::string> claimedModels;
+	std::vector<ModelJob> modelJobs;
+	modelJobs.reserve(manifest.models.size());
+	for (const AssetManifest::ModelEntry& entry : manifest.models)
+	{
+		if (!modelManager->IsLoaded(entry.filePath) && claimedModels.insert(entry.filePath).second)
+		{
+			modelJobs.emplace_back().entry = entry;
+		}
+	}
+
+	if (textureJobs.empty() && modelJobs.empty())
+	{
+		return;
+	}
+
+	/*--------------[ ワーカーでデコードとメッシュの読み込み ]-----------------*/
+
+	//ジョブの実行中はメインスレッドも待つだけなので、マネージャーの一覧は書き換わらない
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	JobCounter counter;
+
+	//大きいテクスチャほど時間がかかるので、モデルより先に積む
+	for (TextureJob& job : textureJobs)
+	{
+		jobSystem->Submit([&job]() { DecodeTexture(job); }, &counter);
+	}
+
+	for (ModelJob& job : modelJobs)
+	{
+		jobSystem->Submit([&job, &claimedTextures, &claimMutex, textureManager, modelManager]()
+			{
+				job.modelData = modelManager->ImportModelData(job.entry.filePath, job.entry.modelType, job.record);
+				job.threadIndex = JobSystem::GetCurrentThreadIndex();
+
+				//モデルが参照するテクスチャが誰も読んでいなければ、ここで続けて読む
+				std::string texturePath = ModelManager::GetTextureFilePath(job.entry.filePath, job.modelData);
+				if (textureManager->IsLoaded(texturePath))
+				{
+					return;
+				}
+				{
+					std::lock_guard<std::mutex> lock(claimMutex);
+					if (!claimedTextures.insert(texturePath).second)
+					{
+						return;
+					}
+				}
+				job.texture = std::make_unique<TextureJob>();
+				job.texture->filePath = texturePath;
+				DecodeTexture(*job.texture);
+			}, &counter);
+	}
+
+	jobSystem->Wait(counter);
+	uint64_t workerMicroseconds = ElapsedMicroseconds(batchStart);
+
+	/*--------------[ メインスレッドでGPUリソースを作り、転送をまとめて積む ]-----------------*/
+
+	//モデルの初期化で参照するので、テクスチャを先に作る
+	for (TextureJob& job : textureJobs)
+	{
+		UploadTexture(job);
+	}
+	for (ModelJob& job : modelJobs)
+	{
+		if (job.texture)
+		{
+			UploadTexture(*job.texture);
+		}
+	}
+	for (ModelJob& job : modelJobs)
+	{
+		Clock::time_point start = Clock::now();
+		modelManager->AddModel(job.entry.filePath, std::move(job.modelData), job.record);
+		job.createMicroseconds = ElapsedMicroseconds(start);
+	}
+
+	//積んだ転送はすぐにコピーキューで始めておく（完了はTextureManager::Updateで確認される）
+	textureManager->FlushUploads();
+
+	/*--------------[ 素材ごとの時間を出力 ]-----------------*/
+
+	uint64_t totalWorkMicroseconds = 0;
+	std::stringstream ss;
+	ss << "Asset load [" << label << "] " << ElapsedMicroseconds(batchStart) / 1000.0 << "ms"
+		<< " (workers " << workerMicroseconds / 1000.0 << "ms, " << jobSystem->GetThreadCount() << " threads)\n";
+	for (const TextureJob& job : textureJobs)
+	{
+		AppendTextureReport(ss, job);
+		totalWorkMicroseconds += job.decodeMicroseconds;
+	}
+	for (const ModelJob& job : modelJobs)
+	{
+		ss << "  [model] " << job.entry.filePath << (job.record.isFromCache ? " cache " : " assimp ")
+			<< job.record.loadMicroseconds / 1000.0 << "ms (thread " << job.threadIndex << ")"
+			<< ", create " << job.createMicroseconds / 1000.0 << "ms\n";
+		totalWorkMicroseconds += job.record.loadMicroseconds;
+		if (job.texture)
+		{
+			AppendTextureReport(ss, *job.texture);
+			totalWorkMicroseconds += job.texture->decodeMicroseconds;
+		}
+	}
+	ss << "  sum of worker time " << totalWorkMicroseconds / 1000.0 << "ms\n";
+	Logger::Log(ss.str());
+}
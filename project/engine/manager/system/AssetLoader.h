@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+#include "AssetManifest.h"
+
+/**
+ * \brief AssetManifestの素材をワーカースレッドで並列に読み込む
+ * \note 画像のデコード・ミップマップ生成・メッシュの読み込みはJobSystemで行い、
+ *       GPUリソースの作成と転送はメインスレッドでまとめて積む
+ */
+namespace AssetLoader
+{
+	/**
+	 * \brief 一覧の素材を読み込む（読み込み済みのものは飛ばす）
+	 * \param label ログに出す名前（シーン名など）
+	 * \note 終わるまで戻らない。素材ごとの時間をログに出す
+	 */
+	void Load(const AssetManifest& manifest, const std::string& label);
+}
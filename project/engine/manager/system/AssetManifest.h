@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * \brief シーンなどが使うテクスチャとモデルの一覧
+ * \note AssetLoader::Loadに渡すと、まとめて並列に読み込む
+ */
+struct AssetManifest
+{
+	//モデルの指定（ModelManager::LoadModelの引数と同じ）
+	struct ModelEntry
+	{
+		std::string filePath;
+		std::string modelType = ".obj";
+	};
+
+	std::vector<std::string> textures;		//テクスチャのファイルパス
+	std::vector<ModelEntry> models;			//モデル
+
+	void AddTexture(const std::string& filePath) { textures.push_back(filePath); }
+	void AddModel(const std::string& filePath, const std::string& modelType = ".obj") { models.push_back({ filePath, modelType }); }
+};
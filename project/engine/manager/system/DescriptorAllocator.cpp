@@ -0,0 +1,166 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+void DescriptorAllocator::Initialize(uint32_t capacity)
+{
+	capacity_ = 0;
+	allocatedCount_ = 0;
+	peakAllocatedCount_ = 0;
+	pendingFreeCount_ = 0;
+	freeRanges_.clear();
+	generations_.clear();
+	allocatedCounts_.clear();
+	frameFrees_.clear();
+	pendingFrees_.clear();
+
+	Grow(capacity);
+}
+
+DescriptorAllocator::Handle DescriptorAllocator::Allocate(uint32_t count)
+{
+	if (count == 0)
+	{
+		return {};
+	}
+
+	//番号の小さい区間から詰めていくと、大きな区間が後ろに残りやすい
+	auto it = std::find_if(freeRanges_.begin(), freeRanges_.end(), [count](const Range& range) { return range.count >= count; });
+	if (it == freeRanges_.end())
+	{
+		return {};
+	}
+
+	Handle handle;
+	handle.index = it->index;
+	handle.count = count;
+	handle.generation = generations_[handle.index];
+
+	it->index += count;
+	it->count -= count;
+	if (it->count == 0)
+	{
+		freeRanges_.erase(it);
+	}
+
+	allocatedCounts_[handle.index] = count;
+	allocatedCount_ += count;
+	peakAllocatedCount_ = (std::max)(peakAllocatedCount_, allocatedCount_);
+	return handle;
+}
+
+void DescriptorAllocator::Free(const Handle& handle)
+{
+	if (!handle.IsValid())
+	{
+		return;
+	}
+	assert(IsValid(handle) && "ERROR: DescriptorAllocator::Free() - Handle is already freed or stale.");
+	if (!IsValid(handle))
+	{
+		return;
+	}
+
+	//世代を進めて古いハンドルを無効にする（番号自体はGPUが使い終わるまで貸し出さない）
+	++generations_[handle.index];
+	allocatedCounts_[handle.index] = 0;
+	allocatedCount_ -= handle.count;
+	pendingFreeCount_ += handle.count;
+	frameFrees_.push_back({ handle.index, handle.count });
+}
+
+void DescriptorAllocator::EndFrame(uint64_t fenceValue)
+{
+	for (const Range& range : frameFrees_)
+	{
+		PendingFree pending;
+		pending.fenceValue = fenceValue;
+		pending.range = range;
+		pendingFrees_.push_back(pending);
+	}
+	frameFrees_.clear();
+}
+
+void DescriptorAllocator::Release(uint64_t completedFenceValue)
+{
+	// 古いフレームから順に、完了したものだけ空きに戻す
+	while (!pendingFrees_.empty() && pendingFrees_.front().fenceValue <= completedFenceValue)
+	{
+		const Range& range = pendingFrees_.front().range;
+		pendingFreeCount_ -= range.count;
+		InsertFreeRange(range);
+		pendingFrees_.pop_front();
+	}
+}
+
+void DescriptorAllocator::Grow(uint32_t capacity)
+{
+	if (capacity <= capacity_)
+	{
+		return;
+	}
+
+	const Range added = { capacity_, capacity - capacity_ };
+	capacity_ = capacity;
+	generations_.resize(capacity_, 0);
+	allocatedCounts_.resize(capacity_, 0);
+	InsertFreeRange(added);
+}
+
+bool DescriptorAllocator::IsValid(const Handle& handle) const
+{
+	if (!handle.IsValid() || handle.index >= capacity_)
+	{
+		return false;
+	}
+	return generations_[handle.index] == handle.generation && allocatedCounts_[handle.index] == handle.count;
+}
+
+uint32_t DescriptorAllocator::GetLargestFreeRange() const
+{
+	uint32_t largest = 0;
+	for (const Range& range : freeRanges_)
+	{
+		largest = (std::max)(largest, range.count);
+	}
+	return largest;
+}
+
+void DescriptorAllocator::InsertFreeRange(const Range& range)
+{
+	auto next = std::lower_bound(freeRanges_.begin(), freeRanges_.end(), range.index,
+		[](const Range& r, uint32_t index) { return r.index < index; });
+
+	//前の区間の末尾とつながるなら伸ばす
+	if (next != freeRanges_.begin())
+	{
+		auto prev = next - 1;
+		assert(prev->index + prev->count <= range.index && "ERROR: DescriptorAllocator::InsertFreeRange() - Range overlaps a free range.");
+		if (prev->index + prev->count == range.index)
+		{
+			prev->count += range.count;
+			//後ろの区間ともつながれば1つにまとめる
+			if (next != freeRanges_.end() && prev->index + prev->count == next->index)
+			{
+				prev->count += next->count;
+				freeRanges_.erase(next);
+			}
+			return;
+		}
+	}
+
+	//後ろの区間の先頭とつながるなら前に伸ばす
+	if (next != freeRanges_.end())
+	{
+		assert(range.index + range.count <= next->index && "ERROR: DescriptorAllocator::InsertFreeRange() - Range overlaps a free range.");
+		if (range.index + range.count == next->index)
+		{
+			next->index = range.index;
+			next->count += range.count;
+			return;
+		}
+	}
+
+	freeRanges_.insert(next, range);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * \brief ディスクリプタヒープの番号を貸し出し、返された番号をGPUが使い終わってから再利用するアロケータ
+ * \note 空き番号を連続した区間のリストで持つので、テーブル用に連続した番号もまとめて借りられる。
+ *       番号の管理とフェンスによる解放だけを扱い、GPUリソースは持たない
+ */
+class DescriptorAllocator
+{
+public:
+	// 割り当てに失敗した時の番号
+	static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+	/// \brief 借りた番号（連続したcount個）
+	struct Handle
+	{
+		uint32_t index = kInvalidIndex;	//先頭の番号
+		uint32_t count = 0;				//連続した個数
+		uint32_t generation = 0;		//借りた時の世代（返された後の古いハンドルを見分ける）
+
+		bool IsValid() const { return index != kInvalidIndex; }
+	};
+
+	/**
+	 * \brief 初期化（全ての番号を空きにする）
+	 * \param capacity 番号の数
+	 */
+	void Initialize(uint32_t capacity);
+
+	/**
+	 * \brief 連続した番号を借りる
+	 * \param count 個数
+	 * \return 空きがなければ無効なハンドル
+	 */
+	Handle Allocate(uint32_t count = 1);
+
+	/**
+	 * \brief 番号を返す
+	 * \note すぐに古いハンドルは無効になるが、番号を貸し出し直すのはEndFrameで結び付けたフェンスが完了してから
+	 */
+	void Free(const Handle& handle);
+
+	/**
+	 * \brief 今フレームに返された番号を締め、GPUに送ったフェンス値と結び付ける
+	 * \param fenceValue このフレームのコマンドの完了時にシグナルされる値
+	 */
+	void EndFrame(uint64_t fenceValue);
+
+	/**
+	 * \brief GPUの処理が完了したフレームで返された番号を空きに戻す
+	 * \param completedFenceValue ID3D12Fence::GetCompletedValueの値
+	 */
+	void Release(uint64_t completedFenceValue);
+
+	/**
+	 * \brief 番号の数を増やす（増えた分は空きになる）
+	 * \param capacity 新しい番号の数（今より大きいこと）
+	 */
+	void Grow(uint32_t capacity);
+
+	/// \brief 貸し出し中のハンドルか（返された後や、世代の違うハンドルはfalse）
+	bool IsValid(const Handle& handle) const;
+
+public: //アクセッサ
+	uint32_t GetCapacity() const { return capacity_; }
+	// 貸し出し中の番号の数
+	uint32_t GetAllocatedCount() const { return allocatedCount_; }
+	uint32_t GetPeakAllocatedCount() const { return peakAllocatedCount_; }
+	// 返されたがGPUの完了待ちの番号の数
+	uint32_t GetPendingFreeCount() const { return pendingFreeCount_; }
+	// すぐに貸し出せる番号の数
+	uint32_t GetFreeCount() const { return capacity_ - allocatedCount_ - pendingFreeCount_; }
+	// すぐに貸し出せる一番長い連続した番号の数
+	uint32_t GetLargestFreeRange() const;
+	// 空き区間の数（断片化の目安）
+	size_t GetFreeRangeCount() const { return freeRanges_.size(); }
+
+private:
+	// 連続した番号
+	struct Range
+	{
+		uint32_t index = 0;
+		uint32_t count = 0;
+	};
+
+	// 返された番号と、完了を判定するフェンス値
+	struct PendingFree
+	{
+		uint64_t fenceValue = 0;
+		Range range;
+	};
+
+	// 空き区間に戻す（前後の空き区間とつなげる）
+	void InsertFreeRange(const Range& range);
+
+private:
+	uint32_t capacity_ = 0;
+	uint32_t allocatedCount_ = 0;
+	uint32_t peakAllocatedCount_ = 0;
+	uint32_t pendingFreeCount_ = 0;
+
+	//空き区間（番号順、隣り合う区間はつなげておく）
+	std::vector<Range> freeRanges_;
+	//番号ごとの世代と、その番号から貸し出した個数（先頭以外は0）
+	std::vector<uint32_t> generations_;
+	std::vector<uint32_t> allocatedCounts_;
+
+	//今フレームに返された番号
+	std::vector<Range> frameFrees_;
+	//締めたフレームに返された番号（フェンス値の小さい順）
+	std::deque<PendingFree> pendingFrees_;
+};
@@ -1,6 +1,12 @@
 #include "SrvManager.h"
 
-const uint32_t SrvManager::kMaxSRVCount = 512;
+#include <algorithm>
+#include <format>
+
+#include "base/Logger.h"
+
+const uint32_t SrvManager::kInitialSRVCount = 512;
+const uint32_t SrvManager::kMaxSRVCount = 65536;
 
 void SrvManager::Initialize(DirectXCommon* dxCommon)
 {
@@ -8,23 +14,40 @@ void SrvManager::Initialize(DirectXCommon* dxCommon)
 	dxCommon_ = dxCommon;
 
 	//ディスクリプタヒープの生成
-	descriptorHeap_ = dxCommon->CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kMaxSRVCount, true);
+	descriptorHeap_ = dxCommon->CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kInitialSRVCount, true);
+	stagingHeap_ = dxCommon->CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kInitialSRVCount, false);
 	//ディスクリプタ１個分のサイズを取得して記録
 	descriptorSize_ = dxCommon->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
+	//番号の管理
+	allocator_.Initialize(kInitialSRVCount);
 }
 
 uint32_t SrvManager::Allocate()
 {
+	return AllocateRange(1).index;
+}
+
+SrvHandle SrvManager::AllocateRange(uint32_t count)
+{
+	SrvHandle handle = allocator_.Allocate(count);
+	if (!handle.IsValid())
+	{
+		//足りなければヒープを倍に大きくする（増えた分は末尾の空きとつながるので、必ず連続して取れる）
+		const uint32_t capacity = allocator_.GetCapacity();
+		GrowHeap((std::min)((std::max)(capacity * 2, capacity + count), kMaxSRVCount));
+		handle = allocator_.Allocate(count);
+	}
+
 	//上限に達していないか確認
-	assert(useIndex_ < kMaxSRVCount);
+	assert(handle.IsValid() && "ERROR: SrvManager::AllocateRange() - SRV heap is full.");
+	return handle;
+}
 
-	//returnする番号を一旦記録しておく
-	int index = useIndex_;
-	//今回のために番号を1進める
-	useIndex_++;
-	//上で記録した番号を返す
-	return index;
+void SrvManager::Free(SrvHandle& handle)
+{
+	allocator_.Free(handle);
+	handle = {};
 }
 
 void SrvManager::CreateSRVforTexture2D(uint32_t srvIndex, ID3D12Resource* pResource, DXGI_FORMAT format, UINT mipLevels)
@@ -41,6 +64,7 @@ void SrvManager::CreateSRVforTexture2D(uint32_t srvIndex, ID3D12Resource* pResou
 		&srvDesc,
 		GetCPUDescriptorHandle(srvIndex)
 	);
+	CommitDescriptor(srvIndex);
 }
 
 void SrvManager::CreateSRVforTexture2DCubeMap(uint32_t srvIndex, ID3D12Resource* pResource, DXGI_FORMAT format,UINT mipLevels)
@@ -58,15 +82,17 @@ void SrvManager::CreateSRVforTexture2DCubeMap(uint32_t srvIndex, ID3D12Resource*
 		&srvDesc,
 		GetCPUDescriptorHandle(srvIndex)
 	);
+	CommitDescriptor(srvIndex);
 }
 
 void SrvManager::CreateSRVforStructuredBuffer(uint32_t srvIndex, ID3D12Resource* pResource, UINT numElements,
-                                              UINT structureByteStride)
+                                              UINT structureByteStride, UINT firstElement)
 {
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
 	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = firstElement;
 	srvDesc.Buffer.NumElements = numElements;
 	srvDesc.Buffer.StructureByteStride = structureByteStride;
 	srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
@@ -76,15 +102,52 @@ void SrvManager::CreateSRVforStructuredBuffer(uint32_t srvIndex, ID3D12Resource*
 		&srvDesc,
 		GetCPUDescriptorHandle(srvIndex)
 	);
+	CommitDescriptor(srvIndex);
+}
+
+void SrvManager::CommitDescriptor(uint32_t srvIndex, uint32_t count)
+{
+	//描画用のヒープはシェーダーから見えるので、CPU側のヒープから写す
+	D3D12_CPU_DESCRIPTOR_HANDLE dest = descriptorHeap_->GetCPUDescriptorHandleForHeapStart();
+	dest.ptr += (descriptorSize_ * srvIndex);
+	dxCommon_->GetDevice()->CopyDescriptorsSimple(count, dest, GetCPUDescriptorHandle(srvIndex), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 }
 
 void SrvManager::PreDraw()
+{
+	SetDescriptorHeap();
+	isRecording_ = true;
+}
+
+void SrvManager::SetDescriptorHeap()
 {
 	//描画用のDescriptorHeapをセット
 	ID3D12DescriptorHeap* descriptorHeaps[] = { descriptorHeap_.Get() };
 	dxCommon_->GetCommandList()->SetDescriptorHeaps(1, descriptorHeaps);
 }
 
+void SrvManager::PostDraw()
+{
+	isRecording_ = false;
+
+	//今フレームに返した番号と古いヒープは、今フレームのコマンドが終わるまでGPUが参照しうる
+	const uint64_t fenceValue = dxCommon_->GetLastSignaledFenceValue();
+	allocator_.EndFrame(fenceValue);
+	for (auto& heap : frameRetiredHeaps_)
+	{
+		retiredHeaps_.push_back({ fenceValue, std::move(heap) });
+	}
+	frameRetiredHeaps_.clear();
+
+	//GPUが使い終わったものを解放
+	const uint64_t completedFenceValue = dxCommon_->GetCompletedFenceValue();
+	allocator_.Release(completedFenceValue);
+	while (!retiredHeaps_.empty() && retiredHeaps_.front().fenceValue <= completedFenceValue)
+	{
+		retiredHeaps_.pop_front();
+	}
+}
+
 void SrvManager::SetGraphicsRootDescriptorTable(UINT RootParameterIndex, uint32_t srvIndex)
 {
 	//RootSignatureの設定
@@ -93,12 +156,13 @@ void SrvManager::SetGraphicsRootDescriptorTable(UINT RootParameterIndex, uint32_
 
 bool SrvManager::IsMaxSRVCount()
 {
-	return useIndex_ >= kMaxSRVCount;
+	//ヒープを大きくしても空きがない時だけ上限
+	return allocator_.GetCapacity() >= kMaxSRVCount && allocator_.GetFreeCount() == 0;
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE SrvManager::GetCPUDescriptorHandle(uint32_t index)
 {
-	D3D12_CPU_DESCRIPTOR_HANDLE handleCPU = descriptorHeap_->GetCPUDescriptorHandleForHeapStart();
+	D3D12_CPU_DESCRIPTOR_HANDLE handleCPU = stagingHeap_->GetCPUDescriptorHandleForHeapStart();
 	handleCPU.ptr += (descriptorSize_ * index);
 	return handleCPU;
 }
@@ -109,3 +173,43 @@ D3D12_GPU_DESCRIPTOR_HANDLE SrvManager::GetGPUDescriptorHandle(uint32_t index)
 	handleGPU.ptr += (descriptorSize_ * index);
 	return handleGPU;
 }
+
+D3D12_GPU_DESCRIPTOR_HANDLE SrvManager::GetGPUDescriptorHandle(const SrvHandle& handle, uint32_t offset)
+{
+	assert(allocator_.IsValid(handle) && offset < handle.count && "ERROR: SrvManager::GetGPUDescriptorHandle() - Handle is freed or offset is out of range.");
+	return GetGPUDescriptorHandle(handle.index + offset);
+}
+
+void SrvManager::GrowHeap(uint32_t capacity)
+{
+	const uint32_t oldCapacity = allocator_.GetCapacity();
+	if (capacity <= oldCapacity)
+	{
+		return;
+	}
+
+	ID3D12Device* device = dxCommon_->GetDevice();
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap = dxCommon_->CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, capacity, true);
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> stagingHeap = dxCommon_->CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, capacity, false);
+
+	//番号はそのままで、今までのディスクリプタを両方のヒープに写す
+	device->CopyDescriptorsSimple(oldCapacity, stagingHeap->GetCPUDescriptorHandleForHeapStart(), stagingHeap_->GetCPUDescriptorHandleForHeapStart(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	device->CopyDescriptorsSimple(oldCapacity, descriptorHeap->GetCPUDescriptorHandleForHeapStart(), stagingHeap_->GetCPUDescriptorHandleForHeapStart(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	//古い描画用のヒープは、送ったフレームと記録中のコマンドが参照しているので、GPUが使い終わるまで残す
+	//（シェーダーから見えないヒープはGPUが参照しないので、すぐに捨ててよい）
+	frameRetiredHeaps_.push_back(std::move(descriptorHeap_));
+	descriptorHeap_ = std::move(descriptorHeap);
+	stagingHeap_ = std::move(stagingHeap);
+	allocator_.Grow(capacity);
+	++growCount_;
+
+	Logger::Log(std::format("SRV heap grown: {} -> {} (grow count:{})\n", oldCapacity, capacity, growCount_));
+
+	if (isRecording_)
+	{
+		//描画の途中なら新しいヒープを設定し直す（これより前に設定したテーブルは使えなくなるので、描画中の確保は避ける）
+		Logger::Log("WARNING: SRV heap was grown while recording draw commands.\n");
+		SetDescriptorHeap();
+	}
+}
@@ -1,24 +1,63 @@
 #pragma once
+#include <deque>
+#include <vector>
+
 #include "base/DirectXCommon.h"
+#include "manager/system/DescriptorAllocator.h"
+
+//SRVの番号（連続したcount個）。返すとGPUが使い終わってから再利用される
+using SrvHandle = DescriptorAllocator::Handle;
 
+/**
+ * \brief CBV/SRV/UAVのディスクリプタヒープを管理するクラス
+ * \note ビューはシェーダーから見えないヒープに作り、描画用のヒープに写す。
+ *       番号が足りなくなったら両方のヒープを大きく作り直し、古い描画用のヒープはGPUが使い終わってから捨てる
+ */
 class SrvManager
 {
 public:
 	//初期化
 	void Initialize(DirectXCommon* dxCommon);
 
-	//確保
+	//確保（アプリの終了まで使い続けるもの用）
 	uint32_t Allocate();
 
+	/**
+	 * \brief 連続した番号を確保する（ディスクリプタテーブル用）
+	 * \note 使い終わったらFreeで返す
+	 */
+	SrvHandle AllocateRange(uint32_t count);
+
+	/**
+	 * \brief 番号を返す
+	 * \note ハンドルはすぐに無効になる。番号はGPUが今フレームまでの描画を終えてから再利用される
+	 */
+	void Free(SrvHandle& handle);
+
 	//SRV生成（テクスチャ用）
 	void CreateSRVforTexture2D(uint32_t srvIndex, ID3D12Resource* pResource, DXGI_FORMAT format,UINT mipLevels);
 	void CreateSRVforTexture2DCubeMap(uint32_t srvIndex, ID3D12Resource* pResource, DXGI_FORMAT format, UINT mipLevels);
 	//SRV生成（Structured Buffer用）
-	void CreateSRVforStructuredBuffer(uint32_t srvIndex, ID3D12Resource* pResource, UINT numElements, UINT structureByteStride);
+	void CreateSRVforStructuredBuffer(uint32_t srvIndex, ID3D12Resource* pResource, UINT numElements, UINT structureByteStride, UINT firstElement = 0);
+
+	/**
+	 * \brief GetCPUDescriptorHandleに直接書き込んだディスクリプタを描画用のヒープに写す
+	 * \note CreateSRV系の関数は自動で写すので、外部のライブラリにハンドルを渡した時だけ呼ぶ
+	 */
+	void CommitDescriptor(uint32_t srvIndex, uint32_t count = 1);
 
 	//描画前処理
 	void PreDraw();
 
+	//描画用のヒープを今のコマンドリストに設定する（並列に記録するリストの先頭でも呼ぶ）
+	void SetDescriptorHeap();
+
+	/**
+	 * \brief 描画後処理（DirectXCommon::PostDrawの後に呼ぶ）
+	 * \note 今フレームに返された番号と古いヒープを送ったフレームのフェンス値と結び付け、GPUが使い終わったものを解放する
+	 */
+	void PostDraw();
+
 	//
 	void SetGraphicsRootDescriptorTable(UINT RootParameterIndex, uint32_t srvIndex);
 
@@ -27,26 +66,60 @@ public:
 
 public: //アクセッサ
 
-	//ヒープの取得
+	//ヒープの取得（大きくした時に変わるので、描画のたびに取得する）
 	ID3D12DescriptorHeap* GetSrvHeap() { return descriptorHeap_.Get(); }
 
+	//ビューを書き込むハンドル（シェーダーから見えないヒープ）
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandle(uint32_t index);
+	//描画で使うハンドル（ヒープを大きくすると変わるので、保持せずに使う時に取得する）
 	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(uint32_t index);
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(const SrvHandle& handle, uint32_t offset = 0);
+
+	//ハンドルが有効か
+	bool IsValid(const SrvHandle& handle) const { return allocator_.IsValid(handle); }
+
+	//番号の管理
+	const DescriptorAllocator& GetAllocator() const { return allocator_; }
+
+	//ヒープを作り直した回数（変わっていたら保持していたGPUハンドルは使えない）
+	uint32_t GetGrowCount() const { return growCount_; }
 
 public:
-	//最大SRV数
+	//最初に確保するSRV数
+	static const uint32_t kInitialSRVCount;
+	//最大SRV数（ヒープはここまで大きくできる）
 	static const uint32_t kMaxSRVCount;
 
 private:
+	// ヒープを大きく作り直し、今までのディスクリプタを写す
+	void GrowHeap(uint32_t capacity);
+
+private:
+	/// \brief 作り直した後、GPUが使い終わるのを待っている描画用のヒープ
+	struct RetiredHeap
+	{
+		uint64_t fenceValue = 0;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap;
+	};
+
 	DirectXCommon* dxCommon_ = nullptr;
 
 	//SRVのディスクリプタサイズ
 	uint32_t descriptorSize_;
-	//SRVのディスクリプタヒープ
+	//SRVのディスクリプタヒープ（描画用）
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap_;
-	//次に使用するSRVインデックス
-	uint32_t useIndex_ = 0;
+	//ビューを作るヒープ（シェーダーから見えない。描画用のヒープへの写し元）
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> stagingHeap_;
 
+	//番号の管理
+	DescriptorAllocator allocator_;
 
-};
+	//今フレームに作り直した古いヒープと、GPUの完了待ちの古いヒープ
+	std::vector<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> frameRetiredHeaps_;
+	std::deque<RetiredHeap> retiredHeaps_;
 
+	//PreDrawからPostDrawの間か（この間に作り直したらヒープを設定し直す）
+	bool isRecording_ = false;
+	//作り直した回数
+	uint32_t growCount_ = 0;
+};
@@ -0,0 +1,147 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define FRUSTUM_USE_SSE
+#endif
+
+namespace
+{
+	// 行列のj列目を取り出す（行ベクトルなのでクリップ座標の各成分は列との内積になる）
+	Vector4 Column(const Matrix4x4& m, int j)
+	{
+		return Vector4{ m.m[0][j], m.m[1][j], m.m[2][j], m.m[3][j] };
+	}
+
+	// 法線の長さで割って、dが平面までの距離になるようにする
+	Vector4 NormalizePlane(const Vector4& plane)
+	{
+		float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length == 0.0f)
+		{
+			return plane;
+		}
+		return Vector4{ plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+	}
+
+	// 中心と半径で表したAABBが平面の外側に完全に出ていないか
+	bool IsInsidePlane(const Vector4& plane, float cx, float cy, float cz, float ex, float ey, float ez)
+	{
+		float distance = plane.x * cx + plane.y * cy + plane.z * cz + plane.w;
+		float radius = std::fabs(plane.x) * ex + std::fabs(plane.y) * ey + std::fabs(plane.z) * ez;
+		return distance + radius >= 0.0f;
+	}
+}
+
+Frustum Frustum::FromViewProjection(const Matrix4x4& viewProjection)
+{
+	const Vector4 c0 = Column(viewProjection, 0);
+	const Vector4 c1 = Column(viewProjection, 1);
+	const Vector4 c2 = Column(viewProjection, 2);
+	const Vector4 c3 = Column(viewProjection, 3);
+
+	Frustum frustum;
+	// -w <= x <= w, -w <= y <= w, 0 <= z <= w
+	frustum.planes_[kLeft] = NormalizePlane(Vector4{ c3.x + c0.x, c3.y + c0.y, c3.z + c0.z, c3.w + c0.w });
+	frustum.planes_[kRight] = NormalizePlane(Vector4{ c3.x - c0.x, c3.y - c0.y, c3.z - c0.z, c3.w - c0.w });
+	frustum.planes_[kBottom] = NormalizePlane(Vector4{ c3.x + c1.x, c3.y + c1.y, c3.z + c1.z, c3.w + c1.w });
+	frustum.planes_[kTop] = NormalizePlane(Vector4{ c3.x - c1.x, c3.y - c1.y, c3.z - c1.z, c3.w - c1.w });
+	frustum.planes_[kNear] = NormalizePlane(c2);
+	frustum.planes_[kFar] = NormalizePlane(Vector4{ c3.x - c2.x, c3.y - c2.y, c3.z - c2.z, c3.w - c2.w });
+	return frustum;
+}
+
+bool Frustum::IsVisible(const AABB& box) const
+{
+	const Vector3 center = box.GetCenter();
+	const Vector3 extent = box.GetHalfSize();
+	for (const Vector4& plane : planes_)
+	{
+		if (!IsInsidePlane(plane, center.x, center.y, center.z, extent.x, extent.y, extent.z))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t Frustum::CullBoxes(const float* centerX, const float* centerY, const float* centerZ,
+							const float* extentX, const float* extentY, const float* extentZ,
+							size_t count, uint8_t* outVisible) const
+{
+	uint32_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef FRUSTUM_USE_SSE
+	// 平面ごとに4個のAABBをまとめて判定し、1枚でも外側なら不可視にする
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 cx = _mm_loadu_ps(centerX + i);
+		const __m128 cy = _mm_loadu_ps(centerY + i);
+		const __m128 cz = _mm_loadu_ps(centerZ + i);
+		const __m128 ex = _mm_loadu_ps(extentX + i);
+		const __m128 ey = _mm_loadu_ps(extentY + i);
+		const __m128 ez = _mm_loadu_ps(extentZ + i);
+
+		__m128 outside = _mm_setzero_ps();
+		for (const Vector4& plane : planes_)
+		{
+			const __m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+			const __m128 radius = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(plane.x)), ex), _mm_mul_ps(_mm_set1_ps(std::fabs(plane.y)), ey)),
+				_mm_mul_ps(_mm_set1_ps(std::fabs(plane.z)), ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		const int outsideMask = _mm_movemask_ps(outside);
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			const bool visible = (outsideMask & (1 << lane)) == 0;
+			outVisible[i + lane] = visible ? 1 : 0;
+			visibleCount += visible ? 1 : 0;
+		}
+	}
+#endif
+
+	// 4個に満たない残り（SSEが使えない環境では全て）
+	for (; i < count; ++i)
+	{
+		bool visible = true;
+		for (const Vector4& plane : planes_)
+		{
+			if (!IsInsidePlane(plane, centerX[i], centerY[i], centerZ[i], extentX[i], extentY[i], extentZ[i]))
+			{
+				visible = false;
+				break;
+			}
+		}
+		outVisible[i] = visible ? 1 : 0;
+		visibleCount += visible ? 1 : 0;
+	}
+
+	return visibleCount;
+}
+
+AABB TransformAABB(const AABB& local, const Matrix4x4& matrix)
+{
+	const Vector3 center = local.GetCenter();
+	const Vector3 extent = local.GetHalfSize();
+
+	// 中心は普通に変換し、半径は行列の各成分の絶対値で広げる
+	Vector3 worldCenter = {
+		center.x * matrix.m[0][0] + center.y * matrix.m[1][0] + center.z * matrix.m[2][0] + matrix.m[3][0],
+		center.x * matrix.m[0][1] + center.y * matrix.m[1][1] + center.z * matrix.m[2][1] + matrix.m[3][1],
+		center.x * matrix.m[0][2] + center.y * matrix.m[1][2] + center.z * matrix.m[2][2] + matrix.m[3][2],
+	};
+	Vector3 worldExtent = {
+		extent.x * std::fabs(matrix.m[0][0]) + extent.y * std::fabs(matrix.m[1][0]) + extent.z * std::fabs(matrix.m[2][0]),
+		extent.x * std::fabs(matrix.m[0][1]) + extent.y * std::fabs(matrix.m[1][1]) + extent.z * std::fabs(matrix.m[2][1]),
+		extent.x * std::fabs(matrix.m[0][2]) + extent.y * std::fabs(matrix.m[1][2]) + extent.z * std::fabs(matrix.m[2][2]),
+	};
+	return AABB(worldCenter - worldExtent, worldCenter + worldExtent);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "AABB.h"
+#include "MatrixFunc.h"
+#include "Vector4.h"
+
+/**
+ * \brief 視錐台（6枚の平面）と、AABBとの交差判定
+ * \note 平面は(a, b, c, d)で a*x + b*y + c*z + d >= 0 を内側とする
+ */
+class Frustum
+{
+public:
+	// 平面の並び
+	enum Plane : uint32_t
+	{
+		kLeft,
+		kRight,
+		kBottom,
+		kTop,
+		kNear,
+		kFar,
+		kPlaneCount,
+	};
+
+	/**
+	 * \brief ビュープロジェクション行列から平面を取り出す
+	 * \note 行ベクトル（v * M）とクリップ空間の深度0～1を前提とする
+	 */
+	static Frustum FromViewProjection(const Matrix4x4& viewProjection);
+
+	// AABBが少しでも視錐台の内側にあるか
+	bool IsVisible(const AABB& box) const;
+
+	/**
+	 * \brief 中心と半径（各軸の半分の大きさ）で表した複数のAABBをまとめて判定する
+	 * \note SSEが使える環境では4個ずつ同時に判定する
+	 * \param outVisible 判定結果（見えるなら1）。count個分の領域が必要
+	 * \return 見えるAABBの数
+	 */
+	uint32_t CullBoxes(const float* centerX, const float* centerY, const float* centerZ,
+					   const float* extentX, const float* extentY, const float* extentZ,
+					   size_t count, uint8_t* outVisible) const;
+
+	const Vector4& GetPlane(Plane plane) const { return planes_[plane]; }
+
+private:
+	Vector4 planes_[kPlaneCount] = {};
+};
+
+/**
+ * \brief ローカル空間のAABBを行列で変換し、それを包むAABBを返す
+ * \param local ローカル空間のAABB
+ * \param matrix ワールド行列（行ベクトル）
+ */
+AABB TransformAABB(const AABB& local, const Matrix4x4& matrix);
@@ -274,6 +274,35 @@ inline Matrix4x4 Inverse(const Matrix4x4& m)
 	return result;
 }
 
+/// \brief 法線変換用の逆転置行列（左上3x3のみ）
+/// \note 左上3x3の余因子行列を行列式で割ると、そのまま逆行列の転置になる。
+///       4x4のInverseより軽く、平行移動は法線に関係しないので0にする
+inline Matrix4x4 MakeInverseTransposeMatrix(const Matrix4x4& m)
+{
+	//余因子
+	const float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	const float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	const float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	const float c10 = m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2];
+	const float c11 = m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0];
+	const float c12 = m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1];
+	const float c20 = m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1];
+	const float c21 = m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2];
+	const float c22 = m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0];
+
+	//行列式（1行目と余因子の内積）
+	const float det = m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02;
+	const float invDet = det != 0.0f ? 1.0f / det : 0.0f;
+
+	Matrix4x4 result{
+		c00 * invDet, c01 * invDet, c02 * invDet, 0.0f,
+		c10 * invDet, c11 * invDet, c12 * invDet, 0.0f,
+		c20 * invDet, c21 * invDet, c22 * invDet, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	return result;
+}
+
 inline Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip)
 {
 	Matrix4x4 m{
@@ -0,0 +1,176 @@
+#include "TransformHierarchy.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+	const Transform kIdentityTransform = {
+		{ 1.0f, 1.0f, 1.0f },
+		{ 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f },
+	};
+}
+
+TransformHierarchy::Handle TransformHierarchy::Create()
+{
+	Handle handle;
+	if (!freeHandles_.empty())
+	{
+		handle = freeHandles_.back();
+		freeHandles_.pop_back();
+	}
+	else
+	{
+		handle = static_cast<Handle>(parents_.size());
+		locals_.emplace_back();
+		worlds_.emplace_back();
+		worldInverseTransposes_.emplace_back();
+		parents_.emplace_back();
+		firstChildren_.emplace_back();
+		nextSiblings_.emplace_back();
+		versions_.emplace_back(0);
+		dirty_.emplace_back(0);
+		alive_.emplace_back(0);
+	}
+
+	locals_[handle] = kIdentityTransform;
+	worlds_[handle] = MakeIdentity4x4();
+	worldInverseTransposes_[handle] = MakeIdentity4x4();
+	parents_[handle] = kInvalidHandle;
+	firstChildren_[handle] = kInvalidHandle;
+	nextSiblings_[handle] = kInvalidHandle;
+	alive_[handle] = 1;
+	dirty_[handle] = 0;
+	MarkDirty(handle);
+	return handle;
+}
+
+void TransformHierarchy::Destroy(Handle handle)
+{
+	assert(handle < alive_.size() && alive_[handle] && "ERROR: TransformHierarchy::Destroy() - Invalid handle.");
+
+	// 子は親なしにする
+	Handle child = firstChildren_[handle];
+	while (child != kInvalidHandle)
+	{
+		Handle next = nextSiblings_[child];
+		parents_[child] = kInvalidHandle;
+		nextSiblings_[child] = kInvalidHandle;
+		MarkDirty(child);
+		child = next;
+	}
+	firstChildren_[handle] = kInvalidHandle;
+
+	Unlink(handle);
+	alive_[handle] = 0;
+	dirty_[handle] = 0;
+	freeHandles_.push_back(handle);
+}
+
+void TransformHierarchy::SetParent(Handle handle, Handle parent)
+{
+	assert(handle < alive_.size() && alive_[handle] && "ERROR: TransformHierarchy::SetParent() - Invalid handle.");
+	if (parents_[handle] == parent)
+	{
+		return;
+	}
+
+#ifdef _DEBUG
+	// 自分の子孫を親にすると循環する
+	for (Handle ancestor = parent; ancestor != kInvalidHandle; ancestor = parents_[ancestor])
+	{
+		assert(ancestor != handle && "ERROR: TransformHierarchy::SetParent() - Parent must not be a descendant.");
+	}
+#endif
+
+	Unlink(handle);
+	parents_[handle] = parent;
+	if (parent != kInvalidHandle)
+	{
+		nextSiblings_[handle] = firstChildren_[parent];
+		firstChildren_[parent] = handle;
+	}
+	MarkDirty(handle);
+}
+
+void TransformHierarchy::SetLocal(Handle handle, const Transform& local)
+{
+	if (std::memcmp(&locals_[handle], &local, sizeof(Transform)) == 0)
+	{
+		return;
+	}
+	locals_[handle] = local;
+	MarkDirty(handle);
+}
+
+const Matrix4x4& TransformHierarchy::GetWorldMatrix(Handle handle)
+{
+	Resolve(handle);
+	return worlds_[handle];
+}
+
+const Matrix4x4& TransformHierarchy::GetWorldInverseTranspose(Handle handle)
+{
+	Resolve(handle);
+	return worldInverseTransposes_[handle];
+}
+
+void TransformHierarchy::MarkDirty(Handle handle)
+{
+	// 変更フラグが立っているノードの子孫には必ずフラグが立っているので、そこで打ち切れる
+	if (dirty_[handle])
+	{
+		return;
+	}
+	dirty_[handle] = 1;
+	for (Handle child = firstChildren_[handle]; child != kInvalidHandle; child = nextSiblings_[child])
+	{
+		MarkDirty(child);
+	}
+}
+
+void TransformHierarchy::Resolve(Handle handle)
+{
+	if (!dirty_[handle])
+	{
+		return;
+	}
+
+	const Transform& local = locals_[handle];
+	Matrix4x4 world = MakeAffineMatrix(local.scale, local.rotate, local.translate);
+	const Handle parent = parents_[handle];
+	if (parent != kInvalidHandle)
+	{
+		Resolve(parent);
+		world = world * worlds_[parent];
+	}
+
+	worlds_[handle] = world;
+	worldInverseTransposes_[handle] = MakeInverseTransposeMatrix(world);
+	dirty_[handle] = 0;
+	++versions_[handle];
+	++recalculatedCount_;
+}
+
+void TransformHierarchy::Unlink(Handle handle)
+{
+	const Handle parent = parents_[handle];
+	if (parent == kInvalidHandle)
+	{
+		return;
+	}
+
+	Handle* link = &firstChildren_[parent];
+	while (*link != kInvalidHandle)
+	{
+		if (*link == handle)
+		{
+			*link = nextSiblings_[handle];
+			break;
+		}
+		link = &nextSiblings_[*link];
+	}
+	nextSiblings_[handle] = kInvalidHandle;
+	parents_[handle] = kInvalidHandle;
+}
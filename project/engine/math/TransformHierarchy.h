@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "base/GraphicsTypes.h"
+
+/**
+ * \brief 親子関係を持つトランスフォームを配列にまとめて管理するクラス
+ * \note ローカルのSRTが変わったノードとその子孫だけに変更フラグを立て、
+ *       ワールド行列を参照した時に親から順に計算し直す（変わらないノードは再計算しない）
+ */
+class TransformHierarchy
+{
+public:
+	using Handle = uint32_t;
+	static constexpr Handle kInvalidHandle = UINT32_MAX;
+
+	// ノードを作る（親なし、単位トランスフォーム）
+	Handle Create();
+
+	// ノードを削除する（子は親なしになる）
+	void Destroy(Handle handle);
+
+	// 親を設定する（kInvalidHandleで親なし）
+	void SetParent(Handle handle, Handle parent);
+
+	/**
+	 * \brief ローカルのSRTを設定する
+	 * \note 値が前回と同じなら何もしない
+	 */
+	void SetLocal(Handle handle, const Transform& local);
+
+	/**
+	 * \brief ワールド行列を取得する
+	 * \note 変更フラグが立っていれば、親から順に計算し直してから返す
+	 */
+	const Matrix4x4& GetWorldMatrix(Handle handle);
+
+	// 法線変換用の逆転置行列を取得する（GetWorldMatrixと同じく必要なら計算し直す）
+	const Matrix4x4& GetWorldInverseTranspose(Handle handle);
+
+public: //アクセッサ
+	Handle GetParent(Handle handle) const { return parents_[handle]; }
+	const Transform& GetLocal(Handle handle) const { return locals_[handle]; }
+	bool IsDirty(Handle handle) const { return dirty_[handle] != 0; }
+	// ワールド行列を計算し直すたびに増える番号
+	uint32_t GetVersion(Handle handle) const { return versions_[handle]; }
+	// 生きているノード数
+	uint32_t GetNodeCount() const { return static_cast<uint32_t>(parents_.size() - freeHandles_.size()); }
+	// ResetStatsからワールド行列を計算し直した回数
+	uint32_t GetRecalculatedCount() const { return recalculatedCount_; }
+	void ResetStats() { recalculatedCount_ = 0; }
+
+private:
+	// 自分と子孫に変更フラグを立てる
+	void MarkDirty(Handle handle);
+	// 親を先に計算してから自分のワールド行列を計算する
+	void Resolve(Handle handle);
+	// 親の子リストから外す
+	void Unlink(Handle handle);
+
+private:
+	// ノードごとのデータ（添字がハンドル）
+	std::vector<Transform> locals_;
+	std::vector<Matrix4x4> worlds_;
+	std::vector<Matrix4x4> worldInverseTransposes_;
+	std::vector<Handle> parents_;
+	std::vector<Handle> firstChildren_;
+	std::vector<Handle> nextSiblings_;
+	std::vector<uint32_t> versions_;
+	std::vector<uint8_t> dirty_;
+	std::vector<uint8_t> alive_;
+
+	// 空いているハンドル
+	std::vector<Handle> freeHandles_;
+
+	uint32_t recalculatedCount_ = 0;
+};
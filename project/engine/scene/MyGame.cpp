@@ -1,6 +1,5 @@
 #include "MyGame.h"
 
-#include <future>
 #include <chrono>
 #include "manager/graphics/ModelManager.h"
 #include "base/Logger.h"
@@ -8,6 +7,7 @@
 #include "ImGui/imgui_internal.h"
 #include "manager/graphics/TextureManager.h"
 #include "manager/graphics/LineManager.h"
+#include "manager/system/AssetLoader.h"
 
 void MyGame::Initialize()
 {
@@ -28,20 +28,10 @@ void MyGame::Initialize()
 	// 処理開始時間を記録
 	auto startTime = std::chrono::high_resolution_clock::now();
 
-	// テクスチャとモデルの読み込みを並列に実行
-	auto loadTexturesFuture = std::async(std::launch::async, [this]() {
-		// テクスチャの読み込み
-		LoadTextures();
-	});
-
-	auto loadModelsFuture = std::async(std::launch::async, [this]() {
-		// モデルの読み込み
-		LoadModels();
-	});
-
-	// 非同期タスクの完了を待つ
-	loadTexturesFuture.get();
-	loadModelsFuture.get();
+	// 全シーンで使うテクスチャとモデルをワーカースレッドで並列に読み込む
+	AssetManifest manifest;
+	DeclareStartupAssets(manifest);
+	AssetLoader::Load(manifest, "Startup");
 
 	// 処理終了時間を記録
 	auto endTime = std::chrono::high_resolution_clock::now();
@@ -57,8 +47,18 @@ void MyGame::Initialize()
 	//ゲームの初期化処理
 	sceneManager_->Initialize(context);
 
+	//モデルごとの読み込み時間（キャッシュとAssimpの比較。最初のシーンの分を含む）
+	ModelManager::GetInstance()->LogLoadReport();
+
 	// Skyboxの初期化
 	skybox_->Initialize(dxCommon_.get(), "./Resources/rostock_laage_airport_4k.dds");
+
+	//シェーダーごとのコンパイル時間（キャッシュとDXCの比較）
+	dxCommon_->LogShaderCompileReport();
+
+	//パイプラインの共有とライブラリの使用状況。起動時に作った分はここで書き出しておく
+	dxCommon_->GetPipelineCache()->LogReport();
+	dxCommon_->GetPipelineCache()->Save();
 }
 
 void MyGame::Finalize()
@@ -92,32 +92,63 @@ void MyGame::Draw()
 
 	srvManager_->PreDraw();
 
+	//並列に記録するコマンドリストも同じヒープでオフスクリーンに描く
+	dxCommon_->SetParallelPassSetup([this]()
+		{
+			srvManager_->SetDescriptorHeap();
+			renderTexture_->ResumeRender();
+		});
+
 	/////////////////< 描画ここから >////////////////////
 
 	// ---------- 3D描画 ---------
 
+	//ライトを書き込み、カメラから見たクラスタに振り分ける
+	lightManager_->PrepareDraw(cameraManager_->GetActiveCamera());
+
 	//3D描画用設定
 	Framework::Draw3DSetting();
 
 	//3Dオブジェクトの描画
 	sceneManager_->Draw3D();
 
+	//影を落とすオブジェクトが揃ったので、描き直しが必要なタイルだけ影を描く
+	if (objectCommon_->RenderShadows(lightManager_.get()))
+	{
+		//描画先をオフスクリーンに戻す
+		renderTexture_->ResumeRender();
+	}
+
+	//描画キューに積んだ3Dオブジェクトをまとめて描画
+	objectCommon_->FlushRenderQueue(cameraManager_->GetActiveCamera(), lightManager_.get());
+
 	//ラインの描画
 	LineManager::GetInstance()->RenderLines();
 
 	// Skyboxの描画
 	skybox_->Draw();
 
-	//パーティクルの描画
-	ParticleManager::GetInstance()->Draw();
-		
-	// ---------- 2D描画 ---------
+	// ---------- パーティクルと2D描画 ---------
+
+	//別々のコマンドリストに並列に記録する（パーティクル→2Dの順に実行される）
+	dxCommon_->RecordParallel(2, [this](uint32_t index)
+		{
+			if (index == 0)
+			{
+				//パーティクルの描画
+				ParticleManager::GetInstance()->Draw();
+				return;
+			}
 
-	//2D描画用設定
-	Framework::Draw2DSetting();
+			//2D描画用設定
+			Framework::Draw2DSetting();
 
-	//スプライトの描画
-	sceneManager_->Draw2D();
+			//スプライトをバッチに積む
+			sceneManager_->Draw2D();
+
+			//積んだスプライトをテクスチャの並びごとにまとめて描画
+			spriteCommon_->FlushBatch();
+		});
 
 	/////////////////< 描画ここまで >////////////////////
 
@@ -128,29 +159,29 @@ void MyGame::Draw()
 	imguiManager_->Draw();
 	dxCommon_->PostDraw();
 
-}
+	//今フレームに返したSRVの番号を、GPUが使い終わったら再利用できるようにする
+	srvManager_->PostDraw();
 
-void MyGame::LoadTextures()
-{
-	TextureManager::GetInstance()->LoadTexture("./Resources/uvChecker.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/black.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/testSprite.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/monsterBall.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/gradationLine.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/circle2.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/flowerfun.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/star.png");
-	TextureManager::GetInstance()->LoadTexture("./Resources/rostock_laage_airport_4k.dds");
 }
 
-void MyGame::LoadModels()
+void MyGame::DeclareStartupAssets(AssetManifest& manifest)
 {
-	ModelManager::GetInstance()->LoadModel("cube");
-	//ModelManager::GetInstance()->LoadModel("plane",".gltf");
-	ModelManager::GetInstance()->LoadModel("terrain");
-	ModelManager::GetInstance()->LoadModel("skydome");
-	ModelManager::GetInstance()->LoadModel("bullet");
-	ModelManager::GetInstance()->LoadModel("wall");
-	ModelManager::GetInstance()->LoadModel("player");
-	ModelManager::GetInstance()->LoadModel("enemy");
+	//テクスチャ
+	manifest.AddTexture("./Resources/uvChecker.png");
+	manifest.AddTexture("./Resources/black.png");
+	manifest.AddTexture("./Resources/testSprite.png");
+	manifest.AddTexture("./Resources/monsterBall.png");
+	manifest.AddTexture("./Resources/gradationLine.png");
+	manifest.AddTexture("./Resources/circle2.png");
+	manifest.AddTexture("./Resources/flowerfun.png");
+	manifest.AddTexture("./Resources/star.png");
+	manifest.AddTexture("./Resources/rostock_laage_airport_4k.dds");
+
+	//モデル（タイトルだけで使うものはTitleScene::DeclareAssetsで読む）
+	manifest.AddModel("cube");
+	//manifest.AddModel("plane",".gltf");
+	manifest.AddModel("bullet");
+	manifest.AddModel("wall");
+	manifest.AddModel("player");
+	manifest.AddModel("enemy");
 }
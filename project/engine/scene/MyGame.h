@@ -1,5 +1,6 @@
 #pragma once
 #include "framework/Framework.h"
+#include "manager/system/AssetManifest.h"
 
 class MyGame : public Framework
 {
@@ -16,9 +17,7 @@ public:
 	//描画
 	void Draw()override;
 private:
-	//テクスチャの読み込み
-	void LoadTextures();
-	//モデルの読み込み
-	void LoadModels();
+	//起動時にまとめて読み込む素材の一覧
+	void DeclareStartupAssets(AssetManifest& manifest);
 };
 
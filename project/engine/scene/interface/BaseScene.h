@@ -1,4 +1,6 @@
 #pragma once
+#include "manager/system/AssetManifest.h"
+
 class SceneManager;
 
 class BaseScene
@@ -16,8 +18,12 @@ public: //メンバ関数
 	virtual void Update() = 0;
 	//描画
 	virtual void Draw3D() = 0;
+	//2D描画（ワーカースレッドで呼ばれることがあるので、描画の記録だけを行う）
 	virtual void Draw2D() = 0;
 
+	//このシーンで使う素材（Initializeの前にまとめて並列に読み込まれる）
+	virtual void DeclareAssets(AssetManifest& manifest) const { (void)manifest; }
+
 	//シーンマネージャーのセット
 	void SetSceneManager(SceneManager* sceneManager) { sceneManager_ = sceneManager; }
 
@@ -2,6 +2,8 @@
 #include "engine/scene/factory/SceneFactory.h"
 #include <assert.h>
 
+#include "manager/system/AssetLoader.h"
+
 #include "externals/imgui/imgui.h"
 
 SceneManager::~SceneManager()
@@ -21,6 +23,7 @@ void SceneManager::Initialize(const SceneContext& context)
 	//最初のシーンを生成
 	currentScene_.reset(sceneFactory_->CreateScene(startSceneName));
 	currentScene_->SetSceneManager(this);
+	LoadSceneAssets(*currentScene_, startSceneName);
 	currentScene_->Initialize();
 	currentSceneName_ = startSceneName;
 }
@@ -94,6 +97,15 @@ void SceneManager::ReserveNextScene()
 		nextSceneName_ = "";
 		//次のシーンを初期化
 		currentScene_->SetSceneManager(this);
+		LoadSceneAssets(*currentScene_, currentSceneName_);
 		currentScene_->Initialize();
 	}
 }
+
+void SceneManager::LoadSceneAssets(const BaseScene& scene, const std::string& sceneName)
+{
+	//シーンが使う素材を並列に読み込む（読み込み済みのものは飛ばされる）
+	AssetManifest manifest;
+	scene.DeclareAssets(manifest);
+	AssetLoader::Load(manifest, sceneName);
+}
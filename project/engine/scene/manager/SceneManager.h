@@ -42,6 +42,8 @@ public: //アクセッサ
 private: //メンバ関数
 	//次のシーンが予約されているか
 	void ReserveNextScene();
+	//シーンが宣言した素材を読み込む
+	void LoadSceneAssets(const BaseScene& scene, const std::string& sceneName);
 
 private: //メンバ変数
 	//今のシーン
@@ -1,8 +1,24 @@
+#include <string>
+
+#include "engine/base/TextureCooker.h"
 #include "engine/scene/MyGame.h"
 
 //Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int)
 {
+	//テクスチャの変換だけを行う（ゲームは起動しない）
+	if (std::string(lpCmdLine).find(TextureCooker::kCommandLineOption) != std::string::npos)
+	{
+		//WICを使うのでCOMを初期化する
+		HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		TextureCooker::CookDirectory("Resources");
+		if (SUCCEEDED(hr))
+		{
+			CoUninitialize();
+		}
+		return 0;
+	}
+
 	//フレームワーク
 	Framework* game = new MyGame();
 
@@ -14,4 +30,4 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
 	//終了
 	return 0;
-}
\ No newline at end of file
+}
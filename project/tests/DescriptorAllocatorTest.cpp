@@ -0,0 +1,190 @@
+#include <random>
+#include <set>
+#include <vector>
+
+#include "TestFramework.h"
+#include "manager/system/DescriptorAllocator.h"
+
+TEST_CASE(DescriptorAllocator_FirstFitFromFront)
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(8);
+
+	const DescriptorAllocator::Handle a = allocator.Allocate();
+	const DescriptorAllocator::Handle b = allocator.Allocate(3);
+	const DescriptorAllocator::Handle c = allocator.Allocate(4);
+	TEST_CHECK(a.index == 0 && a.count == 1);
+	TEST_CHECK(b.index == 1 && b.count == 3);
+	TEST_CHECK(c.index == 4 && c.count == 4);
+	TEST_CHECK(allocator.GetFreeCount() == 0);
+	TEST_CHECK(!allocator.Allocate().IsValid());
+
+	// 空いた区間のうち、先頭に近くて収まるものから貸し出す
+	allocator.Free(a);
+	allocator.Free(c);
+	allocator.EndFrame(1);
+	allocator.Release(1);
+	TEST_CHECK(allocator.Allocate(2).index == 4);
+	TEST_CHECK(allocator.Allocate(1).index == 0);
+	TEST_CHECK(allocator.Allocate(2).index == 6);
+	TEST_CHECK(!allocator.Allocate(1).IsValid());
+}
+
+TEST_CASE(DescriptorAllocator_CoalescesFreeRanges)
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(8);
+
+	std::vector<DescriptorAllocator::Handle> handles;
+	for (int i = 0; i < 8; ++i)
+	{
+		handles.push_back(allocator.Allocate());
+	}
+
+	// 飛び飛びに返すと区間は分かれたまま
+	allocator.Free(handles[1]);
+	allocator.Free(handles[3]);
+	allocator.Free(handles[5]);
+	allocator.EndFrame(1);
+	allocator.Release(1);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 3);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 1);
+	TEST_CHECK(!allocator.Allocate(2).IsValid());
+
+	// 間を返すと前後の区間とつながる
+	allocator.Free(handles[2]);
+	allocator.Free(handles[4]);
+	allocator.EndFrame(2);
+	allocator.Release(2);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 5);
+	TEST_CHECK(allocator.Allocate(5).index == 1);
+
+	// 大きくした分は末尾の空き区間とつながる
+	allocator.Free(handles[7]);
+	allocator.EndFrame(3);
+	allocator.Release(3);
+	allocator.Grow(16);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 9);
+}
+
+TEST_CASE(DescriptorAllocator_GenerationInvalidatesStaleHandles)
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(4);
+
+	const DescriptorAllocator::Handle first = allocator.Allocate(2);
+	TEST_CHECK(allocator.IsValid(first));
+
+	allocator.Free(first);
+	TEST_CHECK(!allocator.IsValid(first));
+	allocator.EndFrame(1);
+	allocator.Release(1);
+
+	// 同じ番号を貸し出し直すと世代が進み、古いハンドルは無効のまま
+	const DescriptorAllocator::Handle second = allocator.Allocate(2);
+	TEST_CHECK(second.index == first.index);
+	TEST_CHECK(second.generation == first.generation + 1);
+	TEST_CHECK(allocator.IsValid(second));
+	TEST_CHECK(!allocator.IsValid(first));
+
+	// 個数が違うハンドルも無効
+	DescriptorAllocator::Handle wrongCount = second;
+	wrongCount.count = 1;
+	TEST_CHECK(!allocator.IsValid(wrongCount));
+}
+
+TEST_CASE(DescriptorAllocator_DefersReuseUntilFenceCompletes)
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(4);
+
+	const DescriptorAllocator::Handle a = allocator.Allocate(2);
+	const DescriptorAllocator::Handle b = allocator.Allocate(2);
+	allocator.Free(a);
+	allocator.EndFrame(5);
+	allocator.Free(b);
+	allocator.EndFrame(6);
+
+	// 返しただけでは貸し出せない
+	TEST_CHECK(allocator.GetPendingFreeCount() == 4);
+	TEST_CHECK(!allocator.Allocate().IsValid());
+
+	// 完了したフェンスの分だけ空きに戻る
+	allocator.Release(4);
+	TEST_CHECK(allocator.GetPendingFreeCount() == 4);
+	allocator.Release(5);
+	TEST_CHECK(allocator.GetPendingFreeCount() == 2);
+	TEST_CHECK(allocator.GetFreeCount() == 2);
+	TEST_CHECK(allocator.Allocate(2).index == 0);
+	TEST_CHECK(!allocator.Allocate().IsValid());
+
+	allocator.Release(6);
+	TEST_CHECK(allocator.GetPendingFreeCount() == 0);
+	TEST_CHECK(allocator.Allocate(2).index == 2);
+}
+
+TEST_CASE(DescriptorAllocator_RandomAllocationsStayDisjoint)
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(256);
+
+	std::mt19937 random(1);
+	std::vector<DescriptorAllocator::Handle> live;
+	uint64_t fence = 0;
+	bool isValid = true;
+	for (int frame = 0; frame < 5000 && isValid; ++frame)
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			if (random() % 2 && !live.empty())
+			{
+				const size_t k = random() % live.size();
+				allocator.Free(live[k]);
+				live[k] = live.back();
+				live.pop_back();
+				continue;
+			}
+
+			const DescriptorAllocator::Handle handle = allocator.Allocate(1 + random() % 6);
+			if (handle.IsValid())
+			{
+				live.push_back(handle);
+			}
+			else if (allocator.GetCapacity() < 4096)
+			{
+				allocator.Grow(allocator.GetCapacity() * 2);
+			}
+		}
+
+		// GPUが2フレーム遅れて追いかける
+		allocator.EndFrame(++fence);
+		allocator.Release(fence > 2 ? fence - 2 : 0);
+
+		std::set<uint32_t> used;
+		uint32_t allocatedCount = 0;
+		for (const DescriptorAllocator::Handle& handle : live)
+		{
+			isValid &= allocator.IsValid(handle);
+			for (uint32_t j = 0; j < handle.count; ++j)
+			{
+				isValid &= used.insert(handle.index + j).second;
+			}
+			allocatedCount += handle.count;
+		}
+		isValid &= allocatedCount == allocator.GetAllocatedCount();
+		isValid &= allocator.GetAllocatedCount() + allocator.GetPendingFreeCount() + allocator.GetFreeCount() == allocator.GetCapacity();
+	}
+	TEST_CHECK(isValid);
+
+	// 全て返せば1つの区間に戻る
+	for (const DescriptorAllocator::Handle& handle : live)
+	{
+		allocator.Free(handle);
+	}
+	allocator.EndFrame(++fence);
+	allocator.Release(fence);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetFreeCount() == allocator.GetCapacity());
+}
@@ -0,0 +1,168 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "TestFramework.h"
+#include "math/Frustum.h"
+
+namespace
+{
+	// 中心と半径を軸ごとに分けて持つAABBの並び
+	struct BoxSet
+	{
+		std::vector<float> centerX, centerY, centerZ;
+		std::vector<float> extentX, extentY, extentZ;
+
+		size_t Size() const { return centerX.size(); }
+
+		AABB Get(size_t i) const
+		{
+			const Vector3 center = { centerX[i], centerY[i], centerZ[i] };
+			const Vector3 extent = { extentX[i], extentY[i], extentZ[i] };
+			return AABB(center - extent, center + extent);
+		}
+	};
+
+	// 原点の少し後ろから斜めに見下ろすカメラの視錐台
+	Frustum MakeTestFrustum()
+	{
+		const Matrix4x4 cameraWorld = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.7f, 0.0f }, { 1.0f, 4.0f, -10.0f });
+		const Matrix4x4 projection = MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+		return Frustum::FromViewProjection(Multiply(Inverse(cameraWorld), projection));
+	}
+
+	BoxSet MakeRandomBoxes(size_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+		std::uniform_real_distribution<float> extent(0.01f, 3.0f);
+
+		BoxSet boxes;
+		for (size_t i = 0; i < count; ++i)
+		{
+			boxes.centerX.push_back(position(random));
+			boxes.centerY.push_back(position(random));
+			boxes.centerZ.push_back(position(random));
+			boxes.extentX.push_back(extent(random));
+			boxes.extentY.push_back(extent(random));
+			boxes.extentZ.push_back(extent(random));
+		}
+		return boxes;
+	}
+
+	// CullBoxesの結果が1個ずつの判定（IsVisible）と一致するか
+	bool MatchesScalar(const Frustum& frustum, const BoxSet& boxes, size_t first, size_t count)
+	{
+		std::vector<uint8_t> visible(count, 0xFF);
+		const uint32_t visibleCount = frustum.CullBoxes(
+			boxes.centerX.data() + first, boxes.centerY.data() + first, boxes.centerZ.data() + first,
+			boxes.extentX.data() + first, boxes.extentY.data() + first, boxes.extentZ.data() + first,
+			count, visible.data());
+
+		uint32_t expectedCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const bool expected = frustum.IsVisible(boxes.Get(first + i));
+			expectedCount += expected ? 1 : 0;
+			if (visible[i] != (expected ? 1 : 0))
+			{
+				return false;
+			}
+		}
+		return visibleCount == expectedCount;
+	}
+}
+
+TEST_CASE(Frustum_CullBoxesMatchesScalarPath)
+{
+	const Frustum frustum = MakeTestFrustum();
+	const BoxSet boxes = MakeRandomBoxes(20000, 1);
+
+	// 4個ずつの判定と1個ずつの判定が一致する
+	TEST_CHECK(MatchesScalar(frustum, boxes, 0, boxes.Size()));
+
+	// 見えるものと見えないものが両方含まれていること
+	std::vector<uint8_t> visible(boxes.Size());
+	const uint32_t visibleCount = frustum.CullBoxes(
+		boxes.centerX.data(), boxes.centerY.data(), boxes.centerZ.data(),
+		boxes.extentX.data(), boxes.extentY.data(), boxes.extentZ.data(),
+		boxes.Size(), visible.data());
+	TEST_CHECK(visibleCount > 0);
+	TEST_CHECK(visibleCount < boxes.Size());
+}
+
+TEST_CASE(Frustum_CullBoxesHandlesScalarTail)
+{
+	const Frustum frustum = MakeTestFrustum();
+	const BoxSet boxes = MakeRandomBoxes(4096, 2);
+
+	// 4で割り切れない個数と、4の倍数でない位置から始まる範囲
+	bool isValid = true;
+	for (size_t count = 0; count <= 13; ++count)
+	{
+		for (size_t first = 0; first < 4; ++first)
+		{
+			isValid &= MatchesScalar(frustum, boxes, first, count);
+		}
+	}
+	isValid &= MatchesScalar(frustum, boxes, 1, boxes.Size() - 2);
+	TEST_CHECK(isValid);
+}
+
+TEST_CASE(Frustum_CullsBoxesInFrontAndBehind)
+{
+	const Frustum frustum = MakeTestFrustum();
+	const Matrix4x4 cameraWorld = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.7f, 0.0f }, { 1.0f, 4.0f, -10.0f });
+	const Vector3 eye = { 1.0f, 4.0f, -10.0f };
+	const Vector3 forward = { cameraWorld.m[2][0], cameraWorld.m[2][1], cameraWorld.m[2][2] };
+	const Vector3 half = { 0.5f, 0.5f, 0.5f };
+
+	const Vector3 front = eye + forward * 10.0f;
+	const Vector3 behind = eye - forward * 10.0f;
+	TEST_CHECK(frustum.IsVisible(AABB(front - half, front + half)));
+	TEST_CHECK(!frustum.IsVisible(AABB(behind - half, behind + half)));
+}
+
+TEST_CASE(Frustum_TransformAABBBoundsAllCorners)
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	std::uniform_real_distribution<float> scale(0.1f, 3.0f);
+
+	bool isValid = true;
+	for (int n = 0; n < 1000; ++n)
+	{
+		const Vector3 min = { value(random), value(random), value(random) };
+		const AABB local(min, min + Vector3{ scale(random), scale(random), scale(random) });
+		const Matrix4x4 matrix = MakeAffineMatrix(
+			{ scale(random), scale(random), scale(random) },
+			{ value(random), value(random), value(random) },
+			{ value(random) * 10.0f, value(random) * 10.0f, value(random) * 10.0f });
+		const AABB world = TransformAABB(local, matrix);
+
+		// 8つの角を変換したものを包むAABBと一致する（アフィン変換なら隙間なく包む）
+		Vector3 expectedMin = { INFINITY, INFINITY, INFINITY };
+		Vector3 expectedMax = { -INFINITY, -INFINITY, -INFINITY };
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			const Vector3 p = {
+				(corner & 1) ? local.max_.x : local.min_.x,
+				(corner & 2) ? local.max_.y : local.min_.y,
+				(corner & 4) ? local.max_.z : local.min_.z,
+			};
+			const Vector3 q = {
+				p.x * matrix.m[0][0] + p.y * matrix.m[1][0] + p.z * matrix.m[2][0] + matrix.m[3][0],
+				p.x * matrix.m[0][1] + p.y * matrix.m[1][1] + p.z * matrix.m[2][1] + matrix.m[3][1],
+				p.x * matrix.m[0][2] + p.y * matrix.m[1][2] + p.z * matrix.m[2][2] + matrix.m[3][2],
+			};
+			expectedMin = { std::fmin(expectedMin.x, q.x), std::fmin(expectedMin.y, q.y), std::fmin(expectedMin.z, q.z) };
+			expectedMax = { std::fmax(expectedMax.x, q.x), std::fmax(expectedMax.y, q.y), std::fmax(expectedMax.z, q.z) };
+		}
+
+		constexpr float kEpsilon = 1e-3f;
+		isValid &= std::fabs(world.min_.x - expectedMin.x) < kEpsilon && std::fabs(world.max_.x - expectedMax.x) < kEpsilon;
+		isValid &= std::fabs(world.min_.y - expectedMin.y) < kEpsilon && std::fabs(world.max_.y - expectedMax.y) < kEpsilon;
+		isValid &= std::fabs(world.min_.z - expectedMin.z) < kEpsilon && std::fabs(world.max_.z - expectedMax.z) < kEpsilon;
+	}
+	TEST_CHECK(isValid);
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "TestFramework.h"
+#include "light/LightCluster.h"
+
+namespace
+{
+	constexpr float kScreenWidth = 1280.0f;
+	constexpr float kScreenHeight = 720.0f;
+	constexpr float kFovY = 0.45f;
+	constexpr float kNearClip = 0.1f;
+	constexpr float kFarClip = 100.0f;
+
+	struct PointLightDesc
+	{
+		Vector3 position;
+		float radius;
+	};
+
+	struct SpotLightDesc
+	{
+		Vector3 position;
+		Vector3 direction;
+		float distance;
+		float cosAngle;
+	};
+
+	// カメラとライトの並び
+	struct LightScene
+	{
+		Matrix4x4 view;
+		Matrix4x4 inverseViewProjection;
+		std::vector<PointLightDesc> pointLights;
+		std::vector<SpotLightDesc> spotLights;
+	};
+
+	LightScene MakeLightScene(uint32_t lightCount, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> signedValue(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> unitValue(0.0f, 1.0f);
+
+		LightScene scene;
+		const Matrix4x4 cameraWorld = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 2.0f, 4.0f, -10.0f });
+		const Matrix4x4 projection = MakePerspectiveFovMatrix(kFovY, kScreenWidth / kScreenHeight, kNearClip, kFarClip);
+		scene.view = Inverse(cameraWorld);
+		scene.inverseViewProjection = Inverse(Multiply(scene.view, projection));
+
+		// 半分をポイントライト、残りをスポットライトにする
+		for (uint32_t i = 0; i < lightCount / 2; ++i)
+		{
+			const Vector3 position = { signedValue(random) * 40.0f, signedValue(random) * 10.0f, signedValue(random) * 40.0f + 20.0f };
+			scene.pointLights.push_back({ position, 1.0f + unitValue(random) * 6.0f });
+		}
+		for (uint32_t i = lightCount / 2; i < lightCount; ++i)
+		{
+			const Vector3 position = { signedValue(random) * 40.0f, signedValue(random) * 10.0f, signedValue(random) * 40.0f + 20.0f };
+			const Vector3 direction = Vector3::Normalize({ signedValue(random), signedValue(random), signedValue(random) });
+			scene.spotLights.push_back({ position, direction, 2.0f + unitValue(random) * 10.0f, std::cos(0.1f + unitValue(random) * 1.6f) });
+		}
+		return scene;
+	}
+
+	void BuildCluster(LightCluster& cluster, const LightScene& scene)
+	{
+		cluster.Begin(scene.view);
+		for (const PointLightDesc& light : scene.pointLights)
+		{
+			cluster.AddPointLight(light.position, light.radius);
+		}
+		for (const SpotLightDesc& light : scene.spotLights)
+		{
+			cluster.AddSpotLight(light.position, light.direction, light.distance, light.cosAngle);
+		}
+		cluster.Build();
+	}
+
+	// 画面上の点と深度（0～1）からワールド座標を求める
+	Vector3 Unproject(const LightScene& scene, float pixelX, float pixelY, float depth)
+	{
+		const float ndc[4] = { pixelX / kScreenWidth * 2.0f - 1.0f, 1.0f - pixelY / kScreenHeight * 2.0f, depth, 1.0f };
+		float clip[4] = {};
+		for (int j = 0; j < 4; ++j)
+		{
+			for (int k = 0; k < 4; ++k)
+			{
+				clip[j] += ndc[k] * scene.inverseViewProjection.m[k][j];
+			}
+		}
+		return Vector3{ clip[0] / clip[3], clip[1] / clip[3], clip[2] / clip[3] };
+	}
+
+	float ViewDepth(const LightScene& scene, const Vector3& world)
+	{
+		return world.x * scene.view.m[0][2] + world.y * scene.view.m[1][2] + world.z * scene.view.m[2][2] + scene.view.m[3][2];
+	}
+
+	// 画面内のランダムな点で、その点を照らすライトが全てクラスタに入っているか数える
+	uint32_t CountMissingLights(const LightCluster& cluster, const LightScene& scene, uint32_t sampleCount, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> unitValue(0.0f, 1.0f);
+		const std::vector<uint32_t>& indices = cluster.GetLightIndices();
+
+		uint32_t missCount = 0;
+		for (uint32_t sample = 0; sample < sampleCount; ++sample)
+		{
+			const float pixelX = unitValue(random) * kScreenWidth;
+			const float pixelY = unitValue(random) * kScreenHeight;
+			const Vector3 world = Unproject(scene, pixelX, pixelY, unitValue(random));
+
+			const LightCluster::ClusterRange range = cluster.GetRanges()[cluster.FindCluster(pixelX, pixelY, ViewDepth(scene, world))];
+			const auto pointBegin = indices.begin() + range.offset;
+			const auto pointEnd = pointBegin + (range.counts & 0xFFFF);
+			const auto spotEnd = pointEnd + (range.counts >> 16);
+
+			for (uint32_t i = 0; i < scene.pointLights.size(); ++i)
+			{
+				const PointLightDesc& light = scene.pointLights[i];
+				if (Vector3::Length(world - light.position) < light.radius && !std::binary_search(pointBegin, pointEnd, i))
+				{
+					++missCount;
+				}
+			}
+			for (uint32_t i = 0; i < scene.spotLights.size(); ++i)
+			{
+				const SpotLightDesc& light = scene.spotLights[i];
+				const Vector3 toPoint = world - light.position;
+				const float distance = Vector3::Length(toPoint);
+				if (distance <= 0.0f || distance >= light.distance || Vector3::Dot(toPoint * (1.0f / distance), light.direction) < light.cosAngle)
+				{
+					continue;
+				}
+				if (!std::binary_search(pointEnd, spotEnd, i))
+				{
+					++missCount;
+				}
+			}
+		}
+		return missCount;
+	}
+}
+
+TEST_CASE(LightCluster_BinsEveryAffectingLight)
+{
+	const LightScene scene = MakeLightScene(200, 7);
+	LightCluster cluster;
+	cluster.SetProjection(kFovY, kScreenWidth / kScreenHeight, kNearClip, kFarClip, kScreenWidth, kScreenHeight);
+	BuildCluster(cluster, scene);
+
+	TEST_CHECK(CountMissingLights(cluster, scene, 20000, 11) == 0);
+	TEST_CHECK(cluster.GetStats().visibleLightCount > 0);
+}
+
+TEST_CASE(LightCluster_RangesCoverIndexList)
+{
+	const LightScene scene = MakeLightScene(200, 8);
+	LightCluster cluster;
+	cluster.SetProjection(kFovY, kScreenWidth / kScreenHeight, kNearClip, kFarClip, kScreenWidth, kScreenHeight);
+	BuildCluster(cluster, scene);
+
+	const std::vector<LightCluster::ClusterRange>& ranges = cluster.GetRanges();
+	const std::vector<uint32_t>& indices = cluster.GetLightIndices();
+	TEST_CHECK(ranges.size() == LightCluster::kClusterCount);
+
+	// 各クラスタの範囲が重ならずに並び、合計が統計と一致する
+	uint32_t total = 0;
+	uint32_t maxCount = 0;
+	bool isValid = true;
+	for (const LightCluster::ClusterRange& range : ranges)
+	{
+		const uint32_t pointCount = range.counts & 0xFFFF;
+		const uint32_t spotCount = range.counts >> 16;
+		isValid &= range.offset == total;
+		isValid &= std::is_sorted(indices.begin() + range.offset, indices.begin() + range.offset + pointCount);
+		total += pointCount + spotCount;
+		maxCount = (std::max)(maxCount, pointCount + spotCount);
+	}
+	TEST_CHECK(isValid);
+	TEST_CHECK(total == indices.size());
+	TEST_CHECK(total == cluster.GetStats().indexCount);
+	TEST_CHECK(maxCount == cluster.GetStats().maxLightsPerCluster);
+}
+
+TEST_CASE(LightCluster_SkipsLightsOutsideFrustum)
+{
+	LightScene scene = MakeLightScene(0, 9);
+	// カメラの真後ろと、遠すぎる位置に置く
+	const Vector3 eye = { 2.0f, 4.0f, -10.0f };
+	const Vector3 forward = Vector3::Normalize(Unproject(scene, kScreenWidth * 0.5f, kScreenHeight * 0.5f, 0.5f) - eye);
+	scene.pointLights.push_back({ eye - forward * 5.0f, 1.0f });
+	scene.pointLights.push_back({ eye + forward * (kFarClip + 10.0f), 1.0f });
+
+	LightCluster cluster;
+	cluster.SetProjection(kFovY, kScreenWidth / kScreenHeight, kNearClip, kFarClip, kScreenWidth, kScreenHeight);
+	BuildCluster(cluster, scene);
+	TEST_CHECK(cluster.GetStats().visibleLightCount == 0);
+	TEST_CHECK(cluster.GetLightIndices().empty());
+
+	// 正面に置けば、画面中央のクラスタに入る
+	const Vector3 front = eye + forward * 10.0f;
+	scene.pointLights.push_back({ front, 1.0f });
+	BuildCluster(cluster, scene);
+	const uint32_t center = cluster.FindCluster(kScreenWidth * 0.5f, kScreenHeight * 0.5f, ViewDepth(scene, front));
+	const LightCluster::ClusterRange range = cluster.GetRanges()[center];
+	TEST_CHECK(cluster.GetStats().visibleLightCount == 1);
+	TEST_CHECK((range.counts & 0xFFFF) == 1);
+	TEST_CHECK(cluster.GetLightIndices()[range.offset] == 2);
+}
+
+BENCHMARK_CASE(LightCluster_Benchmark1000Lights)
+{
+	constexpr uint32_t kLightCount = 1000;
+	constexpr int kIterationCount = 200;
+	constexpr uint32_t kSampleCount = 100000;
+
+	const LightScene scene = MakeLightScene(kLightCount, 7);
+	LightCluster cluster;
+	cluster.SetProjection(kFovY, kScreenWidth / kScreenHeight, kNearClip, kFarClip, kScreenWidth, kScreenHeight);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < kIterationCount; ++i)
+	{
+		BuildCluster(cluster, scene);
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const double buildUs = std::chrono::duration<double, std::micro>(end - start).count() / kIterationCount;
+
+	// ピクセルごとに計算するライトの数（クラスタなしなら全てのライト）
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> unitValue(0.0f, 1.0f);
+	uint64_t clusteredCount = 0;
+	for (uint32_t sample = 0; sample < kSampleCount; ++sample)
+	{
+		const float pixelX = unitValue(random) * kScreenWidth;
+		const float pixelY = unitValue(random) * kScreenHeight;
+		const Vector3 world = Unproject(scene, pixelX, pixelY, unitValue(random));
+		const uint32_t counts = cluster.GetRanges()[cluster.FindCluster(pixelX, pixelY, ViewDepth(scene, world))].counts;
+		clusteredCount += (counts & 0xFFFF) + (counts >> 16);
+	}
+
+	const LightCluster::Stats& stats = cluster.GetStats();
+	std::printf("    %u lights: build %.1f us, visible %u, indices %u, max/cluster %u, lights per pixel %u -> %.2f\n",
+				kLightCount, buildUs, stats.visibleLightCount, stats.indexCount, stats.maxLightsPerCluster,
+				kLightCount, static_cast<double>(clusteredCount) / kSampleCount);
+	TEST_CHECK(CountMissingLights(cluster, scene, 2000, 5) == 0);
+}
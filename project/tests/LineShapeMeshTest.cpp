@@ -0,0 +1,107 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "TestFramework.h"
+#include "line/LineShapeMesh.h"
+#include "math/MatrixFunc.h"
+
+namespace
+{
+	constexpr float kEpsilon = 1e-4f;
+
+	bool IsNear(const Vector3& a, const Vector3& b)
+	{
+		return std::fabs(a.x - b.x) < kEpsilon && std::fabs(a.y - b.y) < kEpsilon && std::fabs(a.z - b.z) < kEpsilon;
+	}
+
+	// 線分リストの終点が全て別の線分の始点になっているか（一周して閉じているか）
+	bool IsClosedLoop(const std::vector<Vector3>& vertices)
+	{
+		for (size_t i = 1; i < vertices.size(); i += 2)
+		{
+			bool isConnected = false;
+			for (size_t j = 0; j < vertices.size(); j += 2)
+			{
+				isConnected |= vertices[i].x == vertices[j].x && vertices[i].y == vertices[j].y && vertices[i].z == vertices[j].z;
+			}
+			if (!isConnected)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE(LineShapeMesh_UnitShapesLieOnSurface)
+{
+	const std::vector<Vector3> box = LineShapeMesh::BuildBox();
+	bool isOnBox = box.size() == 24;
+	for (const Vector3& v : box)
+	{
+		isOnBox &= std::fabs(v.x) == 1.0f && std::fabs(v.y) == 1.0f && std::fabs(v.z) == 1.0f;
+	}
+	// 各辺はちょうど1つの軸に沿う
+	for (size_t i = 0; i < box.size(); i += 2)
+	{
+		const int differentAxes = (box[i].x != box[i + 1].x) + (box[i].y != box[i + 1].y) + (box[i].z != box[i + 1].z);
+		isOnBox &= differentAxes == 1;
+	}
+	TEST_CHECK(isOnBox);
+
+	const std::vector<Vector3> sphere = LineShapeMesh::BuildSphere();
+	bool isOnSphere = sphere.size() == 2 * (LineShapeMesh::kSphereSegments * LineShapeMesh::kSphereRings + LineShapeMesh::kSphereSegments * (LineShapeMesh::kSphereRings - 1));
+	for (const Vector3& v : sphere)
+	{
+		isOnSphere &= std::fabs(std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z) - 1.0f) < kEpsilon;
+	}
+	TEST_CHECK(isOnSphere);
+
+	const std::vector<Vector3> circle = LineShapeMesh::BuildCircle();
+	bool isOnCircle = circle.size() == 2 * LineShapeMesh::kCircleSegments;
+	for (const Vector3& v : circle)
+	{
+		isOnCircle &= v.y == 0.0f && std::fabs(std::sqrt(v.x * v.x + v.z * v.z) - 1.0f) < kEpsilon;
+	}
+	TEST_CHECK(isOnCircle);
+	// 最後の線分は誤差なく最初の点に戻る
+	TEST_CHECK(IsClosedLoop(circle));
+}
+
+TEST_CASE(LineShapeMesh_InstanceMatchesAffineMatrix)
+{
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	const std::vector<Vector3> box = LineShapeMesh::BuildBox();
+
+	bool isValid = true;
+	for (int n = 0; n < 200; ++n)
+	{
+		const Matrix4x4 matrix = MakeAffineMatrix(
+			{ scale(random), scale(random), scale(random) },
+			{ value(random), value(random), value(random) },
+			{ value(random) * 10.0f, value(random) * 10.0f, value(random) * 10.0f });
+
+		// 行列の各行が単位形状の軸と原点の行き先になる
+		const LineShapeInstance instance = LineShapeMesh::MakeInstance(
+			{ matrix.m[0][0], matrix.m[0][1], matrix.m[0][2] },
+			{ matrix.m[1][0], matrix.m[1][1], matrix.m[1][2] },
+			{ matrix.m[2][0], matrix.m[2][1], matrix.m[2][2] },
+			{ matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] },
+			{ 1.0f, 0.0f, 0.0f, 1.0f });
+
+		// OBBの8つの角（箱の頂点）が行列で変換したものと一致する
+		for (const Vector3& p : box)
+		{
+			const Vector3 expected = {
+				p.x * matrix.m[0][0] + p.y * matrix.m[1][0] + p.z * matrix.m[2][0] + matrix.m[3][0],
+				p.x * matrix.m[0][1] + p.y * matrix.m[1][1] + p.z * matrix.m[2][1] + matrix.m[3][1],
+				p.x * matrix.m[0][2] + p.y * matrix.m[1][2] + p.z * matrix.m[2][2] + matrix.m[3][2],
+			};
+			isValid &= IsNear(LineShapeMesh::Transform(instance, p), expected);
+		}
+	}
+	TEST_CHECK(isValid);
+}
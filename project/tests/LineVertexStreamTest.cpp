@@ -0,0 +1,187 @@
+#include <deque>
+#include <vector>
+
+#include "TestFramework.h"
+#include "line/LineVertexStream.h"
+
+namespace
+{
+	constexpr uint32_t kVerticesPerChunk = LineVertexStream::kVerticesPerChunk;
+	constexpr uint32_t kMaxVertexCount = LineVertexStream::kMaxVertexCount;
+
+	// アップロード用リングの代わりに、CPUのメモリから塊を切り出す
+	struct FakeChunkSource
+	{
+		std::deque<std::vector<LineVertex>> chunks;
+		uint32_t limit = UINT32_MAX;	// これ以上は切り出せない
+
+		LineVertexStream::ChunkAllocator MakeAllocator()
+		{
+			return [this]()
+				{
+					LineVertexStream::Chunk chunk;
+					if (chunks.size() >= limit)
+					{
+						return chunk;
+					}
+					chunks.emplace_back(kVerticesPerChunk);
+					chunk.data = chunks.back().data();
+					chunk.gpuAddress = chunks.size();
+					return chunk;
+				};
+		}
+	};
+
+	// 始点のxに識別用の番号を入れた線分を積む
+	bool AddTagged(LineVertexStream& stream, uint64_t frame, float id)
+	{
+		return stream.AddLine(frame, { id, 0.0f, 0.0f }, { id, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f });
+	}
+
+	// 塊を順にたどった線分の並び（識別用の番号）。始点と終点が崩れていれば-1を入れる
+	std::vector<float> LineIds(const std::vector<LineVertexStream::Chunk>& chunks)
+	{
+		std::vector<float> ids;
+		for (const LineVertexStream::Chunk& chunk : chunks)
+		{
+			for (uint32_t i = 0; i + 1 < chunk.vertexCount; i += 2)
+			{
+				const LineVertex& start = chunk.data[i];
+				const LineVertex& end = chunk.data[i + 1];
+				const bool isIntact = start.position.x == end.position.x && start.position.y == 0.0f && end.position.y == 1.0f;
+				ids.push_back(isIntact ? start.position.x : -1.0f);
+			}
+		}
+		return ids;
+	}
+}
+
+TEST_CASE(LineVertexStream_SplitsLinesIntoChunks)
+{
+	FakeChunkSource source;
+	LineVertexStream stream;
+	stream.Initialize(source.MakeAllocator());
+
+	// 1つの塊にちょうど収まる分と、はみ出す1本
+	const uint32_t lineCount = kVerticesPerChunk / 2 + 1;
+	for (uint32_t i = 0; i < lineCount; ++i)
+	{
+		AddTagged(stream, 1, static_cast<float>(i));
+	}
+	TEST_CHECK(stream.GetVertexCount() == lineCount * 2);
+	TEST_CHECK(stream.GetChunkCount() == 2);
+
+	const std::vector<LineVertexStream::Chunk>& chunks = stream.BeginDraw(1);
+	TEST_CHECK(chunks[0].vertexCount == kVerticesPerChunk);
+	TEST_CHECK(chunks[1].vertexCount == 2);
+	TEST_CHECK(chunks[0].gpuAddress != chunks[1].gpuAddress);
+
+	// 線分は塊をまたがず、積んだ順に並ぶ
+	const std::vector<float> ids = LineIds(chunks);
+	bool isInOrder = ids.size() == lineCount;
+	for (uint32_t i = 0; i < ids.size(); ++i)
+	{
+		isInOrder &= ids[i] == static_cast<float>(i);
+	}
+	TEST_CHECK(isInOrder);
+}
+
+TEST_CASE(LineVertexStream_CapsVerticesPerFrame)
+{
+	FakeChunkSource source;
+	LineVertexStream stream;
+	stream.Initialize(source.MakeAllocator());
+
+	bool isAccepted = true;
+	for (uint32_t i = 0; i < kMaxVertexCount / 2; ++i)
+	{
+		isAccepted &= AddTagged(stream, 1, 0.0f);
+	}
+	TEST_CHECK(isAccepted);
+	TEST_CHECK(stream.GetVertexCount() == kMaxVertexCount);
+	TEST_CHECK(stream.GetChunkCount() == kMaxVertexCount / kVerticesPerChunk);
+
+	// 上限を超えた分は捨てて、塊も増やさない
+	TEST_CHECK(!AddTagged(stream, 1, 0.0f));
+	TEST_CHECK(!AddTagged(stream, 1, 0.0f));
+	TEST_CHECK(stream.GetVertexCount() == kMaxVertexCount);
+	TEST_CHECK(stream.GetDroppedVertexCount() == 4);
+	TEST_CHECK(source.chunks.size() == kMaxVertexCount / kVerticesPerChunk);
+
+	// 描画して破棄すれば、次のフレームはまた積める
+	stream.BeginDraw(1);
+	stream.Clear();
+	TEST_CHECK(stream.GetDroppedVertexCount() == 0);
+	TEST_CHECK(AddTagged(stream, 2, 0.0f));
+	TEST_CHECK(stream.GetVertexCount() == 2);
+}
+
+TEST_CASE(LineVertexStream_DefersLinesAddedAfterDraw)
+{
+	FakeChunkSource source;
+	LineVertexStream stream;
+	stream.Initialize(source.MakeAllocator());
+
+	AddTagged(stream, 1, 1.0f);
+	TEST_CHECK(LineIds(stream.BeginDraw(1)) == std::vector<float>({ 1.0f }));
+	stream.Clear();
+
+	// 描画の後に追加された線は、領域を切り出さずに取っておく
+	const size_t chunkCountBefore = source.chunks.size();
+	TEST_CHECK(AddTagged(stream, 1, 2.0f));
+	TEST_CHECK(AddTagged(stream, 1, 3.0f));
+	TEST_CHECK(stream.GetVertexCount() == 0);
+	TEST_CHECK(stream.GetLateVertexCount() == 4);
+	TEST_CHECK(source.chunks.size() == chunkCountBefore);
+
+	// 次のフレームの描画で、そのフレームに積んだ線の後ろに書き込む
+	AddTagged(stream, 2, 4.0f);
+	TEST_CHECK(LineIds(stream.BeginDraw(2)) == std::vector<float>({ 4.0f, 2.0f, 3.0f }));
+	TEST_CHECK(stream.GetLateVertexCount() == 0);
+	stream.Clear();
+
+	// 同じフレームにもう1度描画しても、取っておいた線は次の描画に回る
+	AddTagged(stream, 2, 5.0f);
+	TEST_CHECK(stream.BeginDraw(2).empty());
+	TEST_CHECK(stream.GetLateVertexCount() == 2);
+	TEST_CHECK(LineIds(stream.BeginDraw(3)) == std::vector<float>({ 5.0f }));
+}
+
+TEST_CASE(LineVertexStream_DiscardsStaleChunks)
+{
+	FakeChunkSource source;
+	LineVertexStream stream;
+	stream.Initialize(source.MakeAllocator());
+
+	// 描画されないままフレームが進むと、前のフレームの塊は捨てる
+	AddTagged(stream, 1, 1.0f);
+	AddTagged(stream, 1, 2.0f);
+	AddTagged(stream, 2, 3.0f);
+	TEST_CHECK(stream.GetVertexCount() == 2);
+	TEST_CHECK(stream.GetChunkCount() == 1);
+	TEST_CHECK(LineIds(stream.BeginDraw(2)) == std::vector<float>({ 3.0f }));
+	stream.Clear();
+
+	// 描画の直前にフレームが進んでいても捨てる
+	AddTagged(stream, 3, 4.0f);
+	TEST_CHECK(stream.BeginDraw(4).empty());
+	TEST_CHECK(stream.GetVertexCount() == 0);
+}
+
+TEST_CASE(LineVertexStream_DropsLinesWhenAllocationFails)
+{
+	FakeChunkSource source;
+	source.limit = 1;
+	LineVertexStream stream;
+	stream.Initialize(source.MakeAllocator());
+
+	for (uint32_t i = 0; i < kVerticesPerChunk / 2; ++i)
+	{
+		AddTagged(stream, 1, 0.0f);
+	}
+	// 次の塊を切り出せなければ捨てる
+	TEST_CHECK(!AddTagged(stream, 1, 0.0f));
+	TEST_CHECK(stream.GetVertexCount() == kVerticesPerChunk);
+	TEST_CHECK(stream.GetChunkCount() == 1);
+	TEST_CHECK(stream.GetDroppedVertexCount() == 2);
+}
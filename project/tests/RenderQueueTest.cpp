@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestFramework.h"
+#include "graphics/3d/RenderQueue.h"
+#include "math/Frustum.h"
+
+namespace
+{
+	// RenderQueueはモデルをポインタの比較にしか使わないので、中身のない番地で代用する
+	int modelStorage[2];
+	Model* const kModelA = reinterpret_cast<Model*>(&modelStorage[0]);
+	Model* const kModelB = reinterpret_cast<Model*>(&modelStorage[1]);
+
+	// 平行移動のxに識別用の番号を入れた変換行列
+	TransformationMatrix MakeTaggedTransform(float id)
+	{
+		TransformationMatrix transform{};
+		transform.World = MakeIdentity4x4();
+		transform.World.m[3][0] = id;
+		return transform;
+	}
+
+	void SubmitAt(RenderQueue& queue, Model* model, RenderQueue::Layer layer, uint32_t materialId, uint32_t modelId, float depth, float id, const Vector3& position = { 0.0f, 0.0f, 10.0f })
+	{
+		const Vector3 half = { 0.5f, 0.5f, 0.5f };
+		queue.Submit(model, layer, materialId, modelId, depth, MakeTaggedTransform(id), AABB(position - half, position + half));
+	}
+
+	// Build後のインスタンスの並び（識別用の番号）
+	std::vector<float> InstanceIds(const RenderQueue& queue)
+	{
+		std::vector<float> ids;
+		for (const InstanceData& instance : queue.GetInstances())
+		{
+			ids.push_back(instance.transform.World.m[3][0]);
+		}
+		return ids;
+	}
+}
+
+TEST_CASE(RenderQueue_SortsOpaqueFrontToBackAndTransparentBackToFront)
+{
+	RenderQueue queue;
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 2.0f, 12.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 5.0f, 5.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 8.0f, 18.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 1.0f, 1.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 4.0f, 14.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 3.0f, 3.0f);
+	queue.Build();
+
+	// 不透明が先に手前から、半透明が後に奥から並ぶ
+	TEST_CHECK(InstanceIds(queue) == std::vector<float>({ 1.0f, 3.0f, 5.0f, 18.0f, 14.0f, 12.0f }));
+
+	// キーの大小関係もそのとおりになっている
+	using Layer = RenderQueue::Layer;
+	TEST_CHECK(RenderQueue::MakeSortKey(Layer::Opaque, 0, 0, 1.0f) < RenderQueue::MakeSortKey(Layer::Opaque, 0, 0, 2.0f));
+	TEST_CHECK(RenderQueue::MakeSortKey(Layer::Transparent, 0, 0, 2.0f) < RenderQueue::MakeSortKey(Layer::Transparent, 0, 0, 1.0f));
+	TEST_CHECK(RenderQueue::MakeSortKey(Layer::Opaque, 0xFFFF, 0xFFFF, 1000.0f) < RenderQueue::MakeSortKey(Layer::Transparent, 0, 0, 1000.0f));
+	// 不透明はモデルが深度より優先される
+	TEST_CHECK(RenderQueue::MakeSortKey(Layer::Opaque, 0, 0, 100.0f) < RenderQueue::MakeSortKey(Layer::Opaque, 0, 1, 1.0f));
+}
+
+TEST_CASE(RenderQueue_MergesSameModelIntoOneBatch)
+{
+	RenderQueue queue;
+	// 不透明は積んだ順が飛び飛びでも、同じモデルは隣り合ってまとまる（マテリアルが違ってもよい）
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 1.0f, 1.0f);
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Opaque, 0, 1, 2.0f, 2.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 3, 0, 3.0f, 3.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 1, 0, 4.0f, 4.0f);
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Opaque, 2, 1, 5.0f, 5.0f);
+	queue.Build();
+
+	const std::vector<RenderQueue::Batch>& batches = queue.GetBatches();
+	TEST_CHECK(batches.size() == 2);
+	TEST_CHECK(batches[0].model == kModelA && batches[0].firstInstance == 0 && batches[0].instanceCount == 3);
+	TEST_CHECK(batches[1].model == kModelB && batches[1].firstInstance == 3 && batches[1].instanceCount == 2);
+	TEST_CHECK(queue.GetInstances().size() == 5);
+	// マテリアルの番号はインスタンスごとに残る
+	TEST_CHECK(queue.GetInstances()[1].materialIndex == 1);
+	TEST_CHECK(queue.GetInstances()[2].materialIndex == 3);
+
+	// 半透明は深度の順を優先するので、モデルが交互ならまとめない
+	queue.Clear();
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 4.0f, 4.0f);
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Transparent, 0, 1, 3.0f, 3.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 2.0f, 2.0f);
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Transparent, 0, 0, 1.0f, 1.0f);
+	queue.Build();
+	TEST_CHECK(queue.GetBatchCount() == 3);
+	TEST_CHECK(queue.GetBatches()[2].model == kModelA && queue.GetBatches()[2].instanceCount == 2);
+}
+
+TEST_CASE(RenderQueue_CulledItemsNeverReachBatches)
+{
+	// 原点から+Zを向くカメラ
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+	const Frustum frustum = Frustum::FromViewProjection(Multiply(MakeIdentity4x4(), projection));
+
+	RenderQueue queue;
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 10.0f, 1.0f, { 0.0f, 0.0f, 10.0f });
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 0.0f, 2.0f, { 0.0f, 0.0f, -10.0f });		// 後ろ
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Opaque, 0, 1, 10.0f, 3.0f, { 500.0f, 0.0f, 10.0f });	// 横
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Transparent, 0, 1, 200.0f, 4.0f, { 0.0f, 0.0f, 200.0f });	// 遠クリップより奥
+	SubmitAt(queue, kModelB, RenderQueue::Layer::Transparent, 0, 1, 20.0f, 5.0f, { 1.0f, 1.0f, 20.0f });
+
+	TEST_CHECK(queue.Cull(frustum) == 2);
+	queue.Build();
+	TEST_CHECK(InstanceIds(queue) == std::vector<float>({ 1.0f, 5.0f }));
+	TEST_CHECK(queue.GetBatchCount() == 2);
+	TEST_CHECK(queue.GetBatches()[0].model == kModelA && queue.GetBatches()[0].instanceCount == 1);
+	TEST_CHECK(queue.GetBatches()[1].model == kModelB && queue.GetBatches()[1].instanceCount == 1);
+
+	// 全て外なら何もまとめない
+	queue.Clear();
+	SubmitAt(queue, kModelA, RenderQueue::Layer::Opaque, 0, 0, 0.0f, 1.0f, { 0.0f, 0.0f, -10.0f });
+	TEST_CHECK(queue.Cull(frustum) == 0);
+	queue.Build();
+	TEST_CHECK(queue.GetBatches().empty());
+	TEST_CHECK(queue.GetInstances().empty());
+}
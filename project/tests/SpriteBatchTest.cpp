@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestFramework.h"
+#include "graphics/2d/SpriteBatch.h"
+
+namespace
+{
+	constexpr uint32_t kVerticesPerQuad = SpriteBatch::kVerticesPerQuad;
+
+	// 位置のxに識別用の番号を入れた矩形を積む
+	bool AddTagged(SpriteBatch& batch, uint32_t textureIndex, int32_t layer, float id)
+	{
+		SpriteVertex vertices[kVerticesPerQuad] = {};
+		for (uint32_t i = 0; i < kVerticesPerQuad; ++i)
+		{
+			vertices[i].position = { id, static_cast<float>(i), 0.0f, 1.0f };
+		}
+		return batch.Add(textureIndex, layer, vertices);
+	}
+
+	// Build後の並び（識別用の番号）。4頂点が崩れずに並んでいなければ-1を入れる
+	std::vector<float> QuadIds(const SpriteBatch& batch)
+	{
+		std::vector<SpriteVertex> vertices(static_cast<size_t>(batch.GetQuadCount()) * kVerticesPerQuad);
+		batch.WriteVertices(vertices.data());
+
+		std::vector<float> ids;
+		for (size_t quad = 0; quad < batch.GetQuadCount(); ++quad)
+		{
+			const float id = vertices[quad * kVerticesPerQuad].position.x;
+			bool isIntact = true;
+			for (uint32_t i = 0; i < kVerticesPerQuad; ++i)
+			{
+				const Vector4& position = vertices[quad * kVerticesPerQuad + i].position;
+				isIntact &= position.x == id && position.y == static_cast<float>(i);
+			}
+			ids.push_back(isIntact ? id : -1.0f);
+		}
+		return ids;
+	}
+}
+
+TEST_CASE(SpriteBatch_SortsNegativeLayersFirst)
+{
+	SpriteBatch batch;
+	AddTagged(batch, 0, 2, 1.0f);
+	AddTagged(batch, 0, -1, 2.0f);
+	AddTagged(batch, 0, 0, 3.0f);
+	AddTagged(batch, 0, INT32_MIN, 4.0f);
+	AddTagged(batch, 0, INT32_MAX, 5.0f);
+	AddTagged(batch, 0, -100, 6.0f);
+	batch.Build();
+
+	TEST_CHECK(QuadIds(batch) == std::vector<float>({ 4.0f, 6.0f, 2.0f, 3.0f, 1.0f, 5.0f }));
+	// 全て同じテクスチャなので1回で描ける
+	TEST_CHECK(batch.GetRunCount() == 1);
+	TEST_CHECK(batch.GetRuns()[0].quadCount == 6);
+}
+
+TEST_CASE(SpriteBatch_KeepsSubmissionOrderWithinTexture)
+{
+	SpriteBatch batch;
+	// 同じレイヤーではテクスチャごとにまとまり、同じテクスチャの間は積んだ順のまま
+	AddTagged(batch, 7, 0, 1.0f);
+	AddTagged(batch, 3, 0, 2.0f);
+	AddTagged(batch, 7, 0, 3.0f);
+	AddTagged(batch, 3, 0, 4.0f);
+	AddTagged(batch, 7, 0, 5.0f);
+	batch.Build();
+
+	TEST_CHECK(QuadIds(batch) == std::vector<float>({ 2.0f, 4.0f, 1.0f, 3.0f, 5.0f }));
+	const std::vector<SpriteBatch::Run>& runs = batch.GetRuns();
+	TEST_CHECK(runs.size() == 2);
+	TEST_CHECK(runs[0].textureIndex == 3 && runs[0].firstQuad == 0 && runs[0].quadCount == 2);
+	TEST_CHECK(runs[1].textureIndex == 7 && runs[1].firstQuad == 2 && runs[1].quadCount == 3);
+}
+
+TEST_CASE(SpriteBatch_MergesRunsAcrossLayers)
+{
+	SpriteBatch batch;
+	// レイヤー0の最後とレイヤー1の最初が同じテクスチャなら1つにつながる
+	AddTagged(batch, 1, 0, 1.0f);
+	AddTagged(batch, 2, 0, 2.0f);
+	AddTagged(batch, 2, 1, 3.0f);
+	AddTagged(batch, 5, 1, 4.0f);
+	// レイヤー2はテクスチャ1だけなので、レイヤー1の最後（テクスチャ5）とはつながらない
+	AddTagged(batch, 1, 2, 5.0f);
+	batch.Build();
+
+	TEST_CHECK(QuadIds(batch) == std::vector<float>({ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }));
+	const std::vector<SpriteBatch::Run>& runs = batch.GetRuns();
+	TEST_CHECK(runs.size() == 4);
+	TEST_CHECK(runs[1].textureIndex == 2 && runs[1].firstQuad == 1 && runs[1].quadCount == 2);
+	TEST_CHECK(runs[3].textureIndex == 1 && runs[3].firstQuad == 4 && runs[3].quadCount == 1);
+
+	// 範囲は隙間なく全ての矩形を覆う
+	uint32_t total = 0;
+	for (const SpriteBatch::Run& run : runs)
+	{
+		TEST_CHECK(run.firstQuad == total);
+		total += run.quadCount;
+	}
+	TEST_CHECK(total == batch.GetQuadCount());
+}
+
+TEST_CASE(SpriteBatch_RejectsQuadsOverLimit)
+{
+	SpriteBatch batch;
+	bool isAccepted = true;
+	for (uint32_t i = 0; i < SpriteBatch::kMaxQuadCount; ++i)
+	{
+		isAccepted &= AddTagged(batch, i % 3, 0, static_cast<float>(i));
+	}
+	TEST_CHECK(isAccepted);
+	TEST_CHECK(batch.GetQuadCount() == SpriteBatch::kMaxQuadCount);
+
+	// 上限を超えた分は積まれない
+	TEST_CHECK(!AddTagged(batch, 0, 0, -2.0f));
+	TEST_CHECK(batch.GetQuadCount() == SpriteBatch::kMaxQuadCount);
+	batch.Build();
+	TEST_CHECK(batch.GetRunCount() == 3);
+
+	// 破棄すればまた積める
+	batch.Clear();
+	TEST_CHECK(batch.IsEmpty());
+	TEST_CHECK(AddTagged(batch, 0, 0, 0.0f));
+}
+
+TEST_CASE(SpriteBatch_WritesVerticesInSortedOrder)
+{
+	SpriteBatch batch;
+	AddTagged(batch, 4, 1, 1.0f);
+	AddTagged(batch, 2, 1, 2.0f);
+	AddTagged(batch, 9, -3, 3.0f);
+	AddTagged(batch, 2, 1, 4.0f);
+	batch.Build();
+
+	// 矩形ごとの4頂点は積んだ時の順のまま、矩形はソート後の順に並ぶ
+	TEST_CHECK(QuadIds(batch) == std::vector<float>({ 3.0f, 2.0f, 4.0f, 1.0f }));
+
+	// Buildし直しても並びは変わらない
+	batch.Build();
+	TEST_CHECK(QuadIds(batch) == std::vector<float>({ 3.0f, 2.0f, 4.0f, 1.0f }));
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "TestFramework.h"
+#include "application/GameObject/Combatable/base/StatusValue.h"
+
+namespace
+{
+	// 比較用：毎回全てのバフを足し、毎フレーム全てのバフの残り時間を減らす以前の実装
+	struct LegacyStatusValue
+	{
+		struct Buff
+		{
+			float value;
+			bool isPercent;
+			float duration;
+		};
+
+		float base = 0.0f;
+		std::vector<Buff> buffs;
+
+		float Calc() const
+		{
+			float add = 0.0f;
+			float percent = 1.0f;
+			for (const auto& b : buffs)
+			{
+				if (b.isPercent) percent += b.value;
+				else add += b.value;
+			}
+			return (base + add) * percent;
+		}
+
+		void AddBuff(const BuffValue& buff) { buffs.push_back({ buff.value, buff.isPercent, buff.duration }); }
+
+		// 以前のUpdateは残り時間がちょうど0のものしか消さず、減らして負になったバフが永続になっていた。
+		// それでは比較相手の仕事が減るので、0で止めて同じフレームに消す（StatusValueと同じ失効の仕方）
+		void Update(float deltaTime)
+		{
+			for (auto& b : buffs)
+			{
+				if (b.duration > 0.0f) b.duration = (std::max)(b.duration - deltaTime, 0.0f);
+			}
+			buffs.erase(std::remove_if(buffs.begin(), buffs.end(),
+									   [](const Buff& b) { return b.duration == 0.0f; }),
+						buffs.end());
+		}
+
+		size_t GetBuffCount() const { return buffs.size(); }
+	};
+
+	// キャラクター1体分のステータス
+	template<typename Value>
+	struct Character
+	{
+		Value stats[3];
+	};
+
+	constexpr int kCharacterCount = 2000;
+	constexpr int kFrameCount = 600;
+	constexpr int kQueriesPerStat = 6;
+	constexpr float kDeltaTime = 1.0f / 60.0f;
+
+	// ベンチマークの結果
+	struct BenchmarkResult
+	{
+		double milliseconds = 0.0;	// 経過時間
+		double checksum = 0.0;		// Calcの合計（両方の実装が同じ仕事をしたかの確認用）
+		size_t buffCount = 0;		// 最後に残ったバフの数
+	};
+
+	/**
+	 * \brief 2000体 x 3ステータス x 時限バフ4つを600フレーム更新し、1秒ごとにバフを1つ追加する
+	 */
+	template<typename Value>
+	BenchmarkResult RunBuffBenchmark()
+	{
+		std::vector<Character<Value>> characters(kCharacterCount);
+		for (int c = 0; c < kCharacterCount; ++c)
+		{
+			for (Value& stat : characters[c].stats)
+			{
+				stat.base = 100.0f;
+				for (int b = 0; b < 4; ++b)
+				{
+					stat.AddBuff(BuffValue(b % 2 ? 0.1f : 5.0f, b % 2 == 1, 1.0f + static_cast<float>((c + b) % 7)));
+				}
+			}
+		}
+
+		double checksum = 0.0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < kFrameCount; ++frame)
+		{
+			for (auto& character : characters)
+			{
+				for (Value& stat : character.stats)
+				{
+					stat.Update(kDeltaTime);
+					if (frame % 60 == 0)
+					{
+						stat.AddBuff(BuffValue(2.0f, false, 3.0f));
+					}
+					for (int q = 0; q < kQueriesPerStat; ++q)
+					{
+						checksum += stat.Calc();
+					}
+				}
+			}
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		BenchmarkResult result;
+		result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+		result.checksum = checksum;
+		for (const auto& character : characters)
+		{
+			for (const Value& stat : character.stats)
+			{
+				result.buffCount += stat.GetBuffCount();
+			}
+		}
+		return result;
+	}
+}
+
+TEST_CASE(StatusValue_CalcAppliesAddThenPercent)
+{
+	StatusValue value;
+	value.base = 100.0f;
+	value.AddBuff(BuffValue(20.0f, false));
+	value.AddBuff(BuffValue(0.5f, true));
+	TEST_CHECK(value.Calc() == 180.0f);
+
+	// baseを直接書き換えても反映される
+	value.base = 0.0f;
+	TEST_CHECK(value.Calc() == 30.0f);
+}
+
+TEST_CASE(StatusValue_ZeroDurationExpiresOnNextUpdate)
+{
+	StatusValue value;
+	value.base = 10.0f;
+	value.AddBuff(BuffValue(5.0f, false, 0.0f));
+	TEST_CHECK(value.Calc() == 15.0f);
+
+	value.Update(kDeltaTime);
+	TEST_CHECK(value.GetBuffCount() == 0);
+	TEST_CHECK(value.Calc() == 10.0f);
+}
+
+TEST_CASE(StatusValue_NegativeDurationIsPermanent)
+{
+	StatusValue value;
+	value.AddBuff(BuffValue(1.0f, false, -1.0f));
+	for (int i = 0; i < 1000; ++i)
+	{
+		value.Update(1.0f);
+	}
+	TEST_CHECK(value.GetBuffCount() == 1);
+	TEST_CHECK(value.GetRemainingTime(1) == -1.0f);
+}
+
+TEST_CASE(StatusValue_TimedBuffsExpireInOrder)
+{
+	StatusValue value;
+	const uint32_t late = value.AddBuff(BuffValue(1.0f, false, 2.0f));
+	const uint32_t early = value.AddBuff(BuffValue(10.0f, false, 1.0f));
+	TEST_CHECK(value.Calc() == 11.0f);
+
+	value.Update(1.0f);
+	TEST_CHECK(value.Calc() == 1.0f);
+	TEST_CHECK(value.GetRemainingTime(early) == -1.0f);
+	TEST_CHECK(value.GetRemainingTime(late) == 1.0f);
+
+	value.Update(1.0f);
+	TEST_CHECK(value.GetBuffCount() == 0);
+	TEST_CHECK(value.Calc() == 0.0f);
+}
+
+TEST_CASE(StatusValue_RemoveBuffDropsItsExpiry)
+{
+	// 6個入れて内部配列からあふれさせ、ヒープ側の経路も通す
+	BasicStatusValue<4> value;
+	std::vector<uint32_t> ids;
+	for (int i = 0; i < 6; ++i)
+	{
+		ids.push_back(value.AddBuff(BuffValue(1.0f, false, 1.0f + i)));
+	}
+	TEST_CHECK(value.RemoveBuff(ids[0]));
+	TEST_CHECK(value.RemoveBuff(ids[3]));
+	TEST_CHECK(!value.RemoveBuff(ids[3]));
+	TEST_CHECK(value.GetRemainingTime(ids[0]) == -1.0f);
+	TEST_CHECK(value.GetRemainingTime(ids[3]) == -1.0f);
+	TEST_CHECK(value.Calc() == 4.0f);
+
+	// 残りは期限どおりに失効する
+	value.Update(2.0f);
+	TEST_CHECK(value.GetBuffCount() == 3);
+	value.Update(10.0f);
+	TEST_CHECK(value.GetBuffCount() == 0);
+	TEST_CHECK(value.Calc() == 0.0f);
+}
+
+TEST_CASE(StatusValue_SetBuffValueUpdatesTotal)
+{
+	StatusValue value;
+	const uint32_t id = value.AddBuff(BuffValue(1.0f, false));
+	TEST_CHECK(value.SetBuffValue(id, 7.0f));
+	TEST_CHECK(value.Calc() == 7.0f);
+	TEST_CHECK(!value.SetBuffValue(id + 100, 1.0f));
+}
+
+BENCHMARK_CASE(StatusValue_Benchmark2000Characters)
+{
+	const BenchmarkResult legacy = RunBuffBenchmark<LegacyStatusValue>();
+	const BenchmarkResult cached = RunBuffBenchmark<StatusValue>();
+	std::printf("    %d characters x 3 stats, %d frames: legacy %.2f ms, cached %.2f ms (x%.1f), buffs left %zu / %zu\n",
+				kCharacterCount, kFrameCount, legacy.milliseconds, cached.milliseconds, legacy.milliseconds / cached.milliseconds,
+				legacy.buffCount, cached.buffCount);
+
+	// 両方とも同じようにバフが失効している（比較相手だけ仕事が少ないことはない）
+	// 残り時間をfloatで減らすか経過時間をdoubleで比べるかの違いで、失効が1フレームずれるものはある
+	TEST_CHECK(legacy.buffCount == cached.buffCount);
+	TEST_CHECK(std::fabs(legacy.checksum - cached.checksum) <= std::fabs(legacy.checksum) * 1e-3);
+}
@@ -0,0 +1,52 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	// 実行中のテストで起きた失敗の数
+	int currentFailureCount = 0;
+}
+
+std::vector<TestFramework::TestCase>& TestFramework::GetTestCases()
+{
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+void TestFramework::ReportFailure(const char* file, int line, const char* expression)
+{
+	std::printf("    %s(%d): CHECK failed: %s\n", file, line, expression);
+	++currentFailureCount;
+}
+
+int TestFramework::RunAll(bool runBenchmarks, const char* filter)
+{
+	int failedCount = 0;
+	int runCount = 0;
+	for (const TestCase& testCase : GetTestCases())
+	{
+		if (testCase.isBenchmark && !runBenchmarks)
+		{
+			continue;
+		}
+		if (filter && std::strstr(testCase.name, filter) == nullptr)
+		{
+			continue;
+		}
+
+		std::printf("[ RUN  ] %s\n", testCase.name);
+		currentFailureCount = 0;
+		const auto start = std::chrono::steady_clock::now();
+		testCase.function();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::printf("[%s] %s (%.2f ms)\n", currentFailureCount == 0 ? "  OK  " : " FAIL ", testCase.name, ms);
+
+		++runCount;
+		failedCount += currentFailureCount == 0 ? 0 : 1;
+	}
+	std::printf("\n%d test(s) run, %d failed\n", runCount, failedCount);
+	return failedCount;
+}
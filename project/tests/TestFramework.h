@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+
+/**
+ * \brief エンジンのCPU側の処理を確かめる簡易テストの登録と実行
+ * \note TEST_CASEは常に実行し、BENCHMARK_CASEはコマンドラインに--benchを付けた時だけ実行する
+ */
+namespace TestFramework
+{
+	using TestFunction = void(*)();
+
+	// 登録されたテスト1件分
+	struct TestCase
+	{
+		const char* name;
+		TestFunction function;
+		bool isBenchmark;
+	};
+
+	// 登録されたテストの一覧
+	std::vector<TestCase>& GetTestCases();
+
+	// 静的変数の初期化でテストを登録する
+	struct Registrar
+	{
+		Registrar(const char* name, TestFunction function, bool isBenchmark)
+		{
+			GetTestCases().push_back({ name, function, isBenchmark });
+		}
+	};
+
+	// 失敗を記録する（TEST_CHECKから呼ばれる）
+	void ReportFailure(const char* file, int line, const char* expression);
+
+	/**
+	 * \brief 登録されたテストを実行する
+	 * \param runBenchmarks ベンチマークも実行するか
+	 * \param filter 名前にこの文字列を含むものだけ実行する（nullptrなら全て）
+	 * \return 失敗したテストの数
+	 */
+	int RunAll(bool runBenchmarks, const char* filter);
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static TestFramework::Registrar name##Registrar(#name, name, false); \
+	static void name()
+
+#define BENCHMARK_CASE(name) \
+	static void name(); \
+	static TestFramework::Registrar name##Registrar(#name, name, true); \
+	static void name()
+
+#define TEST_CHECK(expression) \
+	do { if (!(expression)) { TestFramework::ReportFailure(__FILE__, __LINE__, #expression); } } while (false)
@@ -0,0 +1,157 @@
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "TestFramework.h"
+#include "base/UploadRingAllocator.h"
+
+namespace
+{
+	constexpr uint64_t kInvalid = UploadRingAllocator::kInvalidOffset;
+
+	// 割り当てた範囲
+	struct Range
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	bool Overlaps(const Range& a, const Range& b)
+	{
+		return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+	}
+}
+
+TEST_CASE(UploadRing_AlignsOffsets)
+{
+	UploadRingAllocator ring;
+	ring.Initialize(4096);
+
+	TEST_CHECK(ring.Allocate(10) == 0);
+	// 既定のアライメントは256
+	TEST_CHECK(ring.Allocate(10) == 256);
+	TEST_CHECK(ring.Allocate(4, 16) == 272);
+	TEST_CHECK(ring.Allocate(4, 16) == 288);
+	// 詰め物も使用量に含まれる
+	TEST_CHECK(ring.GetUsedSize() == 292);
+}
+
+TEST_CASE(UploadRing_RejectsInvalidSizes)
+{
+	UploadRingAllocator ring;
+	ring.Initialize(1024);
+
+	TEST_CHECK(ring.Allocate(0) == kInvalid);
+	TEST_CHECK(ring.Allocate(1025) == kInvalid);
+	TEST_CHECK(ring.Allocate(1024) == 0);
+	TEST_CHECK(ring.GetUsedSize() == 1024);
+}
+
+TEST_CASE(UploadRing_WrapsAroundToFront)
+{
+	UploadRingAllocator ring;
+	ring.Initialize(1024);
+
+	// 1フレーム目で前半、2フレーム目で後半の途中まで使う
+	TEST_CHECK(ring.Allocate(512) == 0);
+	ring.EndFrame(1);
+	TEST_CHECK(ring.Allocate(256) == 512);
+	ring.EndFrame(2);
+
+	// 1フレーム目が終われば、末尾に収まらない割り当ては先頭に戻る
+	ring.Release(1);
+	TEST_CHECK(ring.Allocate(384) == 0);
+	// 末尾の余り（256バイト）は詰め物として今フレームに数えられる
+	TEST_CHECK(ring.GetUsedSize() == 256 + 256 + 384);
+	ring.EndFrame(3);
+
+	// 2フレーム目だけ終わっても、先頭側がまだ使用中なので足りない
+	ring.Release(2);
+	TEST_CHECK(ring.GetUsedSize() == 256 + 384);
+	TEST_CHECK(ring.Allocate(768) == kInvalid);
+	// 空いているのは384〜768だけ
+	TEST_CHECK(ring.Allocate(256) == 512);
+}
+
+TEST_CASE(UploadRing_ReleasesOnlyCompletedFences)
+{
+	UploadRingAllocator ring;
+	ring.Initialize(4096);
+
+	for (uint64_t fence = 1; fence <= 3; ++fence)
+	{
+		TEST_CHECK(ring.Allocate(1024) != kInvalid);
+		ring.EndFrame(fence);
+	}
+	TEST_CHECK(ring.GetPendingFrameCount() == 3);
+	TEST_CHECK(ring.Allocate(2048) == kInvalid);
+
+	// 完了していないフェンスの領域は戻らない
+	ring.Release(0);
+	TEST_CHECK(ring.GetUsedSize() == 3072);
+
+	ring.Release(2);
+	TEST_CHECK(ring.GetPendingFrameCount() == 1);
+	TEST_CHECK(ring.GetUsedSize() == 1024);
+
+	// 全て完了すれば先頭から使い直す
+	ring.Release(3);
+	TEST_CHECK(ring.GetUsedSize() == 0);
+	TEST_CHECK(ring.Allocate(16) == 0);
+	TEST_CHECK(ring.GetPeakUsedSize() == 3072);
+}
+
+TEST_CASE(UploadRing_InFlightRangesNeverOverlap)
+{
+	constexpr uint64_t kCapacity = 4096;
+	constexpr size_t kFramesInFlight = 2;
+
+	UploadRingAllocator ring;
+	ring.Initialize(kCapacity);
+
+	std::mt19937 random(1);
+	std::deque<std::vector<Range>> inFlight;
+	uint64_t fence = 0;
+	bool isValid = true;
+	for (int frame = 0; frame < 20000 && isValid; ++frame)
+	{
+		std::vector<Range> current;
+		const uint32_t count = random() % 8;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint64_t size = 1 + random() % 600;
+			const uint64_t alignment = (random() % 2) ? 256 : 16;
+			const uint64_t offset = ring.Allocate(size, alignment);
+			if (offset == kInvalid)
+			{
+				continue;
+			}
+
+			const Range range{ offset, size };
+			isValid &= offset % alignment == 0 && offset + size <= kCapacity;
+			for (const auto& ranges : inFlight)
+			{
+				for (const Range& other : ranges)
+				{
+					isValid &= !Overlaps(range, other);
+				}
+			}
+			for (const Range& other : current)
+			{
+				isValid &= !Overlaps(range, other);
+			}
+			current.push_back(range);
+		}
+
+		// GPUが2フレーム遅れて追いかける
+		ring.EndFrame(++fence);
+		inFlight.push_back(std::move(current));
+		if (inFlight.size() > kFramesInFlight)
+		{
+			inFlight.pop_front();
+			ring.Release(fence - kFramesInFlight);
+		}
+	}
+	TEST_CHECK(isValid);
+	TEST_CHECK(ring.GetUsedSize() <= kCapacity);
+}
@@ -0,0 +1,23 @@
+#include <cstring>
+
+#include "TestFramework.h"
+
+// 使い方: EngineTests.exe [--bench] [名前の一部]
+int main(int argc, char* argv[])
+{
+	bool runBenchmarks = false;
+	const char* filter = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+		{
+			runBenchmarks = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	return TestFramework::RunAll(runBenchmarks, filter) == 0 ? 0 : 1;
+}